@@ -0,0 +1,307 @@
+"""Parallel sweep runner for the scratch simulations.
+
+Runs the prebuilt scratch binaries (strategy-mp, simple-nada, tcp-mp-nada,
+many-flows) directly instead of through `./ns3 run`, as many at a time as
+there are cores. Each cell of a sweep is a program, its command line
+parameters and an RngSeed/RngRun pair. Finished cells are cached under
+results/sweep_cache, keyed on a hash of the cell and of the binary and NADA
+library it ran with, so rerunning a sweep only runs the cells that changed
+or never finished; an interrupted sweep resumes where it stopped.
+
+Every run also writes its metrics file (--metricsFile, see NadaMetricsSink)
+next to its cached record; load_metrics() reads it into a pandas DataFrame,
+so results need not be scraped from stdout.
+
+Build once before sweeping:
+
+    ./ns3 build
+
+Example, three runs of every strategy on two data rates:
+
+    python3 experiments/sweep.py strategy-mp \\
+        --set pathSelectionStrategy=0,1,2,4,5 --set dataRate1=50Mbps,100Mbps \\
+        --runs 3 --output results/sweep.jsonl
+"""
+
+import argparse
+import concurrent.futures
+import functools
+import glob
+import hashlib
+import itertools
+import json
+import os
+import subprocess
+import sys
+import time
+
+script_dir = os.path.dirname(os.path.abspath(__file__))
+NS3_DIR = os.environ.get("NS3_DIR", os.path.abspath(os.path.join(script_dir, "..")))
+CACHE_DIR = os.path.join(script_dir, "../results/sweep_cache")
+
+SCRATCH_PROGRAMS = ("strategy-mp", "simple-nada", "tcp-mp-nada", "many-flows")
+
+# Bump when the cached record layout changes
+CACHE_FORMAT = 2
+
+
+@functools.lru_cache(maxsize=None)
+def find_binary(program, ns3_dir=NS3_DIR):
+    """Return the newest built executable of a scratch program"""
+    # ns-3 names them ns3.<version>-<program>-<profile> or ns3-dev-<program>-<profile>
+    pattern = os.path.join(ns3_dir, "build", "scratch", "**", f"ns3*-{program}-*")
+    candidates = [path for path in glob.glob(pattern, recursive=True)
+                  if os.path.isfile(path) and os.access(path, os.X_OK)]
+    if not candidates:
+        raise FileNotFoundError(f"No built binary for scratch/{program} under {ns3_dir}/build; "
+                                f"run ./ns3 build first")
+    return max(candidates, key=os.path.getmtime)
+
+
+@functools.lru_cache(maxsize=None)
+def binary_version(binary, ns3_dir=NS3_DIR):
+    """Hash the binary and the NADA library, so a rebuild invalidates the cache"""
+    digest = hashlib.sha256()
+    libraries = sorted(glob.glob(os.path.join(ns3_dir, "build", "lib", "libns3*-nada*")))
+    for path in [binary] + libraries:
+        with open(path, "rb") as f:
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                digest.update(chunk)
+    return digest.hexdigest()
+
+
+def simulation_timeout(params):
+    """Time limit of one run in seconds, scaled with link speed and packet count"""
+    timeout = 1800  # 30 mins
+    data_rate1 = str(params.get('dataRate1', params.get('dataRate', '1Mbps')))
+    max_packets = int(params.get('maxPackets', 1000))
+
+    if 'Gbps' in data_rate1:
+        rate_val = float(data_rate1.replace('Gbps', ''))
+        if rate_val >= 10:      # 10Gbps+
+            timeout = 3600      # 60 minutes
+        elif rate_val >= 5:     # 5Gbps+
+            timeout = 2700      # 45 minutes
+        elif rate_val >= 1:     # 1Gbps+
+            timeout = 2400      # 40 minutes
+
+    if max_packets > 100000:
+        timeout = max(timeout, 4800)  # 80 minutes for very large packet counts
+    elif max_packets > 50000:
+        timeout = max(timeout, 3600)  # 60 minutes for large packet counts
+
+    return timeout
+
+
+def make_cell(program, params, run=1, seed=1, label=None):
+    """Describe one simulation of a sweep"""
+    return {
+        "program": program,
+        "params": dict(params),
+        "seed": seed,
+        "run": run,
+        "label": label or program,
+    }
+
+
+def cell_key(cell, version):
+    """Cache key of a cell run with a given binary version"""
+    key = {
+        "format": CACHE_FORMAT,
+        "program": cell["program"],
+        "params": {name: str(value) for name, value in cell["params"].items()},
+        "seed": cell["seed"],
+        "run": cell["run"],
+        "version": version,
+    }
+    return hashlib.sha256(json.dumps(key, sort_keys=True).encode()).hexdigest()
+
+
+def build_command(binary, cell, metrics_file=None):
+    cmd = [binary]
+    for name, value in sorted(cell["params"].items()):
+        cmd.append(f"--{name}={value}")
+    if metrics_file:
+        cmd.append(f"--metricsFile={metrics_file}")
+    # Global values, understood by every ns-3 CommandLine
+    cmd.append(f"--RngSeed={cell['seed']}")
+    cmd.append(f"--RngRun={cell['run']}")
+    return cmd
+
+
+def run_cell(binary, cell, ns3_dir=NS3_DIR, timeout=None, metrics_file=None):
+    """Run one cell and return its record; never raises for a failed run
+
+    With metrics_file the program writes its NadaMetricsSink rows there.
+    """
+    if metrics_file:
+        os.makedirs(os.path.dirname(metrics_file), exist_ok=True)
+    cmd = build_command(binary, cell, metrics_file)
+    env = dict(os.environ)
+    library_path = os.path.join(ns3_dir, "build", "lib")
+    env["LD_LIBRARY_PATH"] = os.pathsep.join(
+        path for path in (library_path, env.get("LD_LIBRARY_PATH")) if path)
+
+    record = dict(cell)
+    record["command"] = " ".join(cmd)
+    start = time.monotonic()
+    try:
+        result = subprocess.run(cmd, cwd=ns3_dir, env=env, capture_output=True, text=True,
+                                timeout=timeout or simulation_timeout(cell["params"]))
+        record["returncode"] = result.returncode
+        record["stdout"] = result.stdout
+        record["stderr"] = result.stderr[-4000:]
+    except subprocess.TimeoutExpired:
+        record["returncode"] = None
+        record["stdout"] = ""
+        record["stderr"] = "timed out"
+    record["duration"] = time.monotonic() - start
+    record["ok"] = record["returncode"] == 0
+    record["metrics_file"] = metrics_file if metrics_file and os.path.exists(metrics_file) else None
+    return record
+
+
+def load_metrics(record):
+    """Load the metrics rows of a record, or of a metrics file, into a pandas DataFrame
+
+    Columns are time, kind ("interval" or "final"), source, path and one
+    column per metric.
+    """
+    import pandas as pd
+
+    path = record.get("metrics_file") if isinstance(record, dict) else record
+    if not path:
+        return pd.DataFrame()
+    return pd.read_json(path, lines=True)
+
+
+def metrics_path(cache_dir, key):
+    return os.path.join(cache_dir, key[:2], key + ".metrics.jsonl")
+
+
+def load_cached(cache_dir, key):
+    path = os.path.join(cache_dir, key[:2], key + ".json")
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        # Missing, or cut short by an interrupted write
+        return None
+
+
+def store_cached(cache_dir, key, record):
+    folder = os.path.join(cache_dir, key[:2])
+    os.makedirs(folder, exist_ok=True)
+    path = os.path.join(folder, key + ".json")
+    # Written aside and renamed, so a killed sweep never leaves half a record
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        json.dump(record, f)
+    os.replace(tmp, path)
+
+
+def run_sweep(cells, jobs=None, cache_dir=CACHE_DIR, ns3_dir=NS3_DIR, use_cache=True,
+              timeout=None):
+    """Run every cell not already cached and return their records in order
+
+    Only successful runs are cached, so failed and interrupted cells run
+    again on the next call.
+    """
+    jobs = jobs or os.cpu_count() or 1
+    records = [None] * len(cells)
+    # Identical cells, such as a baseline shared by several strategies, run once
+    pending = {}
+
+    for index, cell in enumerate(cells):
+        binary = find_binary(cell["program"], ns3_dir)
+        key = cell_key(cell, binary_version(binary, ns3_dir))
+        if key in pending:
+            pending[key][2].append(index)
+            continue
+        cached = load_cached(cache_dir, key) if use_cache else None
+        if cached is not None:
+            cached["cached"] = True
+            cached["label"] = cell["label"]
+            records[index] = cached
+        else:
+            pending[key] = (index, binary, [index])
+
+    cached_cells = sum(1 for record in records if record is not None)
+    print(f"Sweep: {len(cells)} cells, {cached_cells} cached, "
+          f"{len(pending)} to run on {min(jobs, max(len(pending), 1))} workers")
+
+    # A thread per worker is enough: each one only waits for its simulation process
+    done = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = {pool.submit(run_cell, binary, cells[index], ns3_dir, timeout,
+                               metrics_path(cache_dir, key)): key
+                   for key, (index, binary, _) in pending.items()}
+        try:
+            for future in concurrent.futures.as_completed(futures):
+                key = futures[future]
+                record = future.result()
+                record["cached"] = False
+                for index in pending[key][2]:
+                    records[index] = dict(record, label=cells[index]["label"])
+                if record["ok"]:
+                    store_cached(cache_dir, key, record)
+                done += 1
+                status = "ok" if record["ok"] else f"FAILED ({record['stderr'][-200:].strip()})"
+                print(f"[{done}/{len(pending)}] {record['label']} run {record['run']}: "
+                      f"{status} in {record['duration']:.0f}s")
+        except KeyboardInterrupt:
+            # Finished cells are already cached; the next call resumes from there
+            pool.shutdown(wait=False, cancel_futures=True)
+            raise
+
+    return records
+
+
+def parse_assignments(assignments):
+    """Turn ['name=a,b', ...] into the cartesian product of parameter dicts"""
+    names, choices = [], []
+    for assignment in assignments or []:
+        name, _, values = assignment.partition("=")
+        if not name or not values:
+            raise ValueError(f"Expected name=value[,value...], got '{assignment}'")
+        names.append(name)
+        choices.append(values.split(","))
+    return [dict(zip(names, combination)) for combination in itertools.product(*choices)]
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Run a parameter sweep of a scratch simulation")
+    parser.add_argument("program", choices=SCRATCH_PROGRAMS)
+    parser.add_argument("--set", action="append", metavar="NAME=V1,V2",
+                        help="Parameter and the values to sweep; repeat for a cartesian product")
+    parser.add_argument("--runs", type=int, default=1, help="RngRun values 1..N per parameter set")
+    parser.add_argument("--seed", type=int, default=1, help="RngSeed of every run")
+    parser.add_argument("--jobs", type=int, default=None, help="Parallel runs (default: cores)")
+    parser.add_argument("--timeout", type=int, default=None, help="Seconds per run")
+    parser.add_argument("--no-cache", action="store_true", help="Run every cell again")
+    parser.add_argument("--cache-dir", default=CACHE_DIR)
+    parser.add_argument("--ns3-dir", default=NS3_DIR)
+    parser.add_argument("--output", help="Write one JSON record per cell to this file")
+    args = parser.parse_args(argv)
+
+    cells = []
+    for params in parse_assignments(args.set):
+        label = " ".join(f"{name}={value}" for name, value in params.items()) or args.program
+        for run in range(1, args.runs + 1):
+            cells.append(make_cell(args.program, params, run=run, seed=args.seed, label=label))
+
+    records = run_sweep(cells, jobs=args.jobs, cache_dir=args.cache_dir, ns3_dir=args.ns3_dir,
+                        use_cache=not args.no_cache, timeout=args.timeout)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            for record in records:
+                f.write(json.dumps(record) + "\n")
+
+    failed = sum(1 for record in records if not record["ok"])
+    print(f"Sweep finished: {len(records) - failed} ok, {failed} failed")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
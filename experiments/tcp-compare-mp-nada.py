@@ -8,6 +8,8 @@ import numpy as np
 import seaborn as sns
 import sys
 
+import sweep
+
 script_dir = os.path.dirname(os.path.abspath(__file__))
 OUTPUT_DIR = os.path.join(script_dir, "../results/comparison")
 print(f"Using output directory: {OUTPUT_DIR}")
@@ -318,71 +320,42 @@ def get_scenario_folder(scenario_name):
     os.makedirs(folder_path, exist_ok=True)
     return folder_path
 
-def run_simulation(script_name, params=None):
-    """Run the specified simulation script with parameters and return the output."""
-    if params:
-        # Auto-calculate adaptive parameters if not already set
-        data_rate1 = params.get('dataRate1', params.get('dataRate', '1Mbps'))
+def prepare_params(params):
+    """Fill in the adaptive maxPackets/simulationTime when a scenario leaves them out"""
+    data_rate1 = params.get('dataRate1', params.get('dataRate', '1Mbps'))
 
-        if 'maxPackets' not in params or 'simulationTime' not in params:
-            adaptive_params = calculate_adaptive_params(
-                data_rate1,
-                params.get('simulationTime', 60)
-            )
+    if 'maxPackets' not in params or 'simulationTime' not in params:
+        adaptive_params = calculate_adaptive_params(
+            data_rate1,
+            params.get('simulationTime', 60)
+        )
 
-            # Apply adaptive parameters if not explicitly set
-            for key, value in adaptive_params.items():
-                if key not in params:
-                    params[key] = value
-                    print(f"Auto-set {key}={value} for {data_rate1}")
+        # Apply adaptive parameters if not explicitly set
+        for key, value in adaptive_params.items():
+            if key not in params:
+                params[key] = value
+                print(f"Auto-set {key}={value} for {data_rate1}")
 
-    cmd_string = script_name
-    if params:
-        for key, value in params.items():
-            cmd_string += f" --{key}={value}"
+    return params
 
-    # Create the command list with quotes around the full command string
-    cmd = ["./ns3", "run", f'"{cmd_string}"']
+def run_simulation(script_name, params=None):
+    """Run the specified simulation script with parameters and return the output."""
+    params = prepare_params(params or {})
+    program = os.path.basename(script_name)
 
-    print(f"Running simulation: {' '.join(cmd)}")
     try:
-        timeout = 1800 # 30 mins
-
-        if params:
-            strategy = params.get('pathSelectionStrategy', 0)
-            data_rate1 = params.get('dataRate1', '1Mbps')
-            max_packets = params.get('maxPackets', 1000)
-
-
-        if 'Gbps' in data_rate1:
-            rate_val = float(data_rate1.replace('Gbps', ''))
-            if rate_val >= 10:      # 10Gbps+
-                timeout = 3600      # 60 minutes
-            elif rate_val >= 5:     # 5Gbps+
-                timeout = 2700      # 45 minutes
-            elif rate_val >= 1:     # 1Gbps+
-                timeout = 2400      # 40 minutes
-
-        if max_packets > 100000:
-            timeout = max(timeout, 4800)  # 80 minutes for very large packet counts
-        elif max_packets > 50000:
-            timeout = max(timeout, 3600)  # 60 minutes for large packet counts
-
-        result = subprocess.run(cmd, capture_output=True, text=True, timeout=timeout)
-
-        if result.returncode != 0:
-            print(f"Simulation failed with code {result.returncode}")
-            print(f"Error: {result.stderr}")
-            return None
-
-        return result.stdout
-    except subprocess.TimeoutExpired:
-        print("Simulation timed out after 10 minutes")
-        return None
+        record = sweep.run_sweep([sweep.make_cell(program, params)], jobs=1)[0]
     except Exception as e:
         print(f"Error running simulation: {e}")
         return None
 
+    if not record["ok"]:
+        print(f"Simulation failed with code {record['returncode']}")
+        print(f"Error: {record['stderr']}")
+        return None
+
+    return record["stdout"]
+
 def parse_output(output):
     """Parse the simulation output and extract relevant statistics."""
     if not output:
@@ -1599,7 +1572,27 @@ def main():
     all_results = {}
     strategy_comparison_results = {}
 
-    # Run all scenarios
+    # Run every simulation up front, in parallel; the baseline runs shared by
+    # the strategies of a base scenario are identical cells and run once
+    cells = []
+    for scenario in SIMULATION_SCENARIOS:
+        multipath_params = prepare_params(scenario["params"])
+        simple_params = multipath_params.copy()
+        simple_params.pop('pathSelectionStrategy', None)  # Remove strategy for simple TCP
+        cells.append(sweep.make_cell("strategy-mp", multipath_params,
+                                     label=f"{scenario['name']} (multipath)"))
+        cells.append(sweep.make_cell("simple-nada", simple_params,
+                                     label=f"{scenario['base_scenario']} (aggregated)"))
+    records = sweep.run_sweep(cells, jobs=SWEEP_JOBS)
+
+    def record_output(record):
+        if not record["ok"]:
+            print(f"Simulation {record['label']} failed with code {record['returncode']}")
+            print(f"Error: {record['stderr']}")
+            return None
+        return record["stdout"]
+
+    # Analyse all scenarios
     for i, scenario in enumerate(SIMULATION_SCENARIOS, 1):
         scenario_name = scenario["name"]
         base_scenario = scenario["base_scenario"]
@@ -1611,13 +1604,9 @@ def main():
         print(f"Strategy: {strategy}")
         print("=" * 50)
 
-        # Run Multipath-NADA-nada simulation
-        multipath_output = run_simulation("scratch/strategy-mp", scenario["params"])
-
-        # Run Aggregated-NADA-nada simulation with same parameters (excluding strategy)
-        simple_params = scenario["params"].copy()
-        simple_params.pop('pathSelectionStrategy', None)  # Remove strategy for simple TCP
-        simple_output = run_simulation("scratch/simple-nada", simple_params)
+        # Multipath-NADA run and the Aggregated-NADA run with the same parameters
+        multipath_output = record_output(records[2 * (i - 1)])
+        simple_output = record_output(records[2 * (i - 1) + 1])
 
         # Save raw outputs
         save_raw_data(scenario_name, multipath_output, simple_output)
@@ -1689,6 +1678,13 @@ if __name__ == "__main__":
     print("="*50)
 
     import sys
+    # --jobs=N caps the parallel simulations, all cores by default
+    SWEEP_JOBS = None
+    for arg in sys.argv[1:]:
+        if arg.startswith("--jobs="):
+            SWEEP_JOBS = int(arg.split("=", 1)[1])
+    sys.argv = [arg for arg in sys.argv if not arg.startswith("--jobs=")]
+
     if len(sys.argv) > 1:
         if sys.argv[1] == "--fast":
             print("🚀 FAST MODE: Applying optimizations for quick comparative testing")
@@ -0,0 +1,815 @@
+/*
+ * NS-3 Simulation of many multipath NADA video flows sharing bottlenecks
+ *
+ * Topology:
+ *
+ *  +----------+                                                    +------------+
+ *  | Sender 1 |---\     +--------+   bottleneck 0   +---------+    /| Receiver 1 |
+ *  +----------+    +----| Left 0 |==================| Right 0 |---+ +------------+
+ *  +----------+   /     +--------+                  +---------+    \+------------+
+ *  | Sender 2 |--+                                                  | Receiver 2 |
+ *  +----------+   \     +--------+   bottleneck 1   +---------+    /+------------+
+ *       ...        +----| Left 1 |==================| Right 1 |---+       ...
+ *  +----------+   /     +--------+                  +---------+    \+------------+
+ *  | Sender N |--+          ...                         ...         | Receiver N |
+ *  +----------+                                                     +------------+
+ *
+ * Every flow is one multipath NADA client streaming video to its own
+ * receiver over pathsPerFlow paths. A path is an access link from the sender
+ * to the left router of a bottleneck, the bottleneck, and an access link from
+ * the right router to the receiver. Which bottleneck each path crosses is
+ * set by --sharing:
+ *
+ *   disjoint  path j of every flow crosses bottleneck j mod B, so the flows
+ *             share every bottleneck but the paths of a flow do not
+ *   shared    every path of flow i crosses bottleneck i mod B, so the paths
+ *             of a flow compete with each other (see couplingMode)
+ *   random    every path crosses a bottleneck drawn at random
+ *
+ * The strategies listed in --strategies are given to the flows in turn. The
+ * run reports Jain's fairness index of the flow goodputs and percentiles of
+ * the one-way packet delay, over all flows and per strategy, along with the
+ * events executed and the peak memory, so the per-flow cost of the clients
+ * can be checked as flows are added.
+ *
+ * With ns-3 built with MPI, --distributed splits the nodes over the ranks
+ * of an mpirun (see RankPlan), e.g.
+ *
+ *   mpirun -np 4 ./ns3 run "many-flows --distributed --numFlows=2000"
+ *
+ * The clients and receivers only exchange packets, so nothing else changes;
+ * the results are summed over the ranks and reported by rank 0.
+ */
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mp-factory.h"
+#include "ns3/mp-nada-base.h"
+#include "ns3/nada-header.h"
+#include "ns3/nada-metrics-sink.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/video-receiver.h"
+#include "ns3/video-source.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+
+#include <mpi.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <sys/resource.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ManyFlowsSimulation");
+
+/**
+ * Results of a group of flows: the goodput of each flow and the delay
+ * histogram of all their packets
+ */
+struct FlowGroup
+{
+    FlowGroup()
+        : binWidth(0.001),
+          packets(0),
+          underruns(0)
+    {
+    }
+
+    /// Add the delay histogram of one flow monitor flow
+    void AddDelays(const Histogram& histogram)
+    {
+        if (histogram.GetNBins() > delayBins.size())
+        {
+            delayBins.resize(histogram.GetNBins(), 0);
+        }
+        for (uint32_t i = 0; i < histogram.GetNBins(); i++)
+        {
+            delayBins[i] += histogram.GetBinCount(i);
+            packets += histogram.GetBinCount(i);
+        }
+    }
+
+    /**
+     * Delay below which a fraction of the packets arrived, in seconds; the
+     * upper edge of the bin holding that packet, so at most one bin high
+     */
+    double GetDelayPercentile(double fraction) const
+    {
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * packets));
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < delayBins.size(); i++)
+        {
+            seen += delayBins[i];
+            if (seen >= rank && seen > 0)
+            {
+                return (i + 1) * binWidth;
+            }
+        }
+        return 0.0;
+    }
+
+    double binWidth;                 // Width of a delay bin (s)
+    std::vector<double> goodputs;    // Mbps received by each flow
+    std::vector<uint64_t> delayBins; // Packets per delay bin
+    uint64_t packets;                // Packets in the histogram
+    uint32_t underruns;              // Playout buffer underruns of the flows
+};
+
+/**
+ * Rank of every node when the run is split over MPI processes. The sender
+ * and the receiver of a flow share a rank, so the flow monitor of that rank
+ * sees both ends of its packets; the flows, and the router pairs of the
+ * bottlenecks, are dealt over the ranks in turn. The only links between
+ * ranks are then access links, whose delay is the lookahead of the run.
+ */
+struct RankPlan
+{
+    explicit RankPlan(uint32_t ranks)
+        : ranks(ranks)
+    {
+    }
+
+    uint32_t GetFlowRank(uint32_t flow) const
+    {
+        return flow % ranks;
+    }
+
+    uint32_t GetBottleneckRank(uint32_t bottleneck) const
+    {
+        return bottleneck % ranks;
+    }
+
+    uint32_t ranks; // MPI processes, 1 for a serial run
+};
+
+#ifdef NS3_MPI
+/**
+ * Sum a vector over the ranks into rank 0; every rank passes the same length
+ */
+void
+SumOverRanks(std::vector<uint64_t>& values)
+{
+    std::vector<uint64_t> total(values.size(), 0);
+    MPI_Reduce(values.data(),
+               total.data(),
+               values.size(),
+               MPI_UINT64_T,
+               MPI_SUM,
+               0,
+               MPI_COMM_WORLD);
+    values.swap(total);
+}
+
+/**
+ * Sum the delay histogram of a group over the ranks into rank 0
+ */
+void
+SumOverRanks(FlowGroup& group)
+{
+    uint64_t bins = group.delayBins.size();
+    uint64_t maxBins = 0;
+    MPI_Allreduce(&bins, &maxBins, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    group.delayBins.resize(maxBins, 0);
+    SumOverRanks(group.delayBins);
+    group.packets = std::accumulate(group.delayBins.begin(), group.delayBins.end(), uint64_t(0));
+}
+
+/**
+ * Largest value over the ranks, on rank 0
+ */
+double
+MaxOverRanks(double value)
+{
+    double max = value;
+    MPI_Reduce(&value, &max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    return max;
+}
+#endif
+
+/**
+ * Jain's fairness index: 1 when every flow gets the same, 1/n when a
+ * single flow gets everything
+ */
+double
+JainIndex(const std::vector<double>& values)
+{
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (double value : values)
+    {
+        sum += value;
+        sumSquares += value * value;
+    }
+    return sumSquares > 0.0 ? sum * sum / (values.size() * sumSquares) : 0.0;
+}
+
+/**
+ * Parse a comma-separated list of strategy IDs, skipping invalid entries
+ */
+std::vector<uint32_t>
+ParseStrategies(const std::string& list)
+{
+    std::vector<uint32_t> strategies;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        std::stringstream value(item);
+        uint32_t strategy;
+        if (value >> strategy && strategy <= MultiPathNadaClientFactory::EARLIEST_ARRIVAL)
+        {
+            strategies.push_back(strategy);
+        }
+        else if (!item.empty())
+        {
+            NS_LOG_WARN("Ignoring unknown strategy '" << item << "'");
+        }
+    }
+    return strategies;
+}
+
+void
+PrintGroup(const std::string& name, const FlowGroup& group)
+{
+    if (group.goodputs.empty())
+    {
+        return;
+    }
+
+    double total = 0.0;
+    for (double goodput : group.goodputs)
+    {
+        total += goodput;
+    }
+
+    std::cout << name << ":\n";
+    std::cout << "  Flows: " << group.goodputs.size() << "\n";
+    std::cout << "  Total goodput: " << total << " Mbps\n";
+    std::cout << "  Mean goodput per flow: " << total / group.goodputs.size() << " Mbps\n";
+    std::cout << "  Jain's fairness index: " << JainIndex(group.goodputs) << "\n";
+    std::cout << "  Delay p50/p95/p99: " << group.GetDelayPercentile(0.50) * 1000.0 << " / "
+              << group.GetDelayPercentile(0.95) * 1000.0 << " / "
+              << group.GetDelayPercentile(0.99) * 1000.0 << " ms\n";
+    std::cout << "  Buffer underruns: " << group.underruns << "\n\n";
+}
+
+void
+RecordGroup(Ptr<NadaMetricsSink> sink, const std::string& source, const FlowGroup& group)
+{
+    if (group.goodputs.empty())
+    {
+        return;
+    }
+
+    double total = 0.0;
+    for (double goodput : group.goodputs)
+    {
+        total += goodput;
+    }
+    sink->RecordFinal(source, 0, "flows", group.goodputs.size());
+    sink->RecordFinal(source, 0, "goodput_mbps", total);
+    sink->RecordFinal(source, 0, "jain_index", JainIndex(group.goodputs));
+    sink->RecordFinal(source, 0, "delay_p50_s", group.GetDelayPercentile(0.50));
+    sink->RecordFinal(source, 0, "delay_p95_s", group.GetDelayPercentile(0.95));
+    sink->RecordFinal(source, 0, "delay_p99_s", group.GetDelayPercentile(0.99));
+    sink->RecordFinal(source, 0, "underruns", group.underruns);
+}
+
+int
+main(int argc, char* argv[])
+{
+    // Flows and paths
+    uint32_t numFlows = 50;
+    uint32_t pathsPerFlow = 2;
+    uint32_t numBottlenecks = 2;
+    std::string sharing = "disjoint";
+    std::string strategyList = "0,6,7";
+
+    // Links
+    std::string bottleneckRate = "100Mbps";
+    uint32_t bottleneckDelayMs = 10;
+    uint32_t delayStepMs = 10;
+    std::string accessRate = "1Gbps";
+    uint32_t accessDelayMs = 1;
+    uint32_t queueSize = 200;
+    bool enableAQM = false;
+
+    // Video and clients
+    std::string videoRate = "2Mbps";
+    bool rateAdaptive = true;
+    std::string videoTrace = "";
+    uint32_t frameRate = 30;
+    uint32_t keyFrameInterval = 60;
+    uint32_t couplingMode = 0;
+    bool failover = false;
+    uint32_t sendHistorySize = 256;
+    uint32_t ackEveryN = 4;
+    uint32_t ackIntervalMs = 10;
+
+    uint32_t simulationTime = 30;
+    double startSpread = 5.0;
+    std::string metricsFile = "";
+    bool distributed = false;
+    bool nullMessages = false;
+
+    CommandLine cmd;
+    cmd.AddValue("numFlows", "Number of multipath video flows", numFlows);
+    cmd.AddValue("pathsPerFlow", "Paths of every flow", pathsPerFlow);
+    cmd.AddValue("bottlenecks", "Number of bottleneck links", numBottlenecks);
+    cmd.AddValue("sharing",
+                 "Bottleneck crossed by each path: disjoint (path j on bottleneck j), "
+                 "shared (every path of flow i on bottleneck i) or random",
+                 sharing);
+    cmd.AddValue("strategies",
+                 "Comma-separated strategy IDs given to the flows in turn "
+                 "(0=WEIGHTED ... 7=EARLIEST_ARRIVAL, as in strategy-mp)",
+                 strategyList);
+    cmd.AddValue("bottleneckRate", "Data rate of every bottleneck link", bottleneckRate);
+    cmd.AddValue("bottleneckDelayMs", "Delay of the first bottleneck link in ms", bottleneckDelayMs);
+    cmd.AddValue("delayStepMs",
+                 "Delay added to each further bottleneck, so the paths of a flow differ",
+                 delayStepMs);
+    cmd.AddValue("accessRate", "Data rate of the access links", accessRate);
+    cmd.AddValue("accessDelayMs", "Delay of the access links in ms", accessDelayMs);
+    cmd.AddValue("queueSize", "Device queue size in packets", queueSize);
+    cmd.AddValue("enableAQM", "Run CoDel on the bottleneck links", enableAQM);
+    cmd.AddValue("videoRate",
+                 "Video bitrate of every flow; its cap when rate adaptive",
+                 videoRate);
+    cmd.AddValue("rateAdaptive",
+                 "Encode at each client's total NADA rate, up to videoRate",
+                 rateAdaptive);
+    cmd.AddValue("videoTrace",
+                 "Frame size trace replayed by every flow (mapped once for all of them)",
+                 videoTrace);
+    cmd.AddValue("frameRate", "Video frame rate", frameRate);
+    cmd.AddValue("keyFrameInterval", "Frames between key frames", keyFrameInterval);
+    cmd.AddValue("couplingMode",
+                 "Per-path NADA coupling: 0=independent, 1=coupled, "
+                 "2=coupled on detected shared bottleneck",
+                 couplingMode);
+    cmd.AddValue("failover", "Fail paths over when their feedback stops", failover);
+    cmd.AddValue("sendHistorySize",
+                 "Packets in flight tracked per path; bounds the client memory per path",
+                 sendHistorySize);
+    cmd.AddValue("ackEveryN",
+                 "Receiver sends one aggregated ACK per N packets (1 = per-packet ACKs)",
+                 ackEveryN);
+    cmd.AddValue("ackIntervalMs",
+                 "Maximum time the receiver holds an aggregated ACK (0 = no timer)",
+                 ackIntervalMs);
+    cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("startSpread", "Flows start evenly over this many seconds", startSpread);
+    cmd.AddValue("metricsFile",
+                 "Write per-flow, per-strategy and run metrics to this JSON-lines file",
+                 metricsFile);
+    cmd.AddValue("distributed",
+                 "Split the nodes over the MPI ranks of the run (needs ns-3 built with MPI)",
+                 distributed);
+    cmd.AddValue("nullmsg",
+                 "Synchronize the ranks with null messages instead of the default barriers",
+                 nullMessages);
+    cmd.Parse(argc, argv);
+
+    uint32_t systemId = 0;
+    uint32_t systemCount = 1;
+    if (distributed)
+    {
+#ifdef NS3_MPI
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(nullMessages ? "ns3::NullMessageSimulatorImpl"
+                                                   : "ns3::DistributedSimulatorImpl"));
+        MpiInterface::Enable(&argc, &argv);
+        systemId = MpiInterface::GetSystemId();
+        systemCount = MpiInterface::GetSize();
+#else
+        std::cerr << "--distributed needs ns-3 built with MPI (--enable-mpi)" << std::endl;
+        return 1;
+#endif
+    }
+    RankPlan plan(systemCount);
+    bool isRoot = (systemId == 0);
+
+    std::vector<uint32_t> strategies = ParseStrategies(strategyList);
+    if (numFlows == 0 || pathsPerFlow == 0 || numBottlenecks == 0 || strategies.empty())
+    {
+        std::cerr << "Need at least one flow, path, bottleneck and strategy" << std::endl;
+        return 1;
+    }
+    if (sharing != "disjoint" && sharing != "shared" && sharing != "random")
+    {
+        std::cerr << "Unknown sharing pattern " << sharing << std::endl;
+        return 1;
+    }
+    if (systemCount > 1 && accessDelayMs == 0)
+    {
+        // The access links join the ranks, and their delay is the lookahead
+        std::cerr << "A distributed run needs access links with a delay" << std::endl;
+        return 1;
+    }
+
+    NadaHeader::SetWireFormat(NadaHeader::COMPACT);
+    Time::SetResolution(Time::NS);
+    LogComponentEnable("ManyFlowsSimulation", LOG_LEVEL_INFO);
+
+    if (isRoot)
+    {
+        std::cout << "**MANY-FLOWS CONFIGURATION:**" << std::endl;
+        std::cout << "  Flows: " << numFlows << ", paths per flow: " << pathsPerFlow << std::endl;
+        std::cout << "  Bottlenecks: " << numBottlenecks << " x " << bottleneckRate
+                  << ", sharing: " << sharing << std::endl;
+        std::cout << "  Strategies: " << strategyList << std::endl;
+        std::cout << "  Ranks: " << systemCount << std::endl;
+    }
+
+    Config::SetDefault("ns3::PointToPointNetDevice::TxQueue",
+                       StringValue("ns3::DropTailQueue<Packet>"));
+    Config::SetDefault("ns3::DropTailQueue<Packet>::MaxSize",
+                       QueueSizeValue(QueueSize(std::to_string(queueSize) + "p")));
+    if (enableAQM)
+    {
+        Config::SetDefault("ns3::CoDelQueueDisc::Interval", TimeValue(Seconds(0.1)));
+        Config::SetDefault("ns3::CoDelQueueDisc::Target", TimeValue(MilliSeconds(5)));
+    }
+
+    // Every rank builds the whole topology, each node owned by one of them
+    NS_LOG_INFO("Creating nodes");
+    NodeContainer senders;
+    NodeContainer receivers;
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        senders.Create(1, plan.GetFlowRank(i));
+        receivers.Create(1, plan.GetFlowRank(i));
+    }
+    NodeContainer leftRouters;
+    NodeContainer rightRouters;
+    for (uint32_t b = 0; b < numBottlenecks; b++)
+    {
+        leftRouters.Create(1, plan.GetBottleneckRank(b));
+        rightRouters.Create(1, plan.GetBottleneckRank(b));
+    }
+
+    InternetStackHelper internet;
+    internet.InstallAll();
+
+    // Every link is a /30 of 10.0.0.0/8, enough for millions of links
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+
+    NS_LOG_INFO("Setting up " << numBottlenecks << " bottleneck links");
+    PointToPointHelper bottleneck;
+    bottleneck.SetDeviceAttribute("DataRate", StringValue(bottleneckRate));
+    std::vector<Time> bottleneckDelays;
+    for (uint32_t b = 0; b < numBottlenecks; b++)
+    {
+        Time delay = MilliSeconds(bottleneckDelayMs + b * delayStepMs);
+        bottleneck.SetChannelAttribute("Delay", TimeValue(delay));
+        NetDeviceContainer dev = bottleneck.Install(leftRouters.Get(b), rightRouters.Get(b));
+        if (enableAQM)
+        {
+            // Before the addresses, which would install the default queue disc
+            TrafficControlHelper tch;
+            tch.SetRootQueueDisc("ns3::CoDelQueueDisc");
+            tch.Install(dev.Get(0));
+        }
+        ipv4.Assign(dev);
+        ipv4.NewNetwork();
+        bottleneckDelays.push_back(delay);
+    }
+
+    // Bottleneck of every path of every flow
+    Ptr<UniformRandomVariable> sharingRng = CreateObject<UniformRandomVariable>();
+    sharingRng->SetStream(0);
+    std::vector<std::vector<uint32_t>> pathBottleneck(numFlows, std::vector<uint32_t>(pathsPerFlow));
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        for (uint32_t j = 0; j < pathsPerFlow; j++)
+        {
+            if (sharing == "disjoint")
+            {
+                pathBottleneck[i][j] = j % numBottlenecks;
+            }
+            else if (sharing == "shared")
+            {
+                pathBottleneck[i][j] = i % numBottlenecks;
+            }
+            else
+            {
+                pathBottleneck[i][j] = sharingRng->GetInteger(0, numBottlenecks - 1);
+            }
+        }
+    }
+
+    NS_LOG_INFO("Setting up " << numFlows * pathsPerFlow * 2 << " access links");
+    PointToPointHelper access;
+    access.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    access.SetChannelAttribute("Delay", TimeValue(MilliSeconds(accessDelayMs)));
+
+    // Sender address of each path, and the receiver address it sends to
+    std::vector<std::vector<Ipv4Address>> senderAddresses(numFlows);
+    std::vector<std::vector<Ipv4Address>> receiverAddresses(numFlows);
+    std::map<Ipv4Address, uint32_t> flowOfSender;
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        for (uint32_t j = 0; j < pathsPerFlow; j++)
+        {
+            uint32_t b = pathBottleneck[i][j];
+            Ipv4InterfaceContainer up = ipv4.Assign(access.Install(senders.Get(i), leftRouters.Get(b)));
+            ipv4.NewNetwork();
+            Ipv4InterfaceContainer down =
+                ipv4.Assign(access.Install(rightRouters.Get(b), receivers.Get(i)));
+            ipv4.NewNetwork();
+
+            senderAddresses[i].push_back(up.GetAddress(0));
+            receiverAddresses[i].push_back(down.GetAddress(1));
+            flowOfSender[up.GetAddress(0)] = i;
+        }
+    }
+
+    NS_LOG_INFO("Computing routes");
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    NS_LOG_INFO("Creating " << numFlows << " clients and receivers");
+    uint16_t videoPort = 9;
+    VideoReceiverHelper server(videoPort);
+    server.SetAttribute("FrameRate", UintegerValue(frameRate));
+    server.SetAttribute("AckEveryN", UintegerValue(ackEveryN));
+    server.SetAttribute("AckInterval", TimeValue(MilliSeconds(ackIntervalMs)));
+
+    // The ranks other than 0 only hold the metrics of their own clients
+    Ptr<NadaMetricsSink> metricsSink;
+    if (!metricsFile.empty())
+    {
+        metricsSink = CreateObject<NadaMetricsSink>();
+        metricsSink->SetAttribute(
+            "FileName",
+            StringValue(isRoot ? metricsFile : metricsFile + ".rank" + std::to_string(systemId)));
+    }
+
+    DataRate linkRate(bottleneckRate);
+    std::vector<Ptr<MultiPathNadaClientBase>> clients;
+    std::vector<Ptr<VideoReceiver>> videoReceivers;
+    std::vector<Time> flowStarts;
+    NodeContainer localHosts;
+    int64_t stream = 1;
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        // Flows of other ranks are still created, so the streams match a serial run
+        bool local = (plan.GetFlowRank(i) == systemId);
+        uint32_t strategy = strategies[i % strategies.size()];
+        Ptr<MultiPathNadaClientBase> client = MultiPathNadaClientFactory::Create(
+            static_cast<MultiPathNadaClientFactory::StrategyType>(strategy));
+        if (!client)
+        {
+            std::cerr << "Failed to create a client with strategy " << strategy << std::endl;
+            return 1;
+        }
+
+        client->SetAttribute("SendHistorySize", UintegerValue(sendHistorySize));
+        client->SetAttribute("CouplingMode", UintegerValue(couplingMode));
+        client->SetAttribute("Pacing", BooleanValue(true));
+        client->SetAttribute("Failover", BooleanValue(failover));
+        client->SetPacketSize(1200);
+        client->SetMaxPackets(std::numeric_limits<uint32_t>::max());
+
+        for (uint32_t j = 0; j < pathsPerFlow; j++)
+        {
+            uint32_t pathId = j + 1;
+            client->AddPath(senderAddresses[i][j],
+                            InetSocketAddress(receiverAddresses[i][j], videoPort),
+                            pathId,
+                            1.0 / pathsPerFlow,
+                            DataRate("500kbps"));
+            Time oneWay = bottleneckDelays[pathBottleneck[i][j]] + MilliSeconds(2 * accessDelayMs);
+            client->SetNadaAdaptability(pathId, DataRate("100kbps"), linkRate * 0.9, oneWay * 4);
+        }
+
+        Time start = Seconds(1.0 + startSpread * i / numFlows);
+        flowStarts.push_back(start);
+        Ptr<VideoReceiver> receiver;
+        if (local)
+        {
+            ApplicationContainer serverApp = server.Install(receivers.Get(i));
+            receiver = DynamicCast<VideoReceiver>(serverApp.Get(0));
+            serverApp.Start(Seconds(0.1));
+            senders.Get(i)->AddApplication(client);
+            localHosts.Add(senders.Get(i));
+            localHosts.Add(receivers.Get(i));
+        }
+        videoReceivers.push_back(receiver);
+
+        client->SetStartTime(start - Seconds(0.8));
+        client->SetStopTime(Seconds(simulationTime - 0.5));
+
+        Ptr<VideoSource> video = CreateObject<VideoSource>();
+        video->SetAttribute("FrameRate", UintegerValue(frameRate));
+        video->SetAttribute("KeyFrameInterval", UintegerValue(keyFrameInterval));
+        video->SetAttribute("TraceFile", StringValue(videoTrace));
+        video->SetAttribute("RateAdaptive", BooleanValue(rateAdaptive));
+        video->SetAttribute("TargetRate", DataRateValue(DataRate(videoRate)));
+        video->SetAttribute("MaxRate", DataRateValue(DataRate(videoRate)));
+        video->SetAttribute("Mtu", UintegerValue(1200));
+        video->SetClient(client);
+        video->SetStartTime(start);
+        video->SetStopTime(Seconds(simulationTime - 0.5));
+
+        stream += client->AssignStreams(stream);
+        stream += video->AssignStreams(stream);
+
+        if (!local)
+        {
+            continue;
+        }
+        senders.Get(i)->AddApplication(video);
+        if (metricsSink)
+        {
+            client->SetMetricsSink(metricsSink, "flow" + std::to_string(i));
+        }
+        clients.push_back(client);
+    }
+
+    // Only the end hosts: the routers would add per-hop records for every packet
+    FlowMonitorHelper flowHelper;
+    flowHelper.SetMonitorAttribute("DelayBinWidth", DoubleValue(0.001));
+    flowHelper.Install(localHosts);
+    Ptr<FlowMonitor> flowMonitor = flowHelper.GetMonitor();
+
+    NS_LOG_INFO("Running " << simulationTime << " s with " << numFlows << " flows");
+    auto wallStart = std::chrono::steady_clock::now();
+    Simulator::Stop(Seconds(simulationTime));
+    Simulator::Run();
+    double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // Data flows leave a sender address; the feedback flows are left out
+    flowMonitor->CheckForLostPackets();
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowHelper.GetClassifier());
+    std::map<FlowId, FlowMonitor::FlowStats> stats = flowMonitor->GetFlowStats();
+
+    // Every rank holds every group, so they are summed in the same order
+    FlowGroup allFlows;
+    std::map<uint32_t, FlowGroup> strategyGroups;
+    for (uint32_t strategy : strategies)
+    {
+        strategyGroups[strategy];
+    }
+    std::vector<uint64_t> flowRxBytes(numFlows, 0);
+    std::vector<uint64_t> flowUnderruns(numFlows, 0);
+    std::vector<uint64_t> bottleneckRxBytes(numBottlenecks, 0);
+    for (const auto& flow : stats)
+    {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
+        auto sender = flowOfSender.find(t.sourceAddress);
+        if (sender == flowOfSender.end())
+        {
+            continue;
+        }
+
+        uint32_t i = sender->second;
+        flowRxBytes[i] += flow.second.rxBytes;
+        allFlows.AddDelays(flow.second.delayHistogram);
+        strategyGroups[strategies[i % strategies.size()]].AddDelays(flow.second.delayHistogram);
+        for (uint32_t j = 0; j < pathsPerFlow; j++)
+        {
+            if (senderAddresses[i][j] == t.sourceAddress)
+            {
+                bottleneckRxBytes[pathBottleneck[i][j]] += flow.second.rxBytes;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        flowUnderruns[i] = videoReceivers[i] ? videoReceivers[i]->GetBufferUnderruns() : 0;
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double peakMb = usage.ru_maxrss / 1024.0; // ru_maxrss is in KB on Linux
+    std::vector<uint64_t> events(1, Simulator::GetEventCount());
+
+#ifdef NS3_MPI
+    if (systemCount > 1)
+    {
+        // Each flow was only seen by its own rank; rank 0 reports the sums
+        SumOverRanks(flowRxBytes);
+        SumOverRanks(flowUnderruns);
+        SumOverRanks(bottleneckRxBytes);
+        SumOverRanks(events);
+        SumOverRanks(allFlows);
+        for (auto& group : strategyGroups)
+        {
+            SumOverRanks(group.second);
+        }
+        wallSeconds = MaxOverRanks(wallSeconds);
+        peakMb = MaxOverRanks(peakMb);
+    }
+#endif
+
+    if (!isRoot)
+    {
+        if (metricsSink)
+        {
+            metricsSink->Write();
+        }
+        Simulator::Destroy();
+#ifdef NS3_MPI
+        MpiInterface::Disable();
+#endif
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < numFlows; i++)
+    {
+        double active = simulationTime - 0.5 - flowStarts[i].GetSeconds();
+        double goodput = active > 0 ? flowRxBytes[i] * 8.0 / active / 1000000 : 0.0;
+        uint32_t underruns = flowUnderruns[i];
+        FlowGroup& group = strategyGroups[strategies[i % strategies.size()]];
+        group.goodputs.push_back(goodput);
+        group.underruns += underruns;
+        allFlows.goodputs.push_back(goodput);
+        allFlows.underruns += underruns;
+        if (metricsSink)
+        {
+            metricsSink->RecordFinal("flow" + std::to_string(i), 0, "goodput_mbps", goodput);
+            metricsSink->RecordFinal("flow" + std::to_string(i), 0, "underruns", underruns);
+        }
+    }
+
+    std::cout << "\n=== MANY-FLOWS MULTIPATH NADA RESULTS ===\n";
+    std::cout << "Simulation time: " << simulationTime << " seconds\n\n";
+    PrintGroup("All flows", allFlows);
+    for (const auto& group : strategyGroups)
+    {
+        PrintGroup(MultiPathNadaClientFactory::GetStrategyName(
+                       static_cast<MultiPathNadaClientFactory::StrategyType>(group.first)),
+                   group.second);
+    }
+
+    std::cout << "Bottleneck utilization:\n";
+    for (uint32_t b = 0; b < numBottlenecks; b++)
+    {
+        std::cout << "  Bottleneck " << b << " (" << bottleneckDelays[b].GetMilliSeconds()
+                  << " ms): "
+                  << 100.0 * bottleneckRxBytes[b] * 8.0 / simulationTime / linkRate.GetBitRate()
+                  << "%\n";
+    }
+
+    std::cout << "\nRun cost:\n";
+    std::cout << "  Events executed: " << events[0] << " ("
+              << events[0] / static_cast<double>(numFlows) / simulationTime
+              << " per flow per simulated second)\n";
+    std::cout << "  Wall clock: " << wallSeconds << " s\n";
+    std::cout << "  Peak memory: " << peakMb << " MB (" << peakMb * 1024.0 / numFlows
+              << " KB per flow)\n";
+    if (systemCount > 1)
+    {
+        std::cout << "  Ranks: " << systemCount << " (wall clock and memory of the largest)\n";
+    }
+
+    if (metricsSink)
+    {
+        RecordGroup(metricsSink, "all_flows", allFlows);
+        for (const auto& group : strategyGroups)
+        {
+            RecordGroup(metricsSink,
+                        MultiPathNadaClientFactory::GetStrategyName(
+                            static_cast<MultiPathNadaClientFactory::StrategyType>(group.first)),
+                        group.second);
+        }
+        for (uint32_t b = 0; b < numBottlenecks; b++)
+        {
+            metricsSink->RecordFinal("bottleneck",
+                                     b,
+                                     "utilization",
+                                     bottleneckRxBytes[b] * 8.0 / simulationTime /
+                                         linkRate.GetBitRate());
+        }
+        metricsSink->RecordFinal("run", 0, "events", events[0]);
+        metricsSink->RecordFinal("run", 0, "ranks", systemCount);
+        metricsSink->RecordFinal("run", 0, "wall_clock_s", wallSeconds);
+        metricsSink->RecordFinal("run", 0, "peak_memory_mb", peakMb);
+        metricsSink->Write();
+    }
+
+    Simulator::Destroy();
+#ifdef NS3_MPI
+    if (distributed)
+    {
+        MpiInterface::Disable();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,451 @@
+/*
+ * Micro-benchmarks of the NADA per-packet paths
+ *
+ * Every benchmark runs one operation in a tight loop on synthetic input,
+ * without sockets or a running simulation, and reports the wall time and
+ * the heap allocations per operation:
+ *
+ *   header-serialize       NadaHeader::Serialize of a video data header
+ *   header-deserialize     NadaHeader::Deserialize of an aggregated feedback
+ *   nada-feedback          NadaCongestionControl::ProcessFeedback + UpdateRate
+ *   select-<strategy>      per-packet path selection of the WEIGHTED,
+ *                          BEST_PATH, ROUND_ROBIN, FRAME_AWARE and
+ *                          BUFFER_AWARE clients over four paths
+ *   frame-assembly         VideoFrameAssembler::AddPacket, the frame
+ *                          reassembly done for every packet the receiver gets
+ *   pacer-queue            NadaPacer::Enqueue + Dequeue of one packet
+ *   retransmit-record      NadaRetransmitBuffer::Record of every sent
+ *                          packet, frames expiring as new ones arrive
+ *
+ * Usage:
+ *   ./ns3 run "nada-bench --output=baseline.csv"
+ *   ./ns3 run "nada-bench --baseline=baseline.csv --threshold=0.2"
+ *
+ * With --baseline the run fails (exit status 1) when a benchmark is more
+ * than the threshold slower than its baseline, or allocates more per
+ * operation. Timings depend on the machine, so a baseline is only
+ * meaningful on the host that recorded it; the allocation counts are not.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mp-best.h"
+#include "ns3/mp-buffer.h"
+#include "ns3/mp-frame.h"
+#include "ns3/mp-rr.h"
+#include "ns3/mp-weighted.h"
+#include "ns3/nada-header.h"
+#include "ns3/nada-improved.h"
+#include "ns3/nada-pacer.h"
+#include "ns3/nada-retransmit-buffer.h"
+#include "ns3/network-module.h"
+#include "ns3/video-frame-assembler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("NadaBenchmark");
+
+// Every heap allocation of the process goes through the counter
+static uint64_t g_allocations = 0;
+
+void*
+operator new(std::size_t size)
+{
+    g_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+struct BenchResult
+{
+    std::string name;   // Benchmark name
+    double nsPerOp;     // Wall time per operation
+    double allocsPerOp; // Heap allocations per operation
+};
+
+/**
+ * \brief Time an operation over a number of iterations
+ * \param name Benchmark name
+ * \param iterations Operations to time, after a tenth as many for warm-up
+ * \param op Called with the iteration number
+ */
+template <class Op>
+BenchResult
+RunBenchmark(const std::string& name, uint32_t iterations, Op op)
+{
+    // Warm up caches and let lazily grown buffers reach their steady size
+    for (uint32_t i = 0; i < iterations / 10; i++)
+    {
+        op(i);
+    }
+
+    uint64_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        op(i);
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+    result.allocsPerOp = static_cast<double>(g_allocations - allocations) / iterations;
+    return result;
+}
+
+std::vector<uint32_t>
+AddBenchPaths(Ptr<MultiPathNadaClientBase> client, uint32_t paths)
+{
+    std::vector<uint32_t> readyPaths;
+    for (uint32_t i = 0; i < paths; i++)
+    {
+        std::ostringstream local;
+        std::ostringstream remote;
+        local << "10.1." << i + 1 << ".1";
+        remote << "10.1." << i + 1 << ".2";
+        client->AddPath(InetSocketAddress(Ipv4Address(local.str().c_str()), 9),
+                        InetSocketAddress(Ipv4Address(remote.str().c_str()), 9),
+                        i,
+                        1.0 + i,
+                        DataRate((i + 1) * 1000000));
+        readyPaths.push_back(i);
+    }
+    client->UpdateWeights();
+    return readyPaths;
+}
+
+template <class Client>
+BenchResult
+BenchSelectPath(const std::string& name, uint32_t iterations)
+{
+    Ptr<Client> client = CreateObject<Client>();
+    std::vector<uint32_t> readyPaths = AddBenchPaths(client, 4);
+
+    BenchResult result = RunBenchmark(name, iterations, [&](uint32_t i) {
+        // A key frame every 30 packets, for the frame-aware client
+        client->SetKeyFrameStatus(i % 30 == 0);
+        volatile uint32_t pathId = client->SelectPath(readyPaths, 1000);
+        (void)pathId;
+    });
+    client->Dispose();
+    return result;
+}
+
+std::vector<BenchResult>
+RunAll(uint32_t iterations, const std::string& filter)
+{
+    std::vector<BenchResult> results;
+    auto wanted = [&filter](const std::string& name) {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    };
+
+    if (wanted("header-serialize"))
+    {
+        NadaHeader header;
+        header.SetPacketType(NadaHeader::DATA);
+        header.SetSequenceNumber(1);
+        header.SetTimestamp(MilliSeconds(100));
+        header.SetPacketSize(1000);
+        header.SetVideoFrameSize(15000);
+        header.SetVideoFrameType(1);
+        header.SetVideoFrameInfo(7, 3, 15);
+
+        Buffer buffer;
+        buffer.AddAtStart(header.GetSerializedSize());
+        results.push_back(RunBenchmark("header-serialize", iterations, [&](uint32_t i) {
+            header.SetSequenceNumber(i);
+            header.Serialize(buffer.Begin());
+        }));
+    }
+
+    if (wanted("header-deserialize"))
+    {
+        NadaAckVector ackVector;
+        for (uint32_t seq = 0; seq < 16; seq++)
+        {
+            // Every eighth packet lost
+            if (seq % 8 != 7)
+            {
+                ackVector.Record(seq, MilliSeconds(100 + seq));
+            }
+        }
+
+        NadaHeader feedback;
+        feedback.SetPacketType(NadaHeader::FEEDBACK);
+        feedback.SetSequenceNumber(15);
+        feedback.SetTimestamp(MilliSeconds(120));
+        feedback.SetReceiveTimestamp(MilliSeconds(115));
+        feedback.SetArrivalTimeOffset(MilliSeconds(20).GetNanoSeconds());
+        feedback.SetAckVector(ackVector);
+        feedback.SetBufferState(MilliSeconds(300), MilliSeconds(250), 0);
+
+        Buffer buffer;
+        buffer.AddAtStart(feedback.GetSerializedSize());
+        feedback.Serialize(buffer.Begin());
+
+        NadaHeader header;
+        results.push_back(RunBenchmark("header-deserialize", iterations, [&](uint32_t) {
+            header.Deserialize(buffer.Begin());
+        }));
+    }
+
+    if (wanted("nada-feedback"))
+    {
+        Ptr<NadaCongestionControl> nada = CreateObject<NadaCongestionControl>();
+        NadaFeedback feedback;
+        feedback.receiveRate = 1e6;
+        feedback.acked = 1;
+        results.push_back(RunBenchmark("nada-feedback", iterations, [&](uint32_t i) {
+            // A queue building up and draining again over 64 reports
+            feedback.delay = MilliSeconds(20 + (i % 64 < 32 ? i % 32 : 32 - i % 32));
+            feedback.rtt = feedback.delay * 2;
+            feedback.lossRate = (i % 100 == 0) ? 0.01 : 0.0;
+            nada->ProcessFeedback(feedback);
+            nada->UpdateRate();
+        }));
+        nada->Dispose();
+    }
+
+    if (wanted("select-weighted"))
+    {
+        results.push_back(BenchSelectPath<MultiPathNadaWeightedClient>("select-weighted", iterations));
+    }
+    if (wanted("select-best"))
+    {
+        results.push_back(BenchSelectPath<MultiPathNadaBestPathClient>("select-best", iterations));
+    }
+    if (wanted("select-rr"))
+    {
+        results.push_back(BenchSelectPath<MultiPathNadaRoundRobinClient>("select-rr", iterations));
+    }
+    if (wanted("select-frame"))
+    {
+        results.push_back(BenchSelectPath<MultiPathNadaFrameAwareClient>("select-frame", iterations));
+    }
+    if (wanted("select-buffer"))
+    {
+        results.push_back(BenchSelectPath<MultiPathNadaBufferAwareClient>("select-buffer", iterations));
+    }
+
+    if (wanted("frame-assembly"))
+    {
+        const uint16_t packetsPerFrame = 15;
+        VideoFrameAssembler assembler;
+        VideoFrameAssembler::Frame completed;
+        results.push_back(RunBenchmark("frame-assembly", iterations, [&](uint32_t i) {
+            uint32_t frameId = i / packetsPerFrame;
+            uint16_t packetIndex = i % packetsPerFrame;
+            assembler.AddPacket(frameId,
+                                packetIndex,
+                                packetsPerFrame,
+                                packetsPerFrame,
+                                frameId % 30 == 0,
+                                1000,
+                                MicroSeconds(i * 100),
+                                MicroSeconds(i * 100),
+                                completed);
+        }));
+    }
+
+    if (wanted("pacer-queue"))
+    {
+        NadaPacer pacer;
+        pacer.SetRate(1e12);
+        pacer.SetBurst(1 << 30);
+        NadaPacer::Item item;
+        item.packet = Create<Packet>(1000);
+        NadaPacer::Item released;
+        results.push_back(RunBenchmark("pacer-queue", iterations, [&](uint32_t i) {
+            // The queue swings between 0 and 64 packets deep
+            item.packetIndex = i % 15;
+            pacer.Enqueue(item, i % 30 == 0);
+            if (i % 128 >= 64)
+            {
+                pacer.Dequeue(MicroSeconds(i), released);
+                pacer.Dequeue(MicroSeconds(i), released);
+            }
+        }));
+    }
+
+    if (wanted("retransmit-record"))
+    {
+        const uint16_t packetsPerFrame = 15;
+        NadaRetransmitBuffer buffer(32);
+        NadaRetransmitBuffer::Entry entry;
+        entry.packetsInFrame = packetsPerFrame;
+        entry.size = 1000;
+        results.push_back(RunBenchmark("retransmit-record", iterations, [&](uint32_t i) {
+            entry.frameId = i / packetsPerFrame;
+            entry.packetIndex = i % packetsPerFrame;
+            entry.isKeyFrame = entry.frameId % 30 == 0;
+            entry.deadline = MilliSeconds(entry.frameId * 33 + 150);
+            buffer.Record(entry);
+            buffer.ExpireBefore(MilliSeconds(entry.frameId * 33));
+        }));
+    }
+
+    return results;
+}
+
+bool
+ReadBaseline(const std::string& fileName, std::map<std::string, BenchResult>& baseline)
+{
+    std::ifstream in(fileName);
+    if (!in)
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        BenchResult result;
+        std::string nsPerOp;
+        std::string allocsPerOp;
+        if (!std::getline(fields, result.name, ',') || !std::getline(fields, nsPerOp, ',') ||
+            !std::getline(fields, allocsPerOp, ','))
+        {
+            continue;
+        }
+        // Skips the header line
+        char* end = nullptr;
+        result.nsPerOp = std::strtod(nsPerOp.c_str(), &end);
+        if (end == nsPerOp.c_str())
+        {
+            continue;
+        }
+        result.allocsPerOp = std::strtod(allocsPerOp.c_str(), nullptr);
+        baseline[result.name] = result;
+    }
+    return true;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t iterations = 200000;
+    std::string filter;
+    std::string output;
+    std::string baselineFile;
+    double threshold = 0.2;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("iterations", "Operations timed per benchmark", iterations);
+    cmd.AddValue("filter", "Only run benchmarks whose name contains this", filter);
+    cmd.AddValue("output", "Write the results to this CSV file", output);
+    cmd.AddValue("baseline", "Compare against the results in this CSV file", baselineFile);
+    cmd.AddValue("threshold", "Slowdown over the baseline counted as a regression", threshold);
+    cmd.Parse(argc, argv);
+
+    iterations = std::max<uint32_t>(iterations, 1);
+    std::vector<BenchResult> results = RunAll(iterations, filter);
+
+    std::map<std::string, BenchResult> baseline;
+    if (!baselineFile.empty() && !ReadBaseline(baselineFile, baseline))
+    {
+        std::cerr << "Cannot read baseline " << baselineFile << std::endl;
+        return 1;
+    }
+
+    uint32_t regressions = 0;
+    std::cout << std::left << std::setw(22) << "benchmark" << std::right << std::setw(12)
+              << "ns/op" << std::setw(14) << "allocs/op";
+    if (!baseline.empty())
+    {
+        std::cout << std::setw(12) << "vs base";
+    }
+    std::cout << std::endl;
+
+    for (const BenchResult& result : results)
+    {
+        std::cout << std::left << std::setw(22) << result.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << result.nsPerOp
+                  << std::setprecision(3) << std::setw(14) << result.allocsPerOp;
+
+        auto it = baseline.find(result.name);
+        if (it != baseline.end())
+        {
+            double ratio = it->second.nsPerOp > 0.0 ? result.nsPerOp / it->second.nsPerOp : 1.0;
+            // Allocation counts are exact, a small slack absorbs the warm-up tail
+            bool slower = ratio > 1.0 + threshold;
+            bool allocates = result.allocsPerOp > it->second.allocsPerOp + 0.01;
+            std::cout << std::setprecision(2) << std::setw(11) << ratio << "x";
+            if (slower || allocates)
+            {
+                std::cout << "  REGRESSION" << (slower ? " (time)" : "")
+                          << (allocates ? " (allocations)" : "");
+                regressions++;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!output.empty())
+    {
+        std::ofstream out(output);
+        out << "benchmark,ns_per_op,allocs_per_op" << std::endl;
+        for (const BenchResult& result : results)
+        {
+            out << result.name << "," << result.nsPerOp << "," << result.allocsPerOp
+                << std::endl;
+        }
+    }
+
+    Simulator::Destroy();
+
+    if (regressions > 0)
+    {
+        std::cerr << regressions << " benchmark(s) regressed against " << baselineFile
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -23,6 +23,7 @@
 #include "ns3/core-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/internet-module.h"
+#include "ns3/nada-metrics-sink.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
@@ -225,9 +226,11 @@ SendAggregateVideoFrame(Ptr<AggregatePathNadaClient> client,
         {
             Time packetDelay = MilliSeconds(i * packetIntervalMs);
 
-            Simulator::Schedule(packetDelay, [client, mtu, packetsSentCounter, isKeyFrame]() {
+            uint32_t frameId = frameCount;
+            Simulator::Schedule(packetDelay, [client, mtu, packetsSentCounter, isKeyFrame, frameId, i, numPacketsNeeded]() {
                 Ptr<Packet> packet = Create<Packet>(mtu);
                 client->SetKeyFrameStatus(isKeyFrame);
+                client->SetVideoFrameContext(frameId, i, numPacketsNeeded);
                 bool sent = client->Send(packet);
                 if (sent && packetsSentCounter)
                 {
@@ -318,6 +321,7 @@ main(int argc, char* argv[])
     uint32_t pathSelectionStrategy = 0;
     double targetBufferLength = 3.0;
     double bufferWeightFactor = 0.3;
+    NadaMetricsSinkHelper metricsHelper;
     bool enableLogging = false;
 
     CommandLine cmd;
@@ -370,6 +374,7 @@ main(int argc, char* argv[])
                  "Buffer influence factor (0-1) for buffer-aware strategy",
                  bufferWeightFactor);
 
+    metricsHelper.AddCommandLineValues(cmd);
     cmd.Parse(argc, argv);
 
     enableLogging = enableLogging || logDetails || logNada;
@@ -563,11 +568,11 @@ main(int argc, char* argv[])
 
     uint16_t port = 9;
 
-    InetSocketAddress localAddr1(ifcSourceRouter1.GetAddress(0), 0);  Any port
+    InetSocketAddress localAddr1(ifcSourceRouter1.GetAddress(0), 0); // Any port
     InetSocketAddress remoteAddr1(ifcRouter1Dest.GetAddress(1), port);
     bool path1Added = aggClient->AddPath(1, localAddr1, remoteAddr1);
 
-    InetSocketAddress localAddr2(ifcSourceRouter2.GetAddress(0), 0);  Any port
+    InetSocketAddress localAddr2(ifcSourceRouter2.GetAddress(0), 0); // Any port
     InetSocketAddress remoteAddr2(ifcRouter2Dest.GetAddress(1), port);
     bool path2Added = aggClient->AddPath(2, localAddr2, remoteAddr2);
 
@@ -706,6 +711,8 @@ main(int argc, char* argv[])
     FlowMonitorHelper flowHelper;
     Ptr<FlowMonitor> flowMonitor = flowHelper.InstallAll();
 
+    Ptr<NadaMetricsSink> metricsSink = metricsHelper.Install(aggClient, serverApp.Get(0));
+
     Simulator::Stop(Seconds(simulationTime));
 
     NS_LOG_INFO("Running simulation for " << simulationTime << " seconds...");
@@ -760,6 +767,14 @@ main(int argc, char* argv[])
             continue;
         }
 
+        if (metricsSink)
+        {
+            metricsSink->RecordFlowStats(isNadaFlow ? "webrtc_flow" : "competing_flow",
+                                         i->first,
+                                         i->second,
+                                         Seconds(simulationTime));
+        }
+
         std::cout << "Flow " << i->first << " (" << t.sourceAddress << " -> "
                   << t.destinationAddress << ")";
         if (isNadaFlow && enableWebRTC)
@@ -885,6 +900,11 @@ main(int argc, char* argv[])
     }
     std::cout << "\n";
 
+    if (metricsSink)
+    {
+        metricsSink->Write();
+    }
+
     Simulator::Destroy();
     return 0;
 }
@@ -31,14 +31,15 @@
 #include "ns3/internet-module.h"
 #include "ns3/mp-factory.h"
 #include "ns3/mp-nada-base.h"
-#include "ns3/mp-nada-client.h"
 #include "ns3/nada-header.h"
 #include "ns3/nada-improved.h"
+#include "ns3/nada-metrics-sink.h"
 #include "ns3/nada-udp-client.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/traffic-control-module.h"
 #include "ns3/video-receiver.h"
+#include "ns3/video-source.h"
 
 using namespace ns3;
 
@@ -194,7 +195,7 @@ ProcessFrameAcknowledgment(WebRtcFrameStats* stats,
 }
 
 bool
-ValidateClientSockets(Ptr<MultiPathNadaClient> client)
+ValidateClientSockets(Ptr<MultiPathNadaClientBase> client)
 {
     if (!client)
     {
@@ -279,20 +280,36 @@ SendMultipathVideoFrame(Ptr<MultiPathNadaClientBase> client,
     {
         double packetIntervalMs = rateMbps > 1000.0 ? 0.1 : 1.0;
 
-        for (uint32_t i = 0; i < packetsToSend; ++i)
+        BooleanValue pacing;
+        client->GetAttribute("Pacing", pacing);
+        if (pacing.Get())
         {
-            Time packetDelay = MilliSeconds(i * packetIntervalMs);
-
-            Simulator::Schedule(packetDelay, [client, mtu, packetsSentCounter, isKeyFrame]() {
-                Ptr<Packet> packet = Create<Packet>(mtu);
-                client->SetKeyFrameStatus(isKeyFrame);
-                bool sent = client->Send(packet);
-                if (sent && packetsSentCounter)
-                {
-                    packetsSentCounter->count++;
-                }
-                NS_LOG_DEBUG("MP: Scheduled packet sent: " << sent);
-            });
+            // The client paces the frame out itself, no per-packet events
+            // needed; FEC repair packets are counted along with the frame
+            uint32_t sentBefore = client->GetTotalPacketsSent();
+            client->SendVideoFrame(frameCount, isKeyFrame, currentFrameSize, mtu);
+            packetsSentCounter->count = client->GetTotalPacketsSent() - sentBefore;
+            packetsToSend = packetsSentCounter->count;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < packetsToSend; ++i)
+            {
+                Time packetDelay = MilliSeconds(i * packetIntervalMs);
+
+                uint32_t frameId = frameCount;
+                Simulator::Schedule(packetDelay, [client, mtu, packetsSentCounter, isKeyFrame, frameId, i, numPacketsNeeded]() {
+                    Ptr<Packet> packet = Create<Packet>(mtu);
+                    client->SetKeyFrameStatus(isKeyFrame);
+                    client->SetVideoFrameContext(frameId, i, numPacketsNeeded);
+                    bool sent = client->Send(packet);
+                    if (sent && packetsSentCounter)
+                    {
+                        packetsSentCounter->count++;
+                    }
+                    NS_LOG_DEBUG("MP: Scheduled packet sent: " << sent);
+                });
+            }
         }
 
         totalPacketsSent += packetsToSend;
@@ -346,6 +363,62 @@ SendMultipathVideoFrame(Ptr<MultiPathNadaClientBase> client,
     }
 }
 
+/**
+ * Trace sinks writing time series as CSV rows: time,source,path,trace,value
+ */
+void
+WriteTraceRow(Ptr<OutputStreamWrapper> stream,
+              const char* source,
+              uint32_t path,
+              const char* trace,
+              double value)
+{
+    *stream->GetStream() << Simulator::Now().GetSeconds() << ',' << source << ',' << path << ','
+                         << trace << ',' << value << '\n';
+}
+
+void
+TraceRate(Ptr<OutputStreamWrapper> stream, uint32_t path, DataRate oldRate, DataRate newRate)
+{
+    WriteTraceRow(stream, "client", path, "rate_bps", newRate.GetBitRate());
+}
+
+void
+TraceQueueingDelay(Ptr<OutputStreamWrapper> stream, uint32_t path, Time delay)
+{
+    WriteTraceRow(stream, "client", path, "queueing_delay_ms", delay.GetSeconds() * 1000.0);
+}
+
+void
+TraceScore(Ptr<OutputStreamWrapper> stream, uint32_t path, double score, double appliedScore)
+{
+    WriteTraceRow(stream, "client", path, "score", appliedScore);
+}
+
+void
+TraceWeight(Ptr<OutputStreamWrapper> stream, uint32_t path, double oldWeight, double newWeight)
+{
+    WriteTraceRow(stream, "client", path, "weight", newWeight);
+}
+
+void
+TraceFailover(Ptr<OutputStreamWrapper> stream, uint32_t path, bool failed, uint32_t packetsMoved)
+{
+    WriteTraceRow(stream, "client", path, failed ? "failover" : "recovered", packetsMoved);
+}
+
+void
+TraceBufferDepth(Ptr<OutputStreamWrapper> stream, uint32_t frames, Time depth)
+{
+    WriteTraceRow(stream, "receiver", 0, "buffer_ms", depth.GetSeconds() * 1000.0);
+}
+
+void
+TraceUnderrun(Ptr<OutputStreamWrapper> stream, uint32_t underruns)
+{
+    WriteTraceRow(stream, "receiver", 0, "underruns", underruns);
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -373,6 +446,19 @@ main(int argc, char* argv[])
     double competingIntensityA = 0.5;
     double competingIntensityB = 0.5;
     bool enableAQM = false;
+    bool legacyHeader = false;
+    NadaMetricsSinkHelper metricsHelper;
+    std::string traceFile = "";
+    bool videoSource = false;
+    std::string videoTrace = "";
+    bool rateAdaptive = false;
+    uint32_t ackEveryN = 1;
+    uint32_t ackIntervalMs = 0;
+    uint32_t couplingMode = 0;
+    bool pacing = true;
+    bool fec = false;
+    bool nack = false;
+    bool failover = false;
 
     double targetBufferLength = 3.0;
     double bufferWeightFactor = 0.3;
@@ -397,7 +483,9 @@ main(int argc, char* argv[])
                  "  2=EQUAL (round-robin distribution)\n"
                  "  3=REDUNDANT (send on all paths simultaneously)\n"
                  "  4=FRAME_AWARE (key frames on reliable paths, delta frames distributed)\n"
-                 "  5=BUFFER_AWARE (adjust based on video buffer status)",
+                 "  5=BUFFER_AWARE (adjust based on video buffer status)\n"
+                 "  6=DEFICIT (byte credit per path, paced at each path's NADA rate)\n"
+                 "  7=EARLIEST_ARRIVAL (each packet on the path where it arrives first)",
                  pathSelectionStrategy);
     cmd.AddValue("competingSourcesA",
                  "Number of competing sources on path A",
@@ -418,8 +506,54 @@ main(int argc, char* argv[])
     cmd.AddValue("bufferWeightFactor",
                  "Buffer influence factor (0-1) for buffer-aware strategy",
                  bufferWeightFactor);
+    cmd.AddValue("legacyHeader",
+                 "Use the original fixed 78-byte NADA header instead of the compact format",
+                 legacyHeader);
+    cmd.AddValue("ackEveryN",
+                 "Receiver sends one aggregated ACK per N packets (1 = per-packet ACKs)",
+                 ackEveryN);
+    cmd.AddValue("ackIntervalMs",
+                 "Maximum time the receiver holds an aggregated ACK (0 = no timer)",
+                 ackIntervalMs);
+    cmd.AddValue("couplingMode",
+                 "Per-path NADA coupling: 0=independent, 1=coupled, "
+                 "2=coupled on detected shared bottleneck",
+                 couplingMode);
+    cmd.AddValue("pacing",
+                 "Pace packets out of the client at each path's NADA rate "
+                 "instead of scheduling every packet",
+                 pacing);
+    cmd.AddValue("fec",
+                 "Protect every frame with forward error correction packets "
+                 "spread across the paths (needs pacing)",
+                 fec);
+    cmd.AddValue("nack",
+                 "Let the receiver NACK missing packets and the sender repair them "
+                 "before their playout deadline",
+                 nack);
+    cmd.AddValue("failover",
+                 "Move traffic off a path within a few RTTs of its feedback stopping, "
+                 "and probe it until it recovers",
+                 failover);
+    metricsHelper.AddCommandLineValues(cmd);
+    cmd.AddValue("traceFile",
+                 "Write per-path rate, queueing delay, score and weight and the receiver "
+                 "buffer depth as CSV time series to this file",
+                 traceFile);
+    cmd.AddValue("videoSource",
+                 "Produce frames with a VideoSource application instead of the fixed-size "
+                 "frame loop",
+                 videoSource);
+    cmd.AddValue("videoTrace",
+                 "Frame size trace replayed by the VideoSource (implies --videoSource)",
+                 videoTrace);
+    cmd.AddValue("rateAdaptive",
+                 "Have the VideoSource encode at the client's total NADA rate",
+                 rateAdaptive);
     cmd.Parse(argc, argv);
 
+    NadaHeader::SetWireFormat(legacyHeader ? NadaHeader::LEGACY : NadaHeader::COMPACT);
+
     // Configure logging
     Time::SetResolution(Time::NS);
     LogComponentEnable("MultipathCompetingWebRtcSimulation", LOG_LEVEL_INFO);
@@ -646,26 +780,27 @@ main(int argc, char* argv[])
 
     mpClient->SetPacketSize(packetSize);
     mpClient->SetMaxPackets(maxPackets);
+    mpClient->SetAttribute("CouplingMode", UintegerValue(couplingMode));
+    mpClient->SetAttribute("Pacing", BooleanValue(pacing));
+    mpClient->SetAttribute("FecEnabled", BooleanValue(fec));
+    mpClient->SetAttribute("Retransmission", BooleanValue(nack));
+    mpClient->SetAttribute("Failover", BooleanValue(failover));
 
     NS_LOG_INFO("Creating server application at destination");
     uint16_t videoPort = 9;
     VideoReceiverHelper server(videoPort);
     server.SetAttribute("FrameRate", UintegerValue(frameRate));
-    ApplicationContainer serverApp = server.Install(destination.Get(0));
-
-    if (pathSelectionStrategy == 5) // BUFFER_AWARE
+    server.SetAttribute("AckEveryN", UintegerValue(ackEveryN));
+    server.SetAttribute("AckInterval", TimeValue(MilliSeconds(ackIntervalMs)));
+    if (nack)
     {
-        Ptr<VideoReceiver> videoReceiver = DynamicCast<VideoReceiver>(serverApp.Get(0));
-        if (videoReceiver)
-        {
-            mpClient->SetVideoReceiver(videoReceiver);
-            NS_LOG_INFO("Linked video receiver to buffer-aware client");
-        }
-        else
-        {
-            NS_LOG_WARN("Failed to link video receiver to buffer-aware client");
-        }
+        // Incomplete frames have to wait for their repairs
+        TimeValue playoutDeadline;
+        mpClient->GetAttribute("PlayoutDeadline", playoutDeadline);
+        server.SetAttribute("Nack", BooleanValue(true));
+        server.SetAttribute("FrameTimeout", playoutDeadline);
     }
+    ApplicationContainer serverApp = server.Install(destination.Get(0));
 
     DataRate rate1(dataRate1);
     DataRate rate2(dataRate2);
@@ -864,18 +999,37 @@ main(int argc, char* argv[])
     NS_LOG_INFO("Scheduling first video frame with delay for initialization: "
                 << socketInitDelay.GetSeconds() << "s");
 
-    // Start sending WebRTC frames with even longer delay
-    Simulator::Schedule(socketInitDelay,
-                        &SendMultipathVideoFrame,
-                        mpClient,
-                        std::ref(frameCount),
-                        keyFrameInterval,
-                        packetSize,
-                        std::ref(frameEvent),
-                        frameInterval,
-                        std::ref(frameStats),
-                        std::ref(totalPacketsSent),
-                        maxPackets);
+    Ptr<VideoSource> videoApp;
+    if (videoSource || !videoTrace.empty())
+    {
+        // Frames sized by the encoder model, sent through the client's own pacing
+        videoApp = CreateObject<VideoSource>();
+        videoApp->SetAttribute("FrameRate", UintegerValue(frameRate));
+        videoApp->SetAttribute("KeyFrameInterval", UintegerValue(keyFrameInterval));
+        videoApp->SetAttribute("TraceFile", StringValue(videoTrace));
+        videoApp->SetAttribute("RateAdaptive", BooleanValue(rateAdaptive));
+        videoApp->SetAttribute("TargetRate", DataRateValue(DataRate(packetSize * 8 * frameRate)));
+        videoApp->SetAttribute("Mtu", UintegerValue(1500));
+        videoApp->SetClient(mpClient);
+        sourceNode->AddApplication(videoApp);
+        videoApp->SetStartTime(socketInitDelay);
+        videoApp->SetStopTime(Seconds(simulationTime - 0.5));
+    }
+    else
+    {
+        // Start sending WebRTC frames with even longer delay
+        Simulator::Schedule(socketInitDelay,
+                            &SendMultipathVideoFrame,
+                            mpClient,
+                            std::ref(frameCount),
+                            keyFrameInterval,
+                            packetSize,
+                            std::ref(frameEvent),
+                            frameInterval,
+                            std::ref(frameStats),
+                            std::ref(totalPacketsSent),
+                            maxPackets);
+    }
 
     NS_LOG_INFO("Setting up flow monitor");
     // Set up flow monitor
@@ -888,6 +1042,42 @@ main(int argc, char* argv[])
 
     flowMonitor = flowHelper.InstallAll();
 
+    Ptr<NadaMetricsSink> metricsSink = metricsHelper.Install(mpClient, serverApp.Get(0));
+
+    if (!traceFile.empty())
+    {
+        AsciiTraceHelper asciiHelper;
+        Ptr<OutputStreamWrapper> traceStream = asciiHelper.CreateFileStream(traceFile);
+        *traceStream->GetStream() << "time,source,path,trace,value\n";
+        for (uint32_t pathId : {1u, 2u})
+        {
+            Ptr<NadaCongestionControl> nada = mpClient->GetPathController(pathId);
+            if (!nada)
+            {
+                continue;
+            }
+            nada->TraceConnectWithoutContext("Rate", MakeBoundCallback(&TraceRate, traceStream, pathId));
+            nada->TraceConnectWithoutContext(
+                "QueueingDelay",
+                MakeBoundCallback(&TraceQueueingDelay, traceStream, pathId));
+            nada->TraceConnectWithoutContext("Score",
+                                             MakeBoundCallback(&TraceScore, traceStream, pathId));
+        }
+        mpClient->TraceConnectWithoutContext("WeightChanged",
+                                             MakeBoundCallback(&TraceWeight, traceStream));
+        mpClient->TraceConnectWithoutContext("PathFailover",
+                                             MakeBoundCallback(&TraceFailover, traceStream));
+        Ptr<VideoReceiver> traceReceiver = DynamicCast<VideoReceiver>(serverApp.Get(0));
+        if (traceReceiver)
+        {
+            traceReceiver->TraceConnectWithoutContext(
+                "BufferDepth",
+                MakeBoundCallback(&TraceBufferDepth, traceStream));
+            traceReceiver->TraceConnectWithoutContext("Underrun",
+                                                      MakeBoundCallback(&TraceUnderrun, traceStream));
+        }
+    }
+
     NS_LOG_INFO("Starting simulation for " << simulationTime << " seconds");
     // Run simulation
     Simulator::Stop(Seconds(simulationTime));
@@ -1048,7 +1238,6 @@ main(int argc, char* argv[])
 
     if (pathSelectionStrategy == 5) // BUFFER_AWARE
     {
-        mpClient->SetVideoReceiver(videoReceiverInstance);
         NS_LOG_INFO("Configured buffer-aware strategy with target buffer: "
                     << targetBufferLength << "s, weight factor: " << bufferWeightFactor);
 
@@ -1064,7 +1253,19 @@ main(int argc, char* argv[])
     printAggStats("Path A Competing Sources", pathACompetingFlows, simulationTime);
     printAggStats("Path B Competing Sources", pathBCompetingFlows, simulationTime);
 
-    frameStats.PrintStats();
+    if (videoApp)
+    {
+        std::cout << "Video Source:\n";
+        std::cout << "  Frames sent: " << videoApp->GetFramesSent() << " ("
+                  << videoApp->GetKeyFramesSent() << " key frames)\n";
+        std::cout << "  Bytes encoded: " << videoApp->GetBytesSent() << "\n";
+        std::cout << "  Final target rate: " << videoApp->GetTargetRate().GetBitRate() / 1e6
+                  << " Mbps\n";
+    }
+    else
+    {
+        frameStats.PrintStats();
+    }
 
     NS_LOG_INFO("Collecting path statistics");
     std::cout << "\nPath Statistics (Strategy: " << mpClient->GetStrategyName() << "):\n";
@@ -1083,6 +1284,32 @@ main(int argc, char* argv[])
         }
     }
 
+    if (metricsSink)
+    {
+        for (const auto& flow : mainSourceFlows)
+        {
+            metricsSink->RecordFlowStats("webrtc_flow",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        for (const auto& flow : pathACompetingFlows)
+        {
+            metricsSink->RecordFlowStats("competing_a",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        for (const auto& flow : pathBCompetingFlows)
+        {
+            metricsSink->RecordFlowStats("competing_b",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        metricsSink->Write();
+    }
+
     NS_LOG_INFO("Cleaning up simulation");
     Simulator::Destroy();
     NS_LOG_INFO("Simulation finished successfully");
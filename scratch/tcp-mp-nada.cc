@@ -29,9 +29,12 @@
 #include "ns3/core-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/internet-module.h"
-#include "ns3/mp-nada-client.h"
+#include "ns3/mp-buffer.h"
+#include "ns3/mp-factory.h"
+#include "ns3/mp-nada-base.h"
 #include "ns3/nada-header.h"
 #include "ns3/nada-improved.h"
+#include "ns3/nada-metrics-sink.h"
 #include "ns3/nada-udp-client.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
@@ -173,7 +176,7 @@ ProcessFrameAcknowledgment(WebRtcFrameStats* stats,
 }
 
 bool
-ValidateClientSockets(Ptr<MultiPathNadaClient> client)
+ValidateClientSockets(Ptr<MultiPathNadaClientBase> client)
 {
     NS_LOG_FUNCTION(client);
 
@@ -200,7 +203,7 @@ ValidateClientSockets(Ptr<MultiPathNadaClient> client)
 }
 
 void
-SendMultipathVideoFrame(Ptr<MultiPathNadaClient> client,
+SendMultipathVideoFrame(Ptr<MultiPathNadaClientBase> client,
                         uint32_t& frameCount,
                         uint32_t keyFrameInterval,
                         uint32_t frameSize,
@@ -287,12 +290,14 @@ SendMultipathVideoFrame(Ptr<MultiPathNadaClient> client,
     for (uint32_t i = 0; i < packetsToSend; i++) {
         Time packetDelay = MilliSeconds(i * packetIntervalMs);
 
-        Simulator::Schedule(packetDelay, [client, packetsSentCounter, mtu, i, packetsToSend]() {
+        uint32_t frameId = frameCount;
+        Simulator::Schedule(packetDelay, [client, packetsSentCounter, mtu, i, packetsToSend, frameId, numPacketsNeeded]() {
             if (!client) return;
 
             try {
                 Ptr<Packet> packet = Create<Packet>(mtu);
                 if (!packet) return;
+                client->SetVideoFrameContext(frameId, i, numPacketsNeeded);
 
                 bool sent = client->Send(packet);
                 if (sent && packetsSentCounter) {
@@ -364,6 +369,8 @@ main(int argc, char* argv[])
     double competingIntensityA = 0.5; // Relative intensity of competing traffic on path A (0-1)
     double competingIntensityB = 0.5; // Relative intensity of competing traffic on path B (0-1)
     bool enableAQM = false;           // Enable Active Queue Management
+    bool legacyHeader = false;
+    NadaMetricsSinkHelper metricsHelper;
 
     double targetBufferLength = 3.0;
     double bufferWeightFactor = 0.3;
@@ -385,7 +392,8 @@ main(int argc, char* argv[])
     cmd.AddValue("maxPackets", "Maximum packets to send", maxPackets);
     cmd.AddValue(
         "pathSelectionStrategy",
-        "Path selection strategy (0=weighted, 1=best, 2=equal, 3=redundant, 4=frame-aware)",
+        "Path selection strategy (0=weighted, 1=best, 2=equal, 3=redundant, 4=frame-aware, "
+        "5=buffer-aware, 6=deficit, 7=earliest-arrival)",
         pathSelectionStrategy);
     cmd.AddValue("competingSourcesA",
                  "Number of competing sources on path A",
@@ -406,8 +414,14 @@ main(int argc, char* argv[])
     cmd.AddValue("bufferWeightFactor",
                  "Buffer influence factor (0-1) for buffer-aware strategy",
                  bufferWeightFactor);
+    cmd.AddValue("legacyHeader",
+                 "Use the original fixed 78-byte NADA header instead of the compact format",
+                 legacyHeader);
+    metricsHelper.AddCommandLineValues(cmd);
     cmd.Parse(argc, argv);
 
+    NadaHeader::SetWireFormat(legacyHeader ? NadaHeader::LEGACY : NadaHeader::COMPACT);
+
     // Configure logging
     Time::SetResolution(Time::NS);
     LogComponentEnable("MultipathCompetingWebRtcSimulation", LOG_LEVEL_INFO);
@@ -433,7 +447,7 @@ main(int argc, char* argv[])
 
     if (logDetails)
     {
-        LogComponentEnable("MultiPathNadaClient", LOG_LEVEL_INFO);
+        LogComponentEnable("MultiPathNadaClientBase", LOG_LEVEL_INFO);
         LogComponentEnable("NadaCongestionControl", LOG_LEVEL_INFO);
     }
 
@@ -612,24 +626,20 @@ main(int argc, char* argv[])
     // Set up routing
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
-    NS_LOG_INFO("Creating MultiPathNadaClient application");
-    // Create MultiPathNadaClient application
+    NS_LOG_INFO("Creating multipath client with strategy " << pathSelectionStrategy);
     uint16_t port = 9;
-    MultiPathNadaClientHelper clientHelper;
-    clientHelper.SetAttribute("PacketSize", UintegerValue(packetSize));
-    clientHelper.SetAttribute("MaxPackets", UintegerValue(maxPackets));
-    clientHelper.SetAttribute("PathSelectionStrategy", UintegerValue(pathSelectionStrategy));
-
-    NS_LOG_INFO("Installing MultiPathNadaClient on source node");
-    // Install the client on the source node
-    ApplicationContainer clientApp = clientHelper.Install(source.Get(0));
-    Ptr<MultiPathNadaClient> mpClient = DynamicCast<MultiPathNadaClient>(clientApp.Get(0));
+    Ptr<MultiPathNadaClientBase> mpClient = MultiPathNadaClientFactory::Create(
+        static_cast<MultiPathNadaClientFactory::StrategyType>(pathSelectionStrategy));
     if (mpClient == nullptr)
     {
-        NS_LOG_ERROR("MultiPathNadaClient pointer is null, cannot continue");
+        NS_LOG_ERROR("Failed to create multipath client, cannot continue");
         return 1;
     }
-    NS_LOG_INFO("MultiPathNadaClient installed successfully");
+    mpClient->SetPacketSize(packetSize);
+    mpClient->SetMaxPackets(maxPackets);
+
+    NS_LOG_INFO("Installing " << mpClient->GetStrategyName() << " client on source node");
+    source.Get(0)->AddApplication(mpClient);
 
     NS_LOG_INFO("Creating server application at destination");
     // Create server application at destination
@@ -638,8 +648,8 @@ main(int argc, char* argv[])
     server.SetAttribute("FrameRate", UintegerValue(frameRate));
     ApplicationContainer serverApp = server.Install(destination.Get(0));
 
-    NS_LOG_INFO("Adding path 1 to MultiPathNadaClient");
-    // Add the two paths to the MultiPathNadaClient
+    NS_LOG_INFO("Adding path 1 to the multipath client");
+    // Add the two paths to the multipath client
     InetSocketAddress destAddr1(ifcRouterADestination.GetAddress(1), port);
     bool path1Added = mpClient->AddPath(ifcSourceRouterA.GetAddress(0),
                                         destAddr1,
@@ -648,7 +658,7 @@ main(int argc, char* argv[])
                                         DataRate(dataRate1));
     NS_LOG_INFO("Path 1 added: " << (path1Added ? "success" : "failed"));
 
-    NS_LOG_INFO("Adding path 2 to MultiPathNadaClient");
+    NS_LOG_INFO("Adding path 2 to the multipath client");
     InetSocketAddress destAddr2(ifcRouterBDestination.GetAddress(1), port);
     bool path2Added = mpClient->AddPath(ifcSourceRouterB.GetAddress(0),
                                         destAddr2,
@@ -771,79 +781,18 @@ main(int argc, char* argv[])
 
     NS_LOG_INFO("Starting applications");
     serverApp.Start(Seconds(0.1));
-    clientApp.Start(Seconds(0.2));
-
-    Simulator::Schedule(Seconds(0.3), &MultiPathNadaClient::InitializePathSocket, mpClient, 1);
-    Simulator::Schedule(Seconds(0.3), &MultiPathNadaClient::InitializePathSocket, mpClient, 2);
-    Simulator::Schedule(Seconds(0.5), &MultiPathNadaClient::ValidateAllSockets, mpClient);
+    mpClient->SetStartTime(Seconds(0.2));
 
+    // The client initializes and retries the path sockets itself
     NS_LOG_INFO("Scheduling client readiness check");
-    int attempts = 0;
-    Simulator::Schedule(Seconds(0.6), [&, attempts]() {
-        // Use the captured attempts value from the outer lambda
-        int nextAttempt = attempts + 1;
-
-        if (mpClient->IsReady())
-        {
-            NS_LOG_INFO("Client is ready after " << nextAttempt << " attempts");
-        }
-        else if (nextAttempt < 20)
-        {
-            NS_LOG_INFO("Client not ready yet, attempt " << nextAttempt);
-
-            // Retry initialization
-            Simulator::Schedule(Seconds(0.0),
-                                &MultiPathNadaClient::InitializePathSocket,
-                                mpClient,
-                                1);
-            Simulator::Schedule(Seconds(0.1),
-                                &MultiPathNadaClient::InitializePathSocket,
-                                mpClient,
-                                2);
-
-            // Schedule another check with incremented attempts
-            Simulator::Schedule(Seconds(1.0), [&, nextAttempt]() {
-                // Recursive check with proper attempt counting
-                int recursiveAttempt = nextAttempt + 1;
-                // Same readiness check logic as above
-                if (mpClient->IsReady())
-                {
-                    NS_LOG_INFO("Client is ready after " << recursiveAttempt << " attempts");
-                }
-                else if (recursiveAttempt < 20)
-                {
-                    NS_LOG_INFO("Client not ready yet, attempt " << recursiveAttempt);
-                    // Continue retry chain...
-                    Simulator::Schedule(Seconds(0.0),
-                                        &MultiPathNadaClient::InitializePathSocket,
-                                        mpClient,
-                                        1);
-                    Simulator::Schedule(Seconds(0.1),
-                                        &MultiPathNadaClient::InitializePathSocket,
-                                        mpClient,
-                                        2);
-                }
-                else
-                {
-                    NS_LOG_ERROR("Client failed to initialize after " << recursiveAttempt
-                                                                      << " attempts");
-                }
-            });
-        }
-        else
-        {
-            NS_LOG_ERROR("Client failed to initialize after " << nextAttempt << " attempts");
-        }
+    Simulator::Schedule(Seconds(0.6), [mpClient]() {
+        NS_LOG_INFO("Client " << (mpClient->IsReady() ? "is ready" : "not ready yet"));
     });
 
-    NS_LOG_INFO("Setting path selection strategy to "
-                << mpClient->GetStrategyName(pathSelectionStrategy));
-    mpClient->SetPathSelectionStrategy(pathSelectionStrategy);
-
     for (int i = 0; i < 10; i++)
     {
         Simulator::Schedule(Seconds(1.0 + i * 5),
-                            &MultiPathNadaClient::ReportSocketStatus,
+                            &MultiPathNadaClientBase::ReportSocketStatus,
                             mpClient);
     }
 
@@ -869,7 +818,7 @@ main(int argc, char* argv[])
 
     NS_LOG_INFO("Setting application stop times");
     // Stop applications
-    clientApp.Stop(Seconds(simulationTime - 0.5));
+    mpClient->SetStopTime(Seconds(simulationTime - 0.5));
     serverApp.Stop(Seconds(simulationTime));
 
     NS_LOG_INFO("Setting up flow monitor");
@@ -878,6 +827,8 @@ main(int argc, char* argv[])
     FlowMonitorHelper flowHelper;
     flowMonitor = flowHelper.InstallAll();
 
+    Ptr<NadaMetricsSink> metricsSink = metricsHelper.Install(mpClient, serverApp.Get(0));
+
     NS_LOG_INFO("Starting simulation for " << simulationTime << " seconds");
     // Run simulation
     Simulator::Stop(Seconds(simulationTime));
@@ -1047,8 +998,8 @@ main(int argc, char* argv[])
 
     if (pathSelectionStrategy == 5) // BUFFER_AWARE
     {
-        mpClient->SetVideoReceiver(videoReceiverInstance);
-        mpClient->SetBufferAwareParameters(targetBufferLength, bufferWeightFactor);
+        DynamicCast<MultiPathNadaBufferAwareClient>(mpClient)
+            ->SetBufferAwareParameters(targetBufferLength, bufferWeightFactor);
         NS_LOG_INFO("Configured buffer-aware strategy with target buffer: "
                     << targetBufferLength << "s, weight factor: " << bufferWeightFactor);
 
@@ -1068,8 +1019,8 @@ main(int argc, char* argv[])
     frameStats.PrintStats();
 
     NS_LOG_INFO("Collecting path statistics");
-    // Print path statistics from the MultiPathNadaClient
-    std::cout << "\nPath Statistics (Strategy: " << mpClient->GetStrategyName(pathSelectionStrategy)
+    // Print path statistics from the multipath client
+    std::cout << "\nPath Statistics (Strategy: " << mpClient->GetStrategyName()
               << "):\n";
     for (uint32_t pathId = 1; pathId <= mpClient->GetNumPaths(); pathId++)
     {
@@ -1086,6 +1037,32 @@ main(int argc, char* argv[])
         }
     }
 
+    if (metricsSink)
+    {
+        for (const auto& flow : mainSourceFlows)
+        {
+            metricsSink->RecordFlowStats("webrtc_flow",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        for (const auto& flow : pathACompetingFlows)
+        {
+            metricsSink->RecordFlowStats("competing_a",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        for (const auto& flow : pathBCompetingFlows)
+        {
+            metricsSink->RecordFlowStats("competing_b",
+                                         flow.first,
+                                         flow.second,
+                                         Seconds(simulationTime));
+        }
+        metricsSink->Write();
+    }
+
     NS_LOG_INFO("Cleaning up simulation");
     Simulator::Destroy();
     NS_LOG_INFO("Simulation finished successfully");
@@ -11,6 +11,9 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -39,6 +42,22 @@ AggregatePathNadaClient::GetTypeId(void)
                           "Time between packets (will be updated by NADA)",
                           TimeValue(MilliSeconds(100)),
                           MakeTimeAccessor(&AggregatePathNadaClient::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("RttCombiner",
+                          "How path delays make up the aggregated RTT "
+                          "(0=mean, 1=min, 2=capacity-weighted mean, 3=percentile)",
+                          UintegerValue(RTT_MEAN),
+                          MakeUintegerAccessor(&AggregatePathNadaClient::m_rttCombiner),
+                          MakeUintegerChecker<uint32_t>(RTT_MEAN, RTT_PERCENTILE))
+            .AddAttribute("RttPercentile",
+                          "Percentile of the recent path samples used by the percentile combiner",
+                          DoubleValue(0.9),
+                          MakeDoubleAccessor(&AggregatePathNadaClient::m_rttPercentile),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("LossTimeout",
+                          "Age after which an unacknowledged packet counts as lost",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&AggregatePathNadaClient::m_lossTimeout),
                           MakeTimeChecker());
     return tid;
 }
@@ -47,16 +66,23 @@ AggregatePathNadaClient::AggregatePathNadaClient()
     : m_packetSize(1024),
       m_maxPackets(100),
       m_totalPacketsSent(0),
-      m_currentPathIndex(0),
+      m_schedulerDirty(true),
+      m_rttCombiner(RTT_MEAN),
+      m_rttPercentile(0.9),
+      m_lossTimeout(MilliSeconds(500)),
       m_running(false),
       m_interval(MilliSeconds(100)),
       m_videoMode(false),
       m_isKeyFrame(false),
+      m_frameId(0),
+      m_packetIndex(0),
+      m_packetsInFrame(0),
       m_totalRate(DataRate("1Mbps")),
       m_totalLinkCapacity(0)
 {
     NS_LOG_FUNCTION(this);
     m_nada = CreateObject<NadaCongestionControl>();
+    m_scheduler.SetMode(PathScheduler::SMOOTH_WRR);
 }
 
 AggregatePathNadaClient::~AggregatePathNadaClient()
@@ -65,15 +91,12 @@ AggregatePathNadaClient::~AggregatePathNadaClient()
 }
 
 bool
-AggregatePathNadaClient::AddPath(uint32_t pathId, Address localAddress, Address remoteAddress)
+AggregatePathNadaClient::AddPath(uint32_t pathId,
+                                 Address localAddress,
+                                 Address remoteAddress,
+                                 DataRate capacity)
 {
-    NS_LOG_FUNCTION(this << pathId << localAddress << remoteAddress);
-
-    if (pathId < 1 || pathId > 2)
-    {
-        NS_LOG_ERROR("Path ID must be 1 or 2, got: " << pathId);
-        return false;
-    }
+    NS_LOG_FUNCTION(this << pathId << localAddress << remoteAddress << capacity);
 
     if (m_paths.find(pathId) != m_paths.end())
     {
@@ -87,13 +110,48 @@ AggregatePathNadaClient::AddPath(uint32_t pathId, Address localAddress, Address
     pathInfo.remoteAddress = remoteAddress;
     pathInfo.packetsSent = 0;
     pathInfo.packetsAcked = 0;
+    pathInfo.bytesSent = 0;
     pathInfo.lastRtt = MilliSeconds(100); // Default RTT
     pathInfo.baseRtt = MilliSeconds(50);  // Default base RTT
-    pathInfo.rttSamples.clear();
-    pathInfo.linkCapacity = DataRate("1Mbps");
+    pathInfo.rttSamples.Clear();
+    pathInfo.linkCapacity = capacity;
+    pathInfo.history.SetLossCallback(
+        MakeCallback(&AggregatePathNadaClient::HandlePacketLost, this));
 
     m_paths[pathId] = pathInfo;
-    NS_LOG_INFO("Added path " << pathId);
+    m_schedulerDirty = true;
+    NS_LOG_INFO("Added path " << pathId << " (" << capacity.GetBitRate() / 1000000.0 << "Mbps)");
+
+    // A path joining a running client starts sending right away
+    if (m_running)
+    {
+        InitializePathSocket(pathId);
+    }
+    return true;
+}
+
+bool
+AggregatePathNadaClient::RemovePath(uint32_t pathId)
+{
+    NS_LOG_FUNCTION(this << pathId);
+
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end())
+    {
+        NS_LOG_ERROR("Path " << pathId << " does not exist");
+        return false;
+    }
+
+    if (it->second.socket)
+    {
+        m_socketToPathId.erase(it->second.socket);
+        it->second.socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        it->second.socket->Close();
+    }
+
+    m_paths.erase(it);
+    m_schedulerDirty = true;
+    NS_LOG_INFO("Removed path " << pathId << ", " << m_paths.size() << " paths left");
     return true;
 }
 
@@ -113,31 +171,51 @@ AggregatePathNadaClient::SetMaxPackets(uint32_t maxPackets)
 }
 
 void
-AggregatePathNadaClient::SetPathCapacities(DataRate path1Capacity, DataRate path2Capacity)
+AggregatePathNadaClient::SetPathCapacity(uint32_t pathId, DataRate capacity)
 {
-    NS_LOG_FUNCTION(this << path1Capacity << path2Capacity);
-
-    // Store individual path capacities
-    auto path1It = m_paths.find(1);
-    auto path2It = m_paths.find(2);
+    NS_LOG_FUNCTION(this << pathId << capacity);
 
-    if (path1It != m_paths.end())
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end())
     {
-        path1It->second.linkCapacity = path1Capacity;
+        NS_LOG_WARN("Cannot set the capacity of unknown path " << pathId);
+        return;
     }
 
-    if (path2It != m_paths.end())
+    it->second.linkCapacity = capacity;
+    m_schedulerDirty = true;
+
+    NS_LOG_INFO("Set path " << pathId << " capacity: " << capacity.GetBitRate() / 1000000.0
+                            << "Mbps");
+}
+
+void
+AggregatePathNadaClient::SetPathCapacities(DataRate path1Capacity, DataRate path2Capacity)
+{
+    NS_LOG_FUNCTION(this << path1Capacity << path2Capacity);
+    SetPathCapacity(1, path1Capacity);
+    SetPathCapacity(2, path2Capacity);
+}
+
+void
+AggregatePathNadaClient::UpdateScheduler()
+{
+    m_readyPaths.clear();
+    m_readyWeights.clear();
+    m_totalLinkCapacity = 0;
+    for (const auto& pathPair : m_paths)
     {
-        path2It->second.linkCapacity = path2Capacity;
+        m_totalLinkCapacity += pathPair.second.linkCapacity.GetBitRate();
+        if (pathPair.second.socket)
+        {
+            m_readyPaths.push_back(pathPair.first);
+            m_readyWeights.push_back(pathPair.second.linkCapacity.GetBitRate());
+        }
     }
 
-    // Calculate total link capacity
-    m_totalLinkCapacity = path1Capacity.GetBitRate() + path2Capacity.GetBitRate();
-
-    NS_LOG_INFO("Set path capacities: Path1="
-                << path1Capacity.GetBitRate() / 1000000.0
-                << "Mbps, Path2=" << path2Capacity.GetBitRate() / 1000000.0
-                << "Mbps, Total=" << m_totalLinkCapacity / 1000000.0 << "Mbps");
+    // Every path gets packets in proportion to its capacity, interleaved
+    m_scheduler.SetWeights(m_readyPaths, m_readyWeights);
+    m_schedulerDirty = false;
 }
 
 bool
@@ -156,24 +234,18 @@ AggregatePathNadaClient::Send(Ptr<Packet> packet)
         return false;
     }
 
-    // **SIMPLIFIED: Just do round-robin path selection**
-    std::vector<uint32_t> availablePaths;
-    for (auto& pathPair : m_paths)
+    if (m_schedulerDirty)
     {
-        if (pathPair.second.socket)
-        {
-            availablePaths.push_back(pathPair.first);
-        }
+        UpdateScheduler();
     }
 
-    if (availablePaths.empty())
+    if (m_scheduler.IsEmpty())
     {
         NS_LOG_ERROR("No available paths for sending");
         return false;
     }
 
-    uint32_t selectedPath = availablePaths[m_currentPathIndex % availablePaths.size()];
-    m_currentPathIndex++;
+    uint32_t selectedPath = m_scheduler.Next();
 
     bool sent = SendOnPath(selectedPath, packet);
     if (sent)
@@ -206,6 +278,10 @@ AggregatePathNadaClient::SendOnPath(uint32_t pathId, Ptr<Packet> packet)
     {
         header.SetVideoFrameType(m_isKeyFrame ? 0 : 1); // 0=key, 1=delta
         header.SetVideoFrameSize(packet->GetSize());
+        if (m_packetsInFrame > 0)
+        {
+            header.SetVideoFrameInfo(m_frameId, m_packetIndex, m_packetsInFrame);
+        }
     }
 
     packet->AddHeader(header);
@@ -216,6 +292,8 @@ AggregatePathNadaClient::SendOnPath(uint32_t pathId, Ptr<Packet> packet)
         if (sent > 0)
         {
             it->second.packetsSent++;
+            it->second.bytesSent += sent;
+            it->second.history.Record(m_totalPacketsSent, Simulator::Now(), sent, m_frameId, pathId);
             return true;
         }
     }
@@ -242,20 +320,20 @@ AggregatePathNadaClient::GetAggregatedRtt()
 bool
 AggregatePathNadaClient::IsReady() const
 {
-    if (m_paths.size() != 2)
+    if (!m_running)
     {
         return false;
     }
 
     for (const auto& pathPair : m_paths)
     {
-        if (!pathPair.second.socket)
+        if (pathPair.second.socket)
         {
-            return false;
+            return true;
         }
     }
 
-    return m_running;
+    return false;
 }
 
 std::map<std::string, double>
@@ -275,6 +353,33 @@ AggregatePathNadaClient::GetPathStats(uint32_t pathId) const
     return stats;
 }
 
+void
+AggregatePathNadaClient::SetMetricsSink(Ptr<NadaMetricsSink> sink, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+    sink->AddSource(name, MakeCallback(&AggregatePathNadaClient::ReportMetrics, this));
+}
+
+void
+AggregatePathNadaClient::ReportMetrics(Ptr<NadaMetricsSink> sink)
+{
+    for (const auto& pathPair : m_paths)
+    {
+        for (const auto& stat : GetPathStats(pathPair.first))
+        {
+            sink->Record(pathPair.first, stat.first, stat.second);
+        }
+    }
+    sink->Record("rate_bps", GetCurrentRate().GetBitRate());
+    sink->Record("rtt_ms", GetAggregatedRtt().GetSeconds() * 1000.0);
+    double lossRate = CalculateAggregatedLoss();
+    if (lossRate >= 0.0)
+    {
+        sink->Record("loss_rate", lossRate);
+    }
+    sink->Record("paths", m_paths.size());
+}
+
 void
 AggregatePathNadaClient::DoDispose(void)
 {
@@ -307,9 +412,9 @@ AggregatePathNadaClient::StartApplication(void)
 {
     NS_LOG_FUNCTION(this);
 
-    if (m_paths.size() != 2)
+    if (m_paths.empty())
     {
-        NS_LOG_ERROR("Exactly 2 paths must be configured before starting");
+        NS_LOG_ERROR("At least one path must be configured before starting");
         return;
     }
 
@@ -332,7 +437,7 @@ AggregatePathNadaClient::StartApplication(void)
 
     NS_LOG_INFO("AggregatePathNadaClient ready - FRAME-BASED TRANSMISSION ONLY");
     std::cout << "**DEBUG: AggregatePathNadaClient - NO continuous transmission active" << std::endl;
-    std::cout << "**DEBUG: No UpdateNadaMetrics scheduled" << std::endl;
+    std::cout << "**DEBUG: NADA fed with aggregated metrics on every feedback" << std::endl;
     std::cout << "**DEBUG: Client will ONLY respond to SendAggregateVideoFrame calls" << std::endl;
 }
 
@@ -397,6 +502,7 @@ AggregatePathNadaClient::InitializePathSocket(uint32_t pathId)
     // Store socket
     it->second.socket = socket;
     m_socketToPathId[socket] = pathId;
+    m_schedulerDirty = true;
 
     NS_LOG_INFO("Initialized socket for path " << pathId);
 }
@@ -434,28 +540,63 @@ AggregatePathNadaClient::HandleRecv(Ptr<Socket> socket)
         {
             NadaHeader header;
             packet->RemoveHeader(header);
+            if (header.GetPacketType() == NadaHeader::NACK)
+            {
+                return;
+            }
 
+            // The feedback timestamp alone only covers the reverse path. With
+            // the receiver's echo the hold time drops out and the clock offset
+            // cancels: forward delay + (now - receive timestamp) is the RTT.
             Time currentTime = Simulator::Now();
-            Time rtt = currentTime - header.GetTimestamp();
+            NadaFeedback feedback;
+            header.GetFeedback(feedback);
+            Time rtt = feedback.hasForwardDelay
+                           ? currentTime - feedback.receiveTimestamp + feedback.forwardDelay
+                           : currentTime - header.GetTimestamp();
 
             // Update path RTT information
-            pathIt->second.lastRtt = rtt;
-            pathIt->second.packetsAcked++;
-
-            // Store RTT sample for aggregation calculation
-            pathIt->second.rttSamples.push_back(rtt);
-            if (pathIt->second.rttSamples.size() > 10) // Keep last 10 samples
+            PathInfo& path = pathIt->second;
+            path.lastRtt = rtt;
+            path.packetsAcked +=
+                header.HasField(NadaHeader::FIELD_ACK_VECTOR)
+                    ? header.GetAckVector().GetReceivedCount()
+                    : 1;
+
+            // Settle the acknowledged packets; the rest stay in flight until
+            // reported missing or too old
+            path.history.ExpireOlderThan(currentTime - m_lossTimeout);
+            NadaSendHistory::Entry sent;
+            if (header.HasField(NadaHeader::FIELD_ACK_VECTOR))
+            {
+                header.GetAckVector().ForEach([&](uint32_t seq, bool received, Time) {
+                    if (!received)
+                    {
+                        path.history.MarkLost(seq);
+                    }
+                    else if (path.history.Retire(seq, sent))
+                    {
+                        path.lossWindow.Push(false);
+                    }
+                });
+            }
+            else if (path.history.Retire(header.GetSequenceNumber(), sent))
             {
-                pathIt->second.rttSamples.erase(pathIt->second.rttSamples.begin());
+                path.lossWindow.Push(false);
             }
 
+            // Store RTT sample for aggregation calculation
+            path.rttSamples.Push(rtt); // Keeps the last 10 samples
+
             // Update base RTT (minimum observed)
-            if (rtt < pathIt->second.baseRtt)
+            if (rtt < path.baseRtt)
             {
-                pathIt->second.baseRtt = rtt;
+                path.baseRtt = rtt;
             }
 
             NS_LOG_DEBUG("Path " << pathId << " RTT: " << rtt.GetMilliSeconds() << "ms");
+
+            UpdateNadaMetrics();
         }
         catch (const std::exception& e)
         {
@@ -478,40 +619,34 @@ AggregatePathNadaClient::UpdateNadaMetrics()
     Time aggregatedRtt = CalculateAggregatedRtt();
 
     // Process the aggregated RTT in NADA
-    m_nada->ProcessAck(Create<Packet>(0), aggregatedRtt);
+    m_nada->ProcessDelay(aggregatedRtt);
 
-    // Calculate aggregated loss rate (simplified)
-    double totalLossRate = 0.0;
-    uint32_t pathCount = 0;
-
-    for (const auto& pathPair : m_paths)
+    double lossRate = CalculateAggregatedLoss();
+    if (lossRate >= 0.0)
     {
-        if (pathPair.second.packetsSent > 0)
-        {
-            double pathLoss =
-                1.0 - (double(pathPair.second.packetsAcked) / pathPair.second.packetsSent);
-            totalLossRate += pathLoss;
-            pathCount++;
-        }
-    }
-
-    if (pathCount > 0)
-    {
-        double avgLossRate = totalLossRate / pathCount;
-        m_nada->ProcessLoss(avgLossRate);
+        m_nada->ProcessLoss(lossRate);
     }
 
-    // Update cached total rate
-    m_totalRate = GetTotalRate();
+    // The controller's periodic update applies these; updating the rate
+    // here would step it once per feedback packet
+    m_totalRate = m_nada->GetCurrentRate();
 
     NS_LOG_DEBUG("Updated NADA with aggregated RTT: "
                  << aggregatedRtt.GetMilliSeconds()
-                 << "ms, loss rate: " << (pathCount > 0 ? totalLossRate / pathCount : 0.0)
-                 << ", total rate: " << m_totalRate.GetBitRate() / 1000000.0 << " Mbps");
+                 << "ms, loss rate: " << std::max(lossRate, 0.0)
+                 << ", rate: " << m_totalRate.GetBitRate() / 1000000.0 << " Mbps");
+}
+
+void
+AggregatePathNadaClient::HandlePacketLost(const NadaSendHistory::Entry& entry)
+{
+    NS_LOG_FUNCTION(this << entry.pathId << entry.seq);
 
-    // Schedule next update
-    // m_updateEvent =
-    //     Simulator::Schedule(MilliSeconds(100), &AggregatePathNadaClient::UpdateNadaMetrics, this);
+    auto it = m_paths.find(entry.pathId);
+    if (it != m_paths.end())
+    {
+        it->second.lossWindow.Push(true);
+    }
 }
 
 Time
@@ -519,26 +654,72 @@ AggregatePathNadaClient::CalculateAggregatedRtt()
 {
     NS_LOG_FUNCTION(this);
 
-    if (m_paths.size() != 2)
+    if (m_paths.empty())
     {
         return MilliSeconds(100); // Default value
     }
 
-    auto path1It = m_paths.find(1);
-    auto path2It = m_paths.find(2);
-
-    if (path1It == m_paths.end() || path2It == m_paths.end())
+    bool anySocket = false;
+    for (const auto& pathPair : m_paths)
     {
-        return MilliSeconds(100);
+        anySocket = anySocket || pathPair.second.socket;
     }
 
-    // Calculate RTT differences for each path
-    // RTT difference = current_rtt - base_rtt
-    Time path1Diff = path1It->second.lastRtt - path1It->second.baseRtt;
-    Time path2Diff = path2It->second.lastRtt - path2It->second.baseRtt;
+    // RTT difference = current_rtt - base_rtt, combined over the active paths
+    Time sum = Seconds(0);
+    Time minDiff = Time::Max();
+    double weightedSum = 0.0;
+    double totalCapacity = 0.0;
+    uint32_t count = 0;
+    m_rttScratch.clear();
 
-    // Aggregated RTT = (path1_diff + path2_diff) / 2
-    Time aggregatedRtt = (path1Diff + path2Diff) / 2;
+    for (const auto& pathPair : m_paths)
+    {
+        const PathInfo& path = pathPair.second;
+        if (anySocket && !path.socket)
+        {
+            continue;
+        }
+
+        Time diff = path.lastRtt - path.baseRtt;
+        sum += diff;
+        minDiff = std::min(minDiff, diff);
+        weightedSum += diff.GetSeconds() * path.linkCapacity.GetBitRate();
+        totalCapacity += path.linkCapacity.GetBitRate();
+        count++;
+
+        for (uint32_t i = 0; i < path.rttSamples.Size(); i++)
+        {
+            m_rttScratch.push_back(path.rttSamples[i] - path.baseRtt);
+        }
+    }
+
+    Time aggregatedRtt = sum / count;
+    switch (m_rttCombiner)
+    {
+        case RTT_MIN:
+            aggregatedRtt = minDiff;
+            break;
+        case RTT_CAPACITY_MEAN:
+            if (totalCapacity > 0.0)
+            {
+                aggregatedRtt = Seconds(weightedSum / totalCapacity);
+            }
+            break;
+        case RTT_PERCENTILE:
+            if (!m_rttScratch.empty())
+            {
+                size_t rank = static_cast<size_t>(
+                    std::floor(m_rttPercentile * (m_rttScratch.size() - 1)));
+                std::nth_element(m_rttScratch.begin(),
+                                 m_rttScratch.begin() + rank,
+                                 m_rttScratch.end());
+                aggregatedRtt = m_rttScratch[rank];
+            }
+            break;
+        default:
+            break;
+    }
 
     // Ensure we have a reasonable minimum RTT
     if (aggregatedRtt < MilliSeconds(1))
@@ -546,13 +727,34 @@ AggregatePathNadaClient::CalculateAggregatedRtt()
         aggregatedRtt = MilliSeconds(1);
     }
 
-    NS_LOG_DEBUG("Path1 diff: " << path1Diff.GetMilliSeconds() << "ms, "
-                                << "Path2 diff: " << path2Diff.GetMilliSeconds() << "ms, "
-                                << "Aggregated: " << aggregatedRtt.GetMilliSeconds() << "ms");
+    NS_LOG_DEBUG("Aggregated RTT over " << count << " paths (combiner " << m_rttCombiner
+                                        << "): " << aggregatedRtt.GetMilliSeconds() << "ms");
 
     return aggregatedRtt;
 }
 
+double
+AggregatePathNadaClient::CalculateAggregatedLoss() const
+{
+    // Each path counts with the bytes it carried, so a lossy path that
+    // carries little traffic does not dominate the aggregate
+    double lostBytes = 0.0;
+    double totalBytes = 0.0;
+    for (const auto& pathPair : m_paths)
+    {
+        const PathInfo& path = pathPair.second;
+        if (path.packetsSent == 0)
+        {
+            continue;
+        }
+
+        lostBytes += path.lossWindow.GetLossRate() * path.bytesSent;
+        totalBytes += path.bytesSent;
+    }
+
+    return (totalBytes > 0.0) ? lostBytes / totalBytes : -1.0;
+}
+
 bool
 AggregatePathNadaClient::IsConnected() const
 {
@@ -648,7 +850,7 @@ AggregatePathNadaClient::GetTotalRate() const
     // Apply NADA's rate control as a scaling factor to the actual link capacity
     double nadaScaling = std::min(1.0, nadaRate.GetBitRate() / (double)totalCapacity);
     uint64_t effectiveBitRate = totalCapacity * nadaScaling;
-    effectiveBitRate = std::max(effectiveBitRate, 500000ULL); // 500 kbps minimum
+    effectiveBitRate = std::max<uint64_t>(effectiveBitRate, 500000); // 500 kbps minimum
 
     DataRate totalRate(effectiveBitRate);
 
@@ -681,6 +883,17 @@ AggregatePathNadaClient::SetKeyFrameStatus(bool isKeyFrame)
     NS_LOG_DEBUG("Set key frame status: " << (isKeyFrame ? "KEY" : "DELTA"));
 }
 
+void
+AggregatePathNadaClient::SetVideoFrameContext(uint32_t frameId,
+                                              uint16_t packetIndex,
+                                              uint16_t packetsInFrame)
+{
+    NS_LOG_FUNCTION(this << frameId << packetIndex << packetsInFrame);
+    m_frameId = frameId;
+    m_packetIndex = packetIndex;
+    m_packetsInFrame = packetsInFrame;
+}
+
 bool
 AggregatePathNadaClient::SendVideoFrame(uint32_t frameId,
                                        bool isKeyFrame,
@@ -713,6 +926,7 @@ AggregatePathNadaClient::SendVideoFrame(uint32_t frameId,
     for (uint32_t i = 0; i < numPacketsNeeded; i++)
     {
         Ptr<Packet> packet = Create<Packet>(mtu);
+        SetVideoFrameContext(frameId, i, numPacketsNeeded);
 
         // **CRITICAL: Use same round-robin as before, but frame-aware**
         bool sent = Send(packet);
@@ -2,13 +2,17 @@
 #define DUAL_PATH_NADA_CLIENT_H
 
 #include "nada-improved.h"
+#include "nada-metrics-sink.h"
+#include "nada-send-history.h"
 #include "nada-udp-client.h"
+#include "nada-window-stats.h"
 
 #include "ns3/address.h"
 #include "ns3/application.h"
 #include "ns3/data-rate.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
+#include "ns3/mp-scheduler.h"
 #include "ns3/socket.h"
 
 #include <map>
@@ -18,14 +22,27 @@ namespace ns3
 {
 
 /**
- * \brief A agg-path NADA client that aggregates metrics from two paths
+ * \brief A agg-path NADA client that aggregates metrics from several paths
  *
- * This client maintains two separate paths and uses round-robin sending,
- * while the NADA algorithm uses aggregated RTT measurements from both paths.
+ * This client maintains any number of paths, which may join and leave while
+ * it runs, and spreads packets over them by capacity-weighted round robin.
+ * A single NADA controller is fed the RTT of all paths, combined as set by
+ * the RttCombiner attribute, and their loss weighted by the bytes each path
+ * carried, every time feedback arrives.
  */
 class AggregatePathNadaClient : public Application
 {
   public:
+    /**
+     * \brief How the per-path queuing delays make up the aggregated RTT
+     */
+    enum RttCombiner
+    {
+        RTT_MEAN = 0,          //!< Mean over the paths
+        RTT_MIN = 1,           //!< Least delayed path
+        RTT_CAPACITY_MEAN = 2, //!< Mean weighted by path capacity
+        RTT_PERCENTILE = 3     //!< Percentile over the recent samples of all paths
+    };
 
     /**
      * \brief Get the type ID.
@@ -45,12 +62,26 @@ class AggregatePathNadaClient : public Application
 
     /**
      * \brief Add a path to the client
-     * \param pathId Path identifier (1 or 2)
+     *
+     * Paths added while the client runs get their socket immediately.
+     *
+     * \param pathId Path identifier
      * \param localAddress Local address for this path
      * \param remoteAddress Remote address for this path
+     * \param capacity Link capacity, the share of packets the path gets
      * \return true if path was added successfully
      */
-    bool AddPath(uint32_t pathId, Address localAddress, Address remoteAddress);
+    bool AddPath(uint32_t pathId,
+                 Address localAddress,
+                 Address remoteAddress,
+                 DataRate capacity = DataRate("1Mbps"));
+
+    /**
+     * \brief Remove a path and close its socket
+     * \param pathId Path identifier
+     * \return true if the path existed
+     */
+    bool RemovePath(uint32_t pathId);
 
     /**
      * \brief Set packet size for both paths
@@ -78,14 +109,14 @@ class AggregatePathNadaClient : public Application
     DataRate GetCurrentRate() const;
 
     /**
-     * \brief Get aggregated RTT from both paths
+     * \brief Get aggregated RTT over the paths
      * \return Aggregated RTT
      */
     Time GetAggregatedRtt();
 
     /**
-     * \brief Check if both paths are ready
-     * \return true if both paths have valid sockets
+     * \brief Check if the client can send
+     * \return true if running with at least one path socket
      */
     bool IsReady() const;
 
@@ -120,11 +151,47 @@ class AggregatePathNadaClient : public Application
      */
     void SetKeyFrameStatus(bool isKeyFrame);
 
+    /**
+     * \brief Set the video frame the next packets belong to
+     *
+     * Carried in the NadaHeader so the receiver can reassemble frames exactly.
+     *
+     * \param frameId Frame identifier
+     * \param packetIndex Position of the next packet in the frame, from 0
+     * \param packetsInFrame Number of packets the frame is split into
+     */
+    void SetVideoFrameContext(uint32_t frameId, uint16_t packetIndex, uint16_t packetsInFrame);
+
+    /**
+     * \brief Set the link capacity of a path
+     * \param pathId Path identifier
+     * \param capacity Link capacity, the share of packets the path gets
+     */
+    void SetPathCapacity(uint32_t pathId, DataRate capacity);
+
+    /**
+     * \brief Set the link capacities of paths 1 and 2
+     * \param path1Capacity Capacity of path 1
+     * \param path2Capacity Capacity of path 2
+     */
     void SetPathCapacities(DataRate path1Capacity, DataRate path2Capacity);
 
+    /**
+     * \brief Have a metrics sink poll the statistics of this client
+     * \param sink The sink
+     * \param name Source name of the rows
+     */
+    void SetMetricsSink(Ptr<NadaMetricsSink> sink, const std::string& name);
+
   protected:
     virtual void DoDispose(void);
 
+    /**
+     * \brief Record GetPathStats() of every path and the totals during a sink poll
+     * \param sink The polling sink
+     */
+    virtual void ReportMetrics(Ptr<NadaMetricsSink> sink);
+
   private:
     struct PathInfo
     {
@@ -133,10 +200,13 @@ class AggregatePathNadaClient : public Application
         Address remoteAddress;
         uint32_t packetsSent;
         uint32_t packetsAcked;
+        uint64_t bytesSent; // Weight of the path loss in the aggregate
         Time lastRtt;
         Time baseRtt;
-        std::vector<Time> rttSamples; // For calculating RTT differences
+        NadaSampleWindow<Time, 10> rttSamples; // For calculating RTT differences
         DataRate linkCapacity;
+        NadaSendHistory history;        // Packets in flight on this path
+        NadaLossWindow<100> lossWindow; // Fate of the last acknowledged or lost packets
     };
 
     // Application lifecycle
@@ -155,17 +225,44 @@ class AggregatePathNadaClient : public Application
      */
     void HandleRecv(Ptr<Socket> socket);
 
+    /**
+     * \brief Count a packet the send history gave up on against its path
+     * \param entry The lost packet
+     */
+    void HandlePacketLost(const NadaSendHistory::Entry& entry);
+
     /**
      * \brief Update NADA algorithm with aggregated metrics
+     *
+     * Called for every feedback packet; the controller's own timer updates the rate.
      */
     void UpdateNadaMetrics();
 
     /**
-     * \brief Calculate aggregated RTT from both paths
+     * \brief Calculate aggregated RTT with the configured combiner
+     *
+     * Combines the queuing delay (RTT above the base RTT) of the paths that
+     * have a socket, or of all paths when none has.
+     *
      * \return Aggregated RTT value
      */
     Time CalculateAggregatedRtt();
 
+    /**
+     * \brief Calculate the loss rate of all paths, weighted by bytes sent
+     *
+     * Each path contributes the loss rate over its last acknowledged or lost
+     * packets, so packets still in flight do not count as lost.
+     *
+     * \return Aggregated loss rate, negative if nothing was sent
+     */
+    double CalculateAggregatedLoss() const;
+
+    /**
+     * \brief Refresh the sendable paths and their scheduler weights
+     */
+    void UpdateScheduler();
+
     /**
      * \brief Send packet on specific path
      * \param pathId Path to use
@@ -193,7 +290,15 @@ class AggregatePathNadaClient : public Application
     uint32_t m_packetSize;
     uint32_t m_maxPackets;
     uint32_t m_totalPacketsSent;
-    uint32_t m_currentPathIndex; // For round-robin
+
+    PathScheduler m_scheduler;            // Capacity-weighted round robin
+    bool m_schedulerDirty;                // Paths or capacities changed since UpdateScheduler()
+    std::vector<uint32_t> m_readyPaths;   // Paths with a socket
+    std::vector<double> m_readyWeights;   // Capacity of each of m_readyPaths
+    uint32_t m_rttCombiner;               // RttCombiner of the aggregated RTT
+    double m_rttPercentile;               // Percentile used by RTT_PERCENTILE
+    std::vector<Time> m_rttScratch;       // Reused by CalculateAggregatedRtt()
+    Time m_lossTimeout;                   // Age after which an unacknowledged packet is lost
 
     bool m_running;
     EventId m_sendEvent;
@@ -203,6 +308,9 @@ class AggregatePathNadaClient : public Application
 
     bool m_videoMode;     // Video mode flag
     bool m_isKeyFrame;    // Current frame type
+    uint32_t m_frameId;        // Frame the next packet belongs to
+    uint16_t m_packetIndex;    // Position of the next packet in the frame
+    uint16_t m_packetsInFrame; // Packets in the frame (0 = no frame info)
     DataRate m_totalRate; // Cached total rate
 
     uint64_t m_totalLinkCapacity;
@@ -1,6 +1,8 @@
 #include "mp-best.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -70,14 +72,9 @@ MultiPathNadaBestPathClient::UpdateWeights()
     m_bestPathId = bestPath;
 }
 
-bool
-MultiPathNadaBestPathClient::Send(Ptr<Packet> packet)
+uint32_t
+MultiPathNadaBestPathClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
 {
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
-    {
-        return false;
-    }
-
     if (++m_bestPathReCheckCounter >= RECHECK_INTERVAL)
     {
         m_bestPathId = FindBestPath();
@@ -85,18 +82,12 @@ MultiPathNadaBestPathClient::Send(Ptr<Packet> packet)
         NS_LOG_DEBUG("BEST_PATH - Rechecked best path: " << m_bestPathId);
     }
 
-    if (!packet)
+    // Fall back to the first ready path while the best one cannot send
+    if (std::find(readyPaths.begin(), readyPaths.end(), m_bestPathId) == readyPaths.end())
     {
-        packet = Create<Packet>(m_packetSize);
+        return readyPaths.front();
     }
-
-    bool sent = SendPacketOnPath(m_bestPathId, packet);
-    if (sent)
-    {
-        m_totalPacketsSent++;
-    }
-
-    return sent;
+    return m_bestPathId;
 }
 
 uint32_t
@@ -1,12 +1,13 @@
 #ifndef MP_BEST_PATH_NADA_H
 #define MP_BEST_PATH_NADA_H
 
-#include "mp-nada-base.h"
+#include "mp-strategy.h"
 
 namespace ns3
 {
 
-class MultiPathNadaBestPathClient : public MultiPathNadaClientBase
+class MultiPathNadaBestPathClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaBestPathClient>
 {
 public:
     static TypeId GetTypeId(void);
@@ -14,10 +15,11 @@ public:
     MultiPathNadaBestPathClient();
     virtual ~MultiPathNadaBestPathClient();
 
-    virtual bool Send(Ptr<Packet> packet) override;
     virtual std::string GetStrategyName() const override { return "BEST_PATH"; }
     virtual void UpdateWeights() override;
 
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+
 private:
     uint32_t m_bestPathId;
     uint32_t m_bestPathReCheckCounter;
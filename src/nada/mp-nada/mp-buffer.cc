@@ -1,6 +1,7 @@
 #include "mp-buffer.h"
 #include "ns3/log.h"
-#include "ns3/random-variable-stream.h"
+
+#include <algorithm>
 
 namespace ns3
 {
@@ -19,7 +20,13 @@ MultiPathNadaBufferAwareClient::GetTypeId(void)
 }
 
 MultiPathNadaBufferAwareClient::MultiPathNadaBufferAwareClient()
-    : m_targetBufferLength(3.0), m_bufferWeightFactor(0.3)
+    : m_targetBufferLength(3.0), m_bufferWeightFactor(0.3),
+      m_hasRemoteState(false),
+      m_remoteBufferDepth(Seconds(0)),
+      m_remotePlayoutTarget(Seconds(0)),
+      m_remoteUnderruns(0),
+      m_underrunPending(false),
+      m_pathMetrics()
 {
     NS_LOG_FUNCTION(this);
 }
@@ -34,14 +41,25 @@ MultiPathNadaBufferAwareClient::UpdateWeights()
 {
     NS_LOG_FUNCTION(this);
 
+    // Buffer state only reaches the sender in feedback; without it (e.g. with
+    // the legacy wire format) the buffer is taken to be on target, which
+    // leaves the weights to path quality alone
     double currentBufferMs = 0.0;
-    if (m_videoReceiver)
+    double targetBufferMs = m_targetBufferLength * 1000.0;
+    double bufferRatio = 1.0;
+    if (m_hasRemoteState)
     {
-        currentBufferMs = m_videoReceiver->GetAverageBufferLength();
+        currentBufferMs = m_remoteBufferDepth.GetSeconds() * 1000.0;
+        targetBufferMs = m_remotePlayoutTarget.GetSeconds() * 1000.0;
+        bufferRatio = (targetBufferMs > 0.0) ? currentBufferMs / targetBufferMs : 1.0;
     }
 
-    double targetBufferMs = m_targetBufferLength * 1000.0;
-    double bufferRatio = currentBufferMs / targetBufferMs;
+    if (m_underrunPending)
+    {
+        // The receiver stalled: treat it as an empty buffer until it refills
+        bufferRatio = 0.0;
+        m_underrunPending = false;
+    }
 
     NS_LOG_INFO("BUFFER_AWARE - Current buffer: " << currentBufferMs << "ms, "
                << "Target: " << targetBufferMs << "ms, "
@@ -50,7 +68,7 @@ MultiPathNadaBufferAwareClient::UpdateWeights()
     // If buffer is critically low, prioritize fastest/most reliable paths
     if (bufferRatio < 0.5)
     {
-        uint32_t bestPath = GetBestPathByRTT();
+        uint32_t bestPath = GetLowestRttPath();
         for (auto& pathPair : m_paths)
         {
             if (pathPair.first == bestPath)
@@ -71,12 +89,12 @@ MultiPathNadaBufferAwareClient::UpdateWeights()
     }
     else
     {
-        std::map<uint32_t, double> pathMetrics;
-
-        for (auto& pathPair : m_paths)
+        double totalWeight = 0.0;
+        for (auto it = m_paths.begin(); it != m_paths.end(); ++it)
         {
+            auto& pathPair = *it;
             uint32_t pathId = pathPair.first;
-            double bufferWeight = CalculateBufferWeight(currentBufferMs, pathId);
+            double bufferWeight = CalculateBufferWeight(bufferRatio, pathId);
 
             // Calculate path quality metric
             double rttMs = pathPair.second.lastRtt.GetMilliSeconds();
@@ -87,7 +105,8 @@ MultiPathNadaBufferAwareClient::UpdateWeights()
             double combinedWeight = m_bufferWeightFactor * bufferWeight +
                                   (1.0 - m_bufferWeightFactor) * qualityWeight;
 
-            pathMetrics[pathId] = combinedWeight;
+            m_pathMetrics[m_paths.GetIndex(it)] = combinedWeight;
+            totalWeight += combinedWeight;
 
             NS_LOG_INFO("BUFFER_AWARE - Path " << pathId << " weights: "
                        << "buffer=" << bufferWeight << ", "
@@ -96,70 +115,51 @@ MultiPathNadaBufferAwareClient::UpdateWeights()
         }
 
         // Normalize weights
-        double totalWeight = 0.0;
-        for (auto& metric : pathMetrics)
-        {
-            totalWeight += metric.second;
-        }
-
         if (totalWeight > 0)
         {
-            for (auto& pathPair : m_paths)
+            for (auto it = m_paths.begin(); it != m_paths.end(); ++it)
             {
-                pathPair.second.weight = pathMetrics[pathPair.first] / totalWeight;
-                NS_LOG_INFO("BUFFER_AWARE - Path " << pathPair.first
-                           << " final weight: " << pathPair.second.weight);
+                it->second.weight = m_pathMetrics[m_paths.GetIndex(it)] / totalWeight;
+                NS_LOG_INFO("BUFFER_AWARE - Path " << it->first
+                           << " final weight: " << it->second.weight);
             }
         }
     }
 }
 
-bool
-MultiPathNadaBufferAwareClient::Send(Ptr<Packet> packet)
+void
+MultiPathNadaBufferAwareClient::OnFeedback(uint32_t pathId, const NadaFeedback& feedback)
 {
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
+    if (!feedback.hasBufferState)
     {
-        return false;
+        return;
     }
 
-    // Get ready paths
-    std::vector<uint32_t> readyPaths;
-    for (const auto& pathPair : m_paths)
+    // Reports from every path describe the same receiver buffer
+    if (m_hasRemoteState && feedback.bufferUnderruns > m_remoteUnderruns)
     {
-        if (pathPair.second.client && pathPair.second.client->GetSocket() &&
-            IsSocketReady(pathPair.second.client->GetSocket()))
-        {
-            readyPaths.push_back(pathPair.first);
-        }
+        NS_LOG_WARN("BUFFER_AWARE - Receiver reported underrun #" << feedback.bufferUnderruns
+                   << " on path " << pathId);
+        m_underrunPending = true;
     }
 
-    if (readyPaths.empty())
-    {
-        return false;
-    }
-
-    uint32_t selectedPath = GetBufferAwarePath(readyPaths);
-
-    if (!packet)
-    {
-        packet = Create<Packet>(m_packetSize);
-    }
+    m_hasRemoteState = true;
+    m_remoteBufferDepth = feedback.bufferDepth;
+    m_remotePlayoutTarget = feedback.playoutTarget;
+    m_remoteUnderruns = std::max(m_remoteUnderruns, feedback.bufferUnderruns);
 
-    bool sent = SendPacketOnPath(selectedPath, packet);
-    if (sent)
+    // The distribution timer picks up the new state; only a stall is worth
+    // reweighting for ahead of it
+    if (m_underrunPending)
     {
-        m_totalPacketsSent++;
+        UpdateWeights();
+        NotifyWeightChanges();
     }
-
-    return sent;
 }
 
 double
-MultiPathNadaBufferAwareClient::CalculateBufferWeight(double currentBufferMs, uint32_t pathId)
+MultiPathNadaBufferAwareClient::CalculateBufferWeight(double bufferRatio, uint32_t pathId)
 {
-    double targetBufferMs = m_targetBufferLength * 1000.0;
-    double bufferDiff = currentBufferMs - targetBufferMs;
-
     // Get path RTT for responsiveness calculation
     auto it = m_paths.find(pathId);
     if (it == m_paths.end())
@@ -172,17 +172,18 @@ MultiPathNadaBufferAwareClient::CalculateBufferWeight(double currentBufferMs, ui
     // Calculate urgency based on buffer status
     double urgencyFactor = 1.0;
 
-    if (bufferDiff < -1000.0) // Buffer very low (< target - 1s)
+    // Thresholds are relative to the target, so they hold for any target depth
+    if (bufferRatio < 2.0 / 3.0) // Buffer very low
     {
         // High urgency: favor fast paths (low RTT, high rate)
         urgencyFactor = 2.0 / (1.0 + pathRttMs / 50.0); // Favor paths with RTT < 50ms
     }
-    else if (bufferDiff < -500.0) // Buffer low (< target - 0.5s)
+    else if (bufferRatio < 5.0 / 6.0) // Buffer low
     {
         // Medium urgency: slightly favor faster paths
         urgencyFactor = 1.5 / (1.0 + pathRttMs / 100.0);
     }
-    else if (bufferDiff > 1000.0) // Buffer high (> target + 1s)
+    else if (bufferRatio > 4.0 / 3.0) // Buffer high
     {
         // Low urgency: can afford to use slower paths for load balancing
         urgencyFactor = 0.8 + 0.4 * (pathRttMs / 200.0);
@@ -199,6 +200,12 @@ MultiPathNadaBufferAwareClient::CalculateBufferWeight(double currentBufferMs, ui
     return finalWeight;
 }
 
+uint32_t
+MultiPathNadaBufferAwareClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
+{
+    return GetBufferAwarePath(readyPaths);
+}
+
 uint32_t
 MultiPathNadaBufferAwareClient::GetBufferAwarePath(const std::vector<uint32_t>& readyPaths)
 {
@@ -213,64 +220,7 @@ MultiPathNadaBufferAwareClient::GetBufferAwarePath(const std::vector<uint32_t>&
     }
 
     // Use weighted selection based on current weights
-    double totalWeight = 0.0;
-    for (auto pathId : readyPaths)
-    {
-        auto it = m_paths.find(pathId);
-        if (it != m_paths.end())
-        {
-            totalWeight += it->second.weight;
-        }
-    }
-
-    if (totalWeight <= 0.0)
-    {
-        return readyPaths[0];
-    }
-
-    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
-    double r = rng->GetValue(0.0, 1.0);
-    double cumulativeProb = 0.0;
-
-    for (auto pathId : readyPaths)
-    {
-        auto it = m_paths.find(pathId);
-        if (it != m_paths.end())
-        {
-            double normalizedWeight = it->second.weight / totalWeight;
-            cumulativeProb += normalizedWeight;
-
-            if (r <= cumulativeProb)
-            {
-                return pathId;
-            }
-        }
-    }
-
-    return readyPaths[0]; // Fallback
-}
-
-uint32_t
-MultiPathNadaBufferAwareClient::GetBestPathByRTT()
-{
-    if (m_paths.empty())
-    {
-        return 0;
-    }
-
-    uint32_t bestPath = m_paths.begin()->first;
-    Time lowestRtt = Time::Max();
-
-    for (auto& pathPair : m_paths)
-    {
-        if (pathPair.second.lastRtt < lowestRtt)
-        {
-            lowestRtt = pathPair.second.lastRtt;
-            bestPath = pathPair.first;
-        }
-    }
-
-    return bestPath;
+    return SelectWeightedPath(readyPaths);
 }
 
 void
@@ -1,12 +1,15 @@
 #ifndef MP_BUFFER_NADA_H
 #define MP_BUFFER_NADA_H
 
-#include "mp-nada-base.h"
+#include "mp-strategy.h"
+
+#include <array>
 
 namespace ns3
 {
 
-class MultiPathNadaBufferAwareClient : public MultiPathNadaClientBase
+class MultiPathNadaBufferAwareClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaBufferAwareClient>
 {
 public:
     static TypeId GetTypeId(void);
@@ -14,19 +17,30 @@ public:
     MultiPathNadaBufferAwareClient();
     virtual ~MultiPathNadaBufferAwareClient();
 
-    virtual bool Send(Ptr<Packet> packet) override;
     virtual std::string GetStrategyName() const override { return "BUFFER_AWARE"; }
     virtual void UpdateWeights() override;
 
+    static const bool REQUIRE_SOCKET_READY = true;
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+
     void SetBufferAwareParameters(double targetBufferLength, double bufferWeightFactor);
 
+protected:
+    virtual void OnFeedback(uint32_t pathId, const NadaFeedback& feedback) override;
+
 private:
     double m_targetBufferLength;
     double m_bufferWeightFactor;
 
-    double CalculateBufferWeight(double currentBufferMs, uint32_t pathId);
+    bool m_hasRemoteState;          // A feedback report carried the receiver's buffer state
+    Time m_remoteBufferDepth;       // Latest reported playout buffer depth
+    Time m_remotePlayoutTarget;     // Latest reported playout target
+    uint32_t m_remoteUnderruns;     // Latest reported underrun count
+    bool m_underrunPending;         // An underrun was reported since the last UpdateWeights
+    std::array<double, PathTable::MAX_PATHS> m_pathMetrics; // Combined weight by table index
+
+    double CalculateBufferWeight(double bufferRatio, uint32_t pathId);
     uint32_t GetBufferAwarePath(const std::vector<uint32_t>& readyPaths);
-    uint32_t GetBestPathByRTT();
 };
 
 } // namespace ns3
@@ -0,0 +1,328 @@
+#include "mp-deficit.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultiPathNadaDeficitClient");
+NS_OBJECT_ENSURE_REGISTERED(MultiPathNadaDeficitClient);
+
+TypeId
+MultiPathNadaDeficitClient::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::MultiPathNadaDeficitClient")
+                           .SetParent<MultiPathNadaClientBase>()
+                           .SetGroupName("Applications")
+                           .AddConstructor<MultiPathNadaDeficitClient>()
+                           .AddAttribute("MaxBurst",
+                                         "Credit a path may accumulate while idle, "
+                                         "expressed as time at the path rate",
+                                         TimeValue(MilliSeconds(20)),
+                                         MakeTimeAccessor(&MultiPathNadaDeficitClient::m_maxBurst),
+                                         MakeTimeChecker())
+                           .AddAttribute("MaxQueueSize",
+                                         "Bytes that may wait for path credit before "
+                                         "new packets are refused",
+                                         UintegerValue(150000),
+                                         MakeUintegerAccessor(&MultiPathNadaDeficitClient::m_maxQueueBytes),
+                                         MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+MultiPathNadaDeficitClient::MultiPathNadaDeficitClient()
+    : m_queuedBytes(0),
+      m_maxQueueBytes(150000),
+      m_maxBurst(MilliSeconds(20))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MultiPathNadaDeficitClient::~MultiPathNadaDeficitClient()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+MultiPathNadaDeficitClient::GetQueuedBytes(void) const
+{
+    return m_queuedBytes;
+}
+
+void
+MultiPathNadaDeficitClient::UpdateWeights()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_paths.empty())
+    {
+        return;
+    }
+
+    // Weights only describe the split for the stats; selection uses the buckets
+    double totalRate = 0.0;
+    for (const auto& pathPair : m_paths)
+    {
+        totalRate += GetPathRate(pathPair.second);
+    }
+
+    for (auto& pathPair : m_paths)
+    {
+        pathPair.second.weight = (totalRate > 0.0)
+                                     ? GetPathRate(pathPair.second) / totalRate
+                                     : 1.0 / m_paths.size();
+
+        NS_LOG_DEBUG("DEFICIT - Path " << pathPair.first
+                    << " rate: " << GetPathRate(pathPair.second) / 1e6 << "Mbps"
+                    << ", weight: " << pathPair.second.weight
+                    << ", credit: " << m_buckets[pathPair.first].credit << " bytes");
+    }
+
+    NS_LOG_INFO("DEFICIT - Total rate: " << totalRate / 1e6 << "Mbps, queued: "
+               << m_queuedBytes << " bytes");
+}
+
+bool
+MultiPathNadaDeficitClient::Send(Ptr<Packet> packet)
+{
+    if (!m_running || m_totalPacketsSent + m_queue.size() >= m_maxPackets)
+    {
+        return false;
+    }
+
+    const std::vector<uint32_t>& readyPaths = GetReadyPaths();
+    if (readyPaths.empty())
+    {
+        NS_LOG_WARN("DEFICIT - No ready paths available");
+        return false;
+    }
+
+    if (!packet)
+    {
+        packet = Create<Packet>(m_packetSize);
+    }
+
+    QueuedPacket entry = {packet,
+                          m_currentFrameId,
+                          m_packetIndex,
+                          m_packetsInFrame,
+                          m_sourcePackets,
+                          m_isKeyFrame};
+
+    // Packets already waiting keep their order
+    if (m_queue.empty())
+    {
+        RefillBuckets(readyPaths);
+        uint32_t pathId = GetMostCreditPath(readyPaths);
+        if (m_buckets[pathId].credit >= 0.0)
+        {
+            return SendQueuedPacket(pathId, entry);
+        }
+    }
+
+    if (m_queuedBytes + packet->GetSize() > m_maxQueueBytes)
+    {
+        NS_LOG_WARN("DEFICIT - Queue full (" << m_queuedBytes << " bytes), refusing packet");
+        return false;
+    }
+
+    m_queue.push_back(entry);
+    m_queuedBytes += packet->GetSize();
+    ScheduleDrain(readyPaths);
+    return true;
+}
+
+double
+MultiPathNadaDeficitClient::GetPathRate(const PathInfo& path) const
+{
+    if (path.nada)
+    {
+        return path.nada->GetCurrentRate().GetBitRate();
+    }
+    return path.currentRate.GetBitRate();
+}
+
+void
+MultiPathNadaDeficitClient::RefillBuckets(const std::vector<uint32_t>& readyPaths)
+{
+    Time now = Simulator::Now();
+
+    for (uint32_t pathId : readyPaths)
+    {
+        double rate = GetPathRate(m_paths[pathId]);
+        double burst = std::max<double>(rate / 8.0 * m_maxBurst.GetSeconds(), m_packetSize);
+
+        auto inserted = m_buckets.insert(std::make_pair(pathId, Bucket{0.0, now}));
+        Bucket& bucket = inserted.first->second;
+        if (inserted.second)
+        {
+            // A new path may send one packet right away
+            bucket.credit = m_packetSize;
+            continue;
+        }
+
+        bucket.credit += rate / 8.0 * (now - bucket.lastRefill).GetSeconds();
+        bucket.credit = std::min(bucket.credit, burst);
+        bucket.lastRefill = now;
+    }
+}
+
+uint32_t
+MultiPathNadaDeficitClient::GetMostCreditPath(const std::vector<uint32_t>& readyPaths) const
+{
+    uint32_t bestPath = readyPaths.front();
+    double bestCredit = -std::numeric_limits<double>::max();
+
+    for (uint32_t pathId : readyPaths)
+    {
+        auto it = m_buckets.find(pathId);
+        double credit = (it != m_buckets.end()) ? it->second.credit : 0.0;
+        if (credit > bestCredit)
+        {
+            bestCredit = credit;
+            bestPath = pathId;
+        }
+    }
+
+    return bestPath;
+}
+
+bool
+MultiPathNadaDeficitClient::SendQueuedPacket(uint32_t pathId, const QueuedPacket& entry)
+{
+    // Queued packets carry the frame they were queued for, not the current one
+    uint32_t frameId = m_currentFrameId;
+    uint16_t packetIndex = m_packetIndex;
+    uint16_t packetsInFrame = m_packetsInFrame;
+    uint16_t sourcePackets = m_sourcePackets;
+    bool isKeyFrame = m_isKeyFrame;
+
+    m_currentFrameId = entry.frameId;
+    m_packetIndex = entry.packetIndex;
+    m_packetsInFrame = entry.packetsInFrame;
+    m_sourcePackets = entry.sourcePackets;
+    m_isKeyFrame = entry.isKeyFrame;
+
+    bool sent = SendPacketOnPath(pathId, entry.packet);
+
+    m_currentFrameId = frameId;
+    m_packetIndex = packetIndex;
+    m_packetsInFrame = packetsInFrame;
+    m_sourcePackets = sourcePackets;
+    m_isKeyFrame = isKeyFrame;
+
+    if (sent)
+    {
+        // Charge the bytes that went on the wire, header included
+        m_buckets[pathId].credit -= entry.packet->GetSize();
+
+        NS_LOG_DEBUG("DEFICIT - Sent " << entry.packet->GetSize() << " bytes on path "
+                    << pathId << ", credit left: " << m_buckets[pathId].credit);
+    }
+
+    return sent;
+}
+
+void
+MultiPathNadaDeficitClient::DrainQueue(void)
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    const std::vector<uint32_t>& readyPaths = GetReadyPaths();
+    if (readyPaths.empty())
+    {
+        ScheduleDrain(readyPaths);
+        return;
+    }
+
+    RefillBuckets(readyPaths);
+    while (!m_queue.empty())
+    {
+        uint32_t pathId = GetMostCreditPath(readyPaths);
+        if (m_buckets[pathId].credit < 0.0)
+        {
+            break;
+        }
+
+        QueuedPacket entry = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_queuedBytes -= entry.packet->GetSize();
+
+        if (!SendQueuedPacket(pathId, entry))
+        {
+            NS_LOG_WARN("DEFICIT - Dropping queued packet, send failed on path " << pathId);
+        }
+    }
+
+    if (!m_queue.empty())
+    {
+        ScheduleDrain(readyPaths);
+    }
+}
+
+void
+MultiPathNadaDeficitClient::ScheduleDrain(const std::vector<uint32_t>& readyPaths)
+{
+    if (m_drainEvent.IsPending())
+    {
+        return;
+    }
+
+    // Wake up when the first bucket is back to zero
+    double wait = m_maxBurst.GetSeconds();
+    for (uint32_t pathId : readyPaths)
+    {
+        double rate = GetPathRate(m_paths[pathId]);
+        if (rate <= 0.0)
+        {
+            continue;
+        }
+        double credit = m_buckets[pathId].credit;
+        wait = std::min(wait, std::max(0.0, -credit * 8.0 / rate));
+    }
+
+    Time delay = std::max(Seconds(wait), MicroSeconds(1));
+    m_drainEvent = Simulator::Schedule(delay, &MultiPathNadaDeficitClient::DrainQueue, this);
+}
+
+void
+MultiPathNadaDeficitClient::StopApplication(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_drainEvent.IsPending())
+    {
+        Simulator::Cancel(m_drainEvent);
+    }
+
+    m_queue.clear();
+    m_queuedBytes = 0;
+
+    MultiPathNadaClientBase::StopApplication();
+}
+
+void
+MultiPathNadaDeficitClient::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_drainEvent.IsPending())
+    {
+        Simulator::Cancel(m_drainEvent);
+    }
+
+    m_queue.clear();
+    m_buckets.clear();
+
+    MultiPathNadaClientBase::DoDispose();
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+#ifndef MP_DEFICIT_NADA_H
+#define MP_DEFICIT_NADA_H
+
+#include "mp-nada-base.h"
+#include "ns3/nada-ring-queue.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Byte-accurate multipath strategy driven by each path's NADA rate
+ *
+ * Every path owns a token bucket that is refilled at the rate its
+ * NadaCongestionControl currently allows. A packet goes to the path with the
+ * most credit and its size in bytes is charged to that path, so the traffic
+ * split follows the path rates regardless of packet sizes. When no path has
+ * credit left the packet waits in a bounded queue and is released as soon as
+ * a bucket refills, which keeps the aggregate close to the sum of path rates
+ * without building queues in the network.
+ */
+class MultiPathNadaDeficitClient : public MultiPathNadaClientBase
+{
+public:
+    static TypeId GetTypeId(void);
+
+    MultiPathNadaDeficitClient();
+    virtual ~MultiPathNadaDeficitClient();
+
+    virtual bool Send(Ptr<Packet> packet) override;
+    virtual std::string GetStrategyName() const override { return "DEFICIT"; }
+    virtual void UpdateWeights() override;
+
+    /**
+     * \brief Get the bytes waiting for credit
+     * \return Queued bytes
+     */
+    uint32_t GetQueuedBytes(void) const;
+
+protected:
+    virtual void StopApplication(void) override;
+    virtual void DoDispose(void) override;
+
+private:
+    struct Bucket
+    {
+        double credit;      // Bytes the path may still send (negative = deficit)
+        Time lastRefill;    // Last time credit was added
+    };
+
+    struct QueuedPacket
+    {
+        Ptr<Packet> packet;
+        uint32_t frameId;
+        uint16_t packetIndex;
+        uint16_t packetsInFrame;
+        uint16_t sourcePackets;
+        bool isKeyFrame;
+    };
+
+    double GetPathRate(const PathInfo& path) const;
+    void RefillBuckets(const std::vector<uint32_t>& readyPaths);
+    uint32_t GetMostCreditPath(const std::vector<uint32_t>& readyPaths) const;
+    bool SendQueuedPacket(uint32_t pathId, const QueuedPacket& entry);
+    void DrainQueue(void);
+    void ScheduleDrain(const std::vector<uint32_t>& readyPaths);
+
+    std::map<uint32_t, Bucket> m_buckets;   // Token bucket of every path
+    NadaRingQueue<QueuedPacket> m_queue;    // Packets waiting for credit
+    uint32_t m_queuedBytes;                 // Bytes in m_queue
+    uint32_t m_maxQueueBytes;               // Queue limit; packets beyond it are refused
+    Time m_maxBurst;                        // Credit a path may bank, as time at its rate
+    EventId m_drainEvent;                   // Releases queued packets when credit is back
+};
+
+} // namespace ns3
+
+#endif /* MP_DEFICIT_NADA_H */
@@ -0,0 +1,171 @@
+#include "mp-ecf.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultiPathNadaEarliestArrivalClient");
+NS_OBJECT_ENSURE_REGISTERED(MultiPathNadaEarliestArrivalClient);
+
+TypeId
+MultiPathNadaEarliestArrivalClient::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::MultiPathNadaEarliestArrivalClient")
+                           .SetParent<MultiPathNadaClientBase>()
+                           .SetGroupName("Applications")
+                           .AddConstructor<MultiPathNadaEarliestArrivalClient>();
+    return tid;
+}
+
+MultiPathNadaEarliestArrivalClient::MultiPathNadaEarliestArrivalClient()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MultiPathNadaEarliestArrivalClient::~MultiPathNadaEarliestArrivalClient()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultiPathNadaEarliestArrivalClient::UpdateWeights()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_paths.empty())
+    {
+        return;
+    }
+
+    // Weights only describe the expected split for the stats; selection
+    // uses the arrival estimates
+    double totalRate = 0.0;
+    for (const auto& pathPair : m_paths)
+    {
+        totalRate += GetPathRate(pathPair.second);
+    }
+
+    for (auto& pathPair : m_paths)
+    {
+        pathPair.second.weight = (totalRate > 0.0)
+                                     ? GetPathRate(pathPair.second) / totalRate
+                                     : 1.0 / m_paths.size();
+
+        NS_LOG_DEBUG("EARLIEST_ARRIVAL - Path " << pathPair.first
+                    << " delay: " << GetOneWayDelay(pathPair.second).GetMilliSeconds() << "ms"
+                    << ", rate: " << GetPathRate(pathPair.second) / 1e6 << "Mbps"
+                    << ", arrival estimate: "
+                    << EstimateArrival(pathPair.first, m_packetSize).GetMilliSeconds() << "ms");
+    }
+}
+
+uint32_t
+MultiPathNadaEarliestArrivalClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size)
+{
+    // Ties go to the path with the lower delay, so a slow path is only used
+    // when it actually brings the packet in earlier
+    uint32_t selectedPath = readyPaths.front();
+    Time bestArrival = Time::Max();
+    Time bestDelay = Time::Max();
+    for (uint32_t pathId : readyPaths)
+    {
+        Time arrival = EstimateArrival(pathId, size);
+        Time delay = GetOneWayDelay(m_paths[pathId]);
+        if (arrival < bestArrival || (arrival == bestArrival && delay < bestDelay))
+        {
+            bestArrival = arrival;
+            bestDelay = delay;
+            selectedPath = pathId;
+        }
+    }
+    return selectedPath;
+}
+
+void
+MultiPathNadaEarliestArrivalClient::OnPacketSent(const std::vector<uint32_t>&,
+                                                 uint32_t pathId,
+                                                 uint32_t size)
+{
+    const PathInfo& path = m_paths[pathId];
+    double rate = GetPathRate(path);
+    if (rate > 0.0)
+    {
+        m_busyUntil[pathId] = GetTransmitStart(pathId, path, rate) + Seconds(size * 8.0 / rate);
+    }
+
+    NS_LOG_DEBUG("EARLIEST_ARRIVAL - Sent packet on path " << pathId
+                << ", expected arrival in "
+                << (m_busyUntil[pathId] + GetOneWayDelay(path) - Simulator::Now()).GetMilliSeconds()
+                << "ms");
+}
+
+Time
+MultiPathNadaEarliestArrivalClient::EstimateArrival(uint32_t pathId, uint32_t size) const
+{
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end())
+    {
+        return Time::Max();
+    }
+
+    double rate = GetPathRate(it->second);
+    if (rate <= 0.0)
+    {
+        return Time::Max();
+    }
+
+    return GetTransmitStart(pathId, it->second, rate) + Seconds(size * 8.0 / rate) +
+           GetOneWayDelay(it->second);
+}
+
+double
+MultiPathNadaEarliestArrivalClient::GetPathRate(const PathInfo& path) const
+{
+    if (path.nada)
+    {
+        return path.nada->GetCurrentRate().GetBitRate();
+    }
+    return path.currentRate.GetBitRate();
+}
+
+Time
+MultiPathNadaEarliestArrivalClient::GetOneWayDelay(const PathInfo& path) const
+{
+    if (path.lastDelay.IsStrictlyPositive())
+    {
+        return path.lastDelay;
+    }
+    return path.lastRtt / 2;
+}
+
+Time
+MultiPathNadaEarliestArrivalClient::GetTransmitStart(uint32_t pathId,
+                                                     const PathInfo& path,
+                                                     double rate) const
+{
+    Time now = Simulator::Now();
+    Time start = now;
+
+    // Bytes handed to the path that its rate has not drained yet
+    auto it = m_busyUntil.find(pathId);
+    if (it != m_busyUntil.end() && it->second > start)
+    {
+        start = it->second;
+    }
+
+    // In-flight bytes beyond one bandwidth-delay product are queued somewhere
+    // along the path; this catches a path that slowed down since we last sent
+    double bdpBytes = rate / 8.0 * path.lastRtt.GetSeconds();
+    double queuedBytes = path.history.GetInFlightBytes() - bdpBytes;
+    if (queuedBytes > 0.0)
+    {
+        start = std::max(start, now + Seconds(queuedBytes * 8.0 / rate));
+    }
+
+    return start;
+}
+
+} // namespace ns3
@@ -0,0 +1,66 @@
+#ifndef MP_ECF_NADA_H
+#define MP_ECF_NADA_H
+
+#include "mp-strategy.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Earliest-arrival multipath strategy (BLEST/ECF style)
+ *
+ * For every packet the strategy estimates when it would reach the receiver
+ * on each path: the one-way delay of the path plus the time needed to drain
+ * the bytes already queued on it at its current NADA rate. The packet goes
+ * to the path with the earliest estimate. Since the packets of a frame are
+ * sent back to back, this fills the fast path first and only spills onto a
+ * slower path once doing so no longer delays the end of the frame, so the
+ * receiver does not wait on the slow path to complete frames.
+ */
+class MultiPathNadaEarliestArrivalClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaEarliestArrivalClient>
+{
+public:
+    static TypeId GetTypeId(void);
+
+    MultiPathNadaEarliestArrivalClient();
+    virtual ~MultiPathNadaEarliestArrivalClient();
+
+    virtual std::string GetStrategyName() const override { return "EARLIEST_ARRIVAL"; }
+    virtual void UpdateWeights() override;
+
+    /**
+     * \brief Pick the ready path with the earliest estimated arrival
+     * \param readyPaths Candidate paths, not empty
+     * \param size Packet size in bytes
+     * \return The selected path ID
+     */
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+
+    /**
+     * \brief Account for the packet queued on the selected path
+     * \param readyPaths The candidates the path was selected from
+     * \param pathId The selected path
+     * \param size Packet size in bytes
+     */
+    void OnPacketSent(const std::vector<uint32_t>& readyPaths, uint32_t pathId, uint32_t size);
+
+    /**
+     * \brief Estimate when a packet sent now would arrive on a path
+     * \param pathId Path to evaluate
+     * \param size Packet size in bytes
+     * \return Estimated arrival time, or Time::Max() if the path has no rate
+     */
+    Time EstimateArrival(uint32_t pathId, uint32_t size) const;
+
+private:
+    double GetPathRate(const PathInfo& path) const;
+    Time GetOneWayDelay(const PathInfo& path) const;
+    Time GetTransmitStart(uint32_t pathId, const PathInfo& path, double rate) const;
+
+    std::map<uint32_t, Time> m_busyUntil; // Time each path finishes sending what it was given
+};
+
+} // namespace ns3
+
+#endif /* MP_ECF_NADA_H */
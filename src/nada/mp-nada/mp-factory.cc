@@ -1,7 +1,10 @@
 #include "mp-factory.h"
 #include "mp-buffer.h"
+#include "mp-deficit.h"
+#include "mp-ecf.h"
 #include "mp-frame.h"
 #include "mp-best.h"
+#include "mp-redundant.h"
 #include "mp-rr.h"
 #include "mp-weighted.h"
 #include "ns3/log.h"
@@ -38,7 +41,18 @@ MultiPathNadaClientFactory::Create(StrategyType strategy)
             NS_LOG_INFO("Creating FRAME_AWARE strategy client");
             return CreateObject<MultiPathNadaFrameAwareClient>();
 
+        case DEFICIT:
+            NS_LOG_INFO("Creating DEFICIT strategy client");
+            return CreateObject<MultiPathNadaDeficitClient>();
+
+        case EARLIEST_ARRIVAL:
+            NS_LOG_INFO("Creating EARLIEST_ARRIVAL strategy client");
+            return CreateObject<MultiPathNadaEarliestArrivalClient>();
+
         case REDUNDANT:
+            NS_LOG_INFO("Creating REDUNDANT strategy client");
+            return CreateObject<MultiPathNadaRedundantClient>();
+
         default:
             NS_LOG_WARN("Unknown strategy " << strategy << ", using WEIGHTED as default");
             return CreateObject<MultiPathNadaWeightedClient>();
@@ -56,6 +70,8 @@ MultiPathNadaClientFactory::GetStrategyName(StrategyType strategy)
         case REDUNDANT: return "REDUNDANT";
         case FRAME_AWARE: return "FRAME_AWARE";
         case BUFFER_AWARE: return "BUFFER_AWARE";
+        case DEFICIT: return "DEFICIT";
+        case EARLIEST_ARRIVAL: return "EARLIEST_ARRIVAL";
         default: return "UNKNOWN";
     }
 }
@@ -16,7 +16,9 @@ public:
         EQUAL = 2,
         REDUNDANT = 3,
         FRAME_AWARE = 4,
-        BUFFER_AWARE = 5
+        BUFFER_AWARE = 5,
+        DEFICIT = 6,
+        EARLIEST_ARRIVAL = 7
     };
 
     static Ptr<MultiPathNadaClientBase> Create(StrategyType strategy);
@@ -1,6 +1,5 @@
 #include "mp-frame.h"
 #include "ns3/log.h"
-#include "ns3/random-variable-stream.h"
 
 namespace ns3
 {
@@ -109,47 +108,13 @@ MultiPathNadaFrameAwareClient::UpdateWeights()
     }
 }
 
-bool
-MultiPathNadaFrameAwareClient::Send(Ptr<Packet> packet)
+uint32_t
+MultiPathNadaFrameAwareClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
 {
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
-    {
-        return false;
-    }
-
-    // Get ready paths
-    std::vector<uint32_t> readyPaths;
-    for (const auto& pathPair : m_paths)
-    {
-        if (pathPair.second.client && pathPair.second.client->GetSocket() &&
-            IsSocketReady(pathPair.second.client->GetSocket()))
-        {
-            readyPaths.push_back(pathPair.first);
-        }
-    }
-
-    if (readyPaths.empty())
-    {
-        return false;
-    }
-
     uint32_t selectedPath = GetFrameAwarePath(readyPaths, m_isKeyFrame);
-
-    if (!packet)
-    {
-        packet = Create<Packet>(m_packetSize);
-    }
-
-    bool sent = SendPacketOnPath(selectedPath, packet);
-    if (sent)
-    {
-        m_totalPacketsSent++;
-
-        NS_LOG_DEBUG("FRAME_AWARE - Sent " << (m_isKeyFrame ? "KEY" : "DELTA")
-                    << " frame packet on path " << selectedPath);
-    }
-
-    return sent;
+    NS_LOG_DEBUG("FRAME_AWARE - Sending " << (m_isKeyFrame ? "KEY" : "DELTA")
+                << " frame packet on path " << selectedPath);
+    return selectedPath;
 }
 
 uint32_t
@@ -207,88 +172,8 @@ MultiPathNadaFrameAwareClient::GetFrameAwarePath(const std::vector<uint32_t>& re
     else
     {
         NS_LOG_DEBUG("FRAME_AWARE - Delta frame: using weighted distribution");
-        return GetWeightedPath(readyPaths);
-    }
-}
-
-uint32_t
-MultiPathNadaFrameAwareClient::GetBestPathByRTT()
-{
-    if (m_paths.empty())
-    {
-        return 0;
-    }
-
-    uint32_t bestPath = m_paths.begin()->first;
-    Time lowestRtt = Time::Max();
-
-    for (auto& pathPair : m_paths)
-    {
-        if (pathPair.second.lastRtt < lowestRtt)
-        {
-            lowestRtt = pathPair.second.lastRtt;
-            bestPath = pathPair.first;
-        }
-    }
-
-    return bestPath;
-}
-
-uint32_t
-MultiPathNadaFrameAwareClient::GetWeightedPath(const std::vector<uint32_t>& readyPaths)
-{
-    if (readyPaths.empty())
-    {
-        return 0;
-    }
-
-    // Calculate total weight of ready paths
-    double totalWeight = 0.0;
-    std::map<uint32_t, double> normalizedWeights;
-
-    for (auto pathId : readyPaths)
-    {
-        auto it = m_paths.find(pathId);
-        if (it != m_paths.end())
-        {
-            totalWeight += it->second.weight;
-            normalizedWeights[pathId] = it->second.weight;
-        }
-    }
-
-    if (totalWeight <= 0.0)
-    {
-        // Use equal weights
-        for (auto pathId : readyPaths)
-        {
-            normalizedWeights[pathId] = 1.0 / readyPaths.size();
-        }
-        totalWeight = 1.0;
+        return SelectWeightedPath(readyPaths);
     }
-    else
-    {
-        // Normalize weights
-        for (auto& pair : normalizedWeights)
-        {
-            pair.second /= totalWeight;
-        }
-    }
-
-    // Select path based on random value
-    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
-    double r = rng->GetValue(0.0, 1.0);
-    double cumulativeProb = 0.0;
-
-    for (auto pathId : readyPaths)
-    {
-        cumulativeProb += normalizedWeights[pathId];
-        if (r <= cumulativeProb)
-        {
-            return pathId;
-        }
-    }
-
-    return readyPaths[0]; // Fallback
 }
 
 } // namespace ns3
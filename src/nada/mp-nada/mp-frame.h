@@ -1,12 +1,13 @@
 #ifndef MP_FRAME_NADA_H
 #define MP_FRAME_NADA_H
 
-#include "mp-nada-base.h"
+#include "mp-strategy.h"
 
 namespace ns3
 {
 
-class MultiPathNadaFrameAwareClient : public MultiPathNadaClientBase
+class MultiPathNadaFrameAwareClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaFrameAwareClient>
 {
 public:
     static TypeId GetTypeId(void);
@@ -14,14 +15,14 @@ public:
     MultiPathNadaFrameAwareClient();
     virtual ~MultiPathNadaFrameAwareClient();
 
-    virtual bool Send(Ptr<Packet> packet) override;
     virtual std::string GetStrategyName() const override { return "FRAME_AWARE"; }
     virtual void UpdateWeights() override;
 
+    static const bool REQUIRE_SOCKET_READY = true;
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+
 private:
     uint32_t GetFrameAwarePath(const std::vector<uint32_t>& readyPaths, bool isKeyFrame);
-    uint32_t GetBestPathByRTT();
-    uint32_t GetWeightedPath(const std::vector<uint32_t>& readyPaths);
 };
 
 } // namespace ns3
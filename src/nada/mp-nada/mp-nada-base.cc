@@ -1,5 +1,7 @@
 #include "mp-nada-base.h"
 #include "ns3/nada-header.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/udp-socket-factory.h"
@@ -7,6 +9,9 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -34,7 +39,140 @@ MultiPathNadaClientBase::GetTypeId(void)
                           "Time between path distribution updates",
                           TimeValue(MilliSeconds(200)),
                           MakeTimeAccessor(&MultiPathNadaClientBase::m_updateInterval),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("SendHistorySize",
+                          "Number of in-flight packets tracked per path",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_sendHistorySize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("LossTimeout",
+                          "Age after which an unacknowledged packet counts as lost",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_lossTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("StaleTimeout",
+                          "Time without feedback, while packets are unacknowledged, "
+                          "after which a path is checked",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_staleTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("PathSelection",
+                          "Weighted path selection: 0=random (alias table), "
+                          "1=smooth weighted round robin",
+                          UintegerValue(PathScheduler::ALIAS),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_pathSelection),
+                          MakeUintegerChecker<uint32_t>(0, 1))
+            .AddAttribute("CouplingMode",
+                          "Coupling of the per-path NADA controllers: 0=independent, "
+                          "1=coupled, 2=coupled on detected shared bottleneck",
+                          UintegerValue(NadaCoupledGroup::UNCOUPLED),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_couplingMode),
+                          MakeUintegerChecker<uint32_t>(0, 2))
+            .AddAttribute("Pacing",
+                          "Queue packets per path and release them at the path NADA rate",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MultiPathNadaClientBase::m_pacingEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("PacingBurst",
+                          "Bytes a path may send back to back after being idle",
+                          UintegerValue(3000),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_pacingBurst),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PacingGranularity",
+                          "Resolution of the pacing timer",
+                          TimeValue(MicroSeconds(250)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_pacingGranularity),
+                          MakeTimeChecker())
+            .AddAttribute("PacingQueueSize",
+                          "Bytes each path pacer may hold before refusing packets",
+                          UintegerValue(500000),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_pacingQueueSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("KeyFramePriority",
+                          "Serve key frame packets ahead of queued delta frames",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&MultiPathNadaClientBase::m_keyFramePriority),
+                          MakeBooleanChecker())
+            .AddAttribute("FecEnabled",
+                          "Protect video frames with forward error correction packets",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MultiPathNadaClientBase::m_fecEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("FecKeyFrameOverhead",
+                          "Repair packets per source packet of a key frame, on top of "
+                          "the worst path loss rate",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&MultiPathNadaClientBase::m_fecKeyOverhead),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("FecDeltaFrameOverhead",
+                          "Repair packets per source packet of a delta frame, on top of "
+                          "the worst path loss rate",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&MultiPathNadaClientBase::m_fecDeltaOverhead),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Retransmission",
+                          "Resend video packets the receiver reports missing",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MultiPathNadaClientBase::m_retransmitEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("PlayoutDeadline",
+                          "Time after a frame is sent at which the receiver plays it out; "
+                          "repairs that would arrive later are not sent",
+                          TimeValue(MilliSeconds(150)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_playoutDeadline),
+                          MakeTimeChecker())
+            .AddAttribute("RetransmitBufferFrames",
+                          "Number of recent frames kept for retransmission",
+                          UintegerValue(32),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_retransmitFrames),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRetransmissions",
+                          "Times a single packet may be sent again",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_maxRetransmissions),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Failover",
+                          "Move traffic off a path as soon as its feedback stops, and probe "
+                          "it until it answers again",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MultiPathNadaClientBase::m_failoverEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("FailoverRttMultiplier",
+                          "Smoothed RTTs without feedback, while packets are in flight, "
+                          "after which a path is declared failed",
+                          DoubleValue(4.0),
+                          MakeDoubleAccessor(&MultiPathNadaClientBase::m_failoverRttMultiplier),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("FailoverMinTimeout",
+                          "Shortest failover timeout; keep it above the receiver AckInterval "
+                          "when ACKs are aggregated",
+                          TimeValue(MilliSeconds(30)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_failoverMinTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("StandbyProbeInterval",
+                          "Time between two probes of a failed path",
+                          TimeValue(MilliSeconds(20)),
+                          MakeTimeAccessor(&MultiPathNadaClientBase::m_probeInterval),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("StandbyProbeSize",
+                          "Payload bytes of a probe of a failed path",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&MultiPathNadaClientBase::m_probeSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("PathSelected",
+                            "A packet was handed to a path: path ID and payload size",
+                            MakeTraceSourceAccessor(&MultiPathNadaClientBase::m_pathSelectedTrace),
+                            "ns3::MultiPathNadaClientBase::PathSelectedTracedCallback")
+            .AddTraceSource("WeightChanged",
+                            "The strategy changed the weight of a path: path ID, old and "
+                            "new weight",
+                            MakeTraceSourceAccessor(&MultiPathNadaClientBase::m_weightChangedTrace),
+                            "ns3::MultiPathNadaClientBase::WeightChangedTracedCallback")
+            .AddTraceSource("PathFailover",
+                            "A path was declared failed or recovered: path ID, whether it "
+                            "failed, and the packets moved off it",
+                            MakeTraceSourceAccessor(&MultiPathNadaClientBase::m_pathFailoverTrace),
+                            "ns3::MultiPathNadaClientBase::PathFailoverTracedCallback");
     return tid;
 }
 
@@ -46,11 +184,48 @@ MultiPathNadaClientBase::MultiPathNadaClientBase()
       m_isKeyFrame(false),
       m_totalRate(DataRate("500kbps")),
       m_totalPacketsSent(0),
+      m_sendPathIndex(0),
+      m_socketsValidated(false),
       m_updateInterval(MilliSeconds(1000)),
-      m_videoReceiver(nullptr),
+      m_lastDistributionUpdate(Seconds(0)),
+      m_currentFrameId(0),
+      m_packetIndex(0),
+      m_packetsInFrame(0),
+      m_sourcePackets(0),
+      m_sendHistorySize(1024),
+      m_lossTimeout(MilliSeconds(500)),
+      m_staleTimeout(Seconds(1)),
+      m_pathSelection(PathScheduler::ALIAS),
+      m_readyVersion(0),
+      m_readyRequireSocket(false),
+      m_couplingMode(NadaCoupledGroup::UNCOUPLED),
+      m_pacingEnabled(false),
+      m_pacingBurst(3000),
+      m_pacingGranularity(MicroSeconds(250)),
+      m_pacingQueueSize(500000),
+      m_keyFramePriority(true),
+      m_fecEnabled(false),
+      m_fecKeyOverhead(0.5),
+      m_fecDeltaOverhead(0.1),
+      m_retransmitEnabled(false),
+      m_playoutDeadline(MilliSeconds(150)),
+      m_retransmitFrames(32),
+      m_maxRetransmissions(1),
+      m_retransmissions(0),
+      m_lateNacks(0),
+      m_failoverEnabled(false),
+      m_failoverRttMultiplier(4.0),
+      m_failoverMinTimeout(MilliSeconds(30)),
+      m_probeInterval(MilliSeconds(20)),
+      m_probeSize(64),
+      m_failovers(0),
+      m_failoverMoved(0),
       m_isVideoMode(false)
 {
     NS_LOG_FUNCTION(this);
+    m_rng = CreateObject<UniformRandomVariable>();
+    m_scheduler.SetRandomStream(m_rng);
+    m_timeouts.SetExpireCallback(MakeCallback(&MultiPathNadaClientBase::HandleTimeout, this));
 }
 
 MultiPathNadaClientBase::~MultiPathNadaClientBase()
@@ -77,10 +252,23 @@ MultiPathNadaClientBase::AddPath(Address localAddress,
     pathInfo.client = CreateObject<UdpNadaClient>();
     pathInfo.nada = CreateObject<NadaCongestionControl>();
     pathInfo.weight = weight;
+    pathInfo.tracedWeight = weight;
     pathInfo.currentRate = initialRate;
     pathInfo.packetsSent = 0;
     pathInfo.packetsAcked = 0;
+    pathInfo.packetsLost = 0;
+    pathInfo.nextSequence = 0;
+    pathInfo.retransmissions = 0;
+    pathInfo.failovers = 0;
+    pathInfo.history.SetCapacity(m_sendHistorySize);
+    pathInfo.history.SetLossCallback(
+        MakeCallback(&MultiPathNadaClientBase::HandlePacketLost, this));
+    pathInfo.pacer.SetRate(initialRate.GetBitRate());
+    pathInfo.pacer.SetBurst(m_pacingBurst);
+    pathInfo.pacer.SetGranularity(m_pacingGranularity);
+    pathInfo.pacer.SetMaxQueueBytes(m_pacingQueueSize);
     pathInfo.lastRtt = MilliSeconds(100);
+    pathInfo.smoothedRtt = Seconds(0);
     pathInfo.lastDelay = MilliSeconds(50);
     pathInfo.localAddress = localAddress;
     pathInfo.remoteAddress = remoteAddress;
@@ -107,6 +295,16 @@ MultiPathNadaClientBase::AddPath(Address localAddress,
         return false;
     }
 
+    if (m_couplingMode != NadaCoupledGroup::UNCOUPLED)
+    {
+        if (!m_coupledGroup)
+        {
+            m_coupledGroup = CreateObject<NadaCoupledGroup>();
+            m_coupledGroup->SetMode(static_cast<NadaCoupledGroup::Mode>(m_couplingMode));
+        }
+        pathInfo.nada->SetCoupledGroup(m_coupledGroup);
+    }
+
     m_paths[pathId] = pathInfo;
     NS_LOG_DEBUG("Added path " << pathId << " successfully");
     return true;
@@ -129,14 +327,16 @@ MultiPathNadaClientBase::RemovePath(uint32_t pathId)
         it->second.client->SetStopTime(Simulator::Now());
     }
 
-    // Remove socket mapping
-    if (it->second.client)
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_SOCKET_INIT));
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_SOCKET_CHECK));
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_STALE));
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_FAILOVER));
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_PROBE));
+
+    // The remaining paths must stop coupling with a controller that is gone
+    if (it->second.nada)
     {
-        Ptr<Socket> socket = it->second.client->GetSocket();
-        if (socket)
-        {
-            m_socketToPathId.erase(socket);
-        }
+        it->second.nada->SetCoupledGroup(nullptr);
     }
 
     m_paths.erase(it);
@@ -190,6 +390,19 @@ MultiPathNadaClientBase::SetKeyFrameStatus(bool isKeyFrame)
     m_isKeyFrame = isKeyFrame;
 }
 
+void
+MultiPathNadaClientBase::SetVideoFrameContext(uint32_t frameId,
+                                              uint16_t packetIndex,
+                                              uint16_t packetsInFrame,
+                                              uint16_t sourcePackets)
+{
+    NS_LOG_FUNCTION(this << frameId << packetIndex << packetsInFrame << sourcePackets);
+    m_currentFrameId = frameId;
+    m_packetIndex = packetIndex;
+    m_packetsInFrame = packetsInFrame;
+    m_sourcePackets = sourcePackets;
+}
+
 bool
 MultiPathNadaClientBase::IsReady(void) const
 {
@@ -198,15 +411,8 @@ MultiPathNadaClientBase::IsReady(void) const
         return false;
     }
 
-    for (const auto& pathPair : m_paths)
-    {
-        if (pathPair.second.client && pathPair.second.client->GetSocket())
-        {
-            return true; // At least one path is available
-        }
-    }
-
-    return false;
+    // At least one path has a socket
+    return m_paths.GetSocketMask() != 0;
 }
 
 DataRate
@@ -237,12 +443,58 @@ MultiPathNadaClientBase::GetPathStats(uint32_t pathId) const
     stats["rate_bps"] = it->second.currentRate.GetBitRate();
     stats["packets_sent"] = it->second.packetsSent;
     stats["packets_acked"] = it->second.packetsAcked;
+    stats["pacer_queue_bytes"] = it->second.pacer.GetQueuedBytes();
+    stats["retransmissions"] = it->second.retransmissions;
+    stats["failed"] = m_paths.IsFailed(pathId) ? 1 : 0;
+    stats["failovers"] = it->second.failovers;
+    stats["packets_lost"] = it->second.packetsLost;
+    stats["inflight_packets"] = it->second.history.GetInFlightPackets();
+    stats["inflight_bytes"] = it->second.history.GetInFlightBytes();
     stats["rtt_ms"] = it->second.lastRtt.GetMilliSeconds();
     stats["delay_ms"] = it->second.lastDelay.GetMilliSeconds();
 
     return stats;
 }
 
+Ptr<NadaCongestionControl>
+MultiPathNadaClientBase::GetPathController(uint32_t pathId) const
+{
+    auto it = m_paths.find(pathId);
+    return it != m_paths.end() ? it->second.nada : nullptr;
+}
+
+void
+MultiPathNadaClientBase::SetMetricsSink(Ptr<NadaMetricsSink> sink, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+    sink->AddSource(name, MakeCallback(&MultiPathNadaClientBase::ReportMetrics, this));
+}
+
+void
+MultiPathNadaClientBase::ReportMetrics(Ptr<NadaMetricsSink> sink)
+{
+    for (const auto& pathPair : m_paths)
+    {
+        for (const auto& stat : GetPathStats(pathPair.first))
+        {
+            sink->Record(pathPair.first, stat.first, stat.second);
+        }
+        const PathInfo& path = pathPair.second;
+        sink->Record(pathPair.first,
+                     "loss_rate",
+                     path.packetsSent > 0 ? static_cast<double>(path.packetsLost) / path.packetsSent
+                                          : 0.0);
+    }
+    sink->Record("total_rate_bps", m_totalRate.GetBitRate());
+    sink->Record("packets_sent", m_totalPacketsSent);
+    sink->Record("paths", m_paths.size());
+    if (m_failoverEnabled)
+    {
+        sink->Record("failovers", m_failovers);
+        sink->Record("failover_packets_moved", m_failoverMoved);
+    }
+}
+
 bool
 MultiPathNadaClientBase::SendPacketOnPath(uint32_t pathId, Ptr<Packet> packet)
 {
@@ -259,6 +511,68 @@ MultiPathNadaClientBase::SendPacketOnPath(uint32_t pathId, Ptr<Packet> packet)
         return false;
     }
 
+    NadaPacer::Item item;
+    item.packet = packet;
+    item.frameId = m_currentFrameId;
+    item.packetIndex = m_packetIndex;
+    item.packetsInFrame = m_packetsInFrame;
+    item.sourcePackets = m_sourcePackets;
+    item.isKeyFrame = m_isKeyFrame;
+
+    // Recorded before the NadaHeader is added, and even if the send fails,
+    // so a NACK or a failover can still resend the packet
+    if ((m_retransmitEnabled || m_failoverEnabled) && m_packetsInFrame > 0)
+    {
+        NadaRetransmitBuffer::Entry entry;
+        entry.frameId = item.frameId;
+        entry.packetIndex = item.packetIndex;
+        entry.packetsInFrame = item.packetsInFrame;
+        entry.sourcePackets = item.sourcePackets;
+        entry.isKeyFrame = item.isKeyFrame;
+        entry.size = packet->GetSize();
+        entry.deadline = Simulator::Now() + m_playoutDeadline;
+        m_retransmitBuffer.Record(entry);
+    }
+
+    // Taken before SendItemOnPath() adds the NadaHeader
+    uint32_t size = packet->GetSize();
+    if (SendItemOnPath(pathId, item, m_keyFramePriority && m_isKeyFrame))
+    {
+        m_totalPacketsSent++;
+        m_pathSelectedTrace(pathId, size);
+        return true;
+    }
+    return false;
+}
+
+bool
+MultiPathNadaClientBase::SendItemOnPath(uint32_t pathId, const NadaPacer::Item& item, bool priority)
+{
+    if (m_pacingEnabled)
+    {
+        // Accepted packets count as sent; the pacer decides when they leave
+        auto it = m_paths.find(pathId);
+        if (it == m_paths.end() || !it->second.pacer.Enqueue(item, priority))
+        {
+            NS_LOG_DEBUG("Pacer full on path " << pathId);
+            return false;
+        }
+        ServicePacers();
+        return true;
+    }
+
+    return TransmitOnPath(pathId, item);
+}
+
+bool
+MultiPathNadaClientBase::TransmitOnPath(uint32_t pathId, const NadaPacer::Item& item)
+{
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end() || !it->second.client)
+    {
+        return false;
+    }
+
     Ptr<Socket> socket = it->second.client->GetSocket();
     if (!socket)
     {
@@ -272,37 +586,114 @@ MultiPathNadaClientBase::SendPacketOnPath(uint32_t pathId, Ptr<Packet> packet)
     {
         // Add proper NADA header
         NadaHeader header;
-        header.SetSequenceNumber(m_totalPacketsSent);
+        uint32_t seq = it->second.nextSequence++;
+        header.SetSequenceNumber(seq);
         header.SetTimestamp(MicroSeconds(Simulator::Now().GetMicroSeconds()));
 
         if (m_isVideoMode)
         {
-            header.SetVideoFrameType(m_isKeyFrame ? 0 : 1);
-            header.SetVideoFrameSize(packet->GetSize());
+            header.SetVideoFrameType(item.isKeyFrame ? 0 : 1);
+            header.SetVideoFrameSize(item.packet->GetSize());
+            if (item.packetsInFrame > 0)
+            {
+                header.SetVideoFrameInfo(item.frameId, item.packetIndex, item.packetsInFrame);
+            }
+            if (item.sourcePackets > 0 && item.sourcePackets < item.packetsInFrame)
+            {
+                header.SetFecInfo(item.sourcePackets);
+            }
         }
 
-        packet->AddHeader(header);
+        item.packet->AddHeader(header);
 
-        int sent = socket->Send(packet);
+        int sent = socket->Send(item.packet);
         if (sent > 0)
         {
             it->second.packetsSent++;
-            m_totalPacketsSent++;
+            it->second.history.Record(seq,
+                                      Simulator::Now(),
+                                      item.packet->GetSize(),
+                                      item.frameId,
+                                      pathId,
+                                      item.packetIndex,
+                                      item.packetsInFrame);
+
+            // Feedback pushes the timers back, so a busy path does not re-arm them here
+            uint32_t staleKey = GetTimerKey(pathId, TIMER_STALE);
+            if (!m_timeouts.IsPending(staleKey))
+            {
+                m_timeouts.Schedule(staleKey, m_staleTimeout);
+            }
+            uint32_t failoverKey = GetTimerKey(pathId, TIMER_FAILOVER);
+            if (m_failoverEnabled && !m_timeouts.IsPending(failoverKey) && !m_paths.IsFailed(pathId))
+            {
+                m_timeouts.Schedule(failoverKey, GetFailoverTimeout(it->second));
+            }
             return true;
         }
         else
         {
             NS_LOG_DEBUG("Send failed for path " << pathId << ", but keeping socket");
+            // A broken socket leaves the ready paths until it is reinitialized
+            m_paths.SetSocketState(pathId, true, IsSocketReady(socket));
             return false;
         }
     }
     catch (const std::exception& e)
     {
-        NS_LOG_DEBUG("Exception in SendPacketOnPath for path " << pathId << ": " << e.what());
+        NS_LOG_DEBUG("Exception in TransmitOnPath for path " << pathId << ": " << e.what());
         return false;
     }
 }
 
+void
+MultiPathNadaClientBase::ServicePacers(void)
+{
+    Time now = Simulator::Now();
+    Time next = Time::Max();
+
+    for (auto& pathPair : m_paths)
+    {
+        PathInfo& path = pathPair.second;
+        if (path.pacer.IsEmpty())
+        {
+            continue;
+        }
+
+        path.pacer.SetRate(path.nada ? path.nada->GetCurrentRate().GetBitRate()
+                                     : path.currentRate.GetBitRate());
+
+        NadaPacer::Item item;
+        while (path.pacer.Dequeue(now, item))
+        {
+            if (!TransmitOnPath(pathPair.first, item))
+            {
+                NS_LOG_DEBUG("Dropping paced packet, send failed on path " << pathPair.first);
+            }
+        }
+
+        next = std::min(next, path.pacer.GetNextSendTime(now));
+    }
+
+    if (next == Time::Max())
+    {
+        return;
+    }
+
+    // One timer serves every path; only move it if this path needs it sooner
+    if (m_pacerEvent.IsPending())
+    {
+        if (m_pacerWakeup <= next)
+        {
+            return;
+        }
+        Simulator::Cancel(m_pacerEvent);
+    }
+
+    m_pacerWakeup = next;
+    m_pacerEvent = Simulator::Schedule(next - now, &MultiPathNadaClientBase::ServicePacers, this);
+}
+
 void
 MultiPathNadaClientBase::SetNadaAdaptability(uint32_t pathId,
                                              DataRate minRate,
@@ -339,21 +730,26 @@ MultiPathNadaClientBase::SendVideoFrame(uint32_t frameId,
     }
 
     uint32_t numPacketsNeeded = (frameSize + mtu - 1) / mtu;
+    uint32_t repairPackets = GetRepairPackets(numPacketsNeeded, isKeyFrame);
+    uint32_t packetsInFrame = numPacketsNeeded + repairPackets;
 
     NS_LOG_INFO("MP: Sending " << (isKeyFrame ? "key" : "delta")
                << " frame #" << frameId
-               << " (size: " << frameSize << " bytes, packets: " << numPacketsNeeded << ")");
+               << " (size: " << frameSize << " bytes, packets: " << numPacketsNeeded
+               << ", repair: " << repairPackets << ")");
 
     // Set video mode for this frame
     SetVideoMode(true);
     SetKeyFrameStatus(isKeyFrame);
     SetPacketSize(mtu);
 
+    uint16_t sourcePackets = (repairPackets > 0) ? numPacketsNeeded : 0;
     uint32_t packetsSent = 0;
 
     for (uint32_t i = 0; i < numPacketsNeeded; i++)
     {
         Ptr<Packet> packet = Create<Packet>(mtu);
+        SetVideoFrameContext(frameId, i, packetsInFrame, sourcePackets);
 
         bool sent = Send(packet);
         if (sent)
@@ -367,62 +763,167 @@ MultiPathNadaClientBase::SendVideoFrame(uint32_t frameId,
         }
     }
 
+    // Repair packets are still worth sending after a refused source packet:
+    // any numPacketsNeeded of the frame's packets rebuild it
+    uint32_t repairSent = 0;
+    if (repairPackets > 0)
+    {
+        SetVideoFrameContext(frameId, numPacketsNeeded, packetsInFrame, sourcePackets);
+        repairSent = SendRepairPackets(repairPackets, mtu);
+    }
+
     NS_LOG_INFO("MP: Frame " << frameId << " complete: " << packetsSent
-               << "/" << numPacketsNeeded << " packets sent");
+               << "/" << numPacketsNeeded << " packets sent, " << repairSent
+               << "/" << repairPackets << " repair packets sent");
 
-    return (packetsSent == numPacketsNeeded);
+    return (packetsSent + repairSent == packetsInFrame);
 }
 
-bool
-MultiPathNadaClientBase::Send(Ptr<Packet> packet)
+void
+MultiPathNadaClientBase::UpdateVideoFrameInfo(uint32_t frameSize, bool isKeyFrame, Time frameInterval)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << frameSize << isKeyFrame << frameInterval);
 
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
+    double totalRateBps = 0.0;
+    for (const auto& pathPair : m_paths)
     {
-        return false;
+        if (pathPair.second.nada)
+        {
+            totalRateBps += pathPair.second.nada->GetCurrentRate().GetBitRate();
+        }
     }
 
-    if (!IsReady())
+    for (auto& pathPair : m_paths)
     {
-        NS_LOG_WARN("Client not ready for sending");
-        return false;
+        Ptr<NadaCongestionControl> nada = pathPair.second.nada;
+        if (!nada)
+        {
+            continue;
+        }
+        double share = (totalRateBps > 0.0) ? nada->GetCurrentRate().GetBitRate() / totalRateBps
+                                            : 1.0 / m_paths.size();
+        nada->UpdateVideoFrameInfo(static_cast<uint32_t>(frameSize * share),
+                                   isKeyFrame,
+                                   frameInterval);
+    }
+}
+
+uint32_t
+MultiPathNadaClientBase::GetRepairPackets(uint32_t sourcePackets, bool isKeyFrame) const
+{
+    if (!m_fecEnabled || sourcePackets == 0)
+    {
+        return 0;
     }
 
-    std::vector<uint32_t> availablePaths;
+    // Cover the worst path's losses, so the frame survives even if the
+    // scheduler put most of it there
+    double worstLoss = 0.0;
     for (const auto& pathPair : m_paths)
     {
-        if (pathPair.second.client && pathPair.second.client->GetSocket())
+        if (pathPair.second.nada)
         {
-            availablePaths.push_back(pathPair.first);
+            worstLoss = std::max(worstLoss, pathPair.second.nada->GetLossRate());
         }
     }
 
+    double overhead = (isKeyFrame ? m_fecKeyOverhead : m_fecDeltaOverhead) + worstLoss;
+    uint32_t repair = static_cast<uint32_t>(std::ceil(sourcePackets * overhead));
+
+    // Both counts travel as 16-bit header fields
+    return std::min<uint32_t>(repair, 0xffff - std::min<uint32_t>(sourcePackets, 0xffff));
+}
+
+uint32_t
+MultiPathNadaClientBase::SendRepairPackets(uint32_t repairPackets, uint32_t mtu)
+{
+    const std::vector<uint32_t>& readyPaths = GetReadyPaths();
+    if (readyPaths.empty())
+    {
+        NS_LOG_WARN("No ready paths for " << repairPackets << " repair packets");
+        return 0;
+    }
+
+    m_repairCounts.assign(readyPaths.size(), 0);
+
+    uint16_t firstIndex = m_packetIndex;
+    uint32_t sent = 0;
+    for (uint32_t i = 0; i < repairPackets; i++)
+    {
+        size_t best = 0;
+        double bestScore = -1.0;
+        for (size_t p = 0; p < readyPaths.size(); p++)
+        {
+            double loss = m_paths[readyPaths[p]].nada->GetLossRate();
+            double score = (1.0 - loss) / (1.0 + m_repairCounts[p]);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = p;
+            }
+        }
+
+        m_packetIndex = firstIndex + i;
+        if (!SendPacketOnPath(readyPaths[best], Create<Packet>(mtu)))
+        {
+            NS_LOG_WARN("Failed to send repair packet " << m_packetIndex << " of frame "
+                        << m_currentFrameId << " on path " << readyPaths[best]);
+            break;
+        }
+        m_repairCounts[best]++;
+        sent++;
+    }
+
+    NS_LOG_DEBUG("Sent " << sent << " repair packets of frame " << m_currentFrameId
+                 << " over " << readyPaths.size() << " paths");
+    return sent;
+}
+
+bool
+MultiPathNadaClientBase::Send(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!CanSend())
+    {
+        return false;
+    }
+
+    // Cached between path changes, so this does not allocate
+    const std::vector<uint32_t>& availablePaths = GetReadyPaths();
     if (availablePaths.empty())
     {
         NS_LOG_ERROR("No available paths for sending");
         return false;
     }
 
-    // Simple round-robin for base class
-    static uint32_t currentPathIndex = 0;
-    uint32_t selectedPath = availablePaths[currentPathIndex % availablePaths.size()];
-    currentPathIndex++;
+    // Simple round-robin for base class; SendPacketOnPath() counts the packet
+    uint32_t selectedPath = availablePaths[m_sendPathIndex % availablePaths.size()];
+    m_sendPathIndex++;
 
-    bool sent = SendPacketOnPath(selectedPath, packet);
-    if (sent)
+    return SendPacketOnPath(selectedPath, packet);
+}
+
+bool
+MultiPathNadaClientBase::CanSend(void) const
+{
+    if (!m_running || m_totalPacketsSent >= m_maxPackets)
     {
-        m_totalPacketsSent++;
+        return false;
     }
 
-    return sent;
+    if (!IsReady())
+    {
+        NS_LOG_WARN("Client not ready for sending");
+        return false;
+    }
+    return true;
 }
 
 void
-MultiPathNadaClientBase::SetVideoReceiver(Ptr<VideoReceiver> receiver)
+MultiPathNadaClientBase::WarnNoReadyPaths(const std::string& strategyName) const
 {
-    NS_LOG_FUNCTION(this << receiver);
-    m_videoReceiver = receiver;
+    NS_LOG_WARN(strategyName << " - No ready paths available");
 }
 
 void
@@ -430,8 +931,7 @@ MultiPathNadaClientBase::ValidateAllSockets(void)
 {
     NS_LOG_FUNCTION(this);
 
-    static bool hasValidated = false;
-    if (hasValidated)
+    if (m_socketsValidated)
     {
         NS_LOG_DEBUG("Sockets already validated, skipping re-validation");
         return;
@@ -458,7 +958,7 @@ MultiPathNadaClientBase::ValidateAllSockets(void)
 
     if (readyCount == totalCount && readyCount > 0)
     {
-        hasValidated = true;
+        m_socketsValidated = true;
         NS_LOG_INFO("All sockets validated successfully - will not re-validate");
 
         for (auto& pathPair : m_paths)
@@ -497,6 +997,71 @@ MultiPathNadaClientBase::GetPacketSize(void) const
     return m_packetSize;
 }
 
+uint32_t
+MultiPathNadaClientBase::GetTotalPacketsSent(void) const
+{
+    return m_totalPacketsSent;
+}
+
+int64_t
+MultiPathNadaClientBase::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_rng->SetStream(stream);
+    return 1;
+}
+
+const std::vector<uint32_t>&
+MultiPathNadaClientBase::GetReadyPaths(bool requireSocketReady)
+{
+    if (m_readyVersion == m_paths.GetVersion() && m_readyRequireSocket == requireSocketReady)
+    {
+        return m_readyPaths;
+    }
+
+    uint64_t mask = requireSocketReady ? m_paths.GetReadyMask() : m_paths.GetSocketMask();
+    mask &= ~m_paths.GetFailedMask();
+    m_readyPaths.clear();
+    for (auto it = m_paths.begin(); it != m_paths.end(); ++it)
+    {
+        if (mask & (uint64_t(1) << m_paths.GetIndex(it)))
+        {
+            m_readyPaths.push_back(it->first);
+        }
+    }
+    m_readyVersion = m_paths.GetVersion();
+    m_readyRequireSocket = requireSocketReady;
+    return m_readyPaths;
+}
+
+uint32_t
+MultiPathNadaClientBase::SelectWeightedPath(const std::vector<uint32_t>& readyPaths)
+{
+    if (readyPaths.empty())
+    {
+        return 0;
+    }
+
+    if (readyPaths.size() == 1)
+    {
+        return readyPaths[0];
+    }
+
+    m_readyWeights.clear();
+    for (uint32_t pathId : readyPaths)
+    {
+        auto it = m_paths.find(pathId);
+        m_readyWeights.push_back(it != m_paths.end() ? it->second.weight : 0.0);
+    }
+
+    m_scheduler.SetMode(static_cast<PathScheduler::Mode>(m_pathSelection));
+    if (m_scheduler.SetWeights(readyPaths, m_readyWeights))
+    {
+        NS_LOG_DEBUG("Path scheduler rebuilt for " << readyPaths.size() << " paths");
+    }
+    return m_scheduler.Next();
+}
+
 void
 MultiPathNadaClientBase::StartApplication(void)
 {
@@ -508,16 +1073,14 @@ MultiPathNadaClientBase::StartApplication(void)
     }
 
     m_running = true;
+    m_retransmitBuffer.SetMaxFrames(m_retransmitFrames);
     NS_LOG_INFO("MultiPathNadaClientBase starting with " << m_paths.size() << " paths");
 
     // Initialize sockets for each path - ONCE ONLY
     uint32_t delay = 0;
     for (auto& pathPair : m_paths)
     {
-        Simulator::Schedule(MilliSeconds(delay),
-                            &MultiPathNadaClientBase::InitializePathSocket,
-                            this,
-                            pathPair.first);
+        m_timeouts.Schedule(GetTimerKey(pathPair.first, TIMER_SOCKET_INIT), MilliSeconds(delay));
         delay += 50;
     }
 
@@ -525,50 +1088,195 @@ MultiPathNadaClientBase::StartApplication(void)
     Simulator::Schedule(MilliSeconds(delay + 500),
                         &MultiPathNadaClientBase::ValidateAllSockets, this);
 
-    // Simulator::Schedule(Seconds(5.0), &MultiPathNadaClientBase::PeriodicHealthCheck, this);
-
-    // Schedule path distribution updates with much longer intervals
-    m_updateEvent = Simulator::Schedule(Seconds(10.0),
-                                       &MultiPathNadaClientBase::UpdatePathDistribution, this);
+    // Rates and weights are then updated as feedback arrives, see HandleRecv
+    m_lastDistributionUpdate = Simulator::Now();
 }
 
 void
-MultiPathNadaClientBase::PeriodicHealthCheck(void)
+MultiPathNadaClientBase::HandleTimeout(uint32_t key)
 {
+    NS_LOG_FUNCTION(this << key);
+
     if (!m_running)
     {
         return;
     }
 
-    NS_LOG_DEBUG("Performing periodic health check");
+    uint32_t pathId = key / TIMER_KINDS;
+    switch (key % TIMER_KINDS)
+    {
+        case TIMER_SOCKET_INIT:
+            InitializePathSocket(pathId);
+            break;
+        case TIMER_SOCKET_CHECK:
+            ValidatePathSocket(pathId);
+            break;
+        case TIMER_STALE:
+            CheckPathHealth(pathId);
+            break;
+        case TIMER_FAILOVER:
+            FailPath(pathId);
+            break;
+        case TIMER_PROBE:
+            SendStandbyProbe(pathId);
+            break;
+    }
+}
+
+void
+MultiPathNadaClientBase::CheckPathHealth(uint32_t pathId)
+{
+    NS_LOG_FUNCTION(this << pathId);
+
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end() || !it->second.client)
+    {
+        return;
+    }
+
+    NS_LOG_WARN("No feedback on path " << pathId << " for " << m_staleTimeout.GetMilliSeconds()
+                << "ms with packets in flight");
 
-    uint32_t healthyPaths = 0;
-    for (const auto& pathPair : m_paths)
+    Ptr<Socket> socket = it->second.client->GetSocket();
+    bool ready = IsSocketReady(socket);
+    m_paths.SetSocketState(pathId, socket != nullptr, ready);
+    if (!ready)
     {
-        uint32_t pathId = pathPair.first;
-        if (pathPair.second.client)
+        NS_LOG_WARN("Health check failed for path " << pathId << ", reinitializing");
+        m_timeouts.Schedule(GetTimerKey(pathId, TIMER_SOCKET_INIT), MilliSeconds(100));
+        return;
+    }
+
+    // Losses detected since the last report only show up in the weights now
+    it->second.packetsLost = it->second.history.GetLostPackets();
+    UpdatePathDistribution();
+}
+
+Time
+MultiPathNadaClientBase::GetFailoverTimeout(const PathInfo& path) const
+{
+    // Until the first sample the configured initial RTT stands in
+    Time rtt = path.smoothedRtt.IsZero() ? path.lastRtt : path.smoothedRtt;
+    return Max(Seconds(rtt.GetSeconds() * m_failoverRttMultiplier), m_failoverMinTimeout);
+}
+
+void
+MultiPathNadaClientBase::FailPath(uint32_t pathId)
+{
+    NS_LOG_FUNCTION(this << pathId);
+
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end() || m_paths.IsFailed(pathId))
+    {
+        return;
+    }
+
+    const std::vector<uint32_t>& readyPaths = GetReadyPaths();
+    if (readyPaths.empty() || (readyPaths.size() == 1 && readyPaths[0] == pathId))
+    {
+        // The stale timer still checks the socket of the last path
+        NS_LOG_DEBUG("No feedback on path " << pathId << ", but no other path to fail over to");
+        return;
+    }
+
+    Time now = Simulator::Now();
+    NS_LOG_WARN("No feedback on path " << pathId << " for "
+                << GetFailoverTimeout(it->second).GetMilliSeconds() << "ms, failing over");
+
+    PathInfo& path = it->second;
+    m_paths.SetFailed(pathId, true);
+    path.failovers++;
+    m_failovers++;
+
+    // Queued packets have not left yet and go elsewhere as they are
+    m_failoverItems.clear();
+    path.pacer.Flush(m_failoverItems);
+
+    // Packets in flight count as lost on this path; frame packets are sent
+    // again while they can still make their playout deadline. Packets
+    // outside a frame carry nothing the receiver waits for.
+    m_failoverEntries.clear();
+    path.history.ExpireAll(m_failoverEntries);
+    path.packetsLost = path.history.GetLostPackets();
+    m_retransmitBuffer.ExpireBefore(now);
+    for (const NadaSendHistory::Entry& sent : m_failoverEntries)
+    {
+        if (sent.packetsInFrame == 0)
         {
-            Ptr<Socket> socket = pathPair.second.client->GetSocket();
-            if (socket && IsSocketReady(socket))
-            {
-                healthyPaths++;
-            }
-            else
-            {
-                NS_LOG_WARN("Health check failed for path " << pathId << ", reinitializing");
-                Simulator::Schedule(MilliSeconds(100),
-                                  &MultiPathNadaClientBase::InitializePathSocket,
-                                  this,
-                                  pathId);
-            }
+            continue;
+        }
+        const NadaRetransmitBuffer::Entry* entry = m_retransmitBuffer.Find(sent.frameId, sent.packetIndex);
+        if (!entry || now >= entry->deadline)
+        {
+            continue;
         }
+
+        NadaPacer::Item item;
+        item.packet = Create<Packet>(entry->size);
+        item.frameId = entry->frameId;
+        item.packetIndex = entry->packetIndex;
+        item.packetsInFrame = entry->packetsInFrame;
+        item.sourcePackets = entry->sourcePackets;
+        item.isKeyFrame = entry->isKeyFrame;
+        m_failoverItems.push_back(item);
     }
 
-    NS_LOG_INFO("Health check: " << healthyPaths << "/" << m_paths.size() << " paths healthy");
+    // The failed path has left the ready paths, so the weights only pick
+    // among the healthy ones; moved packets are late already and skip the
+    // queues
+    const std::vector<uint32_t>& healthyPaths = GetReadyPaths();
+    uint32_t moved = 0;
+    for (const NadaPacer::Item& item : m_failoverItems)
+    {
+        if (SendItemOnPath(SelectWeightedPath(healthyPaths), item, true))
+        {
+            moved++;
+        }
+    }
+    m_failoverItems.clear();
+    m_failoverMoved += moved;
+    NS_LOG_INFO("Path " << pathId << " failed, moved " << moved << " packets to "
+                << healthyPaths.size() << " other paths");
+
+    m_timeouts.Schedule(GetTimerKey(pathId, TIMER_PROBE), m_probeInterval);
+    m_pathFailoverTrace(pathId, true, moved);
+    UpdatePathDistribution();
+}
+
+void
+MultiPathNadaClientBase::RestorePath(uint32_t pathId)
+{
+    NS_LOG_FUNCTION(this << pathId);
 
-    // Schedule next health check
-    Simulator::Schedule(Seconds(10.0),
-                        &MultiPathNadaClientBase::PeriodicHealthCheck, this);
+    NS_LOG_INFO("Path " << pathId << " answered again, back from standby");
+    m_paths.SetFailed(pathId, false);
+    m_timeouts.Cancel(GetTimerKey(pathId, TIMER_PROBE));
+    // The packets given up on when it failed say nothing of the path now
+    auto it = m_paths.find(pathId);
+    if (it != m_paths.end())
+    {
+        it->second.lossWindow.Clear();
+    }
+    m_pathFailoverTrace(pathId, false, 0);
+    UpdatePathDistribution();
+}
+
+void
+MultiPathNadaClientBase::SendStandbyProbe(uint32_t pathId)
+{
+    if (!m_paths.IsFailed(pathId))
+    {
+        return;
+    }
+
+    // Probes skip the pacer, whose rate still reflects the path before it failed
+    NadaPacer::Item item;
+    item.packet = Create<Packet>(m_probeSize);
+    if (!TransmitOnPath(pathId, item))
+    {
+        NS_LOG_DEBUG("Standby probe not sent on path " << pathId);
+    }
+    m_timeouts.Schedule(GetTimerKey(pathId, TIMER_PROBE), m_probeInterval);
 }
 
 void
@@ -587,10 +1295,18 @@ MultiPathNadaClientBase::StopApplication(void)
     }
 
     // Cancel pending events
-    if (m_updateEvent.IsPending())
+    m_timeouts.Clear();
+
+    if (m_pacerEvent.IsPending())
+    {
+        Simulator::Cancel(m_pacerEvent);
+    }
+
+    for (auto& pathPair : m_paths)
     {
-        Simulator::Cancel(m_updateEvent);
+        pathPair.second.pacer.Clear();
     }
+    m_retransmitBuffer.Clear();
 }
 
 void
@@ -603,14 +1319,20 @@ MultiPathNadaClientBase::DoDispose(void)
     {
         pathPair.second.client = nullptr;
         pathPair.second.nada = nullptr;
+        pathPair.second.nadaSocket = nullptr;
     }
+    m_socketStatus.clear();
 
-    m_socketToPathId.clear();
+    m_scheduler.SetRandomStream(nullptr);
+    m_rng = nullptr;
+    m_coupledGroup = nullptr;
 
     // Cancel any pending events
-    if (m_updateEvent.IsPending())
+    m_timeouts.Clear();
+
+    if (m_pacerEvent.IsPending())
     {
-        Simulator::Cancel(m_updateEvent);
+        Simulator::Cancel(m_pacerEvent);
     }
 
     Application::DoDispose();
@@ -759,15 +1481,17 @@ MultiPathNadaClientBase::InitializePathSocket(uint32_t pathId)
         NS_LOG_INFO("Socket connected to " << remoteAddr);
     }
 
-    socket->SetRecvCallback(MakeCallback(&MultiPathNadaClientBase::HandleRecv, this));
-
+    // The path ID is bound into the callbacks, so no socket lookup is needed
     socket->SetCloseCallbacks(
-        MakeCallback(&MultiPathNadaClientBase::HandleSocketClose, this),
-        MakeCallback(&MultiPathNadaClientBase::HandleSocketError, this)
+        MakeCallback(&MultiPathNadaClientBase::HandleSocketClose, this).Bind(pathId),
+        MakeCallback(&MultiPathNadaClientBase::HandleSocketError, this).Bind(pathId)
     );
 
     it->second.client->SetSocket(socket);
 
+    // SetSocket() installs the UdpNadaClient handler; feedback belongs to us
+    socket->SetRecvCallback(MakeCallback(&MultiPathNadaClientBase::HandleRecv, this).Bind(pathId));
+
     Ptr<Socket> verifySocket = it->second.client->GetSocket();
     if (!verifySocket || verifySocket != socket)
     {
@@ -777,17 +1501,10 @@ MultiPathNadaClientBase::InitializePathSocket(uint32_t pathId)
 
     it->second.client->SetNode(GetNode());
 
-    // Store socket mapping AFTER verification
-    m_socketToPathId[socket] = pathId;
-
     if (it->second.nada)
     {
         // Check if NADA is already initialized to avoid double initialization
-        static std::set<std::pair<Ptr<NadaCongestionControl>, Ptr<Socket>>> initializedPairs;
-        std::pair<Ptr<NadaCongestionControl>, Ptr<Socket>> nadaSocketPair =
-            std::make_pair(it->second.nada, socket);
-
-        if (initializedPairs.find(nadaSocketPair) == initializedPairs.end())
+        if (it->second.nadaSocket != socket)
         {
             it->second.nada->Init(socket);
 
@@ -800,7 +1517,7 @@ MultiPathNadaClientBase::InitializePathSocket(uint32_t pathId)
                 it->second.nada->SetVideoMode(true);
             }
 
-            initializedPairs.insert(nadaSocketPair);
+            it->second.nadaSocket = socket;
             NS_LOG_INFO("NADA initialized for path " << pathId << " with rate " << pathRate);
         }
         else
@@ -809,7 +1526,9 @@ MultiPathNadaClientBase::InitializePathSocket(uint32_t pathId)
         }
     }
 
-    if (!IsSocketReady(socket))
+    bool ready = IsSocketReady(socket);
+    m_paths.SetSocketState(pathId, true, ready);
+    if (!ready)
     {
         NS_LOG_WARN("Socket for path " << pathId << " not ready after initialization");
         // Don't return here - socket might become ready shortly
@@ -817,10 +1536,7 @@ MultiPathNadaClientBase::InitializePathSocket(uint32_t pathId)
 
     NS_LOG_INFO("Path " << pathId << " socket initialized successfully");
 
-    Simulator::Schedule(MilliSeconds(100),
-                       &MultiPathNadaClientBase::ValidatePathSocket,
-                       this,
-                       pathId);
+    m_timeouts.Schedule(GetTimerKey(pathId, TIMER_SOCKET_CHECK), MilliSeconds(100));
 }
 
 
@@ -837,6 +1553,7 @@ MultiPathNadaClientBase::ValidatePathSocket(uint32_t pathId)
 
     Ptr<Socket> socket = it->second.client->GetSocket();
     bool ready = IsSocketReady(socket);
+    m_paths.SetSocketState(pathId, socket != nullptr, ready);
 
     if (ready)
     {
@@ -849,17 +1566,14 @@ MultiPathNadaClientBase::ValidatePathSocket(uint32_t pathId)
     else
     {
         NS_LOG_WARN("Path " << pathId << " socket validation failed, retrying...");
-        Simulator::Schedule(MilliSeconds(200),
-                            &MultiPathNadaClientBase::InitializePathSocket,
-                            this,
-                            pathId);
+        m_timeouts.Schedule(GetTimerKey(pathId, TIMER_SOCKET_INIT), MilliSeconds(200));
     }
 }
 
 void
-MultiPathNadaClientBase::HandleRecv(Ptr<Socket> socket)
+MultiPathNadaClientBase::HandleRecv(uint32_t pathId, Ptr<Socket> socket)
 {
-    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_FUNCTION(this << pathId << socket);
 
     if (!socket)
     {
@@ -867,66 +1581,154 @@ MultiPathNadaClientBase::HandleRecv(Ptr<Socket> socket)
         return;
     }
 
-    auto it = m_socketToPathId.find(socket);
-    if (it == m_socketToPathId.end())
+    auto pathIt = m_paths.find(pathId);
+    if (pathIt == m_paths.end())
     {
-        NS_LOG_WARN("Received packet for unknown socket");
+        NS_LOG_ERROR("Path " << pathId << " not found");
         return;
     }
 
-    uint32_t pathId = it->second;
+    PathInfo& path = pathIt->second;
+    NadaSendHistory& history = path.history;
 
     try
     {
+        // Drain every queued datagram; the socket only notifies once per burst
         Address from;
-        Ptr<Packet> packet = socket->RecvFrom(from);
-
-        if (!packet || packet->GetSize() == 0)
+        Ptr<Packet> packet;
+        while ((packet = socket->RecvFrom(from)))
         {
-            NS_LOG_WARN("Null or empty packet received on path " << pathId);
-            return;
-        }
+            if (packet->GetSize() < NadaHeader::GetStaticSize())
+            {
+                NS_LOG_WARN("Packet too small for a NadaHeader on path " << pathId);
+                continue;
+            }
 
-        auto pathIt = m_paths.find(pathId);
-        if (pathIt == m_paths.end())
-        {
-            NS_LOG_ERROR("Path " << pathId << " not found");
-            return;
-        }
+            // Decode the header once, in place
+            NadaHeader header;
+            if (packet->PeekHeader(header) == 0)
+            {
+                continue;
+            }
 
-        // Update statistics
-        pathIt->second.packetsAcked++;
+            if (header.GetPacketType() == NadaHeader::NACK)
+            {
+                HandleNack(header);
+                continue;
+            }
 
-        // Extract delay from header if possible
-        Time delay = MilliSeconds(50); // Default
+            Time now = Simulator::Now();
+            history.ExpireOlderThan(now - m_lossTimeout);
 
-        if (packet->GetSize() >= NadaHeader::GetStaticSize())
-        {
-            try
+            NadaFeedback feedback;
+            header.GetFeedback(feedback);
+
+            // RTT comes from our own send history, so sender and receiver clocks never mix
+            Time rtt = Seconds(0);
+            Time lastDelay = Seconds(0);
+            uint64_t lostBefore = history.GetLostPackets();
+            NadaSendHistory::Entry sent;
+            if (feedback.ackVector)
             {
-                Ptr<Packet> copy = packet->Copy();
-                NadaHeader header;
-                if (copy->RemoveHeader(header))
-                {
-                    if (header.GetTimestamp() > Time::Min())
+                // One delay sample per acknowledged packet, as UdpNadaClient
+                // takes them; the last one travels with the rest of the report
+                feedback.ackVector->ForEach([&](uint32_t seq, bool received, Time arrival) {
+                    if (!received)
                     {
-                        delay = Simulator::Now() - header.GetTimestamp();
-                        pathIt->second.lastDelay = delay;
-                        pathIt->second.lastRtt = delay * 2; // Simplified RTT
+                        history.MarkLost(seq);
+                        return;
                     }
+                    if (!history.Retire(seq, sent))
+                    {
+                        return;
+                    }
+                    if (feedback.acked > 0 && path.nada)
+                    {
+                        path.nada->ProcessDelay(lastDelay);
+                    }
+                    // Take out the time the receiver held the report back
+                    rtt = Max(now - sent.sendTime - (feedback.ackTimestamp - arrival),
+                              Seconds(0));
+                    lastDelay = arrival - sent.sendTime;
+                    path.lossWindow.Push(false);
+                    feedback.acked++;
+                });
+            }
+            else if (history.Retire(feedback.sequence, sent))
+            {
+                rtt = now - sent.sendTime;
+                if (feedback.hasForwardDelay)
+                {
+                    rtt = Max(rtt - (feedback.ackTimestamp - feedback.receiveTimestamp), Seconds(0));
                 }
+                // The receiver's echo measures the forward path alone; halving the
+                // RTT is left for receivers that do not send one
+                lastDelay = feedback.hasForwardDelay ? feedback.forwardDelay : rtt / 2;
+                path.lossWindow.Push(false);
+                feedback.acked = 1;
             }
-            catch (const std::exception& e)
+
+            // Receivers do not measure loss; the sender sees it in its history
+            feedback.lossRate = std::max(feedback.lossRate, path.lossWindow.GetLossRate());
+            bool newLosses = history.GetLostPackets() > lostBefore;
+            path.packetsLost = history.GetLostPackets();
+            if (feedback.acked == 0)
             {
-                NS_LOG_WARN("Exception processing header: " << e.what());
+                NS_LOG_DEBUG("Feedback on path " << pathId << " acknowledged nothing in flight");
+                if (newLosses && path.nada)
+                {
+                    path.nada->ProcessLoss(feedback.lossRate);
+                    path.nada->ProcessEcn(feedback.ecnMarked);
+                    path.nada->UpdateReceiveRate(feedback.receiveRate);
+                }
             }
-        }
+            else
+            {
+                // Update statistics; an aggregated ACK acknowledges every packet it marks received
+                path.packetsAcked += feedback.acked;
+
+                feedback.rtt = rtt;
+                feedback.delay = lastDelay;
+                HandleAck(pathId, feedback);
 
-        HandleAck(pathId, packet, delay);
+                NS_LOG_DEBUG("Packet acknowledged on path " << pathId
+                            << " (acked: " << path.packetsAcked
+                            << ", sent: " << path.packetsSent << ")");
+            }
+
+            // Receiver state rides on every report, even one that acknowledges nothing new
+            OnFeedback(pathId, feedback);
+
+            // Only an acknowledgement of a packet sent after the failure,
+            // such as a probe, shows the path carries traffic again
+            if (m_failoverEnabled && feedback.acked > 0 && m_paths.IsFailed(pathId))
+            {
+                RestorePath(pathId);
+            }
+
+            // The path answered: push the stale timer back while packets are
+            // outstanding, otherwise the next packet sent restarts it
+            uint32_t staleKey = GetTimerKey(pathId, TIMER_STALE);
+            uint32_t failoverKey = GetTimerKey(pathId, TIMER_FAILOVER);
+            if (history.GetInFlightPackets() > 0)
+            {
+                m_timeouts.Schedule(staleKey, m_staleTimeout);
+                if (m_failoverEnabled && !m_paths.IsFailed(pathId))
+                {
+                    m_timeouts.Schedule(failoverKey, GetFailoverTimeout(path));
+                }
+            }
+            else
+            {
+                m_timeouts.Cancel(staleKey);
+                m_timeouts.Cancel(failoverKey);
+            }
 
-        NS_LOG_DEBUG("Packet acknowledged on path " << pathId
-                    << " (acked: " << pathIt->second.packetsAcked
-                    << ", sent: " << pathIt->second.packetsSent << ")");
+            if (now - m_lastDistributionUpdate >= m_updateInterval)
+            {
+                UpdatePathDistribution();
+            }
+        }
     }
     catch (const std::exception& e)
     {
@@ -935,9 +1737,26 @@ MultiPathNadaClientBase::HandleRecv(Ptr<Socket> socket)
 }
 
 void
-MultiPathNadaClientBase::HandleAck(uint32_t pathId, Ptr<Packet> packet, Time delay)
+MultiPathNadaClientBase::HandlePacketLost(const NadaSendHistory::Entry& entry)
 {
-    NS_LOG_FUNCTION(this << pathId << delay);
+    NS_LOG_FUNCTION(this << entry.pathId << entry.seq);
+
+    auto it = m_paths.find(entry.pathId);
+    if (it != m_paths.end())
+    {
+        it->second.lossWindow.Push(true);
+    }
+}
+
+void
+MultiPathNadaClientBase::OnFeedback(uint32_t, const NadaFeedback&)
+{
+}
+
+void
+MultiPathNadaClientBase::HandleAck(uint32_t pathId, const NadaFeedback& feedback)
+{
+    NS_LOG_FUNCTION(this << pathId << feedback.delay);
 
     auto it = m_paths.find(pathId);
     if (it == m_paths.end())
@@ -947,8 +1766,122 @@ MultiPathNadaClientBase::HandleAck(uint32_t pathId, Ptr<Packet> packet, Time del
     }
 
     // Update path statistics
-    it->second.lastDelay = delay;
-    it->second.lastRtt = delay * 2; // Simplified RTT calculation
+    it->second.lastDelay = feedback.delay;
+    it->second.lastRtt = feedback.rtt;
+    // RFC 6298 smoothing, so one slow sample does not shorten or stretch
+    // the failover timeout
+    Time& srtt = it->second.smoothedRtt;
+    srtt = srtt.IsZero() ? feedback.rtt : srtt + (feedback.rtt - srtt) / 8;
+
+    if (it->second.nada)
+    {
+        it->second.nada->ProcessFeedback(feedback);
+    }
+}
+
+void
+MultiPathNadaClientBase::HandleNack(const NadaHeader& header)
+{
+    NS_LOG_FUNCTION(this << header.GetNacks().size());
+
+    if (!m_retransmitEnabled)
+    {
+        return;
+    }
+
+    Time now = Simulator::Now();
+    m_retransmitBuffer.ExpireBefore(now);
+
+    const std::vector<uint32_t>& readyPaths = GetReadyPaths();
+    if (readyPaths.empty())
+    {
+        return;
+    }
+
+    // Repairs take the fastest path, not the one that lost the packet
+    Time delay;
+    uint32_t pathId = GetLowestDelayPath(readyPaths, delay);
+
+    for (const NadaNack& nack : header.GetNacks())
+    {
+        NadaRetransmitBuffer::Entry* entry = m_retransmitBuffer.Find(nack.frameId, nack.packetIndex);
+        if (!entry)
+        {
+            // Its frame is past its deadline or was evicted
+            m_lateNacks++;
+            continue;
+        }
+        if (entry->retransmissions >= m_maxRetransmissions)
+        {
+            continue;
+        }
+        if (now + delay >= entry->deadline)
+        {
+            NS_LOG_DEBUG("Repair of packet " << nack.packetIndex << " of frame " << nack.frameId
+                         << " would miss its deadline by " << (now + delay - entry->deadline).GetMilliSeconds()
+                         << " ms");
+            m_lateNacks++;
+            continue;
+        }
+
+        NadaPacer::Item item;
+        item.packet = Create<Packet>(entry->size);
+        item.frameId = entry->frameId;
+        item.packetIndex = entry->packetIndex;
+        item.packetsInFrame = entry->packetsInFrame;
+        item.sourcePackets = entry->sourcePackets;
+        item.isKeyFrame = entry->isKeyFrame;
+
+        if (!SendItemOnPath(pathId, item, true))
+        {
+            NS_LOG_DEBUG("Could not queue repair of frame " << nack.frameId << " on path " << pathId);
+            break;
+        }
+
+        entry->retransmissions++;
+        m_retransmissions++;
+        m_paths[pathId].retransmissions++;
+        NS_LOG_DEBUG("Repaired packet " << nack.packetIndex << " of frame " << nack.frameId
+                     << " on path " << pathId);
+    }
+}
+
+uint32_t
+MultiPathNadaClientBase::GetLowestDelayPath(const std::vector<uint32_t>& readyPaths, Time& delay) const
+{
+    uint32_t bestPath = readyPaths[0];
+    delay = Time::Max();
+    for (uint32_t pathId : readyPaths)
+    {
+        auto it = m_paths.find(pathId);
+        if (it != m_paths.end() && it->second.lastDelay < delay)
+        {
+            delay = it->second.lastDelay;
+            bestPath = pathId;
+        }
+    }
+    return bestPath;
+}
+
+uint32_t
+MultiPathNadaClientBase::GetLowestRttPath(void) const
+{
+    if (m_paths.empty())
+    {
+        return 0;
+    }
+
+    uint32_t bestPath = m_paths.begin()->first;
+    Time lowestRtt = Time::Max();
+    for (const auto& pathPair : m_paths)
+    {
+        if (pathPair.second.lastRtt < lowestRtt)
+        {
+            lowestRtt = pathPair.second.lastRtt;
+            bestPath = pathPair.first;
+        }
+    }
+    return bestPath;
 }
 
 bool
@@ -959,13 +1892,12 @@ MultiPathNadaClientBase::IsSocketReady(Ptr<Socket> socket) const
         return false;
     }
 
-    static std::map<Ptr<Socket>, std::pair<bool, Time>> socketStatusCache;
-    static const Time CACHE_DURATION = MilliSeconds(100); // Cache for 100ms
+    const Time CACHE_DURATION = MilliSeconds(100); // Cache for 100ms
 
     Time now = Simulator::Now();
-    auto cacheIt = socketStatusCache.find(socket);
+    auto cacheIt = m_socketStatus.find(socket);
 
-    if (cacheIt != socketStatusCache.end())
+    if (cacheIt != m_socketStatus.end())
     {
         if ((now - cacheIt->second.second) < CACHE_DURATION)
         {
@@ -984,14 +1916,14 @@ MultiPathNadaClientBase::IsSocketReady(Ptr<Socket> socket) const
             Address peerAddr;
             isReady = (socket->GetPeerName(peerAddr) == 0);
         }
-        socketStatusCache[socket] = std::make_pair(isReady, now);
+        m_socketStatus[socket] = std::make_pair(isReady, now);
 
         return isReady;
     }
     catch (const std::exception& e)
     {
         NS_LOG_DEBUG("Exception checking socket: " << e.what());
-        socketStatusCache[socket] = std::make_pair(false, now);
+        m_socketStatus[socket] = std::make_pair(false, now);
         return false;
     }
 }
@@ -1002,77 +1934,79 @@ MultiPathNadaClientBase::UpdatePathDistribution()
 {
     NS_LOG_FUNCTION(this);
 
-    // Update NADA rates for all paths
+    // The controllers update their rates as their own feedback arrives
     double totalRateBps = 0.0;
     for (auto& pathPair : m_paths)
     {
         if (pathPair.second.nada)
         {
-            DataRate nadaRate = pathPair.second.nada->UpdateRate();
+            DataRate nadaRate = pathPair.second.nada->GetCurrentRate();
             pathPair.second.currentRate = nadaRate;
             totalRateBps += nadaRate.GetBitRate();
         }
     }
     m_totalRate = DataRate(totalRateBps);
+    m_lastDistributionUpdate = Simulator::Now();
 
     UpdateWeights();
+    NotifyWeightChanges();
 
-    Time nextUpdate;
-    if (totalRateBps >= 10e9) { // 10Gbps+
-        nextUpdate = Seconds(5.0); 
-    } else if (totalRateBps >= 1e9) { // 1Gbps+
-        nextUpdate = Seconds(3.0); 
-    } else if (totalRateBps >= 100e6) { // 100Mbps+
-        nextUpdate = Seconds(1.0);
-    } else {
-        nextUpdate = MilliSeconds(500);
-    }
+    NS_LOG_DEBUG("Updated path distribution, total rate " << totalRateBps / 1e6 << "Mbps");
+}
 
-    // Schedule next update
-    m_updateEvent = Simulator::Schedule(nextUpdate,
-                                       &MultiPathNadaClientBase::UpdatePathDistribution, this);
+void
+MultiPathNadaClientBase::NotifyWeightChanges()
+{
+    // Nothing to compare against when nobody listens
+    if (m_weightChangedTrace.IsEmpty())
+    {
+        return;
+    }
 
-    NS_LOG_DEBUG("Updated path distribution, next update in "
-                << nextUpdate.GetMilliSeconds() << "ms");
+    for (auto& pathPair : m_paths)
+    {
+        PathInfo& info = pathPair.second;
+        if (info.weight != info.tracedWeight)
+        {
+            m_weightChangedTrace(pathPair.first, info.tracedWeight, info.weight);
+            info.tracedWeight = info.weight;
+        }
+    }
 }
 
 void
-MultiPathNadaClientBase::HandleSocketClose(Ptr<Socket> socket)
+MultiPathNadaClientBase::HandleSocketClose(uint32_t pathId, Ptr<Socket> socket)
 {
-    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_FUNCTION(this << pathId << socket);
 
-    auto it = m_socketToPathId.find(socket);
-    if (it != m_socketToPathId.end())
+    // Sockets replaced by a reinitialization no longer speak for the path
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end() || !it->second.client || it->second.client->GetSocket() != socket)
     {
-        uint32_t pathId = it->second;
-        NS_LOG_WARN("Socket closed for path " << pathId << ", will reinitialize");
-
-        // Schedule reinitialization
-        Simulator::Schedule(MilliSeconds(500),
-                          &MultiPathNadaClientBase::InitializePathSocket,
-                          this,
-                          pathId);
+        return;
     }
+
+    NS_LOG_WARN("Socket closed for path " << pathId << ", will reinitialize");
+    m_paths.SetSocketState(pathId, true, false);
+
+    // Schedule reinitialization
+    m_timeouts.Schedule(GetTimerKey(pathId, TIMER_SOCKET_INIT), MilliSeconds(500));
 }
 
 void
-MultiPathNadaClientBase::HandleSocketError(Ptr<Socket> socket)
+MultiPathNadaClientBase::HandleSocketError(uint32_t pathId, Ptr<Socket> socket)
 {
-    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_FUNCTION(this << pathId << socket);
 
-    auto it = m_socketToPathId.find(socket);
-    if (it != m_socketToPathId.end())
+    auto it = m_paths.find(pathId);
+    if (it == m_paths.end() || !it->second.client || it->second.client->GetSocket() != socket)
     {
-        uint32_t pathId = it->second;
-        NS_LOG_ERROR("Socket error for path " << pathId << ", will reinitialize");
-
-        // Clean up and reinitialize
-        m_socketToPathId.erase(it);
-        Simulator::Schedule(MilliSeconds(1000),
-                          &MultiPathNadaClientBase::InitializePathSocket,
-                          this,
-                          pathId);
+        return;
     }
+
+    NS_LOG_ERROR("Socket error for path " << pathId << ", will reinitialize");
+    m_paths.SetSocketState(pathId, true, false);
+    m_timeouts.Schedule(GetTimerKey(pathId, TIMER_SOCKET_INIT), MilliSeconds(1000));
 }
 
 } // namespace ns3
@@ -4,33 +4,51 @@
 #include "ns3/application.h"
 #include "ns3/data-rate.h"
 #include "ns3/event-id.h"
+#include "ns3/nada-header.h"
 #include "ns3/nada-improved.h"
+#include "ns3/nada-metrics-sink.h"
+#include "ns3/nada-pacer.h"
+#include "ns3/nada-retransmit-buffer.h"
+#include "ns3/nada-send-history.h"
+#include "ns3/nada-timeout-wheel.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/nada-udp-client.h"
 #include "ns3/socket.h"
-#include "ns3/video-receiver.h"
+#include "ns3/traced-callback.h"
+#include "mp-path-table.h"
+#include "mp-scheduler.h"
 #include <map>
 #include <vector>
 
 namespace ns3
 {
 
-struct PathInfo
-{
-    Ptr<UdpNadaClient> client;
-    Ptr<NadaCongestionControl> nada;
-    double weight;
-    DataRate currentRate;
-    uint32_t packetsSent;
-    uint32_t packetsAcked;
-    Time lastRtt;
-    Time lastDelay;
-    Address localAddress;
-    Address remoteAddress;
-};
-
 class MultiPathNadaClientBase : public Application
 {
 public:
+    /**
+     * TracedCallback signature of the PathSelected trace
+     * \param pathId The path the packet was given to
+     * \param size Payload size of the packet, without NadaHeader
+     */
+    typedef void (*PathSelectedTracedCallback)(uint32_t pathId, uint32_t size);
+
+    /**
+     * TracedCallback signature of the WeightChanged trace
+     * \param pathId The path
+     * \param oldWeight Weight before the strategy update
+     * \param newWeight Weight after it
+     */
+    typedef void (*WeightChangedTracedCallback)(uint32_t pathId, double oldWeight, double newWeight);
+
+    /**
+     * TracedCallback signature of the PathFailover trace
+     * \param pathId The path
+     * \param failed true when the path was declared failed, false when it recovered
+     * \param packetsMoved Packets moved onto the other paths when it failed
+     */
+    typedef void (*PathFailoverTracedCallback)(uint32_t pathId, bool failed, uint32_t packetsMoved);
+
     static TypeId GetTypeId(void);
 
     MultiPathNadaClientBase();
@@ -47,22 +65,83 @@ public:
     void SetMaxPackets(uint32_t numPackets);
     void SetVideoMode(bool enable);
     void SetKeyFrameStatus(bool isKeyFrame);
+    /**
+     * \brief Set the video frame the next packets belong to
+     *
+     * Carried in the NadaHeader so the receiver can reassemble frames exactly.
+     *
+     * \param frameId Frame identifier
+     * \param packetIndex Position of the next packet in the frame, from 0
+     * \param packetsInFrame Number of packets the frame is split into
+     * \param sourcePackets Packets needed to rebuild the frame when it carries
+     *        FEC repair packets, 0 otherwise
+     */
+    void SetVideoFrameContext(uint32_t frameId,
+                              uint16_t packetIndex,
+                              uint16_t packetsInFrame,
+                              uint16_t sourcePackets = 0);
     bool IsReady(void) const;
     DataRate GetTotalRate(void) const;
     uint32_t GetNumPaths(void) const;
     std::map<std::string, double> GetPathStats(uint32_t pathId) const;
+    /**
+     * \brief Get the congestion controller of a path, to connect to its traces
+     * \param pathId Path identifier
+     * \return The controller, or nullptr if the path does not exist
+     */
+    Ptr<NadaCongestionControl> GetPathController(uint32_t pathId) const;
     bool SendPacketOnPath(uint32_t pathId, Ptr<Packet> packet);
     void SetNadaAdaptability(uint32_t pathId, DataRate minRate, DataRate maxRate, Time rttMax);
-    void SetVideoReceiver(Ptr<VideoReceiver> receiver);
     void ValidateAllSockets(void);
     void ReportSocketStatus();
-    void HandleSocketClose(Ptr<Socket> socket);
-    void HandleSocketError(Ptr<Socket> socket);
+    void HandleSocketClose(uint32_t pathId, Ptr<Socket> socket);
+    void HandleSocketError(uint32_t pathId, Ptr<Socket> socket);
 
     uint32_t GetPacketSize(void) const;
+    uint32_t GetTotalPacketsSent(void) const;
 
-    // Strategy-specific methods (pure virtual)
+    /**
+     * \brief Assign a fixed random stream number to the path scheduler
+     * \param stream First stream index to use
+     * \return Number of stream indices used
+     */
+    virtual int64_t AssignStreams(int64_t stream) override;
+
+    /**
+     * \brief Have a metrics sink poll the statistics of this client
+     * \param sink The sink
+     * \param name Source name of the rows
+     */
+    void SetMetricsSink(Ptr<NadaMetricsSink> sink, const std::string& name);
+
+    /**
+     * \brief Split a video frame into packets and send them
+     *
+     * With FEC enabled, the K source packets go through the strategy's Send()
+     * and are followed by R repair packets spread over the paths least likely
+     * to lose them; the receiver rebuilds the frame from any K of the K+R.
+     *
+     * \param frameId Frame identifier
+     * \param isKeyFrame Whether the frame is a key frame
+     * \param frameSize Frame size in bytes
+     * \param mtu Payload bytes per packet
+     * \return true if every packet of the frame was sent
+     */
     bool SendVideoFrame(uint32_t frameId, bool isKeyFrame, uint32_t frameSize,uint32_t mtu);
+
+    /**
+     * \brief Tell the path controllers about a frame of the encoder
+     *
+     * Each controller gets the share of the frame its rate carries, so it
+     * compares its own rate with what the video needs from it.
+     *
+     * \param frameSize Frame size in bytes
+     * \param isKeyFrame Whether the frame is a key frame
+     * \param frameInterval Time between frames
+     */
+    void UpdateVideoFrameInfo(uint32_t frameSize, bool isKeyFrame, Time frameInterval);
+
+    // Strategy-specific methods (pure virtual)
     virtual bool Send(Ptr<Packet> packet);
     virtual std::string GetStrategyName() const = 0;
     virtual void UpdateWeights() = 0;
@@ -73,17 +152,226 @@ protected:
     virtual void StopApplication(void) override;
     virtual void DoDispose(void) override;
 
-    void PeriodicHealthCheck(void);
+    /**
+     * \brief Timeouts multiplexed on m_timeouts, one of each per path
+     */
+    enum PathTimer
+    {
+        TIMER_SOCKET_INIT = 0,  //!< (Re)initialize the path socket
+        TIMER_SOCKET_CHECK = 1, //!< Validate the path socket after initialization
+        TIMER_STALE = 2,        //!< No feedback while packets are in flight
+        TIMER_FAILOVER = 3,     //!< No feedback within the RTT-based failover timeout
+        TIMER_PROBE = 4,        //!< Next standby probe of a failed path
+        TIMER_KINDS = 5
+    };
+
+    static uint32_t GetTimerKey(uint32_t pathId, PathTimer timer)
+    {
+        return pathId * TIMER_KINDS + timer;
+    }
+
+    /**
+     * \brief Dispatch an expired path timeout
+     * \param key Key built by GetTimerKey()
+     */
+    void HandleTimeout(uint32_t key);
+
+    /**
+     * \brief Check a path that went StaleTimeout without feedback
+     *
+     * Reinitializes the socket when it is no longer usable, and otherwise
+     * refreshes the path loss count and the weights, since no feedback
+     * arrived to do so.
+     *
+     * \param pathId The stale path
+     */
+    void CheckPathHealth(uint32_t pathId);
+
+    /**
+     * \brief Get the time without feedback after which a busy path fails over
+     * \param path The path
+     * \return FailoverRttMultiplier smoothed RTTs, at least FailoverMinTimeout
+     */
+    Time GetFailoverTimeout(const PathInfo& path) const;
+
+    /**
+     * \brief Declare a path failed after its failover timeout
+     *
+     * The path leaves the ready paths, its paced packets and the in-flight
+     * frame packets that can still make their playout deadline go to the
+     * other paths, and it is probed every StandbyProbeInterval until
+     * feedback shows it works again. The last path that can send is never
+     * failed, since there is nowhere to move its packets.
+     *
+     * \param pathId The path
+     */
+    void FailPath(uint32_t pathId);
+
+    /**
+     * \brief Bring a failed path back into the ready paths
+     * \param pathId The path, declared failed
+     */
+    void RestorePath(uint32_t pathId);
+
+    /**
+     * \brief Send one standby probe on a failed path and schedule the next
+     * \param pathId The path
+     */
+    void SendStandbyProbe(uint32_t pathId);
     void InitializePathSocket(uint32_t pathId);
     void ValidatePathSocket(uint32_t pathId);
-    void HandleRecv(Ptr<Socket> socket);
-    void HandleAck(uint32_t pathId, Ptr<Packet> packet, Time delay);
+    /**
+     * \brief Receive callback of a path socket
+     * \param pathId Path the socket belongs to, bound when the callback is set
+     * \param socket The socket with pending data
+     */
+    void HandleRecv(uint32_t pathId, Ptr<Socket> socket);
+    /**
+     * \brief Apply one decoded feedback report to a path
+     * \param pathId Path the feedback arrived on
+     * \param feedback The report, with delay and acked filled in
+     */
+    void HandleAck(uint32_t pathId, const NadaFeedback& feedback);
+    /**
+     * \brief Count a packet the send history gave up on against its path
+     * \param entry The lost packet
+     */
+    void HandlePacketLost(const NadaSendHistory::Entry& entry);
+    /**
+     * \brief Hook called for every feedback report, after HandleAck
+     *
+     * Strategies that react to receiver state (e.g. its playout buffer)
+     * override this instead of polling the receiver. The default does nothing.
+     *
+     * \param pathId Path the feedback arrived on
+     * \param feedback The decoded report
+     */
+    virtual void OnFeedback(uint32_t pathId, const NadaFeedback& feedback);
+
+    /**
+     * \brief Record the metrics of this client during a sink poll
+     *
+     * The default records GetPathStats() of every path and the totals.
+     *
+     * \param sink The polling sink
+     */
+    virtual void ReportMetrics(Ptr<NadaMetricsSink> sink);
     bool IsSocketReady(Ptr<Socket> socket) const;
     void UpdatePathDistribution();
 
+    /**
+     * \brief Add the NadaHeader and hand a packet to the path socket
+     * \param pathId Path to send on
+     * \param item Packet and the frame context it was queued with
+     * \return true if the socket accepted the packet
+     */
+    bool TransmitOnPath(uint32_t pathId, const NadaPacer::Item& item);
+
+    /**
+     * \brief Hand a packet to the path pacer, or straight to the socket
+     * \param pathId Path to send on
+     * \param item Packet and its frame context
+     * \param priority Use the pacer priority lane
+     * \return true if the pacer or the socket accepted the packet
+     */
+    bool SendItemOnPath(uint32_t pathId, const NadaPacer::Item& item, bool priority);
+
+    /**
+     * \brief Resend the packets a receiver reported missing
+     *
+     * Repairs go on the ready path with the lowest one-way delay, and only
+     * when they can arrive before the playout deadline of their frame.
+     *
+     * \param header The NACK
+     */
+    void HandleNack(const NadaHeader& header);
+
+    /**
+     * \brief Find the path with the lowest one-way delay
+     * \param readyPaths Candidate paths, not empty
+     * \param delay Receives the delay of the selected path
+     * \return The selected path ID
+     */
+    uint32_t GetLowestDelayPath(const std::vector<uint32_t>& readyPaths, Time& delay) const;
+
+    /**
+     * \brief Find the path with the lowest measured RTT
+     * \return The selected path ID, 0 when there are no paths
+     */
+    uint32_t GetLowestRttPath(void) const;
+
+    /**
+     * \brief Release every paced packet that is due and re-arm the pacing timer
+     */
+    void ServicePacers(void);
+
+    /**
+     * \brief Collect the paths that can send right now
+     *
+     * Read from the socket state kept in m_paths, and only rebuilt when
+     * that state or the set of paths changed since the previous call.
+     *
+     * \param requireSocketReady Only paths whose socket passed IsSocketReady()
+     * \return Ready path IDs; valid until the next call
+     */
+    const std::vector<uint32_t>& GetReadyPaths(bool requireSocketReady = false);
+
+    /**
+     * \brief Check the preconditions every Send() shares
+     * \return true if the client is running, under MaxPackets and IsReady()
+     */
+    bool CanSend(void) const;
+
+    /**
+     * \brief Log that a send found no path to go out on
+     *
+     * Kept out of line so header templates need not see this file's log component.
+     *
+     * \param strategyName Name of the strategy that was sending
+     */
+    void WarnNoReadyPaths(const std::string& strategyName) const;
+
+    /**
+     * \brief Pick one of the given paths in proportion to PathInfo::weight
+     *
+     * O(1) per call; the scheduler is rebuilt only when the candidate set
+     * or the weights change.
+     *
+     * \param readyPaths Candidate paths
+     * \return The selected path ID
+     */
+    uint32_t SelectWeightedPath(const std::vector<uint32_t>& readyPaths);
+
+    /**
+     * \brief Fire WeightChanged for every path UpdateWeights() changed
+     *
+     * Call after UpdateWeights(); does nothing when the trace is not connected.
+     */
+    void NotifyWeightChanges(void);
+
+    /**
+     * \brief Get the number of FEC repair packets to add to a frame
+     * \param sourcePackets Packets the frame is split into
+     * \param isKeyFrame Whether the frame is a key frame
+     * \return Repair packets, 0 when FEC is disabled
+     */
+    uint32_t GetRepairPackets(uint32_t sourcePackets, bool isKeyFrame) const;
+
+    /**
+     * \brief Send the repair packets of the current frame
+     *
+     * Each packet goes to the ready path maximising (1 - loss) / (1 + n),
+     * n being the repair packets already given to it, so repairs favour
+     * clean paths without piling onto any single one.
+     *
+     * \param repairPackets Number of repair packets
+     * \param mtu Payload bytes per packet
+     * \return Number of repair packets sent
+     */
+    uint32_t SendRepairPackets(uint32_t repairPackets, uint32_t mtu);
+
     // Shared data
-    std::map<uint32_t, PathInfo> m_paths;
-    std::map<Ptr<Socket>, uint32_t> m_socketToPathId;
+    PathTable m_paths;
 
     uint32_t m_packetSize;
     uint32_t m_maxPackets;
@@ -92,10 +380,67 @@ protected:
     bool m_isKeyFrame;
     DataRate m_totalRate;
     uint32_t m_totalPacketsSent;
+    uint32_t m_sendPathIndex;    // Next round-robin position of the base Send()
+    bool m_socketsValidated;     // Every path had a socket at the last ValidateAllSockets()
+
+    Time m_updateInterval;       // Least time between two feedback-driven distribution updates
+    Time m_lastDistributionUpdate;  // Last UpdatePathDistribution() run
+    mutable std::map<Ptr<Socket>, std::pair<bool, Time>> m_socketStatus; // IsSocketReady() results and when they were taken
+
+    uint32_t m_currentFrameId;   // Frame being sent, recorded in the send history
+    uint16_t m_packetIndex;      // Position of the next packet in the frame
+    uint16_t m_packetsInFrame;   // Packets in the frame (0 = no frame info)
+    uint16_t m_sourcePackets;    // Packets needed to rebuild the frame (0 = no FEC)
+    uint32_t m_sendHistorySize;  // Send history capacity of new paths
+    Time m_lossTimeout;          // Age after which an unacknowledged packet is lost
+    Time m_staleTimeout;         // Time without feedback after which a busy path is checked
+    NadaTimeoutWheel m_timeouts; // Socket retry and stale-path timeouts of every path
+
+    PathScheduler m_scheduler;            // Weighted path selection
+    uint32_t m_pathSelection;             // PathScheduler::Mode used by m_scheduler
+    Ptr<UniformRandomVariable> m_rng;     // Random stream for path selection
+    std::vector<uint32_t> m_readyPaths;   // Reused by GetReadyPaths()
+    uint32_t m_readyVersion;              // PathTable version m_readyPaths was built from
+    bool m_readyRequireSocket;            // Whether m_readyPaths only holds ready sockets
+    std::vector<double> m_readyWeights;   // Reused by SelectWeightedPath()
+
+    uint32_t m_couplingMode;                // NadaCoupledGroup::Mode of new paths
+    Ptr<NadaCoupledGroup> m_coupledGroup;   // Shared by the path controllers when coupled
+
+    bool m_pacingEnabled;        // Send through the per-path pacers
+    uint32_t m_pacingBurst;      // Pacer burst allowance of new paths (bytes)
+    Time m_pacingGranularity;    // Pacer timer resolution
+    uint32_t m_pacingQueueSize;  // Pacer queue limit of new paths (bytes)
+    bool m_keyFramePriority;     // Key frames use the pacer priority lane
+    EventId m_pacerEvent;        // Single timer draining all pacers
+    Time m_pacerWakeup;          // When m_pacerEvent fires
+
+    bool m_fecEnabled;           // Protect video frames with repair packets
+    double m_fecKeyOverhead;     // Repair packets per source packet for key frames
+    double m_fecDeltaOverhead;   // Repair packets per source packet for delta frames
+    std::vector<uint32_t> m_repairCounts;  // Reused by SendRepairPackets()
+
+    bool m_retransmitEnabled;    // Answer NACKs with retransmissions
+    Time m_playoutDeadline;      // Time after its first packet at which a frame is played out
+    uint32_t m_retransmitFrames; // Frames held for retransmission
+    uint32_t m_maxRetransmissions;  // Times a packet may be sent again
+    NadaRetransmitBuffer m_retransmitBuffer;  // Recently sent frames
+    uint32_t m_retransmissions;  // Packets sent again
+    uint32_t m_lateNacks;        // NACKed packets that could not arrive in time
+
+    bool m_failoverEnabled;      // Fail paths over when feedback stops
+    double m_failoverRttMultiplier;  // Smoothed RTTs without feedback before a path fails
+    Time m_failoverMinTimeout;   // Floor of the failover timeout
+    Time m_probeInterval;        // Time between standby probes of a failed path
+    uint32_t m_probeSize;        // Payload bytes of a standby probe
+    uint32_t m_failovers;        // Paths declared failed
+    uint32_t m_failoverMoved;    // Packets moved off failed paths
+    std::vector<NadaPacer::Item> m_failoverItems;           // Reused by FailPath()
+    std::vector<NadaSendHistory::Entry> m_failoverEntries;  // Reused by FailPath()
 
-    EventId m_updateEvent;
-    Time m_updateInterval;
-    Ptr<VideoReceiver> m_videoReceiver;
+    TracedCallback<uint32_t, uint32_t> m_pathSelectedTrace;        // Packets handed to a path
+    TracedCallback<uint32_t, double, double> m_weightChangedTrace; // Strategy weight changes
+    TracedCallback<uint32_t, bool, uint32_t> m_pathFailoverTrace;  // Paths failed and recovered
 
 private:
     bool m_isVideoMode;
@@ -0,0 +1,148 @@
+#include "mp-path-table.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PathTable");
+
+namespace
+{
+
+bool
+EntryBefore(const PathTable::Entry& entry, uint32_t pathId)
+{
+    return entry.first < pathId;
+}
+
+} // namespace
+
+PathTable::PathTable()
+    : m_socketMask(0),
+      m_readyMask(0),
+      m_failedMask(0),
+      m_version(1)
+{
+}
+
+PathTable::iterator
+PathTable::find(uint32_t pathId)
+{
+    iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), pathId, EntryBefore);
+    return (it != m_entries.end() && it->first == pathId) ? it : m_entries.end();
+}
+
+PathTable::const_iterator
+PathTable::find(uint32_t pathId) const
+{
+    const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), pathId, EntryBefore);
+    return (it != m_entries.end() && it->first == pathId) ? it : m_entries.end();
+}
+
+PathInfo&
+PathTable::operator[](uint32_t pathId)
+{
+    iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), pathId, EntryBefore);
+    if (it != m_entries.end() && it->first == pathId)
+    {
+        return it->second;
+    }
+
+    NS_ASSERT_MSG(m_entries.size() < MAX_PATHS, "PathTable holds at most " << MAX_PATHS << " paths");
+    uint32_t index = GetIndex(it);
+    m_socketMask = InsertBit(m_socketMask, index);
+    m_readyMask = InsertBit(m_readyMask, index);
+    m_failedMask = InsertBit(m_failedMask, index);
+    m_version++;
+    return m_entries.insert(it, Entry(pathId, PathInfo()))->second;
+}
+
+void
+PathTable::erase(iterator it)
+{
+    uint32_t index = GetIndex(it);
+    m_socketMask = EraseBit(m_socketMask, index);
+    m_readyMask = EraseBit(m_readyMask, index);
+    m_failedMask = EraseBit(m_failedMask, index);
+    m_version++;
+    m_entries.erase(it);
+}
+
+void
+PathTable::clear(void)
+{
+    m_entries.clear();
+    m_socketMask = 0;
+    m_readyMask = 0;
+    m_failedMask = 0;
+    m_version++;
+}
+
+void
+PathTable::SetSocketState(uint32_t pathId, bool hasSocket, bool ready)
+{
+    const_iterator it = find(pathId);
+    if (it == end())
+    {
+        return;
+    }
+
+    uint64_t bit = uint64_t(1) << GetIndex(it);
+    uint64_t socketMask = hasSocket ? (m_socketMask | bit) : (m_socketMask & ~bit);
+    uint64_t readyMask = (hasSocket && ready) ? (m_readyMask | bit) : (m_readyMask & ~bit);
+    if (socketMask != m_socketMask || readyMask != m_readyMask)
+    {
+        NS_LOG_DEBUG("Path " << pathId << " socket " << (hasSocket ? "set" : "missing") << ", "
+                     << ((hasSocket && ready) ? "ready" : "not ready"));
+        m_socketMask = socketMask;
+        m_readyMask = readyMask;
+        m_version++;
+    }
+}
+
+void
+PathTable::SetFailed(uint32_t pathId, bool failed)
+{
+    const_iterator it = find(pathId);
+    if (it == end())
+    {
+        return;
+    }
+
+    uint64_t bit = uint64_t(1) << GetIndex(it);
+    uint64_t failedMask = failed ? (m_failedMask | bit) : (m_failedMask & ~bit);
+    if (failedMask != m_failedMask)
+    {
+        NS_LOG_DEBUG("Path " << pathId << (failed ? " failed" : " recovered"));
+        m_failedMask = failedMask;
+        m_version++;
+    }
+}
+
+bool
+PathTable::IsFailed(uint32_t pathId) const
+{
+    const_iterator it = find(pathId);
+    return it != end() && (m_failedMask & (uint64_t(1) << GetIndex(it)));
+}
+
+uint64_t
+PathTable::InsertBit(uint64_t mask, uint32_t index)
+{
+    // Bits from index up move one position to make room for a cleared bit
+    uint64_t low = mask & ((uint64_t(1) << index) - 1);
+    return low | ((mask & ~low) << 1);
+}
+
+uint64_t
+PathTable::EraseBit(uint64_t mask, uint32_t index)
+{
+    uint64_t low = mask & ((uint64_t(1) << index) - 1);
+    uint64_t high = (index + 1 < MAX_PATHS) ? (mask >> (index + 1)) << index : 0;
+    return low | high;
+}
+
+} // namespace ns3
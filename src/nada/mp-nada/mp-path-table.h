@@ -0,0 +1,157 @@
+#ifndef MP_PATH_TABLE_H
+#define MP_PATH_TABLE_H
+
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nada-improved.h"
+#include "ns3/nada-pacer.h"
+#include "ns3/nada-send-history.h"
+#include "ns3/nada-udp-client.h"
+#include "ns3/nada-window-stats.h"
+#include "ns3/nstime.h"
+
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+struct PathInfo
+{
+    Ptr<UdpNadaClient> client;
+    Ptr<NadaCongestionControl> nada;
+    Ptr<Socket> nadaSocket;  // Socket the controller was initialized on, so it is only done once
+    double weight;
+    double tracedWeight;    // Weight last reported to the WeightChanged trace
+    DataRate currentRate;
+    uint32_t packetsSent;
+    uint32_t packetsAcked;
+    uint32_t packetsLost;   // Reported missing by aggregated feedback
+    NadaLossWindow<100> lossWindow; // Fate of the last acknowledged or lost packets
+    uint32_t nextSequence;  // Per-path sequence space, so feedback covers contiguous ranges
+    NadaSendHistory history; // Packets in flight on this path
+    NadaPacer pacer;         // Packets waiting to leave at the path rate
+    uint32_t retransmissions; // NACKed packets repaired on this path
+    uint32_t failovers;      // Times the path was declared failed
+    Time lastRtt;
+    Time smoothedRtt;        // Base of the failover timeout, zero before the first sample
+    Time lastDelay;
+    Address localAddress;
+    Address remoteAddress;
+};
+
+/**
+ * \brief Dense path table of a multipath client, ordered by path ID
+ *
+ * The paths live in one contiguous vector instead of the nodes of a
+ * std::map, so the scans done for every packet walk memory linearly, and
+ * lookups by ID are a binary search over it. The interface follows the
+ * std::map subset the clients use, entries being (path ID, PathInfo) pairs.
+ *
+ * The table also keeps the socket state of every path as two bitmasks
+ * indexed by table position: one bit per path that has a socket, and one
+ * per path whose socket passed its last readiness check. They are only
+ * written when a socket is set up, validated, closed or fails, so the
+ * ready paths are known without probing every socket for every packet.
+ * A third mask marks the paths declared failed for lack of feedback; they
+ * keep their socket state and are left out of the ready paths until they
+ * answer again.
+ * GetVersion() changes whenever paths or their state change, so callers
+ * can cache what they derive from the table.
+ */
+class PathTable
+{
+  public:
+    typedef std::pair<uint32_t, PathInfo> Entry;
+    typedef std::vector<Entry>::iterator iterator;
+    typedef std::vector<Entry>::const_iterator const_iterator;
+
+    /// Paths the socket state bitmasks can hold
+    static const uint32_t MAX_PATHS = 64;
+
+    PathTable();
+
+    iterator begin(void) { return m_entries.begin(); }
+    iterator end(void) { return m_entries.end(); }
+    const_iterator begin(void) const { return m_entries.begin(); }
+    const_iterator end(void) const { return m_entries.end(); }
+
+    size_t size(void) const { return m_entries.size(); }
+    bool empty(void) const { return m_entries.empty(); }
+
+    iterator find(uint32_t pathId);
+    const_iterator find(uint32_t pathId) const;
+
+    /**
+     * \brief Access a path, adding a default one if it does not exist
+     * \param pathId Path identifier
+     * \return The path
+     */
+    PathInfo& operator[](uint32_t pathId);
+
+    /**
+     * \brief Remove a path; iterators past it are invalidated
+     * \param it The path to remove
+     */
+    void erase(iterator it);
+
+    void clear(void);
+
+    /**
+     * \brief Get the position of a path, its bit in the socket state masks
+     * \param it The path
+     * \return Index into the table
+     */
+    uint32_t GetIndex(const_iterator it) const
+    {
+        return static_cast<uint32_t>(it - m_entries.begin());
+    }
+
+    /**
+     * \brief Record the socket state of a path
+     * \param pathId Path identifier; unknown paths are ignored
+     * \param hasSocket The path has a socket to send on
+     * \param ready The socket passed IsSocketReady()
+     */
+    void SetSocketState(uint32_t pathId, bool hasSocket, bool ready);
+
+    /// Paths with a socket, one bit per table index
+    uint64_t GetSocketMask(void) const { return m_socketMask; }
+
+    /// Paths whose socket is ready, one bit per table index
+    uint64_t GetReadyMask(void) const { return m_readyMask; }
+
+    /**
+     * \brief Record whether a path is declared failed
+     * \param pathId Path identifier; unknown paths are ignored
+     * \param failed No feedback came back in time; the path is only probed
+     */
+    void SetFailed(uint32_t pathId, bool failed);
+
+    /**
+     * \brief Whether a path is declared failed
+     * \param pathId Path identifier
+     * \return false for unknown paths
+     */
+    bool IsFailed(uint32_t pathId) const;
+
+    /// Paths declared failed, one bit per table index
+    uint64_t GetFailedMask(void) const { return m_failedMask; }
+
+    /// Changes whenever a path is added or removed or its socket or failure state changes
+    uint32_t GetVersion(void) const { return m_version; }
+
+  private:
+    static uint64_t InsertBit(uint64_t mask, uint32_t index);
+    static uint64_t EraseBit(uint64_t mask, uint32_t index);
+
+    std::vector<Entry> m_entries; // Paths ordered by path ID
+    uint64_t m_socketMask;        // Bit i: path i has a socket
+    uint64_t m_readyMask;         // Bit i: the socket of path i is ready
+    uint64_t m_failedMask;        // Bit i: path i is declared failed
+    uint32_t m_version;           // Bumped on every change of paths or masks
+};
+
+} // namespace ns3
+
+#endif /* MP_PATH_TABLE_H */
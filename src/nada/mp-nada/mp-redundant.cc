@@ -0,0 +1,98 @@
+#include "mp-redundant.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultiPathNadaRedundantClient");
+NS_OBJECT_ENSURE_REGISTERED(MultiPathNadaRedundantClient);
+
+TypeId
+MultiPathNadaRedundantClient::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::MultiPathNadaRedundantClient")
+                           .SetParent<MultiPathNadaClientBase>()
+                           .SetGroupName("Applications")
+                           .AddConstructor<MultiPathNadaRedundantClient>();
+    return tid;
+}
+
+MultiPathNadaRedundantClient::MultiPathNadaRedundantClient()
+    : m_redundantCopies(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MultiPathNadaRedundantClient::~MultiPathNadaRedundantClient()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultiPathNadaRedundantClient::UpdateWeights()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_paths.empty())
+    {
+        return;
+    }
+
+    // Every path carries every packet
+    double equalWeight = 1.0 / m_paths.size();
+    for (auto& pathPair : m_paths)
+    {
+        pathPair.second.weight = equalWeight;
+    }
+}
+
+uint32_t
+MultiPathNadaRedundantClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
+{
+    Time delay;
+    return GetLowestDelayPath(readyPaths, delay);
+}
+
+void
+MultiPathNadaRedundantClient::OnPacketSent(const std::vector<uint32_t>& readyPaths,
+                                           uint32_t pathId,
+                                           uint32_t size)
+{
+    // The copies bypass SendPacketOnPath(): they are neither new packets nor
+    // new entries of the retransmission buffer
+    NadaPacer::Item item;
+    item.frameId = m_currentFrameId;
+    item.packetIndex = m_packetIndex;
+    item.packetsInFrame = m_packetsInFrame;
+    item.sourcePackets = m_sourcePackets;
+    item.isKeyFrame = m_isKeyFrame;
+
+    for (uint32_t copyPath : readyPaths)
+    {
+        if (copyPath == pathId)
+        {
+            continue;
+        }
+
+        item.packet = Create<Packet>(size);
+        if (SendItemOnPath(copyPath, item, m_keyFramePriority && m_isKeyFrame))
+        {
+            m_redundantCopies++;
+        }
+        else
+        {
+            NS_LOG_WARN("REDUNDANT - Failed to send copy on path " << copyPath);
+        }
+    }
+
+    NS_LOG_DEBUG("REDUNDANT - Sent packet on path " << pathId << " and "
+                << readyPaths.size() - 1 << " copies");
+}
+
+uint32_t
+MultiPathNadaRedundantClient::GetRedundantCopies(void) const
+{
+    return m_redundantCopies;
+}
+
+} // namespace ns3
@@ -0,0 +1,44 @@
+#ifndef MP_REDUNDANT_NADA_H
+#define MP_REDUNDANT_NADA_H
+
+#include "mp-strategy.h"
+
+namespace ns3
+{
+
+/**
+ * \brief Multipath strategy sending every packet on all ready paths
+ *
+ * The original goes on the path with the lowest one-way delay and copies
+ * follow on every other ready path. Copies carry the same frame context, so
+ * the receiver keeps whichever arrives first and drops the rest as
+ * duplicates. Only the original counts towards MaxPackets.
+ */
+class MultiPathNadaRedundantClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaRedundantClient>
+{
+public:
+    static TypeId GetTypeId(void);
+
+    MultiPathNadaRedundantClient();
+    virtual ~MultiPathNadaRedundantClient();
+
+    virtual std::string GetStrategyName() const override { return "REDUNDANT"; }
+    virtual void UpdateWeights() override;
+
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+    void OnPacketSent(const std::vector<uint32_t>& readyPaths, uint32_t pathId, uint32_t size);
+
+    /**
+     * \brief Get the number of copies sent in addition to the originals
+     * \return Redundant copies accepted by the path pacers or sockets
+     */
+    uint32_t GetRedundantCopies(void) const;
+
+private:
+    uint32_t m_redundantCopies; // Copies sent on the non-selected paths
+};
+
+} // namespace ns3
+
+#endif /* MP_REDUNDANT_NADA_H */
@@ -55,33 +55,15 @@ MultiPathNadaRoundRobinClient::UpdateWeights()
                << " paths with equal weights (" << equalWeight << " each)");
 }
 
-bool
-MultiPathNadaRoundRobinClient::Send(Ptr<Packet> packet)
+uint32_t
+MultiPathNadaRoundRobinClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
 {
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
-    {
-        return false;
-    }
-
-    // Get ready paths
-    std::vector<uint32_t> readyPaths;
-    for (const auto& pathPair : m_paths)
-    {
-        if (pathPair.second.client && pathPair.second.client->GetSocket() &&
-            IsSocketReady(pathPair.second.client->GetSocket()))
-        {
-            readyPaths.push_back(pathPair.first);
-        }
-    }
-
-    if (readyPaths.empty())
-    {
-        NS_LOG_WARN("ROUND_ROBIN - No ready paths available");
-        return false;
-    }
+    uint32_t selectedPath = readyPaths[m_currentPathIndex % readyPaths.size()];
 
+    NS_LOG_DEBUG("ROUND_ROBIN - Selected path " << selectedPath
+                << " (index: " << m_currentPathIndex % readyPaths.size()
+                << "/" << readyPaths.size() - 1 << ")");
 
-    uint32_t selectedPath = readyPaths[m_currentPathIndex % readyPaths.size()];
     m_currentPathIndex++;
 
     // Prevent overflow
@@ -89,23 +71,7 @@ MultiPathNadaRoundRobinClient::Send(Ptr<Packet> packet)
     {
         m_currentPathIndex = 0;
     }
-
-    if (!packet)
-    {
-        packet = Create<Packet>(m_packetSize);
-    }
-
-    bool sent = SendPacketOnPath(selectedPath, packet);
-    if (sent)
-    {
-        m_totalPacketsSent++;
-
-        NS_LOG_DEBUG("ROUND_ROBIN - Sent packet on path " << selectedPath
-                    << " (index: " << (m_currentPathIndex - 1) % readyPaths.size()
-                    << "/" << readyPaths.size() - 1 << ")");
-    }
-
-    return sent;
+    return selectedPath;
 }
 
 void
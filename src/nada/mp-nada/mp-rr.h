@@ -1,12 +1,13 @@
 #ifndef MP_RR_NADA_H
 #define MP_RR_NADA_H
 
-#include "mp-nada-base.h"
+#include "mp-strategy.h"
 
 namespace ns3
 {
 
-class MultiPathNadaRoundRobinClient : public MultiPathNadaClientBase
+class MultiPathNadaRoundRobinClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaRoundRobinClient>
 {
 public:
     static TypeId GetTypeId(void);
@@ -14,10 +15,12 @@ public:
     MultiPathNadaRoundRobinClient();
     virtual ~MultiPathNadaRoundRobinClient();
 
-    virtual bool Send(Ptr<Packet> packet) override;
     virtual std::string GetStrategyName() const override { return "ROUND_ROBIN"; }
     virtual void UpdateWeights() override;
 
+    static const bool REQUIRE_SOCKET_READY = true;
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+
 private:
     uint32_t m_currentPathIndex;
     std::vector<uint32_t> m_pathOrder;
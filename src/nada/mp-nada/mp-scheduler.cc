@@ -0,0 +1,230 @@
+#include "mp-scheduler.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PathScheduler");
+
+PathScheduler::PathScheduler()
+    : m_mode(ALIAS),
+      m_valid(false),
+      m_cursor(0)
+{
+}
+
+void
+PathScheduler::SetMode(Mode mode)
+{
+    if (mode != m_mode)
+    {
+        m_mode = mode;
+        m_valid = false;
+    }
+}
+
+PathScheduler::Mode
+PathScheduler::GetMode(void) const
+{
+    return m_mode;
+}
+
+void
+PathScheduler::SetRandomStream(Ptr<UniformRandomVariable> rng)
+{
+    m_rng = rng;
+}
+
+bool
+PathScheduler::SetWeights(const std::vector<uint32_t>& pathIds, const std::vector<double>& weights)
+{
+    NS_ASSERT(pathIds.size() == weights.size());
+
+    if (m_valid && pathIds == m_pathIds && weights == m_weights)
+    {
+        return false;
+    }
+
+    m_pathIds = pathIds;
+    m_weights = weights;
+    Rebuild();
+    return true;
+}
+
+void
+PathScheduler::Invalidate(void)
+{
+    m_valid = false;
+}
+
+bool
+PathScheduler::IsEmpty(void) const
+{
+    return m_pathIds.empty();
+}
+
+void
+PathScheduler::Rebuild(void)
+{
+    // Only usable weights take part; all-zero means equal shares
+    m_effective = m_weights;
+    double total = 0.0;
+    for (double& weight : m_effective)
+    {
+        if (!(weight > 0.0) || !std::isfinite(weight))
+        {
+            weight = 0.0;
+        }
+        total += weight;
+    }
+    if (total <= 0.0)
+    {
+        std::fill(m_effective.begin(), m_effective.end(), 1.0);
+    }
+
+    if (m_mode == ALIAS)
+    {
+        BuildAliasTable();
+    }
+    else
+    {
+        BuildSequence();
+    }
+    m_valid = true;
+
+    NS_LOG_DEBUG("Rebuilt " << (m_mode == ALIAS ? "alias table" : "weighted sequence") << " for "
+                            << m_pathIds.size() << " paths");
+}
+
+void
+PathScheduler::BuildAliasTable(void)
+{
+    uint32_t n = m_pathIds.size();
+    m_probability.assign(n, 1.0);
+    m_alias.resize(n);
+    m_scaled.resize(n);
+    m_small.clear();
+    m_large.clear();
+
+    double total = 0.0;
+    for (double weight : m_effective)
+    {
+        total += weight;
+    }
+
+    // Vose's method: split every slot between itself and one larger slot
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        m_alias[i] = i;
+        m_scaled[i] = m_effective[i] * n / total;
+        (m_scaled[i] < 1.0 ? m_small : m_large).push_back(i);
+    }
+
+    while (!m_small.empty() && !m_large.empty())
+    {
+        uint32_t less = m_small.back();
+        m_small.pop_back();
+        uint32_t more = m_large.back();
+        m_large.pop_back();
+
+        m_probability[less] = m_scaled[less];
+        m_alias[less] = more;
+        m_scaled[more] = (m_scaled[more] + m_scaled[less]) - 1.0;
+        (m_scaled[more] < 1.0 ? m_small : m_large).push_back(more);
+    }
+
+    // Whatever is left is 1.0 up to rounding error
+    for (uint32_t i : m_small)
+    {
+        m_probability[i] = 1.0;
+    }
+    for (uint32_t i : m_large)
+    {
+        m_probability[i] = 1.0;
+    }
+}
+
+void
+PathScheduler::BuildSequence(void)
+{
+    uint32_t n = m_pathIds.size();
+    m_sequence.clear();
+    m_cursor = 0;
+    if (n == 0)
+    {
+        return;
+    }
+
+    double total = 0.0;
+    for (double weight : m_effective)
+    {
+        total += weight;
+    }
+
+    // Integer shares of the sequence; every usable path gets at least one slot
+    std::vector<int64_t> share(n, 0);
+    int64_t shareTotal = 0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (m_effective[i] > 0.0)
+        {
+            share[i] = std::max<int64_t>(1, std::llround(m_effective[i] / total * SEQUENCE_LENGTH));
+            shareTotal += share[i];
+        }
+    }
+
+    // Smooth weighted round robin: add shares, pick the largest credit, charge it the total
+    std::vector<int64_t> credit(n, 0);
+    m_sequence.reserve(shareTotal);
+    for (int64_t slot = 0; slot < shareTotal; ++slot)
+    {
+        uint32_t best = 0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            credit[i] += share[i];
+            if (credit[i] > credit[best])
+            {
+                best = i;
+            }
+        }
+        credit[best] -= shareTotal;
+        m_sequence.push_back(m_pathIds[best]);
+    }
+}
+
+uint32_t
+PathScheduler::Next(void)
+{
+    uint32_t n = m_pathIds.size();
+    if (n == 0)
+    {
+        return 0;
+    }
+    if (!m_valid)
+    {
+        Rebuild();
+    }
+
+    if (m_mode == SMOOTH_WRR)
+    {
+        uint32_t pathId = m_sequence[m_cursor];
+        m_cursor = (m_cursor + 1) % m_sequence.size();
+        return pathId;
+    }
+
+    if (n == 1)
+    {
+        return m_pathIds[0];
+    }
+
+    // One uniform draw picks both the slot and the coin
+    double u = (m_rng ? m_rng->GetValue(0.0, 1.0) : 0.5) * n;
+    uint32_t slot = std::min<uint32_t>(static_cast<uint32_t>(u), n - 1);
+    return (u - slot < m_probability[slot]) ? m_pathIds[slot] : m_pathIds[m_alias[slot]];
+}
+
+} // namespace ns3
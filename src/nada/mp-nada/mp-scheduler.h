@@ -0,0 +1,100 @@
+#ifndef MP_SCHEDULER_H
+#define MP_SCHEDULER_H
+
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Weighted path selection with O(1), allocation-free draws
+ *
+ * The selection structure is rebuilt only when SetWeights() is given a
+ * different set of paths or weights, which in practice happens when a
+ * strategy's UpdateWeights() runs or a path becomes ready. Two modes:
+ *
+ * - ALIAS: Walker/Vose alias table, one draw from the RNG stream per packet.
+ * - SMOOTH_WRR: deterministic smooth weighted round robin (as in nginx),
+ *   precomputed into a sequence of SEQUENCE_LENGTH slots so that paths are
+ *   interleaved rather than sent in bursts.
+ *
+ * The scheduler does not own its random stream; the client passes in one
+ * persistent UniformRandomVariable whose stream it sets in AssignStreams().
+ */
+class PathScheduler
+{
+  public:
+    enum Mode
+    {
+        ALIAS = 0,     //!< Random draw from an alias table
+        SMOOTH_WRR = 1 //!< Deterministic interleaved sequence
+    };
+
+    /// Number of slots in the smooth weighted round robin sequence
+    static const uint32_t SEQUENCE_LENGTH = 100;
+
+    PathScheduler();
+
+    void SetMode(Mode mode);
+    Mode GetMode(void) const;
+
+    /**
+     * \brief Set the random stream used by the ALIAS mode
+     * \param rng Persistent stream owned by the client
+     */
+    void SetRandomStream(Ptr<UniformRandomVariable> rng);
+
+    /**
+     * \brief Set the candidate paths and their weights
+     *
+     * Cheap when nothing changed. Non-positive or non-finite weights count
+     * as zero; if every weight is zero the paths are used equally.
+     *
+     * \param pathIds Candidate paths
+     * \param weights Weight of each path, same order as pathIds
+     * \return true if the selection structure was rebuilt
+     */
+    bool SetWeights(const std::vector<uint32_t>& pathIds, const std::vector<double>& weights);
+
+    /**
+     * \brief Pick the next path
+     * \return The selected path ID; 0 if no path was set
+     */
+    uint32_t Next(void);
+
+    bool IsEmpty(void) const;
+
+    /**
+     * \brief Force the next SetWeights() call to rebuild
+     */
+    void Invalidate(void);
+
+  private:
+    void Rebuild(void);
+    void BuildAliasTable(void);
+    void BuildSequence(void);
+
+    Mode m_mode;                        // Selection mode
+    Ptr<UniformRandomVariable> m_rng;   // Stream for ALIAS draws
+    bool m_valid;                       // Structure matches m_pathIds/m_weights
+
+    std::vector<uint32_t> m_pathIds;    // Paths the structure was built for
+    std::vector<double> m_weights;      // Weights the structure was built for, as given
+    std::vector<double> m_effective;    // m_weights with unusable entries fixed up
+
+    std::vector<double> m_probability;  // Alias table: probability of keeping slot i
+    std::vector<uint32_t> m_alias;      // Alias table: index used otherwise
+    std::vector<double> m_scaled;       // Scratch space for the table build
+    std::vector<uint32_t> m_small;      // Scratch space for the table build
+    std::vector<uint32_t> m_large;      // Scratch space for the table build
+
+    std::vector<uint32_t> m_sequence;   // SMOOTH_WRR: path IDs in send order
+    uint32_t m_cursor;                  // SMOOTH_WRR: next slot in m_sequence
+};
+
+} // namespace ns3
+
+#endif /* MP_SCHEDULER_H */
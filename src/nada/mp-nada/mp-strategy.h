@@ -0,0 +1,78 @@
+#ifndef MP_STRATEGY_H
+#define MP_STRATEGY_H
+
+#include "mp-nada-base.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \brief Send path shared by every strategy that picks a path per packet
+ *
+ * Strategy is the derived client (CRTP). It provides
+ *
+ *     uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
+ *
+ * and may hide REQUIRE_SOCKET_READY and OnPacketSent() to change them.
+ * The calls are resolved at compile time, so the selection policy of the
+ * per-packet send is inlined instead of going through a virtual call, and
+ * the checks around it exist only once.
+ */
+template <class Strategy>
+class MultiPathNadaStrategyClient : public MultiPathNadaClientBase
+{
+public:
+    virtual bool Send(Ptr<Packet> packet) override
+    {
+        if (!CanSend())
+        {
+            return false;
+        }
+
+        Strategy* strategy = static_cast<Strategy*>(this);
+        const std::vector<uint32_t>& readyPaths = GetReadyPaths(Strategy::REQUIRE_SOCKET_READY);
+        if (readyPaths.empty())
+        {
+            WarnNoReadyPaths(strategy->GetStrategyName());
+            return false;
+        }
+
+        if (!packet)
+        {
+            packet = Create<Packet>(m_packetSize);
+        }
+
+        // SendPacketOnPath() adds the NadaHeader, so the size is taken first
+        uint32_t size = packet->GetSize();
+        uint32_t pathId = strategy->SelectPath(readyPaths, size);
+        if (!SendPacketOnPath(pathId, packet))
+        {
+            return false;
+        }
+
+        strategy->OnPacketSent(readyPaths, pathId, size);
+        return true;
+    }
+
+protected:
+    /// Only offer paths whose socket passes IsSocketReady()
+    static const bool REQUIRE_SOCKET_READY = false;
+
+    /**
+     * \brief Called after a packet left on the selected path
+     * \param readyPaths The candidates the path was selected from
+     * \param pathId The selected path
+     * \param size Payload size of the packet, without NadaHeader
+     */
+    void OnPacketSent([[maybe_unused]] const std::vector<uint32_t>& readyPaths,
+                      [[maybe_unused]] uint32_t pathId,
+                      [[maybe_unused]] uint32_t size)
+    {
+    }
+};
+
+} // namespace ns3
+
+#endif /* MP_STRATEGY_H */
@@ -1,6 +1,5 @@
 #include "mp-weighted.h"
 #include "ns3/log.h"
-#include "ns3/random-variable-stream.h"
 
 namespace ns3
 {
@@ -82,48 +81,12 @@ MultiPathNadaWeightedClient::UpdateWeights()
                        << currentWeight << " -> " << newWeight);
         }
     }
-
-    // Recalculate path order for performance optimization
-    RecalculatePathOrder();
 }
 
-bool
-MultiPathNadaWeightedClient::Send(Ptr<Packet> packet)
+uint32_t
+MultiPathNadaWeightedClient::SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t)
 {
-    if (!m_running || m_totalPacketsSent >= m_maxPackets)
-    {
-        return false;
-    }
-
-    std::vector<uint32_t> availablePaths;
-    for (const auto& pathPair : m_paths)
-    {
-        if (pathPair.second.client && pathPair.second.client->GetSocket())
-        {
-            availablePaths.push_back(pathPair.first);
-        }
-    }
-
-    if (availablePaths.empty())
-    {
-        NS_LOG_WARN("WEIGHTED - No available paths");
-        return false;
-    }
-
-    uint32_t selectedPath = GetWeightedPath(availablePaths);
-
-    if (!packet)
-    {
-        packet = Create<Packet>(m_packetSize);
-    }
-
-    bool sent = SendPacketOnPath(selectedPath, packet);
-    if (sent)
-    {
-        m_totalPacketsSent++;
-    }
-
-    return sent;
+    return SelectWeightedPath(readyPaths);
 }
 
 void
@@ -175,117 +138,4 @@ MultiPathNadaWeightedClient::RecoverPath(uint32_t pathId)
     }
 }
 
-void
-MultiPathNadaWeightedClient::RecalculatePathOrder()
-{
-    m_pathOrder.clear();
-
-    if (m_paths.empty())
-    {
-        return;
-    }
-
-    const uint32_t SEQUENCE_LENGTH = 100; // Process 100 packets per sequence
-
-    // Calculate total weight
-    double totalWeight = 0.0;
-    for (const auto& pathPair : m_paths)
-    {
-        totalWeight += pathPair.second.weight;
-    }
-
-    if (totalWeight <= 0.0)
-    {
-        // Equal distribution fallback
-        for (const auto& pathPair : m_paths)
-        {
-            for (uint32_t i = 0; i < SEQUENCE_LENGTH / m_paths.size(); i++)
-            {
-                m_pathOrder.push_back(pathPair.first);
-            }
-        }
-        return;
-    }
-
-    // Create weighted sequence
-    for (const auto& pathPair : m_paths)
-    {
-        uint32_t pathPackets = static_cast<uint32_t>(
-            (pathPair.second.weight / totalWeight) * SEQUENCE_LENGTH);
-        pathPackets = std::max(1U, pathPackets); // At least 1 packet per path
-
-        for (uint32_t i = 0; i < pathPackets; i++)
-        {
-            m_pathOrder.push_back(pathPair.first);
-        }
-    }
-
-    // Shuffle for better distribution
-    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
-    for (uint32_t i = m_pathOrder.size() - 1; i > 0; i--)
-    {
-        uint32_t j = rng->GetInteger(0, i);
-        std::swap(m_pathOrder[i], m_pathOrder[j]);
-    }
-
-    NS_LOG_DEBUG("WEIGHTED - Recalculated path order with " << m_pathOrder.size() << " entries");
-}
-
-uint32_t
-MultiPathNadaWeightedClient::GetWeightedPath(const std::vector<uint32_t>& readyPaths)
-{
-    if (readyPaths.empty())
-    {
-        return 0;
-    }
-
-    // Calculate total weight of ready paths
-    double totalWeight = 0.0;
-    std::map<uint32_t, double> normalizedWeights;
-
-    for (auto pathId : readyPaths)
-    {
-        auto it = m_paths.find(pathId);
-        if (it != m_paths.end())
-        {
-            totalWeight += it->second.weight;
-            normalizedWeights[pathId] = it->second.weight;
-        }
-    }
-
-    if (totalWeight <= 0.0)
-    {
-        // Use equal weights
-        for (auto pathId : readyPaths)
-        {
-            normalizedWeights[pathId] = 1.0 / readyPaths.size();
-        }
-        totalWeight = 1.0;
-    }
-    else
-    {
-        // Normalize weights
-        for (auto& pair : normalizedWeights)
-        {
-            pair.second /= totalWeight;
-        }
-    }
-
-    // Select path based on random value
-    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
-    double r = rng->GetValue(0.0, 1.0);
-    double cumulativeProb = 0.0;
-
-    for (auto pathId : readyPaths)
-    {
-        cumulativeProb += normalizedWeights[pathId];
-        if (r <= cumulativeProb)
-        {
-            return pathId;
-        }
-    }
-
-    return readyPaths[0]; // Fallback
-}
-
 } // namespace ns3
@@ -1,12 +1,13 @@
 #ifndef MP_WEIGHTED_NADA_H
 #define MP_WEIGHTED_NADA_H
 
-#include "mp-nada-base.h"
+#include "mp-strategy.h"
 
 namespace ns3
 {
 
-class MultiPathNadaWeightedClient : public MultiPathNadaClientBase
+class MultiPathNadaWeightedClient
+    : public MultiPathNadaStrategyClient<MultiPathNadaWeightedClient>
 {
 public:
     static TypeId GetTypeId(void);
@@ -14,17 +15,13 @@ public:
     MultiPathNadaWeightedClient();
     virtual ~MultiPathNadaWeightedClient();
 
-    virtual bool Send(Ptr<Packet> packet) override;
     virtual std::string GetStrategyName() const override { return "WEIGHTED"; }
     virtual void UpdateWeights() override;
 
-private:
-    // Pre-calculated path selection for performance
-    std::vector<uint32_t> m_pathOrder;
+    uint32_t SelectPath(const std::vector<uint32_t>& readyPaths, uint32_t size);
 
-    void RecalculatePathOrder();
+private:
     void RecoverPath(uint32_t pathId);
-    uint32_t GetWeightedPath(const std::vector<uint32_t>& readyPaths);
 };
 
 } // namespace ns3
@@ -0,0 +1,348 @@
+#include "nada-coupled-group.h"
+
+#include "nada-improved.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaCoupledGroup");
+NS_OBJECT_ENSURE_REGISTERED(NadaCoupledGroup);
+
+TypeId
+NadaCoupledGroup::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::NadaCoupledGroup")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<NadaCoupledGroup>()
+            .AddAttribute("Mode",
+                          "Subflow coupling (0=uncoupled, 1=always coupled, "
+                          "2=coupled when a shared bottleneck is detected)",
+                          UintegerValue(AUTO),
+                          MakeUintegerAccessor(&NadaCoupledGroup::m_mode),
+                          MakeUintegerChecker<uint32_t>(0, 2))
+            .AddAttribute("SampleInterval",
+                          "Spacing of the delay gradient samples used for "
+                          "shared bottleneck detection",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&NadaCoupledGroup::m_sampleInterval),
+                          MakeTimeChecker())
+            .AddAttribute("WindowSize",
+                          "Number of delay gradient samples correlated per subflow (at most 64)",
+                          UintegerValue(20),
+                          MakeUintegerAccessor(&NadaCoupledGroup::m_windowSize),
+                          MakeUintegerChecker<uint32_t>(4, MAX_WINDOW_SIZE))
+            .AddAttribute("CorrelationThreshold",
+                          "Delay gradient correlation above which two subflows "
+                          "are considered to share a bottleneck",
+                          DoubleValue(0.6),
+                          MakeDoubleAccessor(&NadaCoupledGroup::m_correlationThreshold),
+                          MakeDoubleChecker<double>(-1.0, 1.0));
+    return tid;
+}
+
+NadaCoupledGroup::NadaCoupledGroup()
+    : m_mode(AUTO),
+      m_sampleInterval(MilliSeconds(100)),
+      m_windowSize(20),
+      m_correlationThreshold(0.6),
+      m_lastSample(Seconds(0))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NadaCoupledGroup::~NadaCoupledGroup()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NadaCoupledGroup::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_members.clear();
+    Object::DoDispose();
+}
+
+void
+NadaCoupledGroup::AddMember(NadaCongestionControl* member)
+{
+    NS_LOG_FUNCTION(this << member);
+
+    if (!member || FindMember(member) >= 0)
+    {
+        return;
+    }
+
+    Member entry;
+    entry.cc = member;
+    entry.cluster = m_members.size();
+    m_members.push_back(entry);
+    UpdateClusters();
+}
+
+void
+NadaCoupledGroup::RemoveMember(NadaCongestionControl* member)
+{
+    NS_LOG_FUNCTION(this << member);
+
+    int32_t index = FindMember(member);
+    if (index < 0)
+    {
+        return;
+    }
+
+    m_members.erase(m_members.begin() + index);
+    UpdateClusters();
+}
+
+uint32_t
+NadaCoupledGroup::GetNSubflows(void) const
+{
+    return m_members.size();
+}
+
+void
+NadaCoupledGroup::SetMode(Mode mode)
+{
+    m_mode = mode;
+    UpdateClusters();
+}
+
+NadaCoupledGroup::Mode
+NadaCoupledGroup::GetMode(void) const
+{
+    return static_cast<Mode>(m_mode);
+}
+
+void
+NadaCoupledGroup::Update(void)
+{
+    Time now = Simulator::Now();
+    if (now - m_lastSample < m_sampleInterval)
+    {
+        return;
+    }
+
+    m_lastSample = now;
+    Sample();
+    UpdateClusters();
+}
+
+bool
+NadaCoupledGroup::SharesBottleneck(const NadaCongestionControl* a,
+                                   const NadaCongestionControl* b) const
+{
+    int32_t ia = FindMember(a);
+    int32_t ib = FindMember(b);
+    if (ia < 0 || ib < 0)
+    {
+        return false;
+    }
+    return m_members[ia].cluster == m_members[ib].cluster;
+}
+
+double
+NadaCoupledGroup::GetGradientCorrelation(const NadaCongestionControl* a,
+                                         const NadaCongestionControl* b) const
+{
+    int32_t ia = FindMember(a);
+    int32_t ib = FindMember(b);
+    if (ia < 0 || ib < 0)
+    {
+        return 0.0;
+    }
+    return Correlation(m_members[ia].gradients, m_members[ib].gradients, m_windowSize);
+}
+
+double
+NadaCoupledGroup::GetCoupledScore(const NadaCongestionControl* member, double score) const
+{
+    int32_t index = FindMember(member);
+    if (index < 0)
+    {
+        return score;
+    }
+
+    uint32_t cluster = m_members[index].cluster;
+    double weightedScore = 0.0;
+    double totalRate = 0.0;
+    uint32_t coupled = 0;
+    for (const Member& m : m_members)
+    {
+        if (m.cluster != cluster)
+        {
+            continue;
+        }
+        double rate = m.cc->GetCurrentRate().GetBitRate();
+        weightedScore += rate * m.cc->GetLastScore();
+        totalRate += rate;
+        coupled++;
+    }
+
+    if (coupled < 2 || totalRate <= 0.0)
+    {
+        return score;
+    }
+
+    return std::max(score, weightedScore / totalRate);
+}
+
+double
+NadaCoupledGroup::GetCoupledIncrease(const NadaCongestionControl* member, double increase) const
+{
+    int32_t index = FindMember(member);
+    if (index < 0)
+    {
+        return increase;
+    }
+
+    // Growing each subflow in proportion to its share of the best path rate
+    // bounds the total increase by what the best path alone would take
+    uint32_t cluster = m_members[index].cluster;
+    double totalRate = 0.0;
+    double bestRate = 0.0;
+    for (const Member& m : m_members)
+    {
+        if (m.cluster != cluster)
+        {
+            continue;
+        }
+        double rate = m.cc->GetCurrentRate().GetBitRate();
+        totalRate += rate;
+        bestRate = std::max(bestRate, rate);
+    }
+
+    if (totalRate <= 0.0)
+    {
+        return increase;
+    }
+
+    return increase * bestRate / totalRate;
+}
+
+int32_t
+NadaCoupledGroup::FindMember(const NadaCongestionControl* member) const
+{
+    for (size_t i = 0; i < m_members.size(); i++)
+    {
+        if (m_members[i].cc == member)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void
+NadaCoupledGroup::Sample(void)
+{
+    for (Member& m : m_members)
+    {
+        // The window holds MAX_WINDOW_SIZE samples; Correlation() reads the newest m_windowSize
+        m.gradients.Push(m.cc->GetDelayGradient());
+    }
+}
+
+void
+NadaCoupledGroup::UpdateClusters(void)
+{
+    for (size_t i = 0; i < m_members.size(); i++)
+    {
+        m_members[i].cluster = (m_mode == COUPLED) ? 0 : i;
+    }
+
+    if (m_mode != AUTO)
+    {
+        return;
+    }
+
+    // Members are few, so a quadratic pass with path halving is plenty
+    auto find = [this](uint32_t i) {
+        while (m_members[i].cluster != i)
+        {
+            m_members[i].cluster = m_members[m_members[i].cluster].cluster;
+            i = m_members[i].cluster;
+        }
+        return i;
+    };
+
+    for (size_t i = 0; i < m_members.size(); i++)
+    {
+        for (size_t j = i + 1; j < m_members.size(); j++)
+        {
+            double corr =
+                Correlation(m_members[i].gradients, m_members[j].gradients, m_windowSize);
+            if (corr >= m_correlationThreshold)
+            {
+                uint32_t ri = find(i);
+                uint32_t rj = find(j);
+                m_members[std::max(ri, rj)].cluster = std::min(ri, rj);
+
+                NS_LOG_DEBUG("Subflows " << i << " and " << j
+                            << " share a bottleneck (correlation " << corr << ")");
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_members.size(); i++)
+    {
+        m_members[i].cluster = find(i);
+    }
+}
+
+double
+NadaCoupledGroup::Correlation(const GradientWindow& x,
+                              const GradientWindow& y,
+                              uint32_t window)
+{
+    // Both series are sampled together, so align them on their newest end
+    uint32_t n = std::min({x.Size(), y.Size(), window});
+    if (n < 4)
+    {
+        return 0.0;
+    }
+
+    uint32_t ox = x.Size() - n;
+    uint32_t oy = y.Size() - n;
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        meanX += x[ox + i];
+        meanY += y[oy + i];
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double covXY = 0.0;
+    double varX = 0.0;
+    double varY = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double dx = x[ox + i] - meanX;
+        double dy = y[oy + i] - meanY;
+        covXY += dx * dy;
+        varX += dx * dx;
+        varY += dy * dy;
+    }
+
+    // Flat series carry no evidence either way
+    if (varX < 1e-18 || varY < 1e-18)
+    {
+        return 0.0;
+    }
+
+    return covXY / std::sqrt(varX * varY);
+}
+
+} // namespace ns3
@@ -0,0 +1,139 @@
+#ifndef NADA_COUPLED_GROUP_H
+#define NADA_COUPLED_GROUP_H
+
+#include "ns3/nada-window-stats.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class NadaCongestionControl;
+
+/**
+ * \ingroup internet
+ * \brief Couples the NADA controllers of the subflows of one multipath flow
+ *
+ * Modelled after LIA/OLIA for MPTCP (RFC 6356). Subflows that share a
+ * bottleneck see one aggregate congestion score, and their rate increases are
+ * scaled so the group as a whole grows no faster than its best single path
+ * would. Shared bottlenecks are detected by correlating the delay gradients
+ * of the subflows: paths whose queueing delay rises and falls together are
+ * coupled, disjoint paths keep their independent behaviour.
+ *
+ * Members register themselves through NadaCongestionControl::SetCoupledGroup
+ * and are held by raw pointer; they unregister when disposed.
+ */
+class NadaCoupledGroup : public Object
+{
+  public:
+    /**
+     * \brief Which subflows are coupled
+     */
+    enum Mode
+    {
+        UNCOUPLED = 0, //!< Every subflow runs independently
+        COUPLED = 1,   //!< All subflows are assumed to share one bottleneck
+        AUTO = 2       //!< Couple subflows with correlated delay gradients
+    };
+
+    /// Largest WindowSize; the gradient windows are allocated at this size
+    static const uint32_t MAX_WINDOW_SIZE = 64;
+
+    static TypeId GetTypeId(void);
+    NadaCoupledGroup();
+    virtual ~NadaCoupledGroup();
+
+    /**
+     * \brief Add a subflow controller to the group
+     * \param member Controller to add; ignored if already present
+     */
+    void AddMember(NadaCongestionControl* member);
+
+    /**
+     * \brief Remove a subflow controller from the group
+     * \param member Controller to remove
+     */
+    void RemoveMember(NadaCongestionControl* member);
+
+    /**
+     * \brief Get the number of subflows in the group
+     * \return Number of members
+     */
+    uint32_t GetNSubflows(void) const;
+
+    void SetMode(Mode mode);
+    Mode GetMode(void) const;
+
+    /**
+     * \brief Sample the delay gradients and refresh bottleneck detection
+     *
+     * Called by members before every rate update; samples are only taken
+     * once per SampleInterval so all members contribute aligned series.
+     */
+    void Update(void);
+
+    /**
+     * \brief Check whether two subflows are treated as sharing a bottleneck
+     * \param a First member
+     * \param b Second member
+     * \return true if the rate updates of a and b are coupled
+     */
+    bool SharesBottleneck(const NadaCongestionControl* a, const NadaCongestionControl* b) const;
+
+    /**
+     * \brief Pearson correlation of the sampled delay gradients of two members
+     * \param a First member
+     * \param b Second member
+     * \return Correlation in [-1, 1], or 0 without enough samples
+     */
+    double GetGradientCorrelation(const NadaCongestionControl* a,
+                                  const NadaCongestionControl* b) const;
+
+    /**
+     * \brief Combine a member's score with the score of its bottleneck group
+     * \param member Member updating its rate
+     * \param score The member's own congestion score
+     * \return The larger of the own score and the rate-weighted group score
+     */
+    double GetCoupledScore(const NadaCongestionControl* member, double score) const;
+
+    /**
+     * \brief Scale a member's rate increase to the single-path equivalent
+     * \param member Member updating its rate
+     * \param increase Increase the member would apply on its own (bps)
+     * \return increase * (best member rate / total rate) over the coupled set
+     */
+    double GetCoupledIncrease(const NadaCongestionControl* member, double increase) const;
+
+  protected:
+    virtual void DoDispose(void) override;
+
+  private:
+    typedef NadaSampleWindow<double, MAX_WINDOW_SIZE> GradientWindow;
+
+    struct Member
+    {
+        NadaCongestionControl* cc;     // Registered controller
+        GradientWindow gradients;      // Delay gradient samples, oldest first
+        uint32_t cluster;              // Index of the member heading its bottleneck set
+    };
+
+    int32_t FindMember(const NadaCongestionControl* member) const;
+    void Sample(void);
+    void UpdateClusters(void);
+    static double Correlation(const GradientWindow& x, const GradientWindow& y, uint32_t window);
+
+    std::vector<Member> m_members;  // Subflows of the multipath flow
+    uint32_t m_mode;                // Mode
+    Time m_sampleInterval;          // Spacing of delay gradient samples
+    uint32_t m_windowSize;          // Samples kept per member for correlation
+    double m_correlationThreshold;  // Correlation above which paths are coupled
+    Time m_lastSample;              // Time of the last sample
+};
+
+} // namespace ns3
+
+#endif /* NADA_COUPLED_GROUP_H */
@@ -2,14 +2,301 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("NadaHeader");
 NS_OBJECT_ENSURE_REGISTERED(NadaHeader);
 
+namespace
+{
+
+// Flags byte of the compact data layout
+const uint16_t DATA_VIDEO = 0x01;       // U32 frame size + U8 frame type
+const uint16_t DATA_OVERHEAD = 0x02;    // U16 overhead factor in 1/1000
+const uint16_t DATA_PACKET_SIZE = 0x04; // U16 packet size in bytes
+const uint16_t DATA_FRAME_INFO = 0x08;  // U32 frame id + U16 packet index + U16 packets in frame
+const uint16_t DATA_FEC = 0x10;         // U16 FEC source packets
+
+// Flags byte of the compact feedback layout
+const uint16_t FB_RECV_TIMESTAMP = 0x01;  // U64 receive timestamp in ns
+const uint16_t FB_RECEIVE_RATE = 0x02;    // U32 receive rate in kbps
+const uint16_t FB_LOSS_RATE = 0x04;       // U16 loss fraction in 1/65535
+const uint16_t FB_ECN = 0x08;             // No payload, the flag is the value
+const uint16_t FB_DELAY_GRADIENT = 0x10;  // I32 delay gradient in 1e-6
+const uint16_t FB_REFERENCE_DELTA = 0x20; // I32 reference delta in 1e-6
+const uint16_t FB_ARRIVAL_OFFSET = 0x40;  // I32 arrival time offset in ns
+const uint16_t FB_ACK_VECTOR = 0x0100;    // Variable-size NadaAckVector (extended byte)
+const uint16_t FB_BUFFER_STATE = 0x0200;  // U16 buffer depth ms + U16 playout target ms + U32 underruns
+
+// The NACK layout has no optional fields: U16 count + count * (U32 frame id + U16 packet index)
+const uint32_t NACK_ENTRY_SIZE = 6;
+
+// Shared by both layouts: a second flags byte (bits 8-15) follows
+const uint16_t WIRE_EXTENDED = 0x80;
+
+// Version/type byte + flags byte + U32 seq + U64 timestamp
+const uint32_t COMPACT_PREFIX_SIZE = 14;
+const uint32_t LEGACY_SIZE = 78;
+
+uint32_t
+CompactSize(NadaHeader::PacketType type, uint16_t wireFlags)
+{
+    uint32_t size = COMPACT_PREFIX_SIZE + ((wireFlags & 0xff00) ? 1 : 0);
+    if (type == NadaHeader::DATA)
+    {
+        size += (wireFlags & DATA_VIDEO) ? 5 : 0;
+        size += (wireFlags & DATA_OVERHEAD) ? 2 : 0;
+        size += (wireFlags & DATA_PACKET_SIZE) ? 2 : 0;
+        size += (wireFlags & DATA_FRAME_INFO) ? 8 : 0;
+        size += (wireFlags & DATA_FEC) ? 2 : 0;
+    }
+    else if (type == NadaHeader::NACK)
+    {
+        size += 2;
+    }
+    else
+    {
+        size += (wireFlags & FB_RECV_TIMESTAMP) ? 8 : 0;
+        size += (wireFlags & FB_RECEIVE_RATE) ? 4 : 0;
+        size += (wireFlags & FB_LOSS_RATE) ? 2 : 0;
+        size += (wireFlags & FB_DELAY_GRADIENT) ? 4 : 0;
+        size += (wireFlags & FB_REFERENCE_DELTA) ? 4 : 0;
+        size += (wireFlags & FB_ARRIVAL_OFFSET) ? 4 : 0;
+        size += (wireFlags & FB_BUFFER_STATE) ? 8 : 0;
+    }
+    return size;
+}
+
+template <typename T>
+T
+SaturateRound(double value)
+{
+    double lo = static_cast<double>(std::numeric_limits<T>::min());
+    double hi = static_cast<double>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::clamp(std::round(value), lo, hi));
+}
+
+uint64_t
+DoubleToBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(double));
+    return bits;
+}
+
+double
+BitsToDouble(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(double));
+    return value;
+}
+
+// U32 base seq + U64 reference + U16 run count + U16 delta count
+const uint32_t ACK_VECTOR_PREFIX_SIZE = 16;
+
+// Larger gaps start a new vector rather than a long run of losses
+const uint32_t ACK_VECTOR_MAX_GAP = 1024;
+
+} // namespace
+
+NadaAckVector::NadaAckVector()
+    : m_baseSeq(0),
+      m_highestSeq(0),
+      m_received(0),
+      m_reference(Seconds(0)),
+      m_lastArrival(Seconds(0))
+{
+}
+
+void
+NadaAckVector::Clear(void)
+{
+    m_baseSeq = 0;
+    m_highestSeq = 0;
+    m_received = 0;
+    m_reference = Seconds(0);
+    m_lastArrival = Seconds(0);
+    m_runs.clear();
+    m_deltas.clear();
+}
+
+void
+NadaAckVector::AppendRun(bool received, uint32_t length)
+{
+    uint16_t status = received ? 0x8000 : 0;
+    while (length > 0)
+    {
+        if (!m_runs.empty() && (m_runs.back() & 0x8000) == status &&
+            (m_runs.back() & 0x7fff) < 0x7fff)
+        {
+            uint32_t room = 0x7fff - (m_runs.back() & 0x7fff);
+            uint32_t added = std::min(room, length);
+            m_runs.back() += static_cast<uint16_t>(added);
+            length -= added;
+        }
+        else
+        {
+            uint32_t added = std::min<uint32_t>(0x7fff, length);
+            m_runs.push_back(static_cast<uint16_t>(status | added));
+            length -= added;
+        }
+    }
+}
+
+bool
+NadaAckVector::Record(uint32_t seq, Time arrival)
+{
+    if (m_runs.empty())
+    {
+        m_baseSeq = seq;
+        m_highestSeq = seq;
+        m_received = 1;
+        m_reference = arrival;
+        m_lastArrival = arrival;
+        AppendRun(true, 1);
+        m_deltas.push_back(0);
+        return true;
+    }
+
+    if (seq <= m_highestSeq || seq - m_highestSeq - 1 > ACK_VECTOR_MAX_GAP)
+    {
+        return false;
+    }
+
+    double ticks = std::round(static_cast<double>((arrival - m_lastArrival).GetNanoSeconds()) /
+                              DELTA_TICK_NS);
+    if (ticks < std::numeric_limits<int16_t>::min() || ticks > std::numeric_limits<int16_t>::max())
+    {
+        return false;
+    }
+
+    AppendRun(false, seq - m_highestSeq - 1);
+    AppendRun(true, 1);
+    m_deltas.push_back(static_cast<int16_t>(ticks));
+
+    // Track the quantized time so rounding errors do not accumulate
+    m_lastArrival += NanoSeconds(static_cast<int64_t>(ticks) * DELTA_TICK_NS);
+    m_highestSeq = seq;
+    m_received++;
+    return true;
+}
+
+bool
+NadaAckVector::IsEmpty(void) const
+{
+    return m_runs.empty();
+}
+
+uint32_t
+NadaAckVector::GetBaseSequence(void) const
+{
+    return m_baseSeq;
+}
+
+uint32_t
+NadaAckVector::GetHighestSequence(void) const
+{
+    return m_highestSeq;
+}
+
+uint32_t
+NadaAckVector::GetReceivedCount(void) const
+{
+    return m_received;
+}
+
+uint32_t
+NadaAckVector::GetSpan(void) const
+{
+    return m_runs.empty() ? 0 : m_highestSeq - m_baseSeq + 1;
+}
+
+Time
+NadaAckVector::GetReferenceTime(void) const
+{
+    return m_reference;
+}
+
+uint32_t
+NadaAckVector::GetSerializedSize(void) const
+{
+    return ACK_VECTOR_PREFIX_SIZE + 2 * static_cast<uint32_t>(m_runs.size() + m_deltas.size());
+}
+
+void
+NadaAckVector::Serialize(Buffer::Iterator& start) const
+{
+    start.WriteHtonU32(m_baseSeq);
+    start.WriteHtonU64(static_cast<uint64_t>(m_reference.GetNanoSeconds()));
+    start.WriteHtonU16(static_cast<uint16_t>(m_runs.size()));
+    start.WriteHtonU16(static_cast<uint16_t>(m_deltas.size()));
+    for (uint16_t chunk : m_runs)
+    {
+        start.WriteHtonU16(chunk);
+    }
+    for (int16_t delta : m_deltas)
+    {
+        start.WriteHtonU16(static_cast<uint16_t>(delta));
+    }
+}
+
+uint32_t
+NadaAckVector::Deserialize(Buffer::Iterator& start, uint32_t remaining)
+{
+    Clear();
+    if (remaining < ACK_VECTOR_PREFIX_SIZE)
+    {
+        return 0;
+    }
+
+    m_baseSeq = start.ReadNtohU32();
+    m_reference = NanoSeconds(static_cast<int64_t>(start.ReadNtohU64()));
+    uint16_t runCount = start.ReadNtohU16();
+    uint16_t deltaCount = start.ReadNtohU16();
+
+    uint32_t size = ACK_VECTOR_PREFIX_SIZE + 2 * (static_cast<uint32_t>(runCount) + deltaCount);
+    if (remaining < size)
+    {
+        Clear();
+        return 0;
+    }
+
+    uint32_t span = 0;
+    m_runs.reserve(runCount);
+    for (uint16_t i = 0; i < runCount; ++i)
+    {
+        uint16_t chunk = start.ReadNtohU16();
+        m_runs.push_back(chunk);
+        span += chunk & 0x7fff;
+        m_received += (chunk & 0x8000) ? (chunk & 0x7fff) : 0;
+    }
+
+    int64_t arrival = m_reference.GetNanoSeconds();
+    m_deltas.reserve(deltaCount);
+    for (uint16_t i = 0; i < deltaCount; ++i)
+    {
+        int16_t delta = static_cast<int16_t>(start.ReadNtohU16());
+        m_deltas.push_back(delta);
+        arrival += delta * DELTA_TICK_NS;
+    }
+
+    m_highestSeq = span > 0 ? m_baseSeq + span - 1 : m_baseSeq;
+    m_lastArrival = NanoSeconds(arrival);
+    return size;
+}
+
+NadaHeader::WireFormat NadaHeader::s_wireFormat = NadaHeader::COMPACT;
+
 NadaHeader::NadaHeader()
-    : m_seq(0),
+    : m_type(DATA),
+      m_fields(0),
+      m_seq(0),
       m_timestamp(0),
       m_recvTimestamp(0),
       m_receiveRate(0.0),
@@ -20,8 +307,15 @@ NadaHeader::NadaHeader()
       m_packetSize(0),
       m_videoFrameSize(0),
       m_videoFrameType(0),
+      m_frameId(0),
+      m_packetIndex(0),
+      m_packetsInFrame(0),
+      m_sourcePackets(0),
       m_arrivalTimeOffset(0),
-      m_referenceDelta(0.0)
+      m_referenceDelta(0.0),
+      m_bufferDepth(Seconds(0)),
+      m_playoutTarget(Seconds(0)),
+      m_bufferUnderruns(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -47,65 +341,226 @@ NadaHeader::GetInstanceTypeId(void) const
     return GetTypeId();
 }
 
+void
+NadaHeader::SetWireFormat(WireFormat format)
+{
+    NS_LOG_FUNCTION_NOARGS();
+    s_wireFormat = format;
+}
+
+NadaHeader::WireFormat
+NadaHeader::GetWireFormat(void)
+{
+    return s_wireFormat;
+}
+
 void
 NadaHeader::Print(std::ostream& os) const
 {
     NS_LOG_FUNCTION(this << &os);
-    os << "seq=" << m_seq << " timestamp=" << m_timestamp << " recv_timestamp=" << m_recvTimestamp
+    os << (m_type == FEEDBACK ? "feedback" : (m_type == NACK ? "nack" : "data")) << " seq=" << m_seq
+       << " timestamp=" << m_timestamp << " recv_timestamp=" << m_recvTimestamp
        << " receive_rate=" << m_receiveRate << " loss_rate=" << m_lossRate
        << " ecn_marked=" << m_ecnMarked << " overhead_factor=" << m_overheadFactor
        << " delay_gradient=" << m_delayGradient << " packet_size=" << m_packetSize
        << " video_frame_size=" << m_videoFrameSize;
+    if (m_fields & FIELD_FRAME_INFO)
+    {
+        os << " frame=" << m_frameId << " packet=" << m_packetIndex << "/" << m_packetsInFrame;
+    }
+    if (m_fields & FIELD_FEC)
+    {
+        os << " fec_source=" << m_sourcePackets;
+    }
+    if (m_fields & FIELD_BUFFER_STATE)
+    {
+        os << " buffer=" << m_bufferDepth.GetMilliSeconds() << "/"
+           << m_playoutTarget.GetMilliSeconds() << "ms underruns=" << m_bufferUnderruns;
+    }
+    for (const NadaNack& nack : m_nacks)
+    {
+        os << " nack=" << nack.frameId << ":" << nack.packetIndex;
+    }
+}
+
+uint16_t
+NadaHeader::GetWireFlags(void) const
+{
+    uint16_t flags = 0;
+    if (m_type == DATA)
+    {
+        flags |= (m_fields & FIELD_VIDEO) ? DATA_VIDEO : 0;
+        flags |= (m_fields & FIELD_OVERHEAD) ? DATA_OVERHEAD : 0;
+        flags |= (m_fields & FIELD_PACKET_SIZE) ? DATA_PACKET_SIZE : 0;
+        flags |= (m_fields & FIELD_FRAME_INFO) ? DATA_FRAME_INFO : 0;
+        flags |= (m_fields & FIELD_FEC) ? DATA_FEC : 0;
+    }
+    else if (m_type == FEEDBACK)
+    {
+        flags |= (m_fields & FIELD_RECV_TIMESTAMP) ? FB_RECV_TIMESTAMP : 0;
+        flags |= (m_fields & FIELD_RECEIVE_RATE) ? FB_RECEIVE_RATE : 0;
+        flags |= (m_fields & FIELD_LOSS_RATE) ? FB_LOSS_RATE : 0;
+        flags |= m_ecnMarked ? FB_ECN : 0;
+        flags |= (m_fields & FIELD_DELAY_GRADIENT) ? FB_DELAY_GRADIENT : 0;
+        flags |= (m_fields & FIELD_REFERENCE_DELTA) ? FB_REFERENCE_DELTA : 0;
+        flags |= (m_fields & FIELD_ARRIVAL_OFFSET) ? FB_ARRIVAL_OFFSET : 0;
+        flags |= (m_fields & FIELD_ACK_VECTOR) ? FB_ACK_VECTOR : 0;
+        flags |= (m_fields & FIELD_BUFFER_STATE) ? FB_BUFFER_STATE : 0;
+    }
+    return flags;
 }
 
 uint32_t
 NadaHeader::GetSerializedSize(void) const
 {
     NS_LOG_FUNCTION(this);
-    // 4 bytes (seq) + 8 bytes (timestamp) + 8 bytes (recv timestamp) +
-    // 8 bytes (receive rate) + 8 bytes (loss rate) + 1 byte (ECN) +
-    // 8 bytes (overhead) + 8 bytes (delay gradient) + 4 bytes (packet size) +
-    // 4 bytes (video frame size) + 1 byte (video frame type) +
-    // 8 bytes (arrival time offset) + 8 bytes (reference delta)
-    return 78; // Updated to include all fields
+    if (s_wireFormat == LEGACY)
+    {
+        // 4 bytes (seq) + 8 bytes (timestamp) + 8 bytes (recv timestamp) +
+        // 8 bytes (receive rate) + 8 bytes (loss rate) + 1 byte (ECN) +
+        // 8 bytes (overhead) + 8 bytes (delay gradient) + 4 bytes (packet size) +
+        // 4 bytes (video frame size) + 1 byte (video frame type) +
+        // 8 bytes (arrival time offset) + 8 bytes (reference delta)
+        return LEGACY_SIZE;
+    }
+    uint16_t wireFlags = GetWireFlags();
+    uint32_t size = CompactSize(m_type, wireFlags);
+    if (m_type == FEEDBACK && (wireFlags & FB_ACK_VECTOR))
+    {
+        size += m_ackVector.GetSerializedSize();
+    }
+    if (m_type == NACK)
+    {
+        size += NACK_ENTRY_SIZE * std::min<size_t>(m_nacks.size(), 0xffff);
+    }
+    return size;
 }
 
 void
 NadaHeader::Serialize(Buffer::Iterator start) const
 {
     NS_LOG_FUNCTION(this << &start);
-    // Basic fields
+    if (s_wireFormat == LEGACY)
+    {
+        SerializeLegacy(start);
+        return;
+    }
+
+    uint16_t wireFlags = GetWireFlags();
+    start.WriteU8(static_cast<uint8_t>((COMPACT_VERSION << 4) | (m_type & 0x0f)));
+    if (wireFlags & 0xff00)
+    {
+        start.WriteU8(static_cast<uint8_t>((wireFlags & 0x7f) | WIRE_EXTENDED));
+        start.WriteU8(static_cast<uint8_t>(wireFlags >> 8));
+    }
+    else
+    {
+        start.WriteU8(static_cast<uint8_t>(wireFlags));
+    }
     start.WriteHtonU32(m_seq);
     start.WriteHtonU64(m_timestamp);
-    start.WriteHtonU64(m_recvTimestamp);
 
-    // Serialize doubles directly as bytes
-    // This approach is more portable than reinterpret_cast
-    uint64_t receiveRate, lossRate, overheadFactor, delayGradient, referenceDelta;
+    if (m_type == DATA)
+    {
+        if (wireFlags & DATA_VIDEO)
+        {
+            start.WriteHtonU32(m_videoFrameSize);
+            start.WriteU8(m_videoFrameType);
+        }
+        if (wireFlags & DATA_OVERHEAD)
+        {
+            start.WriteHtonU16(SaturateRound<uint16_t>(m_overheadFactor * 1000.0));
+        }
+        if (wireFlags & DATA_PACKET_SIZE)
+        {
+            start.WriteHtonU16(static_cast<uint16_t>(std::min<uint32_t>(m_packetSize, 0xffff)));
+        }
+        if (wireFlags & DATA_FRAME_INFO)
+        {
+            start.WriteHtonU32(m_frameId);
+            start.WriteHtonU16(m_packetIndex);
+            start.WriteHtonU16(m_packetsInFrame);
+        }
+        if (wireFlags & DATA_FEC)
+        {
+            start.WriteHtonU16(m_sourcePackets);
+        }
+        return;
+    }
+
+    if (m_type == NACK)
+    {
+        uint16_t count = static_cast<uint16_t>(std::min<size_t>(m_nacks.size(), 0xffff));
+        start.WriteHtonU16(count);
+        for (uint16_t i = 0; i < count; i++)
+        {
+            start.WriteHtonU32(m_nacks[i].frameId);
+            start.WriteHtonU16(m_nacks[i].packetIndex);
+        }
+        return;
+    }
+
+    if (wireFlags & FB_RECV_TIMESTAMP)
+    {
+        start.WriteHtonU64(m_recvTimestamp);
+    }
+    if (wireFlags & FB_RECEIVE_RATE)
+    {
+        start.WriteHtonU32(SaturateRound<uint32_t>(m_receiveRate / 1000.0));
+    }
+    if (wireFlags & FB_LOSS_RATE)
+    {
+        start.WriteHtonU16(SaturateRound<uint16_t>(std::clamp(m_lossRate, 0.0, 1.0) * 65535.0));
+    }
+    if (wireFlags & FB_DELAY_GRADIENT)
+    {
+        start.WriteHtonU32(static_cast<uint32_t>(SaturateRound<int32_t>(m_delayGradient * 1e6)));
+    }
+    if (wireFlags & FB_REFERENCE_DELTA)
+    {
+        start.WriteHtonU32(static_cast<uint32_t>(SaturateRound<int32_t>(m_referenceDelta * 1e6)));
+    }
+    if (wireFlags & FB_ARRIVAL_OFFSET)
+    {
+        start.WriteHtonU32(static_cast<uint32_t>(
+            SaturateRound<int32_t>(static_cast<double>(m_arrivalTimeOffset))));
+    }
+    if (wireFlags & FB_BUFFER_STATE)
+    {
+        start.WriteHtonU16(SaturateRound<uint16_t>(m_bufferDepth.GetSeconds() * 1000.0));
+        start.WriteHtonU16(SaturateRound<uint16_t>(m_playoutTarget.GetSeconds() * 1000.0));
+        start.WriteHtonU32(m_bufferUnderruns);
+    }
+    if (wireFlags & FB_ACK_VECTOR)
+    {
+        m_ackVector.Serialize(start);
+    }
+}
 
-    // Use memcpy to avoid aliasing issues
-    memcpy(&receiveRate, &m_receiveRate, sizeof(double));
-    memcpy(&lossRate, &m_lossRate, sizeof(double));
-    memcpy(&overheadFactor, &m_overheadFactor, sizeof(double));
-    memcpy(&delayGradient, &m_delayGradient, sizeof(double));
-    memcpy(&referenceDelta, &m_referenceDelta, sizeof(double));
+void
+NadaHeader::SerializeLegacy(Buffer::Iterator start) const
+{
+    // Basic fields
+    start.WriteHtonU32(m_seq);
+    start.WriteHtonU64(m_timestamp);
+    start.WriteHtonU64(m_recvTimestamp);
 
-    start.WriteHtonU64(receiveRate);
-    start.WriteHtonU64(lossRate);
+    // Doubles are written as their raw bit patterns
+    start.WriteHtonU64(DoubleToBits(m_receiveRate));
+    start.WriteHtonU64(DoubleToBits(m_lossRate));
 
     // ECN marking as a byte (boolean)
     start.WriteU8(m_ecnMarked ? 1 : 0);
 
     // Additional fields for RFC compliance
-    start.WriteHtonU64(overheadFactor);
-    start.WriteHtonU64(delayGradient);
+    start.WriteHtonU64(DoubleToBits(m_overheadFactor));
+    start.WriteHtonU64(DoubleToBits(m_delayGradient));
     start.WriteHtonU32(m_packetSize);
     start.WriteHtonU32(m_videoFrameSize);
     start.WriteU8(m_videoFrameType);
 
-    // Add the missing fields
-    start.WriteHtonU64(m_arrivalTimeOffset);
-    start.WriteHtonU64(referenceDelta);
+    start.WriteHtonU64(static_cast<uint64_t>(m_arrivalTimeOffset));
+    start.WriteHtonU64(DoubleToBits(m_referenceDelta));
 }
 
 uint32_t
@@ -115,126 +570,269 @@ NadaHeader::Deserialize(Buffer::Iterator start)
 
     try
     {
-        // Keep track of the start position for calculating total bytes read
-        Buffer::Iterator bufferStart = start;
-        uint32_t headerSize = GetSerializedSize();
+        Reset();
+        uint32_t bytesRead =
+            (s_wireFormat == LEGACY) ? DeserializeLegacy(start) : DeserializeCompact(start);
+        NS_LOG_DEBUG("Deserialized " << bytesRead << " bytes from NadaHeader");
+        return bytesRead;
+    }
+    catch (const std::exception& e)
+    {
+        NS_LOG_ERROR("Exception during NadaHeader::Deserialize: " << e.what());
+        // Set valid defaults in case of error
+        Reset();
+        return 0;
+    }
+}
 
-        // Check if we have enough bytes
-        if (start.GetSize() < headerSize)
-        {
-            NS_LOG_WARN("Buffer size (" << start.GetSize() << ") smaller than required header size ("
-                      << headerSize << ")");
-            return 0;
-        }
+uint32_t
+NadaHeader::DeserializeCompact(Buffer::Iterator start)
+{
+    Buffer::Iterator bufferStart = start;
 
-        // Simple members first - less likely to cause issues
-        m_seq = start.ReadNtohU32();
+    if (start.GetRemainingSize() < COMPACT_PREFIX_SIZE)
+    {
+        NS_LOG_WARN("Buffer size (" << start.GetRemainingSize()
+                                    << ") smaller than compact NadaHeader prefix");
+        return 0;
+    }
 
-        // Read timestamp as raw uint64_t (don't convert to Time yet)
-        m_timestamp = start.ReadNtohU64();
+    uint8_t versionType = start.ReadU8();
+    if ((versionType >> 4) != COMPACT_VERSION)
+    {
+        NS_LOG_WARN("Unsupported NadaHeader version " << static_cast<uint32_t>(versionType >> 4));
+        return 0;
+    }
+    switch (versionType & 0x0f)
+    {
+        case FEEDBACK:
+            m_type = FEEDBACK;
+            break;
+        case NACK:
+            m_type = NACK;
+            break;
+        default:
+            m_type = DATA;
+            break;
+    }
 
-        // Read receive timestamp as raw uint64_t
-        m_recvTimestamp = start.ReadNtohU64();
+    uint16_t wireFlags = start.ReadU8();
+    if (wireFlags & WIRE_EXTENDED)
+    {
+        wireFlags = (wireFlags & 0x7f) | static_cast<uint16_t>(start.ReadU8() << 8);
+    }
 
-        // For double values, read as uint64_t and then convert safely
-        uint64_t receiveRateBytes, lossRateBytes;
+    // GetRemainingSize() only covers what is left after the bytes read above
+    uint32_t consumed = start.GetDistanceFrom(bufferStart);
+    if (start.GetRemainingSize() + consumed < CompactSize(m_type, wireFlags))
+    {
+        NS_LOG_WARN("Buffer too small for NadaHeader flags 0x" << std::hex << wireFlags
+                                                               << std::dec);
+        Reset();
+        return 0;
+    }
 
-        // Check if we have at least 16 bytes for the two doubles
-        if (start.GetRemainingSize() >= 16)
-        {
-            receiveRateBytes = start.ReadNtohU64();
-            lossRateBytes = start.ReadNtohU64();
+    m_seq = start.ReadNtohU32();
+    m_timestamp = start.ReadNtohU64();
 
-            // Convert to doubles safely
-            memcpy(&m_receiveRate, &receiveRateBytes, sizeof(double));
-            memcpy(&m_lossRate, &lossRateBytes, sizeof(double));
-        }
-        else
+    if (m_type == DATA)
+    {
+        if (wireFlags & DATA_VIDEO)
         {
-            NS_LOG_WARN("Not enough bytes for receive/loss rates, using defaults");
-            m_receiveRate = 0.0;
-            m_lossRate = 0.0;
+            m_videoFrameSize = start.ReadNtohU32();
+            m_videoFrameType = start.ReadU8();
+            m_fields |= FIELD_VIDEO;
         }
-
-        // Continue only if buffer has enough bytes
-        if (start.GetRemainingSize() >= 1)
+        if (wireFlags & DATA_OVERHEAD)
         {
-            uint8_t ecnByte = start.ReadU8();
-            m_ecnMarked = (ecnByte == 1);
+            m_overheadFactor = start.ReadNtohU16() / 1000.0;
+            m_fields |= FIELD_OVERHEAD;
         }
-        else
+        if (wireFlags & DATA_PACKET_SIZE)
         {
-            m_ecnMarked = false;
+            m_packetSize = start.ReadNtohU16();
+            m_fields |= FIELD_PACKET_SIZE;
         }
-
-        // Read overhead factor and delay gradient (doubles)
-        if (start.GetRemainingSize() >= 16)
+        if (wireFlags & DATA_FRAME_INFO)
         {
-            uint64_t overheadBytes = start.ReadNtohU64();
-            uint64_t delayGradientBytes = start.ReadNtohU64();
-
-            memcpy(&m_overheadFactor, &overheadBytes, sizeof(double));
-            memcpy(&m_delayGradient, &delayGradientBytes, sizeof(double));
+            m_frameId = start.ReadNtohU32();
+            m_packetIndex = start.ReadNtohU16();
+            m_packetsInFrame = start.ReadNtohU16();
+            m_fields |= FIELD_FRAME_INFO;
         }
-        else
+        if (wireFlags & DATA_FEC)
         {
-            m_overheadFactor = 1.0;
-            m_delayGradient = 0.0;
+            m_sourcePackets = start.ReadNtohU16();
+            m_fields |= FIELD_FEC;
         }
+        return start.GetDistanceFrom(bufferStart);
+    }
 
-        // Read packet size and video information
-        if (start.GetRemainingSize() >= 12)
+    if (m_type == NACK)
+    {
+        uint16_t count = start.ReadNtohU16();
+        if (start.GetRemainingSize() < NACK_ENTRY_SIZE * count)
         {
-            m_packetSize = start.ReadNtohU32();
-            m_videoFrameSize = start.ReadNtohU32();
-            m_videoFrameType = start.ReadNtohU32();
+            NS_LOG_WARN("Truncated NACK list in NadaHeader");
+            Reset();
+            return 0;
         }
-        else
+        m_nacks.resize(count);
+        for (NadaNack& nack : m_nacks)
         {
-            m_packetSize = 0;
-            m_videoFrameSize = 0;
-            m_videoFrameType = 0;
+            nack.frameId = start.ReadNtohU32();
+            nack.packetIndex = start.ReadNtohU16();
         }
-
-        // Read newer fields added to the header
-        if (start.GetRemainingSize() >= 12)
+        if (count > 0)
         {
-            m_arrivalTimeOffset = start.ReadNtohU32();
-
-            uint64_t refDeltaBytes = start.ReadNtohU64();
-            memcpy(&m_referenceDelta, &refDeltaBytes, sizeof(double));
+            m_fields |= FIELD_NACK;
         }
-        else
+        return start.GetDistanceFrom(bufferStart);
+    }
+
+    if (wireFlags & FB_RECV_TIMESTAMP)
+    {
+        m_recvTimestamp = start.ReadNtohU64();
+        m_fields |= FIELD_RECV_TIMESTAMP;
+    }
+    if (wireFlags & FB_RECEIVE_RATE)
+    {
+        m_receiveRate = start.ReadNtohU32() * 1000.0;
+        m_fields |= FIELD_RECEIVE_RATE;
+    }
+    if (wireFlags & FB_LOSS_RATE)
+    {
+        m_lossRate = start.ReadNtohU16() / 65535.0;
+        m_fields |= FIELD_LOSS_RATE;
+    }
+    if (wireFlags & FB_ECN)
+    {
+        m_ecnMarked = true;
+        m_fields |= FIELD_ECN;
+    }
+    if (wireFlags & FB_DELAY_GRADIENT)
+    {
+        m_delayGradient = static_cast<int32_t>(start.ReadNtohU32()) / 1e6;
+        m_fields |= FIELD_DELAY_GRADIENT;
+    }
+    if (wireFlags & FB_REFERENCE_DELTA)
+    {
+        m_referenceDelta = static_cast<int32_t>(start.ReadNtohU32()) / 1e6;
+        m_fields |= FIELD_REFERENCE_DELTA;
+    }
+    if (wireFlags & FB_ARRIVAL_OFFSET)
+    {
+        m_arrivalTimeOffset = static_cast<int32_t>(start.ReadNtohU32());
+        m_fields |= FIELD_ARRIVAL_OFFSET;
+    }
+    if (wireFlags & FB_BUFFER_STATE)
+    {
+        m_bufferDepth = MilliSeconds(start.ReadNtohU16());
+        m_playoutTarget = MilliSeconds(start.ReadNtohU16());
+        m_bufferUnderruns = start.ReadNtohU32();
+        m_fields |= FIELD_BUFFER_STATE;
+    }
+    if (wireFlags & FB_ACK_VECTOR)
+    {
+        if (m_ackVector.Deserialize(start, start.GetRemainingSize()) == 0)
         {
-            m_arrivalTimeOffset = 0;
-            m_referenceDelta = 0.0;
+            NS_LOG_WARN("Truncated ACK vector in NadaHeader");
+            Reset();
+            return 0;
         }
+        m_fields |= FIELD_ACK_VECTOR;
+    }
+    return start.GetDistanceFrom(bufferStart);
+}
 
-        // Calculate how many bytes we've actually read
-        uint32_t bytesRead = start.GetDistanceFrom(bufferStart);
-        NS_LOG_DEBUG("Deserialized " << bytesRead << " bytes from NadaHeader");
+uint32_t
+NadaHeader::DeserializeLegacy(Buffer::Iterator start)
+{
+    Buffer::Iterator bufferStart = start;
 
-        return bytesRead;
-    }
-    catch (const std::exception& e)
+    if (start.GetRemainingSize() < LEGACY_SIZE)
     {
-        NS_LOG_ERROR("Exception during NadaHeader::Deserialize: " << e.what());
-        // Set valid defaults in case of error
-        m_seq = 0;
-        m_timestamp = 0;
-        m_recvTimestamp = 0;
-        m_receiveRate = 0.0;
-        m_lossRate = 0.0;
-        m_ecnMarked = false;
-        m_overheadFactor = 1.0;
-        m_delayGradient = 0.0;
-        m_packetSize = 0;
-        m_videoFrameSize = 0;
-        m_videoFrameType = 0;
-        m_arrivalTimeOffset = 0;
-        m_referenceDelta = 0.0;
+        NS_LOG_WARN("Buffer size (" << start.GetRemainingSize()
+                                    << ") smaller than required header size (" << LEGACY_SIZE
+                                    << ")");
         return 0;
     }
+
+    m_seq = start.ReadNtohU32();
+    m_timestamp = start.ReadNtohU64();
+    m_recvTimestamp = start.ReadNtohU64();
+    m_receiveRate = BitsToDouble(start.ReadNtohU64());
+    m_lossRate = BitsToDouble(start.ReadNtohU64());
+    m_ecnMarked = (start.ReadU8() == 1);
+    m_overheadFactor = BitsToDouble(start.ReadNtohU64());
+    m_delayGradient = BitsToDouble(start.ReadNtohU64());
+    m_packetSize = start.ReadNtohU32();
+    m_videoFrameSize = start.ReadNtohU32();
+    m_videoFrameType = start.ReadU8();
+    m_arrivalTimeOffset = static_cast<int64_t>(start.ReadNtohU64());
+    m_referenceDelta = BitsToDouble(start.ReadNtohU64());
+
+    // The legacy layout always carries every field
+    m_fields = FIELD_RECV_TIMESTAMP | FIELD_RECEIVE_RATE | FIELD_LOSS_RATE | FIELD_ECN |
+               FIELD_OVERHEAD | FIELD_DELAY_GRADIENT | FIELD_PACKET_SIZE | FIELD_VIDEO |
+               FIELD_ARRIVAL_OFFSET | FIELD_REFERENCE_DELTA;
+
+    return start.GetDistanceFrom(bufferStart);
+}
+
+void
+NadaHeader::Reset(void)
+{
+    m_type = DATA;
+    m_fields = 0;
+    m_seq = 0;
+    m_timestamp = 0;
+    m_recvTimestamp = 0;
+    m_receiveRate = 0.0;
+    m_lossRate = 0.0;
+    m_ecnMarked = false;
+    m_overheadFactor = 1.0;
+    m_delayGradient = 0.0;
+    m_packetSize = 0;
+    m_videoFrameSize = 0;
+    m_videoFrameType = 0;
+    m_frameId = 0;
+    m_packetIndex = 0;
+    m_packetsInFrame = 0;
+    m_sourcePackets = 0;
+    m_arrivalTimeOffset = 0;
+    m_referenceDelta = 0.0;
+    m_ackVector.Clear();
+    m_nacks.clear();
+    m_bufferDepth = Seconds(0);
+    m_playoutTarget = Seconds(0);
+    m_bufferUnderruns = 0;
+}
+
+void
+NadaHeader::SetPacketType(PacketType type)
+{
+    NS_LOG_FUNCTION(this << static_cast<uint32_t>(type));
+    m_type = type;
+}
+
+NadaHeader::PacketType
+NadaHeader::GetPacketType() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_type;
+}
+
+bool
+NadaHeader::IsFeedback() const
+{
+    return m_type == FEEDBACK;
+}
+
+bool
+NadaHeader::HasField(Field field) const
+{
+    return (m_fields & field) != 0;
 }
 
 void
@@ -242,6 +840,7 @@ NadaHeader::SetEcnMarked(bool ecnMarked)
 {
     NS_LOG_FUNCTION(this << ecnMarked);
     m_ecnMarked = ecnMarked;
+    m_fields |= FIELD_ECN;
 }
 
 bool
@@ -256,6 +855,7 @@ NadaHeader::SetOverheadFactor(double factor)
 {
     NS_LOG_FUNCTION(this << factor);
     m_overheadFactor = factor;
+    m_fields |= FIELD_OVERHEAD;
 }
 
 double
@@ -270,6 +870,7 @@ NadaHeader::SetDelayGradient(double gradient)
 {
     NS_LOG_FUNCTION(this << gradient);
     m_delayGradient = gradient;
+    m_fields |= FIELD_DELAY_GRADIENT;
 }
 
 double
@@ -284,6 +885,7 @@ NadaHeader::SetPacketSize(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     m_packetSize = size;
+    m_fields |= FIELD_PACKET_SIZE;
 }
 
 uint32_t
@@ -298,6 +900,7 @@ NadaHeader::SetVideoFrameSize(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     m_videoFrameSize = size;
+    m_fields |= FIELD_VIDEO;
 }
 
 void
@@ -305,6 +908,7 @@ NadaHeader::SetVideoFrameType(uint8_t frameType)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(frameType));
     m_videoFrameType = frameType;
+    m_fields |= FIELD_VIDEO;
 }
 
 uint8_t
@@ -321,6 +925,52 @@ NadaHeader::GetVideoFrameSize() const
     return m_videoFrameSize;
 }
 
+void
+NadaHeader::SetVideoFrameInfo(uint32_t frameId, uint16_t packetIndex, uint16_t packetsInFrame)
+{
+    NS_LOG_FUNCTION(this << frameId << packetIndex << packetsInFrame);
+    m_frameId = frameId;
+    m_packetIndex = packetIndex;
+    m_packetsInFrame = packetsInFrame;
+    m_fields |= FIELD_FRAME_INFO;
+}
+
+void
+NadaHeader::SetFecInfo(uint16_t sourcePackets)
+{
+    NS_LOG_FUNCTION(this << sourcePackets);
+    m_sourcePackets = sourcePackets;
+    m_fields |= FIELD_FEC;
+}
+
+uint32_t
+NadaHeader::GetFrameId() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_frameId;
+}
+
+uint16_t
+NadaHeader::GetPacketIndex() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_packetIndex;
+}
+
+uint16_t
+NadaHeader::GetPacketsInFrame() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_packetsInFrame;
+}
+
+uint16_t
+NadaHeader::GetSourcePackets() const
+{
+    NS_LOG_FUNCTION(this);
+    return (m_fields & FIELD_FEC) ? m_sourcePackets : m_packetsInFrame;
+}
+
 void
 NadaHeader::SetSequenceNumber(uint32_t seq)
 {
@@ -340,6 +990,7 @@ NadaHeader::SetReceiveTimestamp(Time timestamp)
 {
     NS_LOG_FUNCTION(this << timestamp);
     m_recvTimestamp = timestamp.GetNanoSeconds();
+    m_fields |= FIELD_RECV_TIMESTAMP;
 }
 
 void
@@ -347,6 +998,7 @@ NadaHeader::SetReceiveRate(double rate)
 {
     NS_LOG_FUNCTION(this << rate);
     m_receiveRate = rate;
+    m_fields |= FIELD_RECEIVE_RATE;
 }
 
 void
@@ -354,6 +1006,7 @@ NadaHeader::SetLossRate(double lossRate)
 {
     NS_LOG_FUNCTION(this << lossRate);
     m_lossRate = lossRate;
+    m_fields |= FIELD_LOSS_RATE;
 }
 
 uint32_t
@@ -395,12 +1048,8 @@ uint32_t
 NadaHeader::GetStaticSize(void)
 {
     NS_LOG_FUNCTION_NOARGS();
-    // This should return the same size as GetSerializedSize()
-    // 4 bytes (seq) + 8 bytes (timestamp) + 8 bytes (recv timestamp) +
-    // 8 bytes (receive rate) + 8 bytes (loss rate) + 1 byte (ECN) +
-    // 8 bytes (overhead) + 8 bytes (delay gradient) + 4 bytes (packet size) +
-    // 4 bytes (video frame size) + 1 byte (video frame type)
-    return 78;
+    // Data and feedback packets never serialize to less than this
+    return (s_wireFormat == LEGACY) ? LEGACY_SIZE : COMPACT_PREFIX_SIZE;
 }
 
 void
@@ -408,6 +1057,7 @@ NadaHeader::SetArrivalTimeOffset(int64_t offset)
 {
     NS_LOG_FUNCTION(this << offset);
     m_arrivalTimeOffset = offset;
+    m_fields |= FIELD_ARRIVAL_OFFSET;
 }
 
 void
@@ -415,6 +1065,7 @@ NadaHeader::SetReferenceDelta(double referenceDelta)
 {
     NS_LOG_FUNCTION(this << referenceDelta);
     m_referenceDelta = referenceDelta;
+    m_fields |= FIELD_REFERENCE_DELTA;
 }
 
 int64_t
@@ -441,4 +1092,80 @@ NadaHeader::IsHeaderSizeValid(Ptr<Packet> packet) const
     return packet->GetSize() >= NadaHeader::GetStaticSize();
 }
 
+void
+NadaHeader::SetAckVector(const NadaAckVector& ackVector)
+{
+    NS_LOG_FUNCTION(this << ackVector.GetReceivedCount());
+    m_ackVector = ackVector;
+    m_fields |= FIELD_ACK_VECTOR;
+}
+
+const NadaAckVector&
+NadaHeader::GetAckVector() const
+{
+    return m_ackVector;
+}
+
+void
+NadaHeader::AddNack(uint32_t frameId, uint16_t packetIndex)
+{
+    NS_LOG_FUNCTION(this << frameId << packetIndex);
+    m_nacks.push_back(NadaNack{frameId, packetIndex});
+    m_fields |= FIELD_NACK;
+}
+
+const std::vector<NadaNack>&
+NadaHeader::GetNacks() const
+{
+    return m_nacks;
+}
+
+void
+NadaHeader::GetFeedback(NadaFeedback& feedback) const
+{
+    feedback.sequence = m_seq;
+    feedback.ackTimestamp = NanoSeconds(m_timestamp);
+    feedback.receiveRate = m_receiveRate;
+    feedback.lossRate = m_lossRate;
+    feedback.ecnMarked = m_ecnMarked;
+    feedback.ackVector = HasField(FIELD_ACK_VECTOR) ? &m_ackVector : nullptr;
+    // The legacy layout always carries both fields, zero when the receiver set neither
+    feedback.hasForwardDelay = HasField(FIELD_RECV_TIMESTAMP) && HasField(FIELD_ARRIVAL_OFFSET) &&
+                               m_recvTimestamp != 0;
+    feedback.receiveTimestamp = NanoSeconds(m_recvTimestamp);
+    feedback.forwardDelay = NanoSeconds(m_arrivalTimeOffset);
+    feedback.hasBufferState = HasField(FIELD_BUFFER_STATE);
+    feedback.bufferDepth = m_bufferDepth;
+    feedback.playoutTarget = m_playoutTarget;
+    feedback.bufferUnderruns = m_bufferUnderruns;
+}
+
+void
+NadaHeader::SetBufferState(Time depth, Time target, uint32_t underruns)
+{
+    NS_LOG_FUNCTION(this << depth << target << underruns);
+    m_bufferDepth = depth;
+    m_playoutTarget = target;
+    m_bufferUnderruns = underruns;
+    m_fields |= FIELD_BUFFER_STATE;
+}
+
+Time
+NadaHeader::GetBufferDepth() const
+{
+    return m_bufferDepth;
+}
+
+Time
+NadaHeader::GetPlayoutTarget() const
+{
+    return m_playoutTarget;
+}
+
+uint32_t
+NadaHeader::GetBufferUnderruns() const
+{
+    return m_bufferUnderruns;
+}
+
 } // namespace ns3
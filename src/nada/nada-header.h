@@ -5,17 +5,216 @@
 #include "ns3/nstime.h"
 #include "ns3/applications-module.h"
 
+#include <vector>
+
 namespace ns3 {
 
+/**
+ * \ingroup internet
+ * \brief Receive report for a run of packets, carried by aggregated feedback
+ *
+ * Modelled after RFC 8888 / transport-wide congestion control feedback: the
+ * covered sequence range is described by run-length chunks (bit 15 = received,
+ * bits 0-14 = run length) and every received packet contributes a signed
+ * 16-bit arrival delta, in 250 us ticks, relative to the previous received
+ * packet. The first delta is relative to the reference time.
+ */
+class NadaAckVector
+{
+public:
+  /// Resolution of the per-packet arrival deltas
+  static const int64_t DELTA_TICK_NS = 250000;
+
+  NadaAckVector ();
+
+  /**
+   * \brief Drop every recorded packet
+   */
+  void Clear (void);
+
+  /**
+   * \brief Record the arrival of a packet
+   * \param seq Sequence number of the packet
+   * \param arrival Arrival time at the receiver
+   * \return false if the packet cannot be appended (reordered, or too far
+   *         ahead/behind); the caller should flush and start a new vector
+   */
+  bool Record (uint32_t seq, Time arrival);
+
+  bool IsEmpty (void) const;
+  uint32_t GetBaseSequence (void) const;
+  uint32_t GetHighestSequence (void) const;
+  uint32_t GetReceivedCount (void) const;
+  uint32_t GetSpan (void) const;
+  Time GetReferenceTime (void) const;
+
+  /**
+   * \brief Walk every covered sequence number in order
+   * \param f Called as f(seq, received, arrivalTime); arrivalTime is only
+   *        meaningful for received packets
+   */
+  template <typename F>
+  void ForEach (F f) const
+  {
+    uint32_t seq = m_baseSeq;
+    int64_t arrival = m_reference.GetNanoSeconds ();
+    size_t delta = 0;
+    for (uint16_t chunk : m_runs)
+      {
+        bool received = (chunk & 0x8000) != 0;
+        uint16_t length = chunk & 0x7fff;
+        for (uint16_t i = 0; i < length; ++i, ++seq)
+          {
+            if (received && delta < m_deltas.size ())
+              {
+                arrival += m_deltas[delta++] * DELTA_TICK_NS;
+              }
+            f (seq, received, NanoSeconds (arrival));
+          }
+      }
+  }
+
+  uint32_t GetSerializedSize (void) const;
+  void Serialize (Buffer::Iterator &start) const;
+  /**
+   * \brief Read a vector written by Serialize
+   * \param start Iterator positioned at the vector
+   * \param remaining Bytes available from start
+   * \return Bytes read, or 0 if the buffer is truncated
+   */
+  uint32_t Deserialize (Buffer::Iterator &start, uint32_t remaining);
+
+private:
+  void AppendRun (bool received, uint32_t length);
+
+  uint32_t m_baseSeq;               // First sequence number covered
+  uint32_t m_highestSeq;            // Last sequence number covered
+  uint32_t m_received;              // Packets marked received
+  Time m_reference;                 // Arrival time the first delta is relative to
+  Time m_lastArrival;               // Arrival time of the last recorded packet
+  std::vector<uint16_t> m_runs;     // Run-length status chunks
+  std::vector<int16_t> m_deltas;    // Arrival deltas in DELTA_TICK_NS units
+};
+
+/**
+ * \ingroup internet
+ * \brief Receiver report decoded once from a feedback NadaHeader
+ *
+ * Filled by NadaHeader::GetFeedback and completed by the sender with the
+ * delay it measured, then handed by reference to the congestion controller
+ * so the header is never parsed twice.
+ */
+struct NadaFeedback
+{
+  uint32_t sequence;               //!< Acknowledged sequence number (single ACKs)
+  Time ackTimestamp;               //!< Time the receiver sent the feedback
+  double receiveRate;              //!< Receive rate reported by the receiver (bps)
+  double lossRate;                 //!< Loss rate reported by the receiver
+  bool ecnMarked;                  //!< ECN marking seen by the receiver
+  const NadaAckVector *ackVector;  //!< Aggregated report, or nullptr; owned by the header
+  bool hasForwardDelay;            //!< The receiver timed the newest packet it acknowledges
+  Time receiveTimestamp;           //!< Arrival of that packet, receiver clock
+  Time forwardDelay;               //!< Its arrival minus the echoed sender timestamp
+  Time delay;                      //!< Forward one-way delay estimate, set by the sender
+  Time rtt;                        //!< Round-trip time without the hold time, set by the sender
+  uint32_t acked;                  //!< Packets acknowledged, set by the sender
+  bool hasBufferState;             //!< The receiver reported its playout buffer
+  Time bufferDepth;                //!< Media buffered for playout at the receiver
+  Time playoutTarget;              //!< Buffer depth the receiver aims for
+  uint32_t bufferUnderruns;        //!< Underruns the receiver has seen so far
+
+  NadaFeedback ()
+    : sequence (0),
+      ackTimestamp (Seconds (0)),
+      receiveRate (0.0),
+      lossRate (0.0),
+      ecnMarked (false),
+      ackVector (nullptr),
+      hasForwardDelay (false),
+      receiveTimestamp (Seconds (0)),
+      forwardDelay (Seconds (0)),
+      delay (Seconds (0)),
+      rtt (Seconds (0)),
+      acked (0),
+      hasBufferState (false),
+      bufferDepth (Seconds (0)),
+      playoutTarget (Seconds (0)),
+      bufferUnderruns (0)
+  {
+  }
+};
+
+/**
+ * \ingroup internet
+ * \brief Packet of a video frame the receiver asks to have sent again
+ */
+struct NadaNack
+{
+  uint32_t frameId;      //!< Frame the packet belongs to
+  uint16_t packetIndex;  //!< Position of the packet in the frame
+};
+
 /**
  * \ingroup internet
  * \brief Header for NADA (Network-Assisted Dynamic Adaptation) protocol
  *
  * This header follows RFC 8698 Section 5 specifications
+ *
+ * Two encodings are supported. The compact encoding (version 1) starts with
+ * a version/type byte and a flags byte that announces which optional fields
+ * follow, so data packets only carry the video fields and feedback packets
+ * only carry the receiver measurements. Rates and losses are carried as
+ * 32/16-bit fixed-point values. The legacy encoding is the original fixed
+ * 78-byte layout and is kept so older traces can still be compared; it has
+ * no room for the aggregated ACK vector.
  */
 class NadaHeader : public Header
 {
 public:
+  /**
+   * \brief Layout of the packet carrying this header
+   */
+  enum PacketType : uint8_t
+  {
+    DATA = 0,     //!< Media packet sent by a NADA client
+    FEEDBACK = 1, //!< Acknowledgment/feedback sent by the receiver
+    NACK = 2      //!< Retransmission request sent by the receiver (compact only)
+  };
+
+  /**
+   * \brief Wire encodings understood by Serialize/Deserialize
+   */
+  enum WireFormat
+  {
+    COMPACT = 0, //!< Versioned variable-size encoding
+    LEGACY = 1   //!< Original fixed 78-byte layout
+  };
+
+  /**
+   * \brief Optional fields, set as soon as the matching setter is used
+   */
+  enum Field : uint32_t
+  {
+    FIELD_RECV_TIMESTAMP = 1u << 0,
+    FIELD_RECEIVE_RATE = 1u << 1,
+    FIELD_LOSS_RATE = 1u << 2,
+    FIELD_ECN = 1u << 3,
+    FIELD_OVERHEAD = 1u << 4,
+    FIELD_DELAY_GRADIENT = 1u << 5,
+    FIELD_PACKET_SIZE = 1u << 6,
+    FIELD_VIDEO = 1u << 7,
+    FIELD_ARRIVAL_OFFSET = 1u << 8,
+    FIELD_REFERENCE_DELTA = 1u << 9,
+    FIELD_ACK_VECTOR = 1u << 10,
+    FIELD_FRAME_INFO = 1u << 11,
+    FIELD_FEC = 1u << 12,
+    FIELD_NACK = 1u << 13,
+    FIELD_BUFFER_STATE = 1u << 14
+  };
+
+  /// Version written in the high nibble of the first compact byte
+  static const uint8_t COMPACT_VERSION = 1;
+
   /**
    * \brief Constructor
    */
@@ -30,7 +229,23 @@ public:
   virtual void Serialize (Buffer::Iterator start) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
+  /**
+   * \brief Select the encoding used by every NadaHeader in the simulation
+   * \param format COMPACT (default) or LEGACY
+   *
+   * Sender and receiver must agree on the format, so this is a global switch
+   * meant to be flipped once before the simulation starts.
+   */
+  static void SetWireFormat (WireFormat format);
+
+  /**
+   * \brief Get the encoding currently in use
+   * \return The active wire format
+   */
+  static WireFormat GetWireFormat (void);
+
   // Setters
+  void SetPacketType(PacketType type);
   void SetSequenceNumber(uint32_t seq);
   void SetTimestamp(Time timestamp);
   void SetReceiveTimestamp(Time timestamp);
@@ -42,10 +257,58 @@ public:
   void SetPacketSize(uint32_t size);
   void SetVideoFrameSize(uint32_t size);
   void SetVideoFrameType(uint8_t frameType);
+  /**
+   * \brief Identify the packet within its video frame
+   * \param frameId Frame the packet belongs to
+   * \param packetIndex Position of the packet in the frame, from 0
+   * \param packetsInFrame Number of packets the frame was split into
+   *
+   * Only carried by the compact encoding; receivers of legacy headers have
+   * to infer frame boundaries.
+   */
+  void SetVideoFrameInfo(uint32_t frameId, uint16_t packetIndex, uint16_t packetsInFrame);
+  /**
+   * \brief Mark the frame as protected by forward error correction
+   * \param sourcePackets Packets needed to rebuild the frame; packetsInFrame
+   *        then counts source and repair packets together
+   *
+   * Only carried by the compact encoding, alongside the frame info.
+   */
+  void SetFecInfo(uint16_t sourcePackets);
+  /**
+   * \brief Set the arrival time offset of the packet a feedback reports on
+   * \param offset Its arrival time minus the sender timestamp it carried, in
+   *        nanoseconds; the compact encoding sends up to +/-2.1 s
+   *
+   * Together with the receive timestamp this echoes the forward one-way
+   * delay, so the sender does not have to halve the RTT. Any clock offset
+   * between the hosts is part of the value and cancels in the base delay.
+   */
   void SetArrivalTimeOffset(int64_t offset);
   void SetReferenceDelta(double referenceDelta);
+  void SetAckVector(const NadaAckVector& ackVector);
+  /**
+   * \brief Ask for a packet to be sent again
+   * \param frameId Frame the packet belongs to
+   * \param packetIndex Position of the packet in the frame
+   *
+   * Only meaningful on NACK packets.
+   */
+  void AddNack(uint32_t frameId, uint16_t packetIndex);
+  /**
+   * \brief Report the state of the receiver's playout buffer
+   * \param depth Media buffered for playout (sent in ms, up to 65535)
+   * \param target Buffer depth the receiver aims for (sent in ms)
+   * \param underruns Underruns seen so far
+   *
+   * Only carried by the compact encoding, on feedback packets.
+   */
+  void SetBufferState(Time depth, Time target, uint32_t underruns);
 
   // Getters
+  PacketType GetPacketType() const;
+  bool IsFeedback() const;
+  bool HasField(Field field) const;
   uint32_t GetSequenceNumber() const;
   Time GetTimestamp() const;
   Time GetReceiveTimestamp() const;
@@ -57,12 +320,47 @@ public:
   uint32_t GetPacketSize() const;
   uint32_t GetVideoFrameSize() const;
   uint8_t GetVideoFrameType() const;
+  uint32_t GetFrameId() const;
+  uint16_t GetPacketIndex() const;
+  uint16_t GetPacketsInFrame() const;
+  /**
+   * \brief Get the packets needed to rebuild the frame
+   * \return The FEC source packet count, or packetsInFrame without FEC
+   */
+  uint16_t GetSourcePackets() const;
   int64_t GetArrivalTimeOffset() const;
   double GetReferenceDelta() const;
+  const NadaAckVector& GetAckVector() const;
+  const std::vector<NadaNack>& GetNacks() const;
+  Time GetBufferDepth() const;
+  Time GetPlayoutTarget() const;
+  uint32_t GetBufferUnderruns() const;
+
+  /**
+   * \brief Copy the receiver report into a NadaFeedback
+   * \param feedback Receives the report; its ackVector points into this
+   *        header, so the header must outlive it
+   */
+  void GetFeedback (NadaFeedback &feedback) const;
+
+  /**
+   * \brief Smallest serialized size for the active wire format
+   * \return 78 bytes in legacy mode, the fixed compact prefix otherwise
+   */
   static uint32_t GetStaticSize (void);
   bool IsHeaderSizeValid(Ptr<Packet> packet) const;
 
 private:
+  uint16_t GetWireFlags (void) const;
+  void SerializeLegacy (Buffer::Iterator start) const;
+  uint32_t DeserializeLegacy (Buffer::Iterator start);
+  uint32_t DeserializeCompact (Buffer::Iterator start);
+  void Reset (void);
+
+  static WireFormat s_wireFormat;  // Encoding shared by all headers
+
+  PacketType m_type;               // Data or feedback layout
+  uint32_t m_fields;               // Bitmask of present optional fields
   uint32_t m_seq;                  // Sequence number
   uint64_t m_timestamp;            // Sender timestamp in nanoseconds
   uint64_t m_recvTimestamp;        // Receiver timestamp in nanoseconds
@@ -74,8 +372,17 @@ private:
   uint32_t m_packetSize;           // Packet size in bytes
   uint32_t m_videoFrameSize;       // Video frame size in bytes
   uint8_t m_videoFrameType;        // Video frame type (I, P, B frames)
+  uint32_t m_frameId;              // Video frame this packet belongs to
+  uint16_t m_packetIndex;          // Position of the packet in its frame
+  uint16_t m_packetsInFrame;       // Number of packets in the frame
+  uint16_t m_sourcePackets;        // Packets needed to rebuild an FEC frame
   int64_t m_arrivalTimeOffset;     // Arrival time offset in nanoseconds
   double m_referenceDelta;         // Reference delta from RFC
+  NadaAckVector m_ackVector;       // Aggregated receive report (feedback only)
+  std::vector<NadaNack> m_nacks;   // Requested retransmissions (NACK only)
+  Time m_bufferDepth;              // Receiver playout buffer depth
+  Time m_playoutTarget;            // Receiver playout target depth
+  uint32_t m_bufferUnderruns;      // Receiver playout underruns
 };
 
 } // namespace ns3
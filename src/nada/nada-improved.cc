@@ -1,5 +1,6 @@
 #include "nada-improved.h"
 
+#include "nada-header.h"
 #include "nada-udp-client.h"
 
 #include "ns3/address-utils.h"
@@ -56,7 +57,34 @@ NadaCongestionControl::GetTypeId(void)
                                           "Maximum sending rate (bps)",
                                           DoubleValue(20000000.0), // 20 Mbps
                                           MakeDoubleAccessor(&NadaCongestionControl::m_maxRate),
-                                          MakeDoubleChecker<double>(0.0));
+                                          MakeDoubleChecker<double>(0.0))
+                            .AddAttribute("FeedbackDriven",
+                                          "Update the rate when feedback arrives instead of on "
+                                          "a periodic timer",
+                                          BooleanValue(true),
+                                          MakeBooleanAccessor(&NadaCongestionControl::m_feedbackDriven),
+                                          MakeBooleanChecker())
+                            .AddTraceSource("Rate",
+                                            "Sending rate, old and new value, at every change",
+                                            MakeTraceSourceAccessor(&NadaCongestionControl::m_rateTrace),
+                                            "ns3::TracedValueCallback::DataRate")
+                            .AddTraceSource("QueueingDelay",
+                                            "Queueing delay estimate of every delay sample",
+                                            MakeTraceSourceAccessor(&NadaCongestionControl::m_queueingDelayTrace),
+                                            "ns3::Time::TracedCallback")
+                            .AddTraceSource("DelayGradient",
+                                            "Smoothed queueing delay gradient of every delay sample",
+                                            MakeTraceSourceAccessor(&NadaCongestionControl::m_delayGradientTrace),
+                                            "ns3::NadaCongestionControl::ValueTracedCallback")
+                            .AddTraceSource("LossRate",
+                                            "Loss rate of every report",
+                                            MakeTraceSourceAccessor(&NadaCongestionControl::m_lossRateTrace),
+                                            "ns3::NadaCongestionControl::ValueTracedCallback")
+                            .AddTraceSource("Score",
+                                            "Congestion score of every rate update, uncoupled and "
+                                            "as applied",
+                                            MakeTraceSourceAccessor(&NadaCongestionControl::m_scoreTrace),
+                                            "ns3::NadaCongestionControl::ScoreTracedCallback");
     return tid;
 }
 
@@ -74,10 +102,13 @@ NadaCongestionControl::NadaCongestionControl()
       m_referenceDelay(0.010),   // 10ms reference delay
       m_queueDelayTarget(0.020), // 20ms target queue delay
       m_ewmaFactor(0.1),         // EWMA smoothing factor
-      m_ewmaDelayGradient(0.0),   // Initial delay gradient
+      m_ewmaDelayGradient(m_ewmaFactor, 0.0), // Initial delay gradient
       m_videoMode(false),        // Video mode disabled by default
       m_lastKeyFrameTime(0.0),   // Initialize key frame time
-      m_frameSize(0)             // Initialize frame size
+      m_frameSize(0),            // Initialize frame size
+      m_coupledGroup(nullptr),
+      m_lastScore(0.0),
+      m_feedbackDriven(true)
 {
     NS_LOG_FUNCTION(this);
     m_rtt = MilliSeconds(100); // Default initial RTT estimate
@@ -87,6 +118,37 @@ NadaCongestionControl::NadaCongestionControl()
 NadaCongestionControl::~NadaCongestionControl()
 {
     NS_LOG_FUNCTION(this);
+    if (m_coupledGroup)
+    {
+        m_coupledGroup->RemoveMember(this);
+    }
+}
+
+void
+NadaCongestionControl::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_updateEvent);
+    SetCoupledGroup(nullptr);
+    Object::DoDispose();
+}
+
+void
+NadaCongestionControl::SetCoupledGroup(Ptr<NadaCoupledGroup> group)
+{
+    NS_LOG_FUNCTION(this << group);
+
+    if (m_coupledGroup)
+    {
+        m_coupledGroup->RemoveMember(this);
+    }
+
+    m_coupledGroup = group;
+
+    if (m_coupledGroup)
+    {
+        m_coupledGroup->AddMember(this);
+    }
 }
 
 void
@@ -98,9 +160,7 @@ NadaCongestionControl::Init(Ptr<Socket> socket)
     // Use default rate - will be set properly by SetInitialRate
     NS_LOG_INFO("NADA initialized with default rate: " << m_currentRate/1000000.0 << " Mbps");
 
-    // Schedule periodic updates
-    m_updateEvent = Simulator::Schedule(MilliSeconds(100),
-                                       &NadaCongestionControl::PeriodicUpdate, this);
+    SchedulePeriodicUpdate(MilliSeconds(100));
 }
 
 void
@@ -132,7 +192,9 @@ NadaCongestionControl::SetInitialRate(DataRate linkCapacity)
     initialRate = std::max(initialRate, m_minRate);
     initialRate = std::min(initialRate, m_maxRate);
 
+    double oldRate = m_currentRate;
     m_currentRate = initialRate;
+    m_rateTrace(DataRate(oldRate), DataRate(m_currentRate));
 
     // Update max rate based on link capacity (leave 5% headroom)
     m_maxRate = std::min(m_maxRate, linkBps * 0.95);
@@ -146,6 +208,13 @@ void
 NadaCongestionControl::ProcessAck(Ptr<Packet> ack, Time delay)
 {
     NS_LOG_FUNCTION(this << ack << delay);
+    ProcessDelay(delay);
+}
+
+void
+NadaCongestionControl::ProcessDelay(Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
 
     // Update delay measurements
     m_currentDelay = delay.GetSeconds();
@@ -153,6 +222,35 @@ NadaCongestionControl::ProcessAck(Ptr<Packet> ack, Time delay)
 
     // Update RTT estimate (simplified)
     m_rtt = delay * 2; // Assuming symmetric delays for simplicity
+
+    // Track the queueing delay trend, used for shared bottleneck detection
+    double queueingDelay = EstimateQueueingDelay();
+    double gradient = CalculateDelayGradient(queueingDelay);
+
+    m_queueingDelayTrace(Seconds(queueingDelay));
+    m_delayGradientTrace(gradient);
+}
+
+void
+NadaCongestionControl::ProcessFeedback(const NadaFeedback& feedback)
+{
+    NS_LOG_FUNCTION(this << feedback.delay << feedback.lossRate);
+
+    ProcessDelay(feedback.delay);
+    if (feedback.rtt.IsStrictlyPositive())
+    {
+        // Measured, so the symmetric guess of ProcessDelay() is not needed
+        m_rtt = feedback.rtt;
+    }
+    ProcessLoss(feedback.lossRate);
+    ProcessEcn(feedback.ecnMarked);
+    UpdateReceiveRate(feedback.receiveRate);
+
+    // Without a timer the report itself paces the rate updates
+    if (m_feedbackDriven && Simulator::Now() - m_lastUpdateTime >= GetUpdateInterval())
+    {
+        UpdateRate();
+    }
 }
 
 void
@@ -160,12 +258,14 @@ NadaCongestionControl::ProcessLoss(double lossRate)
 {
     NS_LOG_FUNCTION(this << lossRate);
     m_lossRate = lossRate;
+    m_lossRateTrace(lossRate);
 
     // Add more aggressive response to high loss rates
     if (lossRate > 0.2 && m_currentRate > m_minRate*2)
     {
         double oldRate = m_currentRate;
         m_currentRate = m_currentRate * 0.5;
+        m_rateTrace(DataRate(oldRate), DataRate(m_currentRate));
         NS_LOG_INFO("Emergency rate reduction due to high loss: "
                    << oldRate << " -> " << m_currentRate << " bps (loss: " << lossRate << ")");
     }
@@ -177,6 +277,16 @@ NadaCongestionControl::UpdateRate()
     NS_LOG_FUNCTION(this);
 
     double score = CalculateScore();
+    m_lastScore = score;
+
+    // Subflows behind a shared bottleneck react to the congestion of the group
+    if (m_coupledGroup)
+    {
+        m_coupledGroup->Update();
+        score = m_coupledGroup->GetCoupledScore(this, score);
+    }
+    m_scoreTrace(m_lastScore, score);
+
     Time now = Simulator::Now();
     double deltaT = (now - m_lastUpdateTime).GetSeconds();
     m_lastUpdateTime = now;
@@ -219,6 +329,12 @@ NadaCongestionControl::UpdateRate()
             increaseRate = std::min(increaseRate, m_currentRate * 0.1); // Max 10% increase
         }
 
+        // Coupled subflows together grow no faster than the best single path
+        if (m_coupledGroup)
+        {
+            increaseRate = m_coupledGroup->GetCoupledIncrease(this, increaseRate);
+        }
+
         newRate = m_currentRate + increaseRate;
     }
     else if (score < 0.5) {
@@ -256,6 +372,11 @@ NadaCongestionControl::UpdateRate()
         m_currentRate = ApplyVideoAdaptation(m_currentRate);
     }
 
+    if (m_currentRate != oldRate)
+    {
+        m_rateTrace(DataRate(oldRate), DataRate(m_currentRate));
+    }
+
     NS_LOG_DEBUG("NADA rate update: score=" << score
                 << ", old=" << oldRate/1000000.0 << "Mbps"
                 << ", new=" << m_currentRate/1000000.0 << "Mbps"
@@ -270,26 +391,37 @@ NadaCongestionControl::PeriodicUpdate()
     NS_LOG_FUNCTION(this);
 
     UpdateRate();
+    SchedulePeriodicUpdate(GetUpdateInterval());
+}
 
-    // Adaptive update interval based on network capacity and current state
-    Time updateInterval;
+void
+NadaCongestionControl::SchedulePeriodicUpdate(Time delay)
+{
+    // Restarting replaces the pending update, so repeated Init() calls do
+    // not stack several timers
+    Simulator::Cancel(m_updateEvent);
+    if (m_feedbackDriven)
+    {
+        return;
+    }
+    m_updateEvent = Simulator::Schedule(delay, &NadaCongestionControl::PeriodicUpdate, this);
+}
 
+Time
+NadaCongestionControl::GetUpdateInterval() const
+{
+    // Adaptive update interval based on network capacity and current state
     if (m_maxRate >= 1e9) { // 1Gbps+
         // Fast updates during ramp-up phase
         double utilizationRatio = m_currentRate / m_maxRate;
         if (utilizationRatio < 0.5) {
-            updateInterval = MilliSeconds(50); // 50ms during ramp-up
-        } else {
-            updateInterval = MilliSeconds(100); // 100ms during steady state
+            return MilliSeconds(50); // 50ms during ramp-up
         }
-    } else {
-        // RFC recommends once per RTT or 100ms min
-        updateInterval = std::max(m_rtt, MilliSeconds(100));
+        return MilliSeconds(100); // 100ms during steady state
     }
 
-    m_updateEvent = Simulator::Schedule(updateInterval,
-                                       &NadaCongestionControl::PeriodicUpdate,
-                                       this);
+    // RFC recommends once per RTT or 100ms min
+    return std::max(m_rtt, MilliSeconds(100));
 }
 
 double
@@ -338,15 +470,9 @@ NadaCongestionControl::EstimateBaseDelay(Time delay)
 {
     double delayValue = delay.GetSeconds();
 
-    // Store recent delay samples in a window (implement as a circular buffer)
-    m_delayWindow.push_back(delayValue);
-    if (m_delayWindow.size() > 100)
-    { // 10-second window with 100ms sampling
-        m_delayWindow.pop_front();
-    }
-
-    // Find minimum in the window (min-filter approach)
-    double minDelay = *std::min_element(m_delayWindow.begin(), m_delayWindow.end());
+    // Min filter over the last 100 samples (10-second window with 100ms sampling)
+    m_delayWindow.Push(delayValue);
+    double minDelay = m_delayWindow.GetMin();
 
     if (m_baseDelay == 0.0)
     {
@@ -400,44 +526,14 @@ NadaCongestionControl::UpdateReceiveRate(double receiveRate)
 double
 NadaCongestionControl::CalculateDelayGradient(double currentDelay)
 {
-    // Store delay values for gradient calculation
-    m_delayGradients.push_back(currentDelay);
-    if (m_delayGradients.size() > 5) { // Keep last 5 samples
-        m_delayGradients.pop_front();
-    }
-
-    if (m_delayGradients.size() < 2) {
+    // Linear regression slope over the last 5 samples, updated incrementally
+    m_delayGradients.Push(currentDelay);
+    if (m_delayGradients.Size() < 2) {
         return 0.0;
     }
 
-    // Simple linear regression to estimate gradient
-    double sumX = 0;
-    double sumY = 0;
-    double sumXY = 0;
-    double sumX2 = 0;
-    int n = m_delayGradients.size();
-
-    for (int i = 0; i < n; i++) {
-        double x = i;
-        double y = m_delayGradients[i];
-
-        sumX += x;
-        sumY += y;
-        sumXY += x * y;
-        sumX2 += x * x;
-    }
-
-    double denominator = n * sumX2 - sumX * sumX;
-    if (std::abs(denominator) < 1e-10) {
-        return 0.0; // Avoid division by zero
-    }
-
-    double gradient = (n * sumXY - sumX * sumY) / denominator;
-
     // Update EWMA of delay gradient
-    m_ewmaDelayGradient = m_ewmaFactor * gradient + (1 - m_ewmaFactor) * m_ewmaDelayGradient;
-
-    return m_ewmaDelayGradient;
+    return m_ewmaDelayGradient.Update(m_delayGradients.GetSlope());
 }
 
 double
@@ -458,7 +554,7 @@ NadaCongestionControl::ApplyVideoAdaptation(double baseRate)
 
     // 2. Match video rate tiers - find closest viable encoding rate
     // This is simplified - a real implementation would have actual encoding rates
-    const std::vector<double> encodingRates = {
+    static const std::vector<double> encodingRates = {
         500000,   // 500 kbps
         1000000,  // 1 Mbps
         2000000,  // 2 Mbps
@@ -480,24 +576,21 @@ NadaCongestionControl::ApplyVideoAdaptation(double baseRate)
 
     // Add stability logic - don't change rates too frequently
     // Store rate decision in history
-    m_rateHistory.push_back(videoRate);
-    if (m_rateHistory.size() > 10) { // Keep last 10 decisions
-        m_rateHistory.erase(m_rateHistory.begin());
-    }
+    m_rateHistory.Push(videoRate); // Keeps the last 10 decisions
 
     // Only change rate if we've had the same decision multiple times
-    if (m_rateHistory.size() >= 3) {
+    if (m_rateHistory.Size() >= 3) {
         // Count occurrences of the latest rate
         int count = 0;
-        for (size_t i = m_rateHistory.size() - 3; i < m_rateHistory.size(); i++) {
+        for (uint32_t i = m_rateHistory.Size() - 3; i < m_rateHistory.Size(); i++) {
             if (std::abs(m_rateHistory[i] - videoRate) < 1e-6) {
                 count++;
             }
         }
 
         // If we haven't consistently decided on this rate, use previous rate
-        if (count < 2 && !m_rateHistory.empty()) {
-            videoRate = m_rateHistory[m_rateHistory.size() - 1];
+        if (count < 2 && !m_rateHistory.IsEmpty()) {
+            videoRate = m_rateHistory.Back();
         }
     }
 
@@ -508,9 +601,12 @@ void
 NadaCongestionControl::SetVideoMode(bool enable)
 {
     NS_LOG_FUNCTION(this << enable);
+    bool wasEnabled = m_videoMode;
     m_videoMode = enable;
 
-    if (enable) {
+    // Clients enable video mode for every frame; only the first call starts
+    // it, so the key frame time set by UpdateVideoFrameInfo() survives
+    if (enable && !wasEnabled) {
         // Initialize video-specific parameters
         m_lastKeyFrameTime = Simulator::Now().GetSeconds();
         m_frameSize = 0;
@@ -518,16 +614,9 @@ NadaCongestionControl::SetVideoMode(bool enable)
         // When enabling video mode, we should also adjust our update method
         // to use the video rate adaptation logic
 
-        // Cancel any pending update event to restart with new timing
-        if (m_updateEvent.IsPending()) {
-            Simulator::Cancel(m_updateEvent);
-        }
-
-        // Schedule updates at frame-rate frequency (e.g., 30fps = 33.3ms)
+        // Restart the timer (if any) at frame-rate frequency (e.g., 30fps = 33.3ms)
         Time frameInterval = MilliSeconds(33);
-        m_updateEvent = Simulator::Schedule(frameInterval,
-                                           &NadaCongestionControl::PeriodicUpdate,
-                                           this);
+        SchedulePeriodicUpdate(frameInterval);
 
         NS_LOG_INFO("Video mode enabled with " << frameInterval.GetMilliSeconds()
                     << "ms update interval");
@@ -566,10 +655,10 @@ NadaCongestionControl::UpdateVideoFrameInfo(uint32_t frameSize, bool isKeyFrame,
             // by adjusting the parameters used in rate calculation
             if (ratio < 0.8) {
                 // We're sending too little - increase ramp up speed temporarily
-                m_delta *= 1.2;  // Temporary boost to delta
+                m_delta = std::min(m_delta * 1.2, 1.0);  // Temporary boost to delta
             } else if (ratio > 1.2) {
                 // We're sending too much - decrease more aggressively temporarily
-                m_beta *= 1.1;   // Temporary boost to beta
+                m_beta = std::min(m_beta * 1.1, 1.0);   // Temporary boost to beta
             }
         } else {
             // Reset to normal parameters
@@ -12,6 +12,8 @@
 #include "ns3/socket.h"
 #include "ns3/traced-callback.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/nada-coupled-group.h"
+#include "ns3/nada-window-stats.h"
 
 #include <deque>
 #include <vector>
@@ -19,6 +21,8 @@
 namespace ns3
 {
 
+struct NadaFeedback;
+
 /**
  * \ingroup internet
  * \brief NADA congestion control implementation following RFC 8698
@@ -26,6 +30,19 @@ namespace ns3
 class NadaCongestionControl : public Object
 {
   public:
+    /**
+     * TracedCallback signature of the DelayGradient and LossRate traces
+     * \param value The new value
+     */
+    typedef void (*ValueTracedCallback)(double value);
+
+    /**
+     * TracedCallback signature of the Score trace
+     * \param score The uncoupled score
+     * \param appliedScore The score the rate reacted to, after coupling
+     */
+    typedef void (*ScoreTracedCallback)(double score, double appliedScore);
+
     static TypeId GetTypeId(void);
     NadaCongestionControl();
     virtual ~NadaCongestionControl();
@@ -44,11 +61,27 @@ class NadaCongestionControl : public Object
 
     /**
      * \brief Process an acknowledgment
-     * \param ack The acknowledgment packet
+     * \param ack The acknowledgment packet (unused; the header is not parsed)
      * \param delay The one-way delay estimate
      */
     void ProcessAck(Ptr<Packet> ack, Time delay);
 
+    /**
+     * \brief Process one one-way delay sample
+     * \param delay The one-way delay estimate
+     */
+    void ProcessDelay(Time delay);
+
+    /**
+     * \brief Process a decoded receiver report
+     *
+     * Applies the delay sample, loss rate, ECN mark and receive rate in one
+     * call, without touching the feedback packet again.
+     *
+     * \param feedback The report, with delay set by the sender
+     */
+    void ProcessFeedback(const NadaFeedback& feedback);
+
     /**
      * \brief Process packet loss information
      * \param lossRate The reported loss rate
@@ -138,12 +171,60 @@ class NadaCongestionControl : public Object
      */
     void UpdateVideoFrameInfo(uint32_t frameSize, bool isKeyFrame, Time frameInterval);
 
+    /**
+     * \brief Couple this controller with the other subflows of a multipath flow
+     * \param group Group to join, or nullptr to run uncoupled again
+     */
+    void SetCoupledGroup(Ptr<NadaCoupledGroup> group);
+
+    /**
+     * \brief Get the coupled group this controller belongs to
+     * \return The group, or nullptr when uncoupled
+     */
+    Ptr<NadaCoupledGroup> GetCoupledGroup() const
+    {
+        return m_coupledGroup;
+    }
+
+    /**
+     * \brief Get the congestion score of the last rate update
+     * \return The uncoupled score in [0, 1]
+     */
+    double GetLastScore() const
+    {
+        return m_lastScore;
+    }
+
+    /**
+     * \brief Get the smoothed queueing delay gradient
+     * \return EWMA of the delay gradient (s per sample)
+     */
+    double GetDelayGradient() const
+    {
+        return m_ewmaDelayGradient.Get();
+    }
+
+  protected:
+    virtual void DoDispose(void) override;
+
   private:
     /**
      * \brief Periodic update function called on a timer
      */
     void PeriodicUpdate();
 
+    /**
+     * \brief Restart the periodic update timer; does nothing in feedback-driven mode
+     * \param delay Time until the next update
+     */
+    void SchedulePeriodicUpdate(Time delay);
+
+    /**
+     * \brief Time between two rate updates
+     * \return The interval, at least 100ms or one RTT below 1Gbps
+     */
+    Time GetUpdateInterval() const;
+
     /**
      * \brief Calculate the congestion score according to RFC 8698
      * \return The congestion score
@@ -197,20 +278,31 @@ class NadaCongestionControl : public Object
     double m_referenceDelay;    // D_thr from RFC 8698
     double m_queueDelayTarget;  // Target queue delay
     double m_ewmaFactor;        // EWMA smoothing factor
-    double m_ewmaDelayGradient; // EWMA of delay gradient
+    NadaEwma m_ewmaDelayGradient; // EWMA of delay gradient
     bool m_ecnMarked;           // ECN marking status
     double m_receiveRate;       // Estimated receive rate
 
     // Data structures for statistics and processing
-    std::deque<double> m_delayWindow;    // Window for delay measurements
-    std::deque<double> m_delayGradients; // Recent delay gradients
-    std::deque<uint32_t> m_lossWindow;   // Window for loss measurements
-    std::vector<double> m_rateHistory;   // History of sending rates
+    NadaWindowedMin<double, 100> m_delayWindow;  // Minimum of recent delay measurements
+    NadaWindowedSlope<5> m_delayGradients;       // Trend of recent queueing delays
+    NadaSampleWindow<double, 10> m_rateHistory;  // History of video rate decisions
 
     // Video specific state
     bool m_videoMode;          // Whether video adaptation is active
     double m_lastKeyFrameTime; // Time of last key frame
     uint32_t m_frameSize;      // Current frame size
+
+    // Multipath coupling
+    Ptr<NadaCoupledGroup> m_coupledGroup; // Subflows sharing the rate increase
+    double m_lastScore;                   // Uncoupled score of the last update
+    bool m_feedbackDriven;                // Rate updated on feedback, not on a timer
+
+    // Trace sources; firing one nobody is connected to costs a branch
+    TracedCallback<DataRate, DataRate> m_rateTrace; // Sending rate changes
+    TracedCallback<Time> m_queueingDelayTrace;      // Queueing delay samples
+    TracedCallback<double> m_delayGradientTrace;    // Smoothed delay gradient
+    TracedCallback<double> m_lossRateTrace;         // Reported loss rates
+    TracedCallback<double, double> m_scoreTrace;    // Uncoupled and applied scores
 };
 
 /**
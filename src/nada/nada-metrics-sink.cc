@@ -0,0 +1,337 @@
+#include "nada-metrics-sink.h"
+
+#include "agg-path-nada.h"
+#include "video-receiver.h"
+
+#include "mp-nada/mp-nada-base.h"
+
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaMetricsSink");
+NS_OBJECT_ENSURE_REGISTERED(NadaMetricsSink);
+
+namespace
+{
+
+void
+WriteJsonString(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (char c : s)
+    {
+        switch (c)
+        {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\r':
+                os << "\\r";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                // Other control characters are not allowed raw in a JSON string
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    os << escaped;
+                }
+                else
+                {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
+
+} // namespace
+
+TypeId
+NadaMetricsSink::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::NadaMetricsSink")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<NadaMetricsSink>()
+            .AddAttribute("FileName",
+                          "JSON-lines file the rows are written to",
+                          StringValue("nada-metrics.jsonl"),
+                          MakeStringAccessor(&NadaMetricsSink::m_fileName),
+                          MakeStringChecker())
+            .AddAttribute("Interval",
+                          "Time between two polls of the sources (0 = final rows only)",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NadaMetricsSink::m_interval),
+                          MakeTimeChecker());
+    return tid;
+}
+
+NadaMetricsSink::NadaMetricsSink()
+    : m_fileName("nada-metrics.jsonl"),
+      m_interval(Seconds(0)),
+      m_pollStart(0),
+      m_pollFinal(false),
+      m_pollSource(nullptr)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NadaMetricsSink::~NadaMetricsSink()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NadaMetricsSink::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_sampleEvent);
+    m_sources.clear();
+    Object::DoDispose();
+}
+
+void
+NadaMetricsSink::AddSource(const std::string& name, Collector collector)
+{
+    NS_LOG_FUNCTION(this << name);
+    m_sources.emplace_back(name, collector);
+}
+
+void
+NadaMetricsSink::Record(uint32_t path, const std::string& metric, double value)
+{
+    if (!m_pollSource)
+    {
+        NS_LOG_WARN("Metric " << metric << " recorded outside a poll");
+        return;
+    }
+    GetRow(m_pollFinal, *m_pollSource, path).values.emplace_back(metric, value);
+}
+
+void
+NadaMetricsSink::Record(const std::string& metric, double value)
+{
+    Record(NO_PATH, metric, value);
+}
+
+void
+NadaMetricsSink::RecordFinal(const std::string& source,
+                             uint32_t path,
+                             const std::string& metric,
+                             double value)
+{
+    for (Row& row : m_finalRows)
+    {
+        if (row.source == source && row.path == path)
+        {
+            row.values.emplace_back(metric, value);
+            return;
+        }
+    }
+    m_finalRows.push_back(Row{Seconds(0), true, source, path, {{metric, value}}});
+}
+
+void
+NadaMetricsSink::RecordFlowStats(const std::string& source,
+                                 FlowId flowId,
+                                 const FlowMonitor::FlowStats& flow,
+                                 Time duration)
+{
+    RecordFinal(source, flowId, "tx_packets", flow.txPackets);
+    RecordFinal(source, flowId, "rx_packets", flow.rxPackets);
+    RecordFinal(source, flowId, "rx_bytes", flow.rxBytes);
+    RecordFinal(source, flowId, "throughput_mbps", flow.rxBytes * 8.0 / duration.GetSeconds() / 1000000);
+    if (flow.rxPackets > 0)
+    {
+        RecordFinal(source, flowId, "mean_delay_s", flow.delaySum.GetSeconds() / flow.rxPackets);
+    }
+    if (flow.rxPackets > 1)
+    {
+        RecordFinal(source,
+                    flowId,
+                    "mean_jitter_s",
+                    flow.jitterSum.GetSeconds() / (flow.rxPackets - 1));
+    }
+    if (flow.txPackets > 0)
+    {
+        RecordFinal(source,
+                    flowId,
+                    "loss_rate",
+                    static_cast<double>(flow.txPackets - flow.rxPackets) / flow.txPackets);
+    }
+}
+
+void
+NadaMetricsSink::Start(void)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_sampleEvent);
+    if (m_interval.IsStrictlyPositive())
+    {
+        m_sampleEvent = Simulator::Schedule(m_interval, &NadaMetricsSink::Sample, this);
+    }
+}
+
+void
+NadaMetricsSink::Sample(void)
+{
+    Poll(false);
+    m_sampleEvent = Simulator::Schedule(m_interval, &NadaMetricsSink::Sample, this);
+}
+
+void
+NadaMetricsSink::Poll(bool final)
+{
+    m_pollStart = m_rows.size();
+    m_pollFinal = final;
+    for (const auto& source : m_sources)
+    {
+        m_pollSource = &source.first;
+        source.second(this);
+    }
+    m_pollSource = nullptr;
+}
+
+NadaMetricsSink::Row&
+NadaMetricsSink::GetRow(bool final, const std::string& source, uint32_t path)
+{
+    // A poll only produces a handful of rows, so they are searched in place
+    for (size_t i = m_pollStart; i < m_rows.size(); i++)
+    {
+        if (m_rows[i].path == path && m_rows[i].source == source)
+        {
+            return m_rows[i];
+        }
+    }
+    m_rows.push_back(Row{Simulator::Now(), final, source, path, {}});
+    return m_rows.back();
+}
+
+bool
+NadaMetricsSink::Write(void)
+{
+    NS_LOG_FUNCTION(this << m_fileName);
+
+    Simulator::Cancel(m_sampleEvent);
+    Poll(true);
+
+    std::ofstream out(m_fileName);
+    if (!out)
+    {
+        NS_LOG_ERROR("Cannot open metrics file " << m_fileName);
+        return false;
+    }
+
+    out.precision(10);
+    Time now = Simulator::Now();
+    auto writeRow = [&out](const Row& row, Time time) {
+        out << "{\"time\":" << time.GetSeconds() << ",\"kind\":\""
+            << (row.final ? "final" : "interval") << "\",\"source\":";
+        WriteJsonString(out, row.source);
+        if (row.path != NO_PATH)
+        {
+            out << ",\"path\":" << row.path;
+        }
+        for (const auto& value : row.values)
+        {
+            out << ',';
+            WriteJsonString(out, value.first);
+            out << ':';
+            if (std::isfinite(value.second))
+            {
+                out << value.second;
+            }
+            else
+            {
+                out << "null";
+            }
+        }
+        out << "}\n";
+    };
+
+    for (const Row& row : m_rows)
+    {
+        writeRow(row, row.time);
+    }
+    for (const Row& row : m_finalRows)
+    {
+        writeRow(row, now);
+    }
+
+    NS_LOG_INFO("Wrote " << m_rows.size() + m_finalRows.size() << " metric rows to "
+                         << m_fileName);
+    return static_cast<bool>(out);
+}
+
+NadaMetricsSinkHelper::NadaMetricsSinkHelper()
+    : m_fileName(""),
+      m_intervalMs(0)
+{
+}
+
+void
+NadaMetricsSinkHelper::AddCommandLineValues(CommandLine& cmd)
+{
+    cmd.AddValue("metricsFile",
+                 "Write client, receiver and flow metrics to this JSON-lines file",
+                 m_fileName);
+    cmd.AddValue("metricsIntervalMs",
+                 "Also sample the client and receiver metrics every this many ms (0 = end only)",
+                 m_intervalMs);
+}
+
+Ptr<NadaMetricsSink>
+NadaMetricsSinkHelper::Install(Ptr<Application> client, Ptr<Application> receiver) const
+{
+    if (m_fileName.empty())
+    {
+        return nullptr;
+    }
+
+    Ptr<NadaMetricsSink> sink = CreateObject<NadaMetricsSink>();
+    sink->SetAttribute("FileName", StringValue(m_fileName));
+    sink->SetAttribute("Interval", TimeValue(MilliSeconds(m_intervalMs)));
+
+    if (Ptr<AggregatePathNadaClient> agg = DynamicCast<AggregatePathNadaClient>(client))
+    {
+        agg->SetMetricsSink(sink, "client");
+    }
+    else if (Ptr<MultiPathNadaClientBase> mp = DynamicCast<MultiPathNadaClientBase>(client))
+    {
+        mp->SetMetricsSink(sink, "client");
+    }
+    else
+    {
+        NS_LOG_WARN("Client " << client << " reports no metrics");
+    }
+
+    if (Ptr<VideoReceiver> videoReceiver = DynamicCast<VideoReceiver>(receiver))
+    {
+        videoReceiver->SetMetricsSink(sink, "receiver");
+    }
+
+    sink->Start();
+    return sink;
+}
+
+} // namespace ns3
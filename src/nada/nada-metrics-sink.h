@@ -0,0 +1,165 @@
+#ifndef NADA_METRICS_SINK_H
+#define NADA_METRICS_SINK_H
+
+#include "ns3/application.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class CommandLine;
+
+/**
+ * \ingroup internet
+ * \brief Collects the metrics of clients and receivers into one JSON-lines file
+ *
+ * Clients and receivers register as named sources through their
+ * SetMetricsSink() and are polled once when the file is written, and at every
+ * Interval in between if one is set. Each poll produces one row per
+ * source and path:
+ *
+ *     {"time":12.5,"kind":"interval","source":"client","path":0,"rate_bps":...}
+ *
+ * Rows of a source as a whole have no "path". The final poll is marked
+ * "kind":"final", as are values added with RecordFinal(), such as flow
+ * monitor results. The file loads directly into pandas with
+ * pandas.read_json(path, lines=True).
+ *
+ * Sources are held by raw pointer, so Write() must run before they are
+ * disposed.
+ */
+class NadaMetricsSink : public Object
+{
+  public:
+    /// Path of the rows that describe a source as a whole
+    static const uint32_t NO_PATH = 0xffffffff;
+
+    /// Polls a source; it calls Record() for each of its values
+    typedef Callback<void, Ptr<NadaMetricsSink>> Collector;
+
+    static TypeId GetTypeId(void);
+    NadaMetricsSink();
+    virtual ~NadaMetricsSink();
+
+    /**
+     * \brief Register a source to poll
+     * \param name Source column of its rows
+     * \param collector Called at every poll
+     */
+    void AddSource(const std::string& name, Collector collector);
+
+    /**
+     * \brief Add a value to the row of the source being polled
+     * \param path Path the value belongs to, or NO_PATH
+     * \param metric Column name
+     * \param value The value; NaN and infinities are written as null
+     *
+     * Only meaningful from within a Collector.
+     */
+    void Record(uint32_t path, const std::string& metric, double value);
+    void Record(const std::string& metric, double value);
+
+    /**
+     * \brief Add a value known only at the end of the run
+     * \param source Source column of the row
+     * \param path Path the value belongs to, or NO_PATH
+     * \param metric Column name
+     * \param value The value
+     */
+    void RecordFinal(const std::string& source, uint32_t path, const std::string& metric, double value);
+
+    /**
+     * \brief Add the flow monitor results of one flow as a final row
+     *
+     * The flow ID goes in the path column.
+     *
+     * \param source Source column of the row
+     * \param flowId Flow the statistics belong to
+     * \param flow Statistics collected by the FlowMonitor
+     * \param duration Time the throughput is averaged over
+     */
+    void RecordFlowStats(const std::string& source,
+                         FlowId flowId,
+                         const FlowMonitor::FlowStats& flow,
+                         Time duration);
+
+    /**
+     * \brief Start polling every Interval; does nothing without one
+     */
+    void Start(void);
+
+    /**
+     * \brief Poll the sources a last time and write every row to FileName
+     * \return false if the file could not be written
+     */
+    bool Write(void);
+
+  protected:
+    virtual void DoDispose(void) override;
+
+  private:
+    struct Row
+    {
+        Time time;                                         // When the row was sampled
+        bool final;                                        // Written by the final poll
+        std::string source;                                // Source name
+        uint32_t path;                                     // Path, or NO_PATH
+        std::vector<std::pair<std::string, double>> values; // Column names and values
+    };
+
+    void Sample(void);
+    void Poll(bool final);
+    Row& GetRow(bool final, const std::string& source, uint32_t path);
+
+    std::string m_fileName;                                // Output file
+    Time m_interval;                                       // Polling interval, 0 for final rows only
+    EventId m_sampleEvent;                                 // Next interval poll
+    std::vector<std::pair<std::string, Collector>> m_sources; // Registered sources
+    std::vector<Row> m_rows;                               // Rows written by Write()
+    std::vector<Row> m_finalRows;                          // Rows added by RecordFinal()
+    size_t m_pollStart;                                    // First row of the current poll
+    bool m_pollFinal;                                      // The current poll is the final one
+    const std::string* m_pollSource;                       // Source being polled, or nullptr
+};
+
+/**
+ * \brief Sets up a NadaMetricsSink from the command line of a program
+ */
+class NadaMetricsSinkHelper
+{
+  public:
+    NadaMetricsSinkHelper();
+
+    /**
+     * \brief Add the metricsFile and metricsIntervalMs options
+     * \param cmd Command line of the program; the helper must outlive Parse()
+     */
+    void AddCommandLineValues(CommandLine& cmd);
+
+    /**
+     * \brief Create and start a sink polling a client and its receiver
+     *
+     * The client may be an AggregatePathNadaClient or any multipath client.
+     *
+     * \param client Client application, polled as "client"
+     * \param receiver VideoReceiver, polled as "receiver"; may be null
+     * \return The sink, or null if no metricsFile was given
+     */
+    Ptr<NadaMetricsSink> Install(Ptr<Application> client, Ptr<Application> receiver) const;
+
+  private:
+    std::string m_fileName;  // metricsFile; empty disables the sink
+    uint32_t m_intervalMs;   // metricsIntervalMs; 0 for final rows only
+};
+
+} // namespace ns3
+
+#endif /* NADA_METRICS_SINK_H */
@@ -0,0 +1,208 @@
+#include "nada-pacer.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaPacer");
+
+NadaPacer::NadaPacer()
+    : m_queuedBytes(0),
+      m_maxQueueBytes(500000),
+      m_rate(1000000.0),
+      m_burst(3000),
+      m_tokens(3000.0),
+      m_granularity(MicroSeconds(250)),
+      m_lastRefill(Seconds(0))
+{
+}
+
+void
+NadaPacer::SetRate(double bps)
+{
+    m_rate = std::max(bps, 0.0);
+}
+
+void
+NadaPacer::SetBurst(uint32_t bytes)
+{
+    m_burst = bytes;
+    m_tokens = std::min(m_tokens, static_cast<double>(m_burst));
+}
+
+void
+NadaPacer::SetGranularity(Time granularity)
+{
+    m_granularity = granularity;
+}
+
+void
+NadaPacer::SetMaxQueueBytes(uint32_t bytes)
+{
+    m_maxQueueBytes = bytes;
+}
+
+bool
+NadaPacer::Enqueue(const Item& item, bool priority)
+{
+    if (!item.packet)
+    {
+        return false;
+    }
+
+    uint32_t size = item.packet->GetSize();
+    if (m_queuedBytes + size > m_maxQueueBytes)
+    {
+        NS_LOG_DEBUG("Pacer queue full (" << m_queuedBytes << " bytes), refusing packet");
+        return false;
+    }
+
+    if (priority)
+    {
+        m_priority.push_back(item);
+    }
+    else
+    {
+        m_normal.push_back(item);
+    }
+    m_queuedBytes += size;
+    return true;
+}
+
+bool
+NadaPacer::Dequeue(Time now, Item& item)
+{
+    const Item* head = Head();
+    if (!head)
+    {
+        return false;
+    }
+
+    Refill(now);
+
+    // Anything that becomes eligible before the next timer tick goes now
+    uint32_t size = head->packet->GetSize();
+    double slack = m_rate / 8.0 * m_granularity.GetSeconds();
+    if (m_tokens + slack < size)
+    {
+        return false;
+    }
+
+    NadaRingQueue<Item>& lane = m_priority.empty() ? m_normal : m_priority;
+    item = std::move(lane.front());
+    lane.pop_front();
+    m_queuedBytes -= size;
+    m_tokens -= size;
+    return true;
+}
+
+Time
+NadaPacer::GetNextSendTime(Time now)
+{
+    const Item* head = Head();
+    if (!head)
+    {
+        return Time::Max();
+    }
+
+    Refill(now);
+
+    double missing = head->packet->GetSize() - m_tokens;
+    if (missing <= 0.0)
+    {
+        return now;
+    }
+    if (m_rate <= 0.0)
+    {
+        return Time::Max();
+    }
+    return now + std::max(Seconds(missing * 8.0 / m_rate), m_granularity);
+}
+
+void
+NadaPacer::Clear(void)
+{
+    m_priority.clear();
+    m_normal.clear();
+    m_queuedBytes = 0;
+    m_tokens = m_burst;
+}
+
+void
+NadaPacer::Flush(std::vector<Item>& items)
+{
+    NadaRingQueue<Item>* lanes[] = {&m_priority, &m_normal};
+    for (NadaRingQueue<Item>* lane : lanes)
+    {
+        while (!lane->empty())
+        {
+            items.push_back(std::move(lane->front()));
+            lane->pop_front();
+        }
+    }
+    Clear();
+}
+
+bool
+NadaPacer::IsEmpty(void) const
+{
+    return m_priority.empty() && m_normal.empty();
+}
+
+uint32_t
+NadaPacer::GetQueuedPackets(void) const
+{
+    return m_priority.size() + m_normal.size();
+}
+
+uint32_t
+NadaPacer::GetQueuedBytes(void) const
+{
+    return m_queuedBytes;
+}
+
+double
+NadaPacer::GetRate(void) const
+{
+    return m_rate;
+}
+
+uint32_t
+NadaPacer::GetBurst(void) const
+{
+    return m_burst;
+}
+
+void
+NadaPacer::Refill(Time now)
+{
+    if (now > m_lastRefill)
+    {
+        // A burst smaller than the head packet must not stall the queue
+        const Item* head = Head();
+        double cap = std::max<double>(m_burst, head ? head->packet->GetSize() : 0);
+        m_tokens += m_rate / 8.0 * (now - m_lastRefill).GetSeconds();
+        m_tokens = std::min(m_tokens, cap);
+    }
+    m_lastRefill = now;
+}
+
+const NadaPacer::Item*
+NadaPacer::Head(void) const
+{
+    if (!m_priority.empty())
+    {
+        return &m_priority.front();
+    }
+    if (!m_normal.empty())
+    {
+        return &m_normal.front();
+    }
+    return nullptr;
+}
+
+} // namespace ns3
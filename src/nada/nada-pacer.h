@@ -0,0 +1,140 @@
+#ifndef NADA_PACER_H
+#define NADA_PACER_H
+
+#include "ns3/nada-ring-queue.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Token-bucket send queue that releases packets at a target rate
+ *
+ * Packets wait in a FIFO until the bucket holds enough bytes for them. The
+ * bucket fills at the pacing rate and is capped at the burst allowance, so
+ * at most one burst leaves back to back after an idle period. Key frame
+ * packets can be queued in a priority lane that is always served first.
+ *
+ * The pacer owns no timer: the caller asks GetNextSendTime() when the head
+ * can leave and drains the queue with Dequeue(), which lets one timer serve
+ * the pacers of every path.
+ */
+class NadaPacer
+{
+  public:
+    /**
+     * \brief A queued packet and the video frame context to send it with
+     */
+    struct Item
+    {
+        Ptr<Packet> packet;      //!< Payload, without NadaHeader
+        uint32_t frameId;        //!< Video frame the packet belongs to
+        uint16_t packetIndex;    //!< Position of the packet in its frame
+        uint16_t packetsInFrame; //!< Packets in the frame (0 = no frame info)
+        uint16_t sourcePackets;  //!< Packets needed to rebuild the frame (0 = no FEC)
+        bool isKeyFrame;         //!< Packet belongs to a key frame
+
+        Item()
+            : packet(nullptr),
+              frameId(0),
+              packetIndex(0),
+              packetsInFrame(0),
+              sourcePackets(0),
+              isKeyFrame(false)
+        {
+        }
+    };
+
+    NadaPacer();
+
+    /**
+     * \brief Set the rate the bucket fills at
+     * \param bps Pacing rate in bits per second
+     */
+    void SetRate(double bps);
+
+    /**
+     * \brief Set the burst allowance
+     * \param bytes Bytes the bucket may hold after an idle period
+     */
+    void SetBurst(uint32_t bytes);
+
+    /**
+     * \brief Set the timer granularity
+     *
+     * Packets that would become eligible within one granularity of now are
+     * released early, so the driving timer never needs to fire more often.
+     *
+     * \param granularity Timer granularity; sub-millisecond values are fine
+     */
+    void SetGranularity(Time granularity);
+
+    /**
+     * \brief Set the queue limit
+     * \param bytes Queued bytes above which Enqueue() refuses packets
+     */
+    void SetMaxQueueBytes(uint32_t bytes);
+
+    /**
+     * \brief Queue a packet
+     * \param item Packet and frame context
+     * \param priority Queue in the priority lane
+     * \return false if the queue is full
+     */
+    bool Enqueue(const Item& item, bool priority = false);
+
+    /**
+     * \brief Release the head packet if the bucket allows it
+     * \param now Current time
+     * \param item Receives the released packet
+     * \return false if the queue is empty or the head has to wait
+     */
+    bool Dequeue(Time now, Item& item);
+
+    /**
+     * \brief Get the time the head packet becomes eligible
+     * \param now Current time
+     * \return now if it can leave right away, Time::Max() if the queue is empty
+     */
+    Time GetNextSendTime(Time now);
+
+    /**
+     * \brief Drop every queued packet and refill the bucket
+     */
+    void Clear(void);
+
+    /**
+     * \brief Take every queued packet out, as when the path stops carrying them
+     * \param items Receives the packets, priority lane first, in release order
+     */
+    void Flush(std::vector<Item>& items);
+
+    bool IsEmpty(void) const;
+    uint32_t GetQueuedPackets(void) const;
+    uint32_t GetQueuedBytes(void) const;
+    double GetRate(void) const;
+    uint32_t GetBurst(void) const;
+
+  private:
+    void Refill(Time now);
+    const Item* Head(void) const;
+
+    NadaRingQueue<Item> m_priority; // Key frame lane, served first
+    NadaRingQueue<Item> m_normal;   // Everything else
+    uint32_t m_queuedBytes;       // Bytes in both lanes
+    uint32_t m_maxQueueBytes;     // Queue limit
+    double m_rate;                // Pacing rate (bps)
+    uint32_t m_burst;             // Bucket capacity (bytes)
+    double m_tokens;              // Bytes that may leave now
+    Time m_granularity;           // Release slack and timer resolution
+    Time m_lastRefill;            // Last time tokens were added
+};
+
+} // namespace ns3
+
+#endif /* NADA_PACER_H */
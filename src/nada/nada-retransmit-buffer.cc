@@ -0,0 +1,147 @@
+#include "nada-retransmit-buffer.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaRetransmitBuffer");
+
+NadaRetransmitBuffer::NadaRetransmitBuffer(uint32_t maxFrames)
+    : m_maxFrames(std::max<uint32_t>(maxFrames, 1)),
+      m_packets(0)
+{
+}
+
+void
+NadaRetransmitBuffer::SetMaxFrames(uint32_t maxFrames)
+{
+    NS_LOG_FUNCTION(this << maxFrames);
+    m_maxFrames = std::max<uint32_t>(maxFrames, 1);
+    while (m_frames.size() > m_maxFrames)
+    {
+        PopOldest();
+    }
+}
+
+void
+NadaRetransmitBuffer::Record(const Entry& entry)
+{
+    Frame* frame = FindFrame(entry.frameId);
+    if (!frame)
+    {
+        if (!m_frames.empty() && static_cast<int32_t>(entry.frameId - m_frames.back().frameId) < 0)
+        {
+            NS_LOG_DEBUG("Frame " << entry.frameId << " already left the retransmit buffer");
+            return;
+        }
+
+        if (m_frames.size() >= m_maxFrames)
+        {
+            PopOldest();
+        }
+
+        // Takes over the slot of a frame that left, and its packet storage
+        frame = &m_frames.push_back_reuse();
+        frame->frameId = entry.frameId;
+        frame->deadline = entry.deadline;
+        frame->packets.clear();
+    }
+
+    if (entry.packetIndex >= frame->packets.size())
+    {
+        frame->packets.resize(std::max<uint32_t>(entry.packetIndex + 1, entry.packetsInFrame));
+    }
+
+    Entry& slot = frame->packets[entry.packetIndex];
+    if (!slot.recorded)
+    {
+        m_packets++;
+    }
+    slot = entry;
+    slot.deadline = frame->deadline;
+    slot.retransmissions = 0;
+    slot.recorded = true;
+}
+
+NadaRetransmitBuffer::Entry*
+NadaRetransmitBuffer::Find(uint32_t frameId, uint16_t packetIndex)
+{
+    Frame* frame = FindFrame(frameId);
+    if (!frame || packetIndex >= frame->packets.size() || !frame->packets[packetIndex].recorded)
+    {
+        return nullptr;
+    }
+    return &frame->packets[packetIndex];
+}
+
+uint32_t
+NadaRetransmitBuffer::ExpireBefore(Time now)
+{
+    // Deadlines grow with the frame ID, so expired frames sit at the front
+    uint32_t expired = 0;
+    while (!m_frames.empty() && m_frames.front().deadline <= now)
+    {
+        PopOldest();
+        expired++;
+    }
+    return expired;
+}
+
+void
+NadaRetransmitBuffer::Clear(void)
+{
+    m_frames.clear();
+    m_packets = 0;
+}
+
+uint32_t
+NadaRetransmitBuffer::GetMaxFrames(void) const
+{
+    return m_maxFrames;
+}
+
+uint32_t
+NadaRetransmitBuffer::GetFrames(void) const
+{
+    return m_frames.size();
+}
+
+uint32_t
+NadaRetransmitBuffer::GetPackets(void) const
+{
+    return m_packets;
+}
+
+void
+NadaRetransmitBuffer::PopOldest(void)
+{
+    for (const Entry& entry : m_frames.front().packets)
+    {
+        m_packets -= entry.recorded ? 1 : 0;
+    }
+    m_frames.pop_front_reuse();
+}
+
+NadaRetransmitBuffer::Frame*
+NadaRetransmitBuffer::FindFrame(uint32_t frameId)
+{
+    // Frames are sorted by ID, and lookups almost always hit the newest ones
+    for (size_t i = m_frames.size(); i > 0; i--)
+    {
+        Frame& frame = m_frames[i - 1];
+        if (frame.frameId == frameId)
+        {
+            return &frame;
+        }
+        if (static_cast<int32_t>(frameId - frame.frameId) > 0)
+        {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ns3
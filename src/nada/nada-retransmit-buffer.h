@@ -0,0 +1,120 @@
+#ifndef NADA_RETRANSMIT_BUFFER_H
+#define NADA_RETRANSMIT_BUFFER_H
+
+#include "ns3/nada-ring-queue.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Recently sent video packets kept for NACK-driven retransmission
+ *
+ * Packets are grouped by frame, and every frame carries the playout
+ * deadline it was sent with. Frames leave the buffer once their deadline
+ * has passed, since a repair arriving after playout is useless, and the
+ * oldest frames are evicted when more than the configured number of frames
+ * are held. Frames are expected in increasing frameId order, as the sender
+ * produces them.
+ *
+ * New frames take over the slot and packet storage of frames that left, so
+ * once the buffer has held its largest frames recording never allocates.
+ */
+class NadaRetransmitBuffer
+{
+  public:
+    /**
+     * \brief A sent packet and the frame context to resend it with
+     */
+    struct Entry
+    {
+        uint32_t frameId;         //!< Video frame the packet belongs to
+        uint16_t packetIndex;     //!< Position of the packet in its frame
+        uint16_t packetsInFrame;  //!< Packets in the frame, repair packets included
+        uint16_t sourcePackets;   //!< Packets needed to rebuild the frame (0 = no FEC)
+        bool isKeyFrame;          //!< Packet belongs to a key frame
+        uint32_t size;            //!< Payload size in bytes, without NadaHeader
+        Time deadline;            //!< Playout deadline of the frame
+        uint32_t retransmissions; //!< Times the packet was sent again
+        bool recorded;            //!< Slot holds a sent packet
+
+        Entry()
+            : frameId(0),
+              packetIndex(0),
+              packetsInFrame(0),
+              sourcePackets(0),
+              isKeyFrame(false),
+              size(0),
+              deadline(Seconds(0)),
+              retransmissions(0),
+              recorded(false)
+        {
+        }
+    };
+
+    /**
+     * \brief Constructor
+     * \param maxFrames Number of frames held at most
+     */
+    explicit NadaRetransmitBuffer(uint32_t maxFrames = 32);
+
+    /**
+     * \brief Set the number of frames held, evicting the oldest ones if needed
+     * \param maxFrames Number of frames held at most
+     */
+    void SetMaxFrames(uint32_t maxFrames);
+
+    /**
+     * \brief Record a packet sent for the first time
+     *
+     * The first packet recorded for a frame sets the frame's deadline.
+     * Packets of frames older than the newest one held are only recorded if
+     * their frame is still in the buffer.
+     *
+     * \param entry Packet and frame context; retransmissions and recorded are ignored
+     */
+    void Record(const Entry& entry);
+
+    /**
+     * \brief Look up a packet still held
+     * \param frameId Frame the packet belongs to
+     * \param packetIndex Position of the packet in the frame
+     * \return The entry, or nullptr if the packet was never recorded or its
+     *         frame has left the buffer
+     */
+    Entry* Find(uint32_t frameId, uint16_t packetIndex);
+
+    /**
+     * \brief Drop every frame whose playout deadline is not after a given time
+     * \param now Current time
+     * \return Number of frames dropped
+     */
+    uint32_t ExpireBefore(Time now);
+
+    void Clear(void);
+    uint32_t GetMaxFrames(void) const;
+    uint32_t GetFrames(void) const;
+    uint32_t GetPackets(void) const;
+
+  private:
+    struct Frame
+    {
+        uint32_t frameId;              // Frame identifier
+        Time deadline;                 // Playout deadline of the frame
+        std::vector<Entry> packets;    // Indexed by packet index
+    };
+
+    Frame* FindFrame(uint32_t frameId);
+    void PopOldest(void);
+
+    NadaRingQueue<Frame> m_frames;  // Held frames, oldest first
+    uint32_t m_maxFrames;        // Frames held at most
+    uint32_t m_packets;          // Packets recorded across all held frames
+};
+
+} // namespace ns3
+
+#endif /* NADA_RETRANSMIT_BUFFER_H */
@@ -0,0 +1,134 @@
+#ifndef NADA_RING_QUEUE_H
+#define NADA_RING_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief FIFO over a growable ring of reused slots
+ *
+ * Replaces std::deque for the queues a packet or frame passes through.
+ * A deque used as a FIFO allocates a new block every few elements pushed
+ * and frees one every few popped, for as long as traffic flows; the ring
+ * only allocates when it has to grow past its largest size so far, then
+ * keeps its storage. Popped slots are reset to T(), so elements holding
+ * packets release them right away.
+ *
+ * The interface follows the std::deque subset the queues use, indices
+ * counting from the front.
+ */
+template <typename T>
+class NadaRingQueue
+{
+  public:
+    NadaRingQueue()
+        : m_head(0),
+          m_size(0)
+    {
+    }
+
+    void push_back(const T& value)
+    {
+        Grow();
+        m_slots[Slot(m_size)] = value;
+        m_size++;
+    }
+
+    void push_back(T&& value)
+    {
+        Grow();
+        m_slots[Slot(m_size)] = std::move(value);
+        m_size++;
+    }
+
+    /**
+     * \brief Append an element
+     * \return The new back element; it holds whatever was last stored in
+     *         its slot, so storage it owns can be reused
+     */
+    T& push_back_reuse()
+    {
+        Grow();
+        m_size++;
+        return back();
+    }
+
+    /// Only valid while !empty()
+    void pop_front()
+    {
+        m_slots[m_head] = T();
+        m_head = Slot(1);
+        m_size--;
+    }
+
+    /**
+     * \brief Remove the front element without resetting its slot
+     *
+     * For elements whose storage push_back_reuse() should pick up again;
+     * only valid while !empty()
+     */
+    void pop_front_reuse()
+    {
+        m_head = Slot(1);
+        m_size--;
+    }
+
+    T& front() { return m_slots[m_head]; }
+    const T& front() const { return m_slots[m_head]; }
+    T& back() { return m_slots[Slot(m_size - 1)]; }
+    const T& back() const { return m_slots[Slot(m_size - 1)]; }
+    T& operator[](size_t i) { return m_slots[Slot(i)]; }
+    const T& operator[](size_t i) const { return m_slots[Slot(i)]; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_slots.size(); }
+
+    /// Remove every element; the storage is kept
+    void clear()
+    {
+        while (m_size > 0)
+        {
+            pop_front();
+        }
+        m_head = 0;
+    }
+
+  private:
+    size_t Slot(size_t i) const
+    {
+        // Capacity is a power of two
+        return (m_head + i) & (m_slots.size() - 1);
+    }
+
+    void Grow()
+    {
+        if (m_size < m_slots.size())
+        {
+            return;
+        }
+        // Full, so every slot is moved; doubling unrolls the ring so the
+        // front lands at slot 0
+        std::vector<T> slots(m_slots.empty() ? 8 : m_slots.size() * 2);
+        for (size_t i = 0; i < m_size; i++)
+        {
+            slots[i] = std::move(m_slots[Slot(i)]);
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+    }
+
+    std::vector<T> m_slots; // Ring storage, front at m_head
+    size_t m_head;          // Slot of the front element
+    size_t m_size;          // Number of elements
+};
+
+} // namespace ns3
+
+#endif /* NADA_RING_QUEUE_H */
@@ -0,0 +1,251 @@
+#include "nada-send-history.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaSendHistory");
+
+NadaSendHistory::NadaSendHistory(uint32_t capacity)
+    : m_mask(0),
+      m_oldest(0),
+      m_next(0),
+      m_empty(true),
+      m_inFlightPackets(0),
+      m_inFlightBytes(0),
+      m_lostPackets(0)
+{
+    SetCapacity(capacity);
+}
+
+void
+NadaSendHistory::SetCapacity(uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << capacity);
+
+    uint32_t slots = 1;
+    while (slots < capacity && slots < (1u << 31))
+    {
+        slots <<= 1;
+    }
+
+    m_ring.assign(slots, Entry());
+    m_mask = slots - 1;
+    m_oldest = 0;
+    m_next = 0;
+    m_empty = true;
+    m_inFlightPackets = 0;
+    m_inFlightBytes = 0;
+}
+
+void
+NadaSendHistory::SetLossCallback(LossCallback callback)
+{
+    m_lossCallback = callback;
+}
+
+void
+NadaSendHistory::Record(uint32_t seq,
+                        Time sendTime,
+                        uint32_t size,
+                        uint32_t frameId,
+                        uint32_t pathId,
+                        uint16_t packetIndex,
+                        uint16_t packetsInFrame)
+{
+    NS_LOG_FUNCTION(this << seq << sendTime << size);
+
+    if (m_empty)
+    {
+        m_oldest = seq;
+        m_empty = false;
+    }
+    else if (seq - m_oldest > m_mask)
+    {
+        // The ring wrapped: everything older than one capacity ago is lost
+        uint32_t newOldest = seq - m_mask;
+        for (; m_oldest != newOldest && m_oldest != m_next; ++m_oldest)
+        {
+            Entry& stale = m_ring[m_oldest & m_mask];
+            if (stale.inFlight && stale.seq == m_oldest)
+            {
+                Release(stale, true);
+            }
+        }
+        m_oldest = newOldest;
+    }
+
+    Entry& entry = m_ring[seq & m_mask];
+    if (entry.inFlight)
+    {
+        Release(entry, true);
+    }
+
+    entry.seq = seq;
+    entry.sendTime = sendTime;
+    entry.size = size;
+    entry.frameId = frameId;
+    entry.pathId = pathId;
+    entry.packetIndex = packetIndex;
+    entry.packetsInFrame = packetsInFrame;
+    entry.inFlight = true;
+
+    m_inFlightPackets++;
+    m_inFlightBytes += size;
+    m_next = seq + 1;
+}
+
+NadaSendHistory::Entry*
+NadaSendHistory::Lookup(uint32_t seq)
+{
+    if (m_empty || seq - m_oldest >= m_next - m_oldest)
+    {
+        return nullptr;
+    }
+
+    Entry& entry = m_ring[seq & m_mask];
+    return (entry.inFlight && entry.seq == seq) ? &entry : nullptr;
+}
+
+const NadaSendHistory::Entry*
+NadaSendHistory::Find(uint32_t seq) const
+{
+    return const_cast<NadaSendHistory*>(this)->Lookup(seq);
+}
+
+bool
+NadaSendHistory::Retire(uint32_t seq, Entry& entry)
+{
+    Entry* slot = Lookup(seq);
+    if (!slot)
+    {
+        return false;
+    }
+
+    entry = *slot;
+    Release(*slot, false);
+    AdvanceOldest();
+    return true;
+}
+
+bool
+NadaSendHistory::MarkLost(uint32_t seq)
+{
+    Entry* slot = Lookup(seq);
+    if (!slot)
+    {
+        return false;
+    }
+
+    Release(*slot, true);
+    AdvanceOldest();
+    return true;
+}
+
+uint32_t
+NadaSendHistory::ExpireOlderThan(Time cutoff)
+{
+    uint32_t expired = 0;
+    while (!m_empty && m_oldest != m_next)
+    {
+        Entry& entry = m_ring[m_oldest & m_mask];
+        if (entry.inFlight && entry.seq == m_oldest)
+        {
+            if (entry.sendTime >= cutoff)
+            {
+                break;
+            }
+            Release(entry, true);
+            expired++;
+        }
+        m_oldest++;
+    }
+
+    if (expired > 0)
+    {
+        NS_LOG_DEBUG("Expired " << expired << " packets sent before " << cutoff);
+    }
+    return expired;
+}
+
+uint32_t
+NadaSendHistory::ExpireAll(std::vector<Entry>& expired)
+{
+    uint32_t count = 0;
+    for (; !m_empty && m_oldest != m_next; ++m_oldest)
+    {
+        Entry& entry = m_ring[m_oldest & m_mask];
+        if (entry.inFlight && entry.seq == m_oldest)
+        {
+            expired.push_back(entry);
+            Release(entry, true);
+            count++;
+        }
+    }
+
+    if (count > 0)
+    {
+        NS_LOG_DEBUG("Expired all " << count << " packets in flight");
+    }
+    return count;
+}
+
+void
+NadaSendHistory::Release(Entry& entry, bool lost)
+{
+    entry.inFlight = false;
+    m_inFlightPackets--;
+    m_inFlightBytes -= entry.size;
+
+    if (lost)
+    {
+        m_lostPackets++;
+        NS_LOG_LOGIC("Packet " << entry.seq << " on path " << entry.pathId << " lost");
+        if (!m_lossCallback.IsNull())
+        {
+            m_lossCallback(entry);
+        }
+    }
+}
+
+void
+NadaSendHistory::AdvanceOldest(void)
+{
+    // Skip retired slots so ExpireOlderThan() stays amortised O(1)
+    while (m_oldest != m_next)
+    {
+        const Entry& entry = m_ring[m_oldest & m_mask];
+        if (entry.inFlight && entry.seq == m_oldest)
+        {
+            break;
+        }
+        m_oldest++;
+    }
+}
+
+uint32_t
+NadaSendHistory::GetCapacity(void) const
+{
+    return m_mask + 1;
+}
+
+uint32_t
+NadaSendHistory::GetInFlightPackets(void) const
+{
+    return m_inFlightPackets;
+}
+
+uint64_t
+NadaSendHistory::GetInFlightBytes(void) const
+{
+    return m_inFlightBytes;
+}
+
+uint64_t
+NadaSendHistory::GetLostPackets(void) const
+{
+    return m_lostPackets;
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+#ifndef NADA_SEND_HISTORY_H
+#define NADA_SEND_HISTORY_H
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Fixed-capacity, sequence-indexed record of packets in flight
+ *
+ * Entries live in a power-of-two ring indexed by sequence number, so
+ * recording, looking up and retiring a packet are O(1) and memory stays
+ * bounded no matter how many packets are lost. Sequence numbers must be
+ * recorded in increasing order. Packets that are never acknowledged are
+ * retired by ExpireOlderThan(), or when their slot is reused, and are
+ * reported through the loss callback.
+ */
+class NadaSendHistory
+{
+  public:
+    /**
+     * \brief A packet that has been sent and not yet retired
+     */
+    struct Entry
+    {
+        uint32_t seq;            //!< Sequence number
+        Time sendTime;           //!< Transmission time
+        uint32_t size;           //!< Packet size in bytes
+        uint32_t frameId;        //!< Video frame the packet belongs to
+        uint32_t pathId;         //!< Path the packet was sent on
+        uint16_t packetIndex;    //!< Position of the packet in its frame
+        uint16_t packetsInFrame; //!< Packets in the frame (0 = no frame info)
+        bool inFlight;           //!< Sent and neither acknowledged nor declared lost
+
+        Entry()
+            : seq(0),
+              sendTime(Seconds(0)),
+              size(0),
+              frameId(0),
+              pathId(0),
+              packetIndex(0),
+              packetsInFrame(0),
+              inFlight(false)
+        {
+        }
+    };
+
+    /// Called for every packet declared lost
+    typedef Callback<void, const Entry&> LossCallback;
+
+    /**
+     * \brief Constructor
+     * \param capacity Number of slots, rounded up to a power of two
+     */
+    explicit NadaSendHistory(uint32_t capacity = 1024);
+
+    /**
+     * \brief Resize the ring, dropping every entry without reporting losses
+     * \param capacity Number of slots, rounded up to a power of two
+     */
+    void SetCapacity(uint32_t capacity);
+
+    /**
+     * \brief Set the callback invoked for packets declared lost
+     * \param callback The loss callback
+     */
+    void SetLossCallback(LossCallback callback);
+
+    /**
+     * \brief Record a sent packet
+     *
+     * If the slot still holds a packet in flight, that packet is declared lost.
+     *
+     * \param seq Sequence number, larger than any previously recorded one
+     * \param sendTime Transmission time
+     * \param size Packet size in bytes
+     * \param frameId Video frame the packet belongs to
+     * \param pathId Path the packet was sent on
+     * \param packetIndex Position of the packet in its frame
+     * \param packetsInFrame Packets in the frame, 0 for packets outside a frame
+     */
+    void Record(uint32_t seq,
+                Time sendTime,
+                uint32_t size,
+                uint32_t frameId = 0,
+                uint32_t pathId = 0,
+                uint16_t packetIndex = 0,
+                uint16_t packetsInFrame = 0);
+
+    /**
+     * \brief Retire an acknowledged packet
+     * \param seq Sequence number of the packet
+     * \param entry Receives a copy of the retired entry
+     * \return false if the packet is unknown or already retired
+     */
+    bool Retire(uint32_t seq, Entry& entry);
+
+    /**
+     * \brief Retire a packet reported missing by the receiver
+     * \param seq Sequence number of the packet
+     * \return false if the packet is unknown or already retired
+     */
+    bool MarkLost(uint32_t seq);
+
+    /**
+     * \brief Look up a packet still in flight
+     * \param seq Sequence number of the packet
+     * \return The entry, or nullptr if it is not in flight
+     */
+    const Entry* Find(uint32_t seq) const;
+
+    /**
+     * \brief Declare lost every packet sent before a cutoff time
+     * \param cutoff Packets sent strictly before this time are lost
+     * \return Number of packets declared lost
+     */
+    uint32_t ExpireOlderThan(Time cutoff);
+
+    /**
+     * \brief Declare lost every packet in flight, as when its path failed
+     * \param expired Receives a copy of each expired entry, oldest first
+     * \return Number of packets declared lost
+     */
+    uint32_t ExpireAll(std::vector<Entry>& expired);
+
+    uint32_t GetCapacity(void) const;
+    uint32_t GetInFlightPackets(void) const;
+    uint64_t GetInFlightBytes(void) const;
+    uint64_t GetLostPackets(void) const;
+
+  private:
+    Entry* Lookup(uint32_t seq);
+    void Release(Entry& entry, bool lost);
+    void AdvanceOldest(void);
+
+    std::vector<Entry> m_ring;   // Slots indexed by seq & m_mask
+    uint32_t m_mask;             // Capacity - 1
+    uint32_t m_oldest;           // Lowest sequence number that may still be in flight
+    uint32_t m_next;             // One past the highest recorded sequence number
+    bool m_empty;                // Nothing recorded since the last reset
+    uint32_t m_inFlightPackets;  // Packets currently in flight
+    uint64_t m_inFlightBytes;    // Bytes currently in flight
+    uint64_t m_lostPackets;      // Packets declared lost so far
+    LossCallback m_lossCallback; // Loss notification
+};
+
+} // namespace ns3
+
+#endif /* NADA_SEND_HISTORY_H */
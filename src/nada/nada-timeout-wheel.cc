@@ -0,0 +1,190 @@
+#include "nada-timeout-wheel.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NadaTimeoutWheel");
+
+NadaTimeoutWheel::NadaTimeoutWheel(Time granularity, uint32_t slots)
+    : m_granularity(granularity.IsStrictlyPositive() ? granularity : MilliSeconds(1)),
+      m_slots(std::max<uint32_t>(slots, 1)),
+      m_eventTick(0),
+      m_entries(0)
+{
+}
+
+NadaTimeoutWheel::~NadaTimeoutWheel()
+{
+    Simulator::Cancel(m_event);
+}
+
+void
+NadaTimeoutWheel::SetExpireCallback(Callback<void, uint32_t> expire)
+{
+    m_expire = expire;
+}
+
+void
+NadaTimeoutWheel::Schedule(uint32_t key, Time delay)
+{
+    NS_LOG_FUNCTION(this << key << delay);
+
+    Time deadline = Simulator::Now() + std::max(delay, Seconds(0));
+    uint64_t tick = GetTick(deadline);
+
+    auto it = m_timeouts.find(key);
+    if (it != m_timeouts.end() && tick >= it->second.slotTick)
+    {
+        // Refiled lazily once the wheel reaches the current slot
+        it->second.deadline = deadline;
+        return;
+    }
+
+    m_timeouts[key] = Timeout{deadline, tick};
+    Insert(key, tick);
+    Arm(tick);
+}
+
+void
+NadaTimeoutWheel::Cancel(uint32_t key)
+{
+    NS_LOG_FUNCTION(this << key);
+
+    // The entry left in its slot is recognised as stale and dropped there
+    m_timeouts.erase(key);
+    if (m_timeouts.empty())
+    {
+        Clear();
+    }
+}
+
+bool
+NadaTimeoutWheel::IsPending(uint32_t key) const
+{
+    return m_timeouts.find(key) != m_timeouts.end();
+}
+
+void
+NadaTimeoutWheel::Clear(void)
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& slot : m_slots)
+    {
+        slot.clear();
+    }
+    m_timeouts.clear();
+    m_entries = 0;
+    Simulator::Cancel(m_event);
+}
+
+uint32_t
+NadaTimeoutWheel::GetPending(void) const
+{
+    return m_timeouts.size();
+}
+
+uint64_t
+NadaTimeoutWheel::GetTick(Time t) const
+{
+    int64_t step = m_granularity.GetTimeStep();
+    return static_cast<uint64_t>((t.GetTimeStep() + step - 1) / step);
+}
+
+void
+NadaTimeoutWheel::Insert(uint32_t key, uint64_t tick)
+{
+    m_slots[tick % m_slots.size()].push_back(Entry{key, tick});
+    m_entries++;
+}
+
+void
+NadaTimeoutWheel::Arm(uint64_t tick)
+{
+    if (m_event.IsPending() && m_eventTick <= tick)
+    {
+        return;
+    }
+
+    Simulator::Cancel(m_event);
+    m_eventTick = tick;
+    Time at = TimeStep(tick * m_granularity.GetTimeStep());
+    m_event = Simulator::Schedule(std::max(at - Simulator::Now(), Seconds(0)),
+                                  &NadaTimeoutWheel::Advance,
+                                  this);
+}
+
+uint64_t
+NadaTimeoutWheel::GetNextTick(uint64_t from) const
+{
+    // The first slot holding an entry of this rotation wins; entries of later
+    // rotations only count when no slot does
+    uint64_t later = std::numeric_limits<uint64_t>::max();
+    for (uint64_t tick = from; tick < from + m_slots.size(); tick++)
+    {
+        for (const Entry& entry : m_slots[tick % m_slots.size()])
+        {
+            if (entry.tick <= tick)
+            {
+                return entry.tick;
+            }
+            later = std::min(later, entry.tick);
+        }
+    }
+    return later;
+}
+
+void
+NadaTimeoutWheel::Advance(void)
+{
+    NS_LOG_FUNCTION(this << m_eventTick);
+
+    // Take the entries due at this tick, leaving those of later rotations
+    uint64_t current = m_eventTick;
+    std::vector<Entry>& slot = m_slots[current % m_slots.size()];
+    m_expired.clear();
+    auto due = std::partition(slot.begin(), slot.end(), [current](const Entry& entry) {
+        return entry.tick != current;
+    });
+    m_expired.assign(due, slot.end());
+    slot.erase(due, slot.end());
+    m_entries -= m_expired.size();
+
+    Time now = Simulator::Now();
+    for (const Entry& entry : m_expired)
+    {
+        auto it = m_timeouts.find(entry.key);
+        if (it == m_timeouts.end() || it->second.slotTick != entry.tick)
+        {
+            continue; // Cancelled or moved earlier
+        }
+
+        if (it->second.deadline > now)
+        {
+            // Pushed back since it was filed
+            it->second.slotTick = GetTick(it->second.deadline);
+            Insert(entry.key, it->second.slotTick);
+            continue;
+        }
+
+        m_timeouts.erase(it);
+        if (!m_expire.IsNull())
+        {
+            m_expire(entry.key);
+        }
+    }
+
+    if (m_timeouts.empty())
+    {
+        Clear();
+        return;
+    }
+    Arm(GetNextTick(current));
+}
+
+} // namespace ns3
@@ -0,0 +1,98 @@
+#ifndef NADA_TIMEOUT_WHEEL_H
+#define NADA_TIMEOUT_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Hashed timing wheel that multiplexes many timeouts on one event
+ *
+ * Every timeout is identified by a caller-chosen key and rounded up to the
+ * wheel granularity. A single simulator event is armed at the earliest
+ * occupied slot, and none at all while no timeout is pending, so idle
+ * timeouts cost nothing.
+ *
+ * Pushing a pending timeout later, which is what a liveness timer does on
+ * every packet, only updates its deadline: the entry is moved to its new
+ * slot when the wheel reaches the old one. Timeouts further away than one
+ * rotation stay in their slot until the rotation they belong to.
+ */
+class NadaTimeoutWheel
+{
+  public:
+    /**
+     * \param granularity Width of a slot; deadlines are rounded up to it
+     * \param slots Number of slots in one rotation
+     */
+    explicit NadaTimeoutWheel(Time granularity = MilliSeconds(10), uint32_t slots = 256);
+    ~NadaTimeoutWheel();
+
+    /**
+     * \brief Set the function called with the key of every expired timeout
+     * \param expire The callback; a timeout is no longer pending when it runs,
+     *        so the callback may schedule the same key again
+     */
+    void SetExpireCallback(Callback<void, uint32_t> expire);
+
+    /**
+     * \brief Start a timeout, replacing the pending one with the same key
+     * \param key Timeout identifier
+     * \param delay Time from now until it expires
+     */
+    void Schedule(uint32_t key, Time delay);
+
+    /**
+     * \brief Stop a pending timeout; nothing happens if it is not pending
+     * \param key Timeout identifier
+     */
+    void Cancel(uint32_t key);
+
+    bool IsPending(uint32_t key) const;
+
+    /**
+     * \brief Stop every timeout and the wheel event
+     */
+    void Clear(void);
+
+    uint32_t GetPending(void) const;
+
+  private:
+    struct Timeout
+    {
+        Time deadline;     // When the timeout expires
+        uint64_t slotTick; // Tick of the slot holding its live entry
+    };
+
+    struct Entry
+    {
+        uint32_t key;  // Timeout identifier
+        uint64_t tick; // Tick the entry was filed under
+    };
+
+    uint64_t GetTick(Time t) const;
+    void Insert(uint32_t key, uint64_t tick);
+    uint64_t GetNextTick(uint64_t from) const;
+    void Arm(uint64_t tick);
+    void Advance(void);
+
+    Time m_granularity;                            // Width of a slot
+    std::vector<std::vector<Entry>> m_slots;       // Entries by tick modulo the slot count
+    std::unordered_map<uint32_t, Timeout> m_timeouts; // Pending timeouts by key
+    std::vector<Entry> m_expired;                  // Scratch list of the slot being served
+    Callback<void, uint32_t> m_expire;             // Called for every expired timeout
+    EventId m_event;                               // The single wheel event
+    uint64_t m_eventTick;                          // Tick m_event is armed for
+    uint32_t m_entries;                            // Entries filed in the slots
+};
+
+} // namespace ns3
+
+#endif /* NADA_TIMEOUT_WHEEL_H */
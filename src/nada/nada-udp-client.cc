@@ -8,6 +8,8 @@
 #include "ns3/names.h"
 #include "ns3/udp-socket-factory.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 // UdpNadaClient implementation
@@ -40,7 +42,18 @@ UdpNadaClient::GetTypeId(void)
                                           "The destination Address",
                                           AddressValue(),
                                           MakeAddressAccessor(&UdpNadaClient::m_peer),
-                                          MakeAddressChecker());
+                                          MakeAddressChecker())
+                            .AddAttribute("SendHistorySize",
+                                          "Number of in-flight packets tracked for RTT and loss",
+                                          UintegerValue(1024),
+                                          MakeUintegerAccessor(&UdpNadaClient::SetSendHistorySize,
+                                                               &UdpNadaClient::GetSendHistorySize),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("LossTimeout",
+                                          "Age after which an unacknowledged packet counts as lost",
+                                          TimeValue(MilliSeconds(500)),
+                                          MakeTimeAccessor(&UdpNadaClient::m_lossTimeout),
+                                          MakeTimeChecker());
     return tid;
 }
 
@@ -54,9 +67,11 @@ UdpNadaClient::UdpNadaClient()
       m_videoMode(false),
       m_currentFrameSize(0),
       m_currentFrameType(DELTA_FRAME),
-      m_overheadRatio(1.0)
+      m_overheadRatio(1.0),
+      m_lossTimeout(MilliSeconds(500))
 {
     NS_LOG_FUNCTION(this);
+    m_sendHistory.SetLossCallback(MakeCallback(&UdpNadaClient::HandlePacketLost, this));
 }
 
 UdpNadaClient::~UdpNadaClient()
@@ -124,6 +139,7 @@ UdpNadaClient::SendPacket(Ptr<Packet> packet)
     header.SetOverheadFactor(m_overheadRatio); // Use SetOverheadFactor instead of SetOverheadRatio
 
     packet->AddHeader(header);
+    uint32_t size = packet->GetSize();
 
     NS_LOG_INFO("Sending packet at " << Simulator::Now().GetSeconds()
                                      << " seq=" << header.GetSequenceNumber());
@@ -131,7 +147,7 @@ UdpNadaClient::SendPacket(Ptr<Packet> packet)
     m_packetsSent++;
 
     // Record send time for RTT calculation
-    m_sentPackets[header.GetSequenceNumber()] = Simulator::Now();
+    m_sendHistory.Record(header.GetSequenceNumber(), Simulator::Now(), size);
 }
 
 Ptr<Socket>
@@ -372,40 +388,151 @@ UdpNadaClient::HandleRead(Ptr<Socket> socket)
             continue; // Skip this packet
         }
 
-        // Extract header with all feedback information
+        // Decode the feedback once, in place
         NadaHeader header;
-        if (packet->RemoveHeader(header))
+        if (packet->PeekHeader(header) && m_nada)
         {
-            // Calculate round-trip time if this is an ACK for a packet we sent
-            uint32_t seq = header.GetSequenceNumber();
-            auto it = m_sentPackets.find(seq);
-
-            if (it != m_sentPackets.end())
+            // Retransmission requests are for multipath senders
+            if (header.GetPacketType() == NadaHeader::NACK)
             {
-                Time sendTime = it->second;
-                Time rtt = Simulator::Now() - sendTime;
+                continue;
+            }
+
+            // Anything unacknowledged for too long will not be acknowledged at all
+            m_sendHistory.ExpireOlderThan(Simulator::Now() - m_lossTimeout);
 
-                // Clean up old entries to prevent memory growth
-                m_sentPackets.erase(it);
+            NadaFeedback feedback;
+            header.GetFeedback(feedback);
 
-                // Approximate one-way delay as RTT/2 (can be improved with clock sync)
-                Time delay = rtt / 2;
+            if (feedback.ackVector)
+            {
+                ProcessAckVector(feedback);
+                continue;
+            }
 
-                // Process receive rate and loss information
-                double receiveRate = header.GetReceiveRate();
-                double lossRate = header.GetLossRate();
-                bool ecnMarked = header.GetEcnMarked();
+            // Calculate round-trip time if this is an ACK for a packet we sent
+            NadaSendHistory::Entry sent;
+            if (m_sendHistory.Retire(feedback.sequence, sent))
+            {
+                Time rtt = Simulator::Now() - sent.sendTime;
+                m_lossWindow.Push(false);
+
+                // Use the forward delay the receiver echoed; only without it
+                // is the RTT assumed to split evenly
+                if (feedback.hasForwardDelay)
+                {
+                    rtt = Max(rtt - (feedback.ackTimestamp - feedback.receiveTimestamp),
+                              Seconds(0));
+                    feedback.delay = feedback.forwardDelay;
+                }
+                else
+                {
+                    feedback.delay = rtt / 2;
+                }
+                feedback.rtt = rtt;
+                feedback.acked = 1;
+                feedback.lossRate = CollectLossRate(feedback.lossRate);
 
                 // Update NADA congestion control with complete feedback
-                m_nada->ProcessAck(packet, delay);
-                m_nada->ProcessLoss(lossRate);
-                m_nada->ProcessEcn(ecnMarked);
-                m_nada->UpdateReceiveRate(receiveRate);
+                m_nada->ProcessFeedback(feedback);
             }
         }
     }
 }
 
+void
+UdpNadaClient::ProcessAckVector(NadaFeedback& feedback)
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    uint32_t covered = 0;
+    uint32_t lost = 0;
+    Time lastDelay = Seconds(0);
+
+    // One forward delay sample per received packet; covered but missing packets are
+    // losses. Every sample but the last goes to NADA directly, the last one
+    // travels with the rest of the report.
+    feedback.ackVector->ForEach([&](uint32_t seq, bool received, Time arrival) {
+        if (!received)
+        {
+            if (m_sendHistory.MarkLost(seq))
+            {
+                covered++;
+                lost++;
+            }
+            return;
+        }
+
+        NadaSendHistory::Entry sent;
+        if (!m_sendHistory.Retire(seq, sent))
+        {
+            return;
+        }
+
+        if (feedback.acked > 0)
+        {
+            m_nada->ProcessDelay(lastDelay);
+        }
+        covered++;
+        feedback.acked++;
+        m_lossWindow.Push(false);
+        // Take out the time the receiver held the report back
+        Time rtt = Max(now - sent.sendTime - (feedback.ackTimestamp - arrival), Seconds(0));
+        // The arrival is on the receiver clock, so this matches the forward
+        // delay the receiver echoes, clock offset included
+        lastDelay = arrival - sent.sendTime;
+        feedback.rtt = rtt;
+    });
+
+    if (covered == 0)
+    {
+        return;
+    }
+
+    feedback.lossRate = CollectLossRate(feedback.lossRate);
+    if (feedback.acked > 0)
+    {
+        feedback.delay = lastDelay;
+        m_nada->ProcessFeedback(feedback);
+    }
+    else
+    {
+        m_nada->ProcessLoss(feedback.lossRate);
+        m_nada->ProcessEcn(feedback.ecnMarked);
+        m_nada->UpdateReceiveRate(feedback.receiveRate);
+    }
+
+    NS_LOG_DEBUG("ACK vector: " << (covered - lost) << " received, " << lost << " lost, "
+                                << m_sendHistory.GetInFlightPackets() << " in flight");
+}
+
+double
+UdpNadaClient::CollectLossRate(double reportedLoss)
+{
+    return std::max(reportedLoss, m_lossWindow.GetLossRate());
+}
+
+void
+UdpNadaClient::HandlePacketLost(const NadaSendHistory::Entry& entry)
+{
+    NS_LOG_FUNCTION(this << entry.seq);
+    m_lossWindow.Push(true);
+}
+
+void
+UdpNadaClient::SetSendHistorySize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_sendHistory.SetCapacity(size);
+}
+
+uint32_t
+UdpNadaClient::GetSendHistorySize(void) const
+{
+    return m_sendHistory.GetCapacity();
+}
+
 void
 UdpNadaClient::SetPacketSize(uint32_t size)
 {
@@ -2,14 +2,16 @@
 #define NADA_UDP_CLIENT_H
 
 #include "ns3/applications-module.h"
+#include "ns3/nada-send-history.h"
+#include "ns3/nada-window-stats.h"
 #include "ns3/socket.h"
 
-#include <map>
-
 namespace ns3
 {
 
 class NadaCongestionControl;
+class NadaHeader;
+struct NadaFeedback;
 
 /**
  * \brief Video frame type enumeration
@@ -154,6 +156,34 @@ class UdpNadaClient : public Application
     uint32_t GetMaxPackets() const;
 
   private:
+    /**
+     * \brief Expand an aggregated ACK into per-packet delay and loss samples
+     * \param feedback The decoded feedback carrying the ACK vector
+     */
+    void ProcessAckVector(NadaFeedback& feedback);
+
+    /**
+     * \brief Loss rate to hand to NADA for the current feedback
+     *
+     * Combines the loss reported by the receiver with the losses detected
+     * locally (missing from feedback or timed out) over the last
+     * LOSS_WINDOW packets, so a single loss weighs 1/LOSS_WINDOW however
+     * often feedback arrives.
+     *
+     * \param reportedLoss Loss rate reported by the receiver
+     * \return The larger of the reported and the locally detected loss rate
+     */
+    double CollectLossRate(double reportedLoss);
+
+    /**
+     * \brief Count a packet the send history declared lost
+     * \param entry The lost packet
+     */
+    void HandlePacketLost(const NadaSendHistory::Entry& entry);
+
+    void SetSendHistorySize(uint32_t size);
+    uint32_t GetSendHistorySize(void) const;
+
     uint32_t m_packetSize;  // Size of each packet sent
     uint32_t m_numPackets;  // Number of packets to send
     Time m_interval;        // Initial packet interval
@@ -172,8 +202,11 @@ class UdpNadaClient : public Application
     VideoFrameType m_currentFrameType; // Current video frame type
     double m_overheadRatio;            // Protocol overhead ratio
 
-    // RTT tracking
-    std::map<uint32_t, Time> m_sentPackets; // Sent packets for RTT calculation
+    // RTT and loss tracking
+    NadaSendHistory m_sendHistory; // Packets in flight, indexed by sequence number
+    Time m_lossTimeout;            // Age after which an unacknowledged packet is lost
+    static const uint32_t LOSS_WINDOW = 100;   // Packets the local loss rate is taken over
+    NadaLossWindow<LOSS_WINDOW> m_lossWindow; // Fate of the last acknowledged or lost packets
 };
 
 /**
@@ -0,0 +1,583 @@
+#ifndef NADA_WINDOW_STATS_H
+#define NADA_WINDOW_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Fixed-capacity ring of the last N samples
+ *
+ * Pushing into a full window overwrites the oldest sample. Storage is a
+ * std::array, so the window never allocates.
+ */
+template <typename T, uint32_t N>
+class NadaSampleWindow
+{
+  public:
+    NadaSampleWindow()
+        : m_head(0),
+          m_size(0)
+    {
+    }
+
+    /**
+     * \brief Append a sample
+     * \param value The sample
+     * \return true if the oldest sample was overwritten
+     */
+    bool Push(const T& value)
+    {
+        bool full = (m_size == N);
+        m_ring[(m_head + m_size) % N] = value;
+        if (full)
+        {
+            m_head = (m_head + 1) % N;
+        }
+        else
+        {
+            m_size++;
+        }
+        return full;
+    }
+
+    /**
+     * \brief Oldest sample, only valid while !IsEmpty()
+     */
+    const T& Front() const
+    {
+        return m_ring[m_head];
+    }
+
+    /**
+     * \brief Newest sample, only valid while !IsEmpty()
+     */
+    const T& Back() const
+    {
+        return m_ring[(m_head + m_size - 1) % N];
+    }
+
+    /**
+     * \brief Sample by age, 0 being the oldest
+     */
+    const T& operator[](uint32_t i) const
+    {
+        return m_ring[(m_head + i) % N];
+    }
+
+    void Clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    uint32_t Size() const
+    {
+        return m_size;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    bool IsFull() const
+    {
+        return m_size == N;
+    }
+
+    static uint32_t Capacity()
+    {
+        return N;
+    }
+
+  private:
+    std::array<T, N> m_ring; // Samples, oldest at m_head
+    uint32_t m_head;         // Index of the oldest sample
+    uint32_t m_size;         // Number of valid samples
+};
+
+/**
+ * \ingroup internet
+ * \brief Minimum of the last N samples in amortised O(1)
+ *
+ * Keeps a monotonic deque of candidates: a new sample evicts every larger
+ * candidate, since those can never be the minimum again, and candidates
+ * are dropped from the front once they fall out of the window.
+ */
+template <typename T, uint32_t N>
+class NadaWindowedMin
+{
+  public:
+    NadaWindowedMin()
+        : m_head(0),
+          m_size(0),
+          m_count(0)
+    {
+    }
+
+    void Push(const T& value)
+    {
+        // Candidates are at most N samples old, so the ring never overflows
+        while (m_size > 0 && !(At(m_size - 1).value < value))
+        {
+            m_size--;
+        }
+        if (m_size > 0 && m_count - At(0).index >= N)
+        {
+            m_head = (m_head + 1) % N;
+            m_size--;
+        }
+        m_ring[(m_head + m_size) % N] = Candidate{m_count, value};
+        m_size++;
+        m_count++;
+    }
+
+    /**
+     * \brief Minimum of the window, only valid while !IsEmpty()
+     */
+    const T& GetMin() const
+    {
+        return At(0).value;
+    }
+
+    void Clear()
+    {
+        m_head = 0;
+        m_size = 0;
+        m_count = 0;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+  private:
+    struct Candidate
+    {
+        uint64_t index; // Position of the sample in the input stream
+        T value;        // The sample
+    };
+
+    const Candidate& At(uint32_t i) const
+    {
+        return m_ring[(m_head + i) % N];
+    }
+
+    std::array<Candidate, N> m_ring; // Increasing candidates, oldest first
+    uint32_t m_head;                 // Index of the front candidate
+    uint32_t m_size;                 // Number of candidates
+    uint64_t m_count;                // Samples pushed so far
+};
+
+/**
+ * \ingroup internet
+ * \brief Share of the last N packets that were lost
+ *
+ * Until N packets have been seen the ones not seen yet count as received,
+ * so an early loss does not read as a loss rate of one half or more.
+ */
+template <uint32_t N>
+class NadaLossWindow
+{
+  public:
+    NadaLossWindow()
+        : m_lost(0)
+    {
+    }
+
+    /**
+     * \brief Record the fate of a packet
+     * \param lost Whether it was lost
+     */
+    void Push(bool lost)
+    {
+        if (m_window.IsFull() && m_window.Front())
+        {
+            m_lost--;
+        }
+        m_window.Push(lost);
+        m_lost += lost ? 1 : 0;
+    }
+
+    double GetLossRate() const
+    {
+        return static_cast<double>(m_lost) / N;
+    }
+
+    void Clear()
+    {
+        m_window.Clear();
+        m_lost = 0;
+    }
+
+  private:
+    NadaSampleWindow<bool, N> m_window; // Fate of the last packets, true if lost
+    uint32_t m_lost;                    // Lost packets in the window
+};
+
+/**
+ * \ingroup internet
+ * \brief Exponentially weighted moving average
+ */
+class NadaEwma
+{
+  public:
+    /**
+     * \param alpha Weight of a new sample
+     * \param initial Value before the first sample
+     */
+    explicit NadaEwma(double alpha = 0.1, double initial = 0.0)
+        : m_alpha(alpha),
+          m_value(initial)
+    {
+    }
+
+    double Update(double sample)
+    {
+        m_value = m_alpha * sample + (1.0 - m_alpha) * m_value;
+        return m_value;
+    }
+
+    double Get() const
+    {
+        return m_value;
+    }
+
+    void SetAlpha(double alpha)
+    {
+        m_alpha = alpha;
+    }
+
+    void Reset(double value = 0.0)
+    {
+        m_value = value;
+    }
+
+  private:
+    double m_alpha; // Weight of a new sample
+    double m_value; // Current average
+};
+
+/**
+ * \ingroup internet
+ * \brief Mean and variance of every sample seen, using Welford's update
+ */
+class NadaRunningMeanVar
+{
+  public:
+    NadaRunningMeanVar()
+        : m_count(0),
+          m_mean(0.0),
+          m_m2(0.0)
+    {
+    }
+
+    void Push(double value)
+    {
+        m_count++;
+        double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+    }
+
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMean() const
+    {
+        return m_mean;
+    }
+
+    /**
+     * \brief Population variance, 0 with fewer than two samples
+     */
+    double GetVariance() const
+    {
+        return (m_count > 1) ? m_m2 / m_count : 0.0;
+    }
+
+    void Clear()
+    {
+        m_count = 0;
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    }
+
+  private:
+    uint64_t m_count; // Samples pushed
+    double m_mean;    // Running mean
+    double m_m2;      // Sum of squared deviations from the mean
+};
+
+/**
+ * \ingroup internet
+ * \brief Mean and variance of the last N samples in O(1)
+ */
+template <uint32_t N>
+class NadaWindowedMeanVar
+{
+  public:
+    NadaWindowedMeanVar()
+        : m_sum(0.0),
+          m_sumSquares(0.0)
+    {
+    }
+
+    void Push(double value)
+    {
+        if (m_window.IsFull())
+        {
+            double oldest = m_window.Front();
+            m_sum -= oldest;
+            m_sumSquares -= oldest * oldest;
+        }
+        m_window.Push(value);
+        m_sum += value;
+        m_sumSquares += value * value;
+    }
+
+    uint32_t Size() const
+    {
+        return m_window.Size();
+    }
+
+    double GetMean() const
+    {
+        return m_window.IsEmpty() ? 0.0 : m_sum / m_window.Size();
+    }
+
+    double GetVariance() const
+    {
+        if (m_window.Size() < 2)
+        {
+            return 0.0;
+        }
+        double mean = GetMean();
+        return std::max(0.0, m_sumSquares / m_window.Size() - mean * mean);
+    }
+
+    void Clear()
+    {
+        m_window.Clear();
+        m_sum = 0.0;
+        m_sumSquares = 0.0;
+    }
+
+  private:
+    NadaSampleWindow<double, N> m_window; // Samples in the window
+    double m_sum;                         // Sum of the window
+    double m_sumSquares;                  // Sum of squares of the window
+};
+
+/**
+ * \ingroup internet
+ * \brief Least-squares slope of the last N samples against their position
+ *
+ * Samples are taken at x = 0, 1, ..., n-1, oldest first. The sums of y and
+ * x*y are updated incrementally; the sums over x follow from n alone.
+ */
+template <uint32_t N>
+class NadaWindowedSlope
+{
+  public:
+    NadaWindowedSlope()
+        : m_sumY(0.0),
+          m_sumXY(0.0)
+    {
+    }
+
+    void Push(double value)
+    {
+        uint32_t x = m_window.Size();
+        if (m_window.IsFull())
+        {
+            // Dropping the oldest sample shifts every other one to x - 1
+            double oldest = m_window.Front();
+            m_sumY -= oldest;
+            m_sumXY -= m_sumY;
+            x = N - 1;
+        }
+        m_window.Push(value);
+        m_sumY += value;
+        m_sumXY += x * value;
+    }
+
+    uint32_t Size() const
+    {
+        return m_window.Size();
+    }
+
+    /**
+     * \brief Slope per sample, 0 with fewer than two samples
+     */
+    double GetSlope() const
+    {
+        double n = m_window.Size();
+        if (n < 2)
+        {
+            return 0.0;
+        }
+        double sumX = n * (n - 1) / 2.0;
+        double sumX2 = (n - 1) * n * (2 * n - 1) / 6.0;
+        double denominator = n * sumX2 - sumX * sumX;
+        return (n * m_sumXY - sumX * m_sumY) / denominator;
+    }
+
+    void Clear()
+    {
+        m_window.Clear();
+        m_sumY = 0.0;
+        m_sumXY = 0.0;
+    }
+
+  private:
+    NadaSampleWindow<double, N> m_window; // Samples in the window
+    double m_sumY;                        // Sum of y
+    double m_sumXY;                       // Sum of x * y
+};
+
+/**
+ * \ingroup internet
+ * \brief Quantiles of every sample seen, in fixed memory
+ *
+ * A log-linear histogram in the manner of HdrHistogram: values below 32
+ * have a bucket each, and every power of two above is split into 16
+ * buckets, so a bucket spans at most 1/16 of its lower bound. Quantiles
+ * are reported at the middle of their bucket, within about 3% of the
+ * exact value however many samples are pushed. Values from 2^32 share the
+ * last bucket. The caller picks the unit, e.g. microseconds for delays.
+ */
+class NadaLogHistogram
+{
+  public:
+    NadaLogHistogram()
+    {
+        Clear();
+    }
+
+    void Push(uint64_t value)
+    {
+        m_counts[GetBucket(value)]++;
+        m_min = (m_count == 0) ? value : std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        m_sum += value;
+        m_count++;
+    }
+
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMean() const
+    {
+        return (m_count > 0) ? static_cast<double>(m_sum) / m_count : 0.0;
+    }
+
+    /**
+     * \brief Smallest sample, 0 with no samples
+     */
+    uint64_t GetMin() const
+    {
+        return m_min;
+    }
+
+    /**
+     * \brief Largest sample, 0 with no samples
+     */
+    uint64_t GetMax() const
+    {
+        return m_max;
+    }
+
+    /**
+     * \brief Value below which a fraction of the samples fall
+     * \param fraction Fraction in [0, 1], e.g. 0.99 for the 99th percentile
+     * \return The quantile, 0 with no samples
+     */
+    double GetQuantile(double fraction) const
+    {
+        if (m_count == 0)
+        {
+            return 0.0;
+        }
+        // The extremes are kept exactly
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * m_count));
+        if (rank <= 1)
+        {
+            return m_min;
+        }
+        if (rank >= m_count)
+        {
+            return m_max;
+        }
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKETS; i++)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                uint32_t shift = GetShift(i);
+                double lower = static_cast<double>(uint64_t(i - (shift << SUB_BITS)) << shift);
+                double middle = lower + ((uint64_t(1) << shift) - 1) / 2.0;
+                return std::min<double>(std::max<double>(middle, m_min), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    void Clear()
+    {
+        m_counts.fill(0);
+        m_count = 0;
+        m_sum = 0;
+        m_min = 0;
+        m_max = 0;
+    }
+
+  private:
+    static const uint32_t SUB_BITS = 4;                 // log2 of the buckets per power of two
+    static const uint32_t LINEAR = 2u << SUB_BITS;      // Values below this have a bucket each
+    static const uint32_t BUCKETS = LINEAR + ((31 - SUB_BITS) << SUB_BITS);
+
+    /**
+     * \brief Bucket of a value: its top SUB_BITS + 1 bits, offset by their shift
+     */
+    static uint32_t GetBucket(uint64_t value)
+    {
+        value = std::min<uint64_t>(value, 0xffffffff);
+        uint32_t shift = 0;
+        while ((value >> shift) >= LINEAR)
+        {
+            shift++;
+        }
+        return (shift << SUB_BITS) + static_cast<uint32_t>(value >> shift);
+    }
+
+    /**
+     * \brief Right shift of the values in a bucket, log2 of its width
+     */
+    static uint32_t GetShift(uint32_t bucket)
+    {
+        return (bucket < LINEAR) ? 0 : (bucket >> SUB_BITS) - 1;
+    }
+
+    std::array<uint32_t, BUCKETS> m_counts; // Samples per bucket
+    uint64_t m_count;                       // Samples pushed
+    uint64_t m_sum;                         // Sum of the samples, for the mean
+    uint64_t m_min;                         // Smallest sample
+    uint64_t m_max;                         // Largest sample
+};
+
+} // namespace ns3
+
+#endif /* NADA_WINDOW_STATS_H */
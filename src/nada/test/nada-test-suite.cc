@@ -0,0 +1,325 @@
+#include "ns3/agg-path-nada.h"
+#include "ns3/data-rate.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/nada-header.h"
+#include "ns3/nada-improved.h"
+#include "ns3/nada-window-stats.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/video-receiver.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup nada-tests
+ * \brief A loss in a hundred packets is not taken for heavy loss
+ *
+ * Sender-side losses are averaged over NadaLossWindow, so however often
+ * feedback arrives one loss in 100 packets reads as 1% and the emergency
+ * decrease of NadaCongestionControl::ProcessLoss() (loss above 20%) does
+ * not trigger.
+ */
+class NadaSparseLossTestCase : public TestCase
+{
+  public:
+    NadaSparseLossTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+NadaSparseLossTestCase::NadaSparseLossTestCase()
+    : TestCase("One loss in 100 packets causes no multiplicative decrease")
+{
+}
+
+void
+NadaSparseLossTestCase::DoRun()
+{
+    Ptr<NadaCongestionControl> nada = CreateObject<NadaCongestionControl>();
+    nada->SetInitialRate(DataRate("20Mbps"));
+    DataRate initial = nada->GetCurrentRate();
+
+    // The loss comes first, the worst case for a short average; with
+    // per-packet ACKs every packet is followed by a report
+    NadaLossWindow<100> window;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        window.Push(i == 0);
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(window.GetLossRate(), 0.01, "Loss rate of packet " << i);
+        nada->ProcessLoss(window.GetLossRate());
+    }
+    NS_TEST_ASSERT_MSG_EQ(nada->GetCurrentRate(), initial, "The rate was cut");
+
+    // The loss leaves the window after 100 more packets
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        window.Push(false);
+    }
+    NS_TEST_ASSERT_MSG_EQ(window.GetLossRate(), 0.0, "The loss did not leave the window");
+
+    // Heavy loss still triggers the emergency decrease
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        window.Push(true);
+    }
+    nada->ProcessLoss(window.GetLossRate());
+    NS_TEST_ASSERT_MSG_LT(nada->GetCurrentRate().GetBitRate(),
+                          initial.GetBitRate(),
+                          "50% loss did not cut the rate");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup nada-tests
+ * \brief AckEveryN = 0 without an AckInterval still acknowledges every packet
+ *
+ * AckEveryN = 0 leaves the AckInterval timer as the only trigger of
+ * aggregated ACKs. Without a timer the receiver has to fall back to
+ * per-packet ACKs instead of holding the report forever.
+ */
+class NadaAckEveryZeroTestCase : public TestCase
+{
+  public:
+    NadaAckEveryZeroTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Send a data packet to the receiver
+     * \param socket Sender socket
+     * \param peer Receiver address
+     * \param seq Sequence number of the packet
+     */
+    void SendData(Ptr<Socket> socket, Address peer, uint32_t seq);
+
+    /**
+     * \brief Count the feedback packets reaching the sender
+     * \param socket Sender socket
+     */
+    void ReceiveFeedback(Ptr<Socket> socket);
+
+    uint32_t m_feedback; // Feedback packets received by the sender
+};
+
+NadaAckEveryZeroTestCase::NadaAckEveryZeroTestCase()
+    : TestCase("AckEveryN = 0 without AckInterval falls back to per-packet ACKs"),
+      m_feedback(0)
+{
+}
+
+void
+NadaAckEveryZeroTestCase::SendData(Ptr<Socket> socket, Address peer, uint32_t seq)
+{
+    NadaHeader header;
+    header.SetPacketType(NadaHeader::DATA);
+    header.SetSequenceNumber(seq);
+    header.SetTimestamp(Simulator::Now());
+    Ptr<Packet> packet = Create<Packet>(1000);
+    packet->AddHeader(header);
+    socket->SendTo(packet, 0, peer);
+}
+
+void
+NadaAckEveryZeroTestCase::ReceiveFeedback(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_feedback++;
+    }
+}
+
+void
+NadaAckEveryZeroTestCase::DoRun()
+{
+    const uint32_t packets = 20;
+    NadaHeader::WireFormat format = NadaHeader::GetWireFormat();
+    NadaHeader::SetWireFormat(NadaHeader::COMPACT);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper link;
+    NetDeviceContainer devices = link.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    VideoReceiverHelper server(9);
+    server.SetAttribute("AckEveryN", UintegerValue(0));
+    ApplicationContainer apps = server.Install(nodes.Get(1));
+    apps.Start(Seconds(0));
+    apps.Stop(Seconds(2));
+
+    Ptr<Socket> sender = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    sender->Bind();
+    sender->SetRecvCallback(MakeCallback(&NadaAckEveryZeroTestCase::ReceiveFeedback, this));
+    Address peer = InetSocketAddress(interfaces.GetAddress(1), 9);
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        Simulator::Schedule(MilliSeconds(100 + 10 * i),
+                            &NadaAckEveryZeroTestCase::SendData,
+                            this,
+                            sender,
+                            peer,
+                            i);
+    }
+
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+    Simulator::Destroy();
+    NadaHeader::SetWireFormat(format);
+
+    NS_TEST_ASSERT_MSG_EQ(m_feedback, packets, "Every data packet should be acknowledged");
+}
+
+/**
+ * \ingroup nada-tests
+ * \brief The RTT combiner of AggregatePathNadaClient steers its controller
+ *
+ * One of two paths is overloaded, so its queue and RTT keep growing while
+ * the other path stays idle. The mean of the path delays reports the queue,
+ * their minimum does not, so the client combining with the minimum ends up
+ * sending faster.
+ */
+class NadaAggregateRttCombinerTestCase : public TestCase
+{
+  public:
+    NadaAggregateRttCombinerTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the two-path scenario
+     * \param combiner AggregatePathNadaClient::RttCombiner to use
+     * \return Rate of the controller at the end of the run
+     */
+    DataRate RunWithCombiner(AggregatePathNadaClient::RttCombiner combiner);
+
+    /**
+     * \brief Hand a video frame to the client
+     * \param client The client
+     * \param frameId Frame identifier
+     */
+    void SendFrame(Ptr<AggregatePathNadaClient> client, uint32_t frameId);
+};
+
+NadaAggregateRttCombinerTestCase::NadaAggregateRttCombinerTestCase()
+    : TestCase("The aggregated RTT combiner changes the rate of AggregatePathNadaClient")
+{
+}
+
+void
+NadaAggregateRttCombinerTestCase::SendFrame(Ptr<AggregatePathNadaClient> client, uint32_t frameId)
+{
+    const uint16_t packets = 12;
+    for (uint16_t i = 0; i < packets; i++)
+    {
+        client->SetVideoFrameContext(frameId, i, packets);
+        client->Send(Create<Packet>(1000));
+    }
+}
+
+DataRate
+NadaAggregateRttCombinerTestCase::RunWithCombiner(AggregatePathNadaClient::RttCombiner combiner)
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    // Path 1 is far from full; path 2 gets 1.2 Mbps of its 1 Mbps
+    SimpleNetDeviceHelper fastLink;
+    fastLink.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    fastLink.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    SimpleNetDeviceHelper slowLink;
+    slowLink.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Mbps")));
+    slowLink.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer fast = ipv4.Assign(fastLink.Install(nodes));
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer slow = ipv4.Assign(slowLink.Install(nodes));
+
+    VideoReceiverHelper server(9);
+    ApplicationContainer apps = server.Install(nodes.Get(1));
+    apps.Start(Seconds(0));
+    apps.Stop(Seconds(3));
+
+    Ptr<AggregatePathNadaClient> client = CreateObject<AggregatePathNadaClient>();
+    client->SetAttribute("RttCombiner", UintegerValue(combiner));
+    client->SetMaxPackets(100000);
+    // Equal capacities split the load evenly over both paths
+    client->AddPath(1,
+                    InetSocketAddress(fast.GetAddress(0), 0),
+                    InetSocketAddress(fast.GetAddress(1), 9),
+                    DataRate("5Mbps"));
+    client->AddPath(2,
+                    InetSocketAddress(slow.GetAddress(0), 0),
+                    InetSocketAddress(slow.GetAddress(1), 9),
+                    DataRate("5Mbps"));
+    nodes.Get(0)->AddApplication(client);
+    client->SetStartTime(Seconds(0));
+    client->SetStopTime(Seconds(3));
+
+    // 25 frames of 12 packets per second, whatever rate the controller picks
+    for (uint32_t i = 0; i < 60; i++)
+    {
+        Simulator::Schedule(MilliSeconds(100 + 40 * i),
+                            &NadaAggregateRttCombinerTestCase::SendFrame,
+                            this,
+                            client,
+                            i);
+    }
+
+    DataRate rate;
+    Simulator::Schedule(MilliSeconds(2500), [&rate, client]() { rate = client->GetCurrentRate(); });
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+    Simulator::Destroy();
+    return rate;
+}
+
+void
+NadaAggregateRttCombinerTestCase::DoRun()
+{
+    DataRate meanRate = RunWithCombiner(AggregatePathNadaClient::RTT_MEAN);
+    DataRate minRate = RunWithCombiner(AggregatePathNadaClient::RTT_MIN);
+
+    NS_TEST_ASSERT_MSG_GT(minRate.GetBitRate(),
+                          meanRate.GetBitRate(),
+                          "Ignoring the queued path should leave a higher rate");
+}
+
+/**
+ * \ingroup nada-tests
+ * \brief Unit tests of the NADA module
+ */
+class NadaTestSuite : public TestSuite
+{
+  public:
+    NadaTestSuite();
+};
+
+NadaTestSuite::NadaTestSuite()
+    : TestSuite("nada", Type::UNIT)
+{
+    AddTestCase(new NadaSparseLossTestCase(), Duration::QUICK);
+    AddTestCase(new NadaAckEveryZeroTestCase(), Duration::QUICK);
+    AddTestCase(new NadaAggregateRttCombinerTestCase(), Duration::QUICK);
+}
+
+/// Static instance registering the suite
+static NadaTestSuite g_nadaTestSuite;
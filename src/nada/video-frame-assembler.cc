@@ -0,0 +1,287 @@
+#include "video-frame-assembler.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("VideoFrameAssembler");
+
+VideoFrameAssembler::VideoFrameAssembler(uint32_t window)
+    : m_started(false),
+      m_oldest(0),
+      m_newest(0),
+      m_pending(0),
+      m_dropped(0),
+      m_recovered(0)
+{
+    SetWindow(window);
+}
+
+void
+VideoFrameAssembler::SetWindow(uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+    m_slots.assign(std::max<uint32_t>(window, 1), Slot());
+    Clear();
+}
+
+void
+VideoFrameAssembler::Clear(void)
+{
+    for (Slot& slot : m_slots)
+    {
+        slot.state = EMPTY;
+    }
+    m_started = false;
+    m_oldest = 0;
+    m_newest = 0;
+    m_pending = 0;
+}
+
+VideoFrameAssembler::SlotState
+VideoFrameAssembler::GetState(uint32_t frameId) const
+{
+    const Slot& slot = m_slots[frameId % m_slots.size()];
+    return (slot.state != EMPTY && slot.frame.frameId == frameId) ? slot.state : EMPTY;
+}
+
+VideoFrameAssembler::Result
+VideoFrameAssembler::AddPacket(uint32_t frameId,
+                               uint16_t packetIndex,
+                               uint16_t packetsInFrame,
+                               uint16_t packetsRequired,
+                               bool isKeyFrame,
+                               uint32_t size,
+                               Time sent,
+                               Time arrival,
+                               Frame& completed)
+{
+    NS_LOG_FUNCTION(this << frameId << packetIndex << packetsInFrame);
+
+    uint32_t window = m_slots.size();
+    if (!m_started)
+    {
+        m_started = true;
+        m_oldest = frameId;
+        m_newest = frameId;
+    }
+    else if (static_cast<int32_t>(frameId - m_oldest) < 0)
+    {
+        return STALE;
+    }
+
+    if (static_cast<int32_t>(frameId - m_newest) > 0)
+    {
+        m_newest = frameId;
+    }
+
+    // Newer frames push the oldest ones out of the window
+    while (m_newest - m_oldest >= window)
+    {
+        Slot& old = m_slots[m_oldest % window];
+        if (GetState(m_oldest) == ASSEMBLING)
+        {
+            NS_LOG_DEBUG("Frame " << m_oldest << " pushed out of the assembly window");
+            Drop(old);
+        }
+        m_oldest++;
+    }
+
+    Slot& slot = m_slots[frameId % window];
+    SlotState state = GetState(frameId);
+    if (state == FINISHED)
+    {
+        return STALE;
+    }
+    if (state == EMPTY)
+    {
+        packetsInFrame = std::max<uint16_t>(packetsInFrame, 1);
+        slot.frame = Frame();
+        slot.frame.frameId = frameId;
+        slot.frame.isKeyFrame = isKeyFrame;
+        slot.frame.packetsInFrame = packetsInFrame;
+        slot.frame.packetsRequired = std::max<uint16_t>(std::min(packetsRequired, packetsInFrame), 1);
+        slot.frame.firstSendTime = sent;
+        slot.frame.firstPacketTime = arrival;
+        slot.bits.assign((packetsInFrame + 63) / 64, 0);
+        slot.requests = 0;
+        slot.state = ASSEMBLING;
+        m_pending++;
+    }
+
+    Frame& frame = slot.frame;
+    if (packetIndex >= frame.packetsInFrame)
+    {
+        NS_LOG_WARN("Packet index " << packetIndex << " out of range for frame " << frameId
+                                    << " (" << frame.packetsInFrame << " packets)");
+        return STALE;
+    }
+
+    uint64_t mask = uint64_t(1) << (packetIndex % 64);
+    uint64_t& word = slot.bits[packetIndex / 64];
+    if (word & mask)
+    {
+        return DUPLICATE;
+    }
+    word |= mask;
+
+    frame.packetsReceived++;
+    if (packetIndex < frame.packetsRequired)
+    {
+        frame.sourceReceived++;
+    }
+    frame.totalSize += size;
+    frame.lastPacketTime = arrival;
+    // Packets of a frame may leave out of order, or again after a NACK
+    frame.firstSendTime = std::min(frame.firstSendTime, sent);
+
+    if (frame.packetsReceived < frame.packetsRequired)
+    {
+        return PENDING;
+    }
+
+    // The slot stays FINISHED so late duplicates and unneeded repair
+    // packets are recognised
+    frame.complete = true;
+    frame.recovered = (frame.sourceReceived < frame.packetsRequired);
+    if (frame.recovered)
+    {
+        NS_LOG_DEBUG("Frame " << frameId << " rebuilt from " << frame.sourceReceived << "/"
+                              << frame.packetsRequired << " source packets");
+        m_recovered++;
+    }
+    completed = frame;
+    slot.state = FINISHED;
+    m_pending--;
+    AdvanceOldest();
+    return COMPLETE;
+}
+
+uint32_t
+VideoFrameAssembler::ExpireOlderThan(Time cutoff)
+{
+    if (!m_started || m_pending == 0)
+    {
+        return 0;
+    }
+
+    uint32_t expired = 0;
+    for (uint32_t frameId = m_oldest; frameId != m_newest + 1; ++frameId)
+    {
+        if (GetState(frameId) != ASSEMBLING)
+        {
+            continue;
+        }
+
+        Slot& slot = m_slots[frameId % m_slots.size()];
+        if (slot.frame.firstPacketTime >= cutoff)
+        {
+            break;
+        }
+
+        NS_LOG_DEBUG("Frame " << frameId << " timed out with " << slot.frame.packetsReceived
+                              << "/" << slot.frame.packetsInFrame << " packets");
+        Drop(slot);
+        expired++;
+
+        // Frames older than a timed-out one that never showed up are lost too
+        m_oldest = frameId + 1;
+    }
+
+    AdvanceOldest();
+    return expired;
+}
+
+uint32_t
+VideoFrameAssembler::CollectMissing(Time now,
+                                    Time holdoff,
+                                    Time retryInterval,
+                                    uint32_t maxRequests,
+                                    uint32_t maxPackets,
+                                    std::vector<Missing>& missing)
+{
+    if (!m_started || m_pending == 0)
+    {
+        return 0;
+    }
+
+    uint32_t added = 0;
+    for (uint32_t frameId = m_oldest; frameId != m_newest + 1 && added < maxPackets; ++frameId)
+    {
+        if (GetState(frameId) != ASSEMBLING)
+        {
+            continue;
+        }
+
+        Slot& slot = m_slots[frameId % m_slots.size()];
+        Frame& frame = slot.frame;
+        if (slot.requests >= maxRequests || now - frame.lastPacketTime < holdoff ||
+            (slot.requests > 0 && now - slot.lastRequest < retryInterval))
+        {
+            continue;
+        }
+
+        // Index order puts source packets ahead of FEC repair packets
+        uint32_t needed = frame.packetsRequired - frame.packetsReceived;
+        for (uint16_t i = 0; i < frame.packetsInFrame && needed > 0 && added < maxPackets; i++)
+        {
+            if (!(slot.bits[i / 64] & (uint64_t(1) << (i % 64))))
+            {
+                missing.push_back(Missing{frameId, i});
+                needed--;
+                added++;
+            }
+        }
+
+        slot.lastRequest = now;
+        slot.requests++;
+    }
+
+    return added;
+}
+
+void
+VideoFrameAssembler::Drop(Slot& slot)
+{
+    m_pending--;
+    m_dropped++;
+    slot.state = FINISHED;
+}
+
+void
+VideoFrameAssembler::AdvanceOldest(void)
+{
+    while (m_oldest != m_newest + 1 && GetState(m_oldest) == FINISHED)
+    {
+        m_oldest++;
+    }
+}
+
+uint32_t
+VideoFrameAssembler::GetWindow(void) const
+{
+    return m_slots.size();
+}
+
+uint32_t
+VideoFrameAssembler::GetPendingFrames(void) const
+{
+    return m_pending;
+}
+
+uint64_t
+VideoFrameAssembler::GetDroppedFrames(void) const
+{
+    return m_dropped;
+}
+
+uint64_t
+VideoFrameAssembler::GetRecoveredFrames(void) const
+{
+    return m_recovered;
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+#ifndef VIDEO_FRAME_ASSEMBLER_H
+#define VIDEO_FRAME_ASSEMBLER_H
+
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Reassembles video frames from packets carrying explicit frame info
+ *
+ * Frames in progress live in a fixed table indexed by frameId modulo the
+ * window size; each slot keeps a received-packet bitmap, so duplicates are
+ * ignored and completion is exact. Slots and bitmaps are allocated once and
+ * reused, so adding a packet never allocates. Frames that stay incomplete
+ * longer than the timeout, or that are pushed out of the window by newer
+ * frames, are dropped.
+ *
+ * Frames protected by forward error correction are complete as soon as any
+ * packetsRequired of their packetsInFrame packets are in; payloads are not
+ * inspected, so the code is modelled as an ideal MDS erasure code.
+ */
+class VideoFrameAssembler
+{
+public:
+  /**
+   * \brief A frame being assembled or handed to the playout buffer
+   */
+  struct Frame
+  {
+    uint32_t frameId;           // Frame ID
+    bool isKeyFrame;            // Whether this is a key frame
+    uint32_t totalSize;         // Bytes received for this frame
+    uint16_t packetsInFrame;    // Packets the sender split the frame into
+    uint16_t packetsRequired;   // Packets needed to rebuild the frame
+    uint16_t packetsReceived;   // Distinct packets received so far
+    uint16_t sourceReceived;    // Distinct packets received below packetsRequired
+    bool complete;              // Whether enough packets have been received
+    bool recovered;             // Whether repair packets stood in for lost ones
+    Time firstSendTime;         // Earliest sender timestamp of its packets
+    Time firstPacketTime;       // Arrival time of the first packet
+    Time lastPacketTime;        // Arrival time of the last packet
+
+    Frame ()
+      : frameId (0),
+        isKeyFrame (false),
+        totalSize (0),
+        packetsInFrame (0),
+        packetsRequired (0),
+        packetsReceived (0),
+        sourceReceived (0),
+        complete (false),
+        recovered (false),
+        firstSendTime (Seconds (0)),
+        firstPacketTime (Seconds (0)),
+        lastPacketTime (Seconds (0))
+    {
+    }
+  };
+
+  /**
+   * \brief A packet of a frame in progress that has not arrived
+   */
+  struct Missing
+  {
+    uint32_t frameId;           // Frame the packet belongs to
+    uint16_t packetIndex;       // Position of the packet in the frame
+  };
+
+  /**
+   * \brief Outcome of AddPacket
+   */
+  enum Result
+  {
+    PENDING,    //!< Packet stored, frame still incomplete
+    COMPLETE,   //!< Packet completed the frame
+    DUPLICATE,  //!< Packet was already received
+    STALE       //!< Frame is too old, already delivered or already dropped
+  };
+
+  /**
+   * \brief Constructor
+   * \param window Number of frames that can be in progress at once
+   */
+  explicit VideoFrameAssembler (uint32_t window = 64);
+
+  /**
+   * \brief Resize the table, dropping every frame in progress
+   * \param window Number of frames that can be in progress at once
+   */
+  void SetWindow (uint32_t window);
+
+  /**
+   * \brief Drop every frame in progress and forget delivered frames
+   */
+  void Clear (void);
+
+  /**
+   * \brief Add a received packet
+   * \param frameId Frame the packet belongs to
+   * \param packetIndex Position of the packet in the frame
+   * \param packetsInFrame Number of packets in the frame
+   * \param packetsRequired Packets needed to rebuild the frame; equal to
+   *        packetsInFrame unless the frame carries FEC repair packets
+   * \param isKeyFrame Whether the frame is a key frame
+   * \param size Packet size in bytes
+   * \param sent Sender timestamp of the packet
+   * \param arrival Arrival time of the packet
+   * \param completed Receives the frame when the result is COMPLETE
+   * \return What happened to the packet
+   */
+  Result AddPacket (uint32_t frameId, uint16_t packetIndex, uint16_t packetsInFrame,
+                    uint16_t packetsRequired, bool isKeyFrame, uint32_t size, Time sent,
+                    Time arrival, Frame &completed);
+
+  /**
+   * \brief Drop frames whose first packet arrived before a cutoff time
+   *
+   * Walks from the oldest frame in progress and stops at the first one
+   * that is still young, so the cost is amortised O(1) per frame.
+   *
+   * \param cutoff Frames started strictly before this time are dropped
+   * \return Number of frames dropped
+   */
+  uint32_t ExpireOlderThan (Time cutoff);
+
+  /**
+   * \brief Collect the missing packets of stalled frames
+   *
+   * A frame in progress is stalled once none of its packets arrived for
+   * the holdoff time, which leaves room for packets reordered across paths.
+   * Each frame is requested at most maxRequests times, retryInterval apart.
+   * For FEC frames only as many packets as the frame still needs are
+   * requested, source packets first.
+   *
+   * \param now Current time
+   * \param holdoff Time without packets after which a frame is stalled
+   * \param retryInterval Minimum time between two requests for a frame
+   * \param maxRequests Requests allowed per frame
+   * \param maxPackets Entries to append at most
+   * \param missing Receives the missing packets
+   * \return Number of entries appended
+   */
+  uint32_t CollectMissing (Time now, Time holdoff, Time retryInterval, uint32_t maxRequests,
+                           uint32_t maxPackets, std::vector<Missing> &missing);
+
+  uint32_t GetWindow (void) const;
+  uint32_t GetPendingFrames (void) const;
+  uint64_t GetDroppedFrames (void) const;
+  uint64_t GetRecoveredFrames (void) const;
+
+private:
+  enum SlotState
+  {
+    EMPTY,      // No packet of the frame seen yet
+    ASSEMBLING, // Frame in progress
+    FINISHED    // Frame delivered or dropped
+  };
+
+  struct Slot
+  {
+    Frame frame;                 // Frame occupying the slot
+    SlotState state;             // Progress of frame.frameId
+    std::vector<uint64_t> bits;  // Received packets, one bit per packet index
+    Time lastRequest;            // Last time missing packets were requested
+    uint32_t requests;           // Times missing packets were requested
+
+    Slot ()
+      : state (EMPTY),
+        lastRequest (Seconds (0)),
+        requests (0)
+    {
+    }
+  };
+
+  SlotState GetState (uint32_t frameId) const;
+  void Drop (Slot &slot);
+  void AdvanceOldest (void);
+
+  std::vector<Slot> m_slots;     // Frames in progress, indexed by frameId % window
+  bool m_started;                // At least one frame has been seen
+  uint32_t m_oldest;             // Frames below this ID are finished or given up on
+  uint32_t m_newest;             // Highest frame ID seen
+  uint32_t m_pending;            // Frames in progress
+  uint64_t m_dropped;            // Frames dropped incomplete
+  uint64_t m_recovered;          // Frames completed with the help of repair packets
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_FRAME_ASSEMBLER_H */
@@ -0,0 +1,261 @@
+#include "video-frame-trace.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("VideoFrameTrace");
+
+namespace
+{
+
+const char TRACE_MAGIC[8] = {'N', 'A', 'D', 'A', 'F', 'T', 'R', '1'};
+
+/// Whether a file exists and was modified no earlier than another one
+bool
+IsUpToDate(const std::string& fileName, const std::string& source)
+{
+    struct stat file;
+    struct stat src;
+    if (stat(fileName.c_str(), &file) != 0)
+    {
+        return false;
+    }
+    return stat(source.c_str(), &src) != 0 || file.st_mtime >= src.st_mtime;
+}
+
+} // namespace
+
+Ptr<VideoFrameTrace>
+VideoFrameTrace::Open(const std::string& fileName)
+{
+    // Traces are immutable once read, so every source of the process shares them
+    static std::map<std::string, Ptr<VideoFrameTrace>> s_traces;
+    auto it = s_traces.find(fileName);
+    if (it != s_traces.end())
+    {
+        return it->second;
+    }
+
+    Ptr<VideoFrameTrace> trace = Create<VideoFrameTrace>();
+    std::string cacheName = fileName + ".nftr";
+    bool loaded = trace->Map(fileName) ||
+                  (IsUpToDate(cacheName, fileName) && trace->Map(cacheName));
+    if (!loaded && trace->Parse(fileName))
+    {
+        loaded = true;
+        if (!trace->WriteCache(cacheName))
+        {
+            NS_LOG_WARN("Cannot write frame trace cache " << cacheName);
+        }
+    }
+
+    if (!loaded || trace->GetFrames() == 0)
+    {
+        NS_LOG_ERROR("No frames in video trace " << fileName);
+        return nullptr;
+    }
+
+    NS_LOG_INFO("Video trace " << fileName << ": " << trace->GetFrames() << " frames, "
+                               << trace->GetKeyFrames() << " key frames, mean "
+                               << trace->GetMeanSize() << " bytes");
+    s_traces[fileName] = trace;
+    return trace;
+}
+
+VideoFrameTrace::VideoFrameTrace()
+    : m_entries(nullptr),
+      m_frames(0),
+      m_keyFrames(0),
+      m_totalBytes(0),
+      m_mapping(nullptr),
+      m_mappingSize(0)
+{
+}
+
+VideoFrameTrace::~VideoFrameTrace()
+{
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+}
+
+uint32_t
+VideoFrameTrace::GetFrames(void) const
+{
+    return m_frames;
+}
+
+uint32_t
+VideoFrameTrace::GetKeyFrames(void) const
+{
+    return m_keyFrames;
+}
+
+uint32_t
+VideoFrameTrace::GetSize(uint32_t index) const
+{
+    return m_entries[index] & ~KEY_BIT;
+}
+
+bool
+VideoFrameTrace::IsKeyFrame(uint32_t index) const
+{
+    return (m_entries[index] & KEY_BIT) != 0;
+}
+
+double
+VideoFrameTrace::GetMeanSize(void) const
+{
+    return m_frames > 0 ? static_cast<double>(m_totalBytes) / m_frames : 0.0;
+}
+
+bool
+VideoFrameTrace::Map(const std::string& fileName)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(FileHeader))
+    {
+        mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    size_t expected = sizeof(FileHeader) + static_cast<size_t>(header.frames) * sizeof(uint32_t);
+    if (std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        static_cast<size_t>(info.st_size) != expected)
+    {
+        // A text trace, or a cache cut short
+        munmap(mapping, info.st_size);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_mappingSize = info.st_size;
+    m_entries = reinterpret_cast<const uint32_t*>(static_cast<const char*>(mapping) +
+                                                  sizeof(FileHeader));
+    m_frames = header.frames;
+    m_keyFrames = header.keyFrames;
+    m_totalBytes = header.totalBytes;
+    return true;
+}
+
+bool
+VideoFrameTrace::Parse(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    if (!in)
+    {
+        return false;
+    }
+
+    m_parsed.clear();
+    m_keyFrames = 0;
+    m_totalBytes = 0;
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+
+        // The first number is the size, any other word the picture type
+        std::istringstream fields(line);
+        std::string field;
+        bool hasSize = false;
+        bool isKeyFrame = false;
+        uint64_t size = 0;
+        while (fields >> field)
+        {
+            if (std::isdigit(static_cast<unsigned char>(field[0])))
+            {
+                if (!hasSize)
+                {
+                    size = std::strtoull(field.c_str(), nullptr, 10);
+                    hasSize = true;
+                }
+                continue;
+            }
+            std::transform(field.begin(), field.end(), field.begin(), [](unsigned char c) {
+                return std::toupper(c);
+            });
+            isKeyFrame = isKeyFrame || field == "I" || field == "IDR" || field == "K" ||
+                         field == "KEY";
+        }
+
+        // Lines without a size, such as a CSV heading, are not frames
+        if (!hasSize)
+        {
+            continue;
+        }
+        uint32_t entry = static_cast<uint32_t>(std::min<uint64_t>(size, ~KEY_BIT));
+        m_totalBytes += entry;
+        if (isKeyFrame)
+        {
+            entry |= KEY_BIT;
+            m_keyFrames++;
+        }
+        m_parsed.push_back(entry);
+    }
+
+    m_entries = m_parsed.data();
+    m_frames = m_parsed.size();
+    return true;
+}
+
+bool
+VideoFrameTrace::WriteCache(const std::string& fileName) const
+{
+    FileHeader header;
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.frames = m_frames;
+    header.keyFrames = m_keyFrames;
+    header.totalBytes = m_totalBytes;
+
+    // Written aside and renamed, so parallel runs never map half a cache
+    std::ostringstream tmpName;
+    tmpName << fileName << "." << getpid() << ".tmp";
+    {
+        std::ofstream out(tmpName.str(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(m_entries), m_frames * sizeof(uint32_t));
+        if (!out)
+        {
+            std::remove(tmpName.str().c_str());
+            return false;
+        }
+    }
+    return std::rename(tmpName.str().c_str(), fileName.c_str()) == 0;
+}
+
+} // namespace ns3
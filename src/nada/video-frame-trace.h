@@ -0,0 +1,96 @@
+#ifndef VIDEO_FRAME_TRACE_H
+#define VIDEO_FRAME_TRACE_H
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Read-only sequence of encoded frame sizes replayed by VideoSource
+ *
+ * A text trace has one frame per line: its size in bytes and, optionally,
+ * its picture type, in either order and separated by spaces, tabs or
+ * commas. I, IDR and K mark key frames; every other type, or none, is a
+ * delta frame. Lines starting with '#' are ignored. This reads the output
+ * of, for example,
+ *
+ *     ffprobe -select_streams v -show_entries frame=pict_type,pkt_size -of csv=p=0 in.mp4
+ *
+ * The first time a text trace is opened it is parsed once and written next
+ * to it as a binary cache, <trace>.nftr. Later runs, and traces given in
+ * that format directly, are memory-mapped without any parsing. Open() also
+ * shares the trace between every source of a process, so a thousand flows
+ * replaying the same trace map it once.
+ */
+class VideoFrameTrace : public SimpleRefCount<VideoFrameTrace>
+{
+  public:
+    /**
+     * \brief Open a trace, reusing the one already open under the same name
+     * \param fileName Text trace or binary cache
+     * \return The trace, or nullptr if it cannot be read or holds no frames
+     */
+    static Ptr<VideoFrameTrace> Open(const std::string& fileName);
+
+    /// An empty trace; use Open() to read one
+    VideoFrameTrace();
+    ~VideoFrameTrace();
+
+    uint32_t GetFrames(void) const;
+    uint32_t GetKeyFrames(void) const;
+
+    /**
+     * \brief Size of a frame
+     * \param index Frame index, below GetFrames()
+     * \return Size in bytes
+     */
+    uint32_t GetSize(uint32_t index) const;
+
+    /**
+     * \brief Whether a frame is a key frame
+     * \param index Frame index, below GetFrames()
+     */
+    bool IsKeyFrame(uint32_t index) const;
+
+    /**
+     * \brief Mean frame size over the whole trace
+     * \return Bytes per frame
+     */
+    double GetMeanSize(void) const;
+
+  private:
+    /// Header of the binary cache; the frame entries follow it
+    struct FileHeader
+    {
+        char magic[8];       // "NADAFTR1"
+        uint32_t frames;     // Frame entries
+        uint32_t keyFrames;  // Entries with KEY_BIT set
+        uint64_t totalBytes; // Sum of the frame sizes
+    };
+
+    /// Set in an entry for key frames; the other bits hold the size
+    static const uint32_t KEY_BIT = 0x80000000;
+
+    bool Map(const std::string& fileName);
+    bool Parse(const std::string& fileName);
+    bool WriteCache(const std::string& fileName) const;
+
+    const uint32_t* m_entries;      // Frame entries, mapped or in m_parsed
+    uint32_t m_frames;              // Number of entries
+    uint32_t m_keyFrames;           // Key frames among them
+    uint64_t m_totalBytes;          // Sum of the frame sizes
+    void* m_mapping;                // Mapped cache file, or nullptr
+    size_t m_mappingSize;           // Bytes mapped
+    std::vector<uint32_t> m_parsed; // Entries when no cache could be mapped
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_FRAME_TRACE_H */
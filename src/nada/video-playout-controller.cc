@@ -0,0 +1,126 @@
+#include "video-playout-controller.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("VideoPlayoutController");
+
+VideoPlayoutController::VideoPlayoutController()
+    : m_frameInterval(Seconds(1.0 / 30.0)),
+      m_minDelay(MilliSeconds(40)),
+      m_maxDelay(Seconds(1)),
+      m_jitterFactor(4.0),
+      m_maxStretch(0.05),
+      m_started(false),
+      m_lastFrameId(0),
+      m_lastCompletion(Seconds(0)),
+      m_jitter(1.0 / 16.0, 0.0),
+      m_spread(1.0 / 16.0, 0.0)
+{
+}
+
+void
+VideoPlayoutController::SetFrameInterval(Time interval)
+{
+    m_frameInterval = interval;
+}
+
+void
+VideoPlayoutController::SetLimits(Time minDelay, Time maxDelay)
+{
+    m_minDelay = minDelay;
+    m_maxDelay = std::max(minDelay, maxDelay);
+}
+
+void
+VideoPlayoutController::SetJitterFactor(double factor)
+{
+    m_jitterFactor = std::max(factor, 0.0);
+}
+
+void
+VideoPlayoutController::SetMaxStretch(double stretch)
+{
+    m_maxStretch = std::clamp(stretch, 0.0, 0.5);
+}
+
+void
+VideoPlayoutController::OnFrameComplete(uint32_t frameId, Time firstPacketTime, Time lastPacketTime)
+{
+    m_spread.Update((lastPacketTime - firstPacketTime).GetSeconds());
+
+    if (!m_started)
+    {
+        m_started = true;
+        m_lastFrameId = frameId;
+        m_lastCompletion = lastPacketTime;
+        return;
+    }
+
+    // Frames completing out of order say nothing new about the spacing
+    int32_t frames = static_cast<int32_t>(frameId - m_lastFrameId);
+    if (frames <= 0)
+    {
+        return;
+    }
+
+    // RFC 3550 interarrival jitter, with the frame schedule as the sender clock
+    double transit = (lastPacketTime - m_lastCompletion).GetSeconds() -
+                     frames * m_frameInterval.GetSeconds();
+    m_jitter.Update(std::fabs(transit));
+    m_lastFrameId = frameId;
+    m_lastCompletion = lastPacketTime;
+
+    NS_LOG_DEBUG("Frame " << frameId << ": jitter " << m_jitter.Get() * 1000.0 << " ms, spread "
+                          << m_spread.Get() * 1000.0 << " ms, target "
+                          << GetTargetDelay().GetMilliSeconds() << " ms");
+}
+
+Time
+VideoPlayoutController::GetTargetDelay(void) const
+{
+    Time target = m_frameInterval + Seconds(m_spread.Get() + m_jitterFactor * m_jitter.Get());
+    return std::clamp(target, m_minDelay, m_maxDelay);
+}
+
+Time
+VideoPlayoutController::GetPlayoutInterval(Time bufferDepth) const
+{
+    Time target = GetTargetDelay();
+    if (!target.IsStrictlyPositive())
+    {
+        return m_frameInterval;
+    }
+
+    // Below the target frames are held slightly longer, above it shorter
+    double error = (target - bufferDepth).GetSeconds() / target.GetSeconds();
+    double stretch = m_maxStretch * std::clamp(error, -1.0, 1.0);
+    return m_frameInterval * (1.0 + stretch);
+}
+
+Time
+VideoPlayoutController::GetJitter(void) const
+{
+    return Seconds(m_jitter.Get());
+}
+
+Time
+VideoPlayoutController::GetDelaySpread(void) const
+{
+    return Seconds(m_spread.Get());
+}
+
+void
+VideoPlayoutController::Reset(void)
+{
+    m_started = false;
+    m_jitter.Reset();
+    m_spread.Reset();
+}
+
+} // namespace ns3
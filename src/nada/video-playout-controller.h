@@ -0,0 +1,94 @@
+#ifndef VIDEO_PLAYOUT_CONTROLLER_H
+#define VIDEO_PLAYOUT_CONTROLLER_H
+
+#include "ns3/nstime.h"
+#include "nada-window-stats.h"
+
+namespace ns3 {
+
+/**
+ * \brief Sizes the playout buffer of a video receiver from what it measures
+ *
+ * The target buffer depth covers the frame interval, the spread between the
+ * first and last packet of a frame (which grows when a frame is split over
+ * paths with different delays), and a multiple of the frame inter-arrival
+ * jitter, estimated as in RFC 3550 from the completion times of the frames.
+ * Playout is stretched or compressed by up to a few percent to steer the
+ * buffer towards the target instead of running it dry.
+ */
+class VideoPlayoutController
+{
+public:
+  VideoPlayoutController ();
+
+  /**
+   * \brief Set the nominal time between two frames
+   * \param interval Frame interval of the stream
+   */
+  void SetFrameInterval (Time interval);
+
+  /**
+   * \brief Bound the target buffer depth
+   * \param minDelay Smallest target
+   * \param maxDelay Largest target
+   */
+  void SetLimits (Time minDelay, Time maxDelay);
+
+  /**
+   * \brief Set how many jitter estimates the target covers
+   * \param factor Jitter multiple added to the target
+   */
+  void SetJitterFactor (double factor);
+
+  /**
+   * \brief Set the largest playout rate change
+   * \param stretch Fraction of the frame interval, e.g. 0.05 for +/-5%
+   */
+  void SetMaxStretch (double stretch);
+
+  /**
+   * \brief Account for a frame that has been assembled
+   * \param frameId Frame identifier
+   * \param firstPacketTime Arrival time of its first packet
+   * \param lastPacketTime Arrival time of the packet that completed it
+   */
+  void OnFrameComplete (uint32_t frameId, Time firstPacketTime, Time lastPacketTime);
+
+  /**
+   * \brief Get the buffer depth playout aims for
+   * \return Target depth, within the configured limits
+   */
+  Time GetTargetDelay (void) const;
+
+  /**
+   * \brief Get the time until the next frame should be played
+   * \param bufferDepth Media currently buffered
+   * \return The frame interval, stretched when the buffer is below the
+   *         target and compressed when it is above
+   */
+  Time GetPlayoutInterval (Time bufferDepth) const;
+
+  Time GetJitter (void) const;
+  Time GetDelaySpread (void) const;
+
+  /**
+   * \brief Forget every measurement
+   */
+  void Reset (void);
+
+private:
+  Time m_frameInterval;          // Nominal time between frames
+  Time m_minDelay;               // Smallest target depth
+  Time m_maxDelay;               // Largest target depth
+  double m_jitterFactor;         // Jitter multiple in the target
+  double m_maxStretch;           // Largest relative playout rate change
+  bool m_started;                // A frame has completed
+  uint32_t m_lastFrameId;        // Newest frame completed
+  Time m_lastCompletion;         // Completion time of m_lastFrameId
+  NadaEwma m_jitter;             // Inter-arrival jitter in seconds, gain 1/16
+  NadaEwma m_spread;             // First-to-last packet spread in seconds
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_PLAYOUT_CONTROLLER_H */
@@ -2,9 +2,13 @@
 #include "nada-header.h"
 
 #include "ns3/address-utils.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/double.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/log.h"
+#include "ns3/nstime.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
@@ -14,6 +18,7 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cmath>
 
 namespace ns3
 {
@@ -37,7 +42,102 @@ VideoReceiver::GetTypeId(void)
                                          "Frame rate in frames per second.",
                                          UintegerValue(30),
                                          MakeUintegerAccessor(&VideoReceiver::m_frameRate),
-                                         MakeUintegerChecker<uint32_t>());
+                                         MakeUintegerChecker<uint32_t>())
+                           .AddAttribute("AckEveryN",
+                                         "Send an aggregated ACK after this many data packets "
+                                         "from a sender (1 = one ACK per packet, 0 = only "
+                                         "the AckInterval timer triggers ACKs; without a "
+                                         "timer, 0 falls back to one ACK per packet).",
+                                         UintegerValue(1),
+                                         MakeUintegerAccessor(&VideoReceiver::m_ackEveryN),
+                                         MakeUintegerChecker<uint32_t>())
+                           .AddAttribute("AckInterval",
+                                         "Maximum time an aggregated ACK is held back "
+                                         "(0 = no timer).",
+                                         TimeValue(Seconds(0)),
+                                         MakeTimeAccessor(&VideoReceiver::m_ackInterval),
+                                         MakeTimeChecker())
+                           .AddAttribute("FrameWindow",
+                                         "Number of frames that can be assembled at once.",
+                                         UintegerValue(64),
+                                         MakeUintegerAccessor(&VideoReceiver::SetFrameWindow,
+                                                              &VideoReceiver::GetFrameWindow),
+                                         MakeUintegerChecker<uint32_t>(1))
+                           .AddAttribute("FrameTimeout",
+                                         "Time after its first packet at which an incomplete "
+                                         "frame is dropped.",
+                                         TimeValue(MilliSeconds(50)),
+                                         MakeTimeAccessor(&VideoReceiver::m_frameTimeout),
+                                         MakeTimeChecker())
+                           .AddAttribute("Nack",
+                                         "Request missing packets of stalled frames from the "
+                                         "sender (compact headers only).",
+                                         BooleanValue(false),
+                                         MakeBooleanAccessor(&VideoReceiver::m_nackEnabled),
+                                         MakeBooleanChecker())
+                           .AddAttribute("NackHoldoff",
+                                         "Time without packets of a frame after which its "
+                                         "missing packets are requested.",
+                                         TimeValue(MilliSeconds(20)),
+                                         MakeTimeAccessor(&VideoReceiver::m_nackHoldoff),
+                                         MakeTimeChecker())
+                           .AddAttribute("NackRetryInterval",
+                                         "Minimum time between two requests for the same frame.",
+                                         TimeValue(MilliSeconds(60)),
+                                         MakeTimeAccessor(&VideoReceiver::m_nackRetryInterval),
+                                         MakeTimeChecker())
+                           .AddAttribute("NackRetries",
+                                         "Number of times the missing packets of a frame are "
+                                         "requested.",
+                                         UintegerValue(2),
+                                         MakeUintegerAccessor(&VideoReceiver::m_nackRetries),
+                                         MakeUintegerChecker<uint32_t>())
+                           .AddAttribute("StartupDelay",
+                                         "Media buffered before playback starts.",
+                                         TimeValue(MilliSeconds(200)),
+                                         MakeTimeAccessor(&VideoReceiver::m_startupDelay),
+                                         MakeTimeChecker())
+                           .AddAttribute("MinPlayoutDelay",
+                                         "Smallest target depth of the playout buffer.",
+                                         TimeValue(MilliSeconds(40)),
+                                         MakeTimeAccessor(&VideoReceiver::m_minPlayoutDelay),
+                                         MakeTimeChecker())
+                           .AddAttribute("MaxPlayoutDelay",
+                                         "Largest target depth of the playout buffer.",
+                                         TimeValue(Seconds(1)),
+                                         MakeTimeAccessor(&VideoReceiver::m_maxPlayoutDelay),
+                                         MakeTimeChecker())
+                           .AddAttribute("JitterFactor",
+                                         "Multiple of the measured frame jitter the target "
+                                         "playout depth covers.",
+                                         DoubleValue(4.0),
+                                         MakeDoubleAccessor(&VideoReceiver::m_jitterFactor),
+                                         MakeDoubleChecker<double>(0.0))
+                           .AddAttribute("MaxPlayoutStretch",
+                                         "Largest relative change of the playout rate used to "
+                                         "steer the buffer to its target.",
+                                         DoubleValue(0.05),
+                                         MakeDoubleAccessor(&VideoReceiver::m_maxPlayoutStretch),
+                                         MakeDoubleChecker<double>(0.0, 0.5))
+                           .AddAttribute("QoeReferenceRate",
+                                         "Video bitrate the QoE estimate scores as full "
+                                         "quality.",
+                                         DataRateValue(DataRate("2Mbps")),
+                                         MakeDataRateAccessor(&VideoReceiver::m_qoeReferenceRate),
+                                         MakeDataRateChecker())
+                           .AddTraceSource("FrameComplete",
+                                           "A frame was assembled and entered the playout buffer.",
+                                           MakeTraceSourceAccessor(&VideoReceiver::m_frameCompleteTrace),
+                                           "ns3::VideoReceiver::FrameCompleteTracedCallback")
+                           .AddTraceSource("Underrun",
+                                           "Playout found the buffer empty.",
+                                           MakeTraceSourceAccessor(&VideoReceiver::m_underrunTrace),
+                                           "ns3::VideoReceiver::UnderrunTracedCallback")
+                           .AddTraceSource("BufferDepth",
+                                           "Frames and media time in the playout buffer, at every "
+                                           "change.",
+                                           MakeTraceSourceAccessor(&VideoReceiver::m_bufferDepthTrace),
+                                           "ns3::VideoReceiver::BufferDepthTracedCallback");
     return tid;
 }
 
@@ -45,9 +145,33 @@ VideoReceiver::VideoReceiver()
     : m_port(9),
       m_frameRate(30),
       m_frameInterval(Seconds(1.0/30.0)), // Default 30fps
+      m_frameTimeout(MilliSeconds(50)),
+      m_fallbackFrameId(1),
+      m_fallbackPacketCount(0),
       m_lastFrameId(0),
       m_consumedFrames(0),
-      m_bufferUnderruns(0)
+      m_bufferUnderruns(0),
+      m_lastFrameLatency(Seconds(0)),
+      m_completedFrames(0),
+      m_completedBytes(0),
+      m_firstFrameTime(Seconds(0)),
+      m_playoutStart(Seconds(0)),
+      m_stallStart(Seconds(0)),
+      m_stallTime(Seconds(0)),
+      m_qoeReferenceRate(DataRate("2Mbps")),
+      m_ackEveryN(1),
+      m_ackInterval(Seconds(0)),
+      m_nackEnabled(false),
+      m_nackHoldoff(MilliSeconds(20)),
+      m_nackRetryInterval(MilliSeconds(60)),
+      m_nackRetries(2),
+      m_nackedPackets(0),
+      m_playing(false),
+      m_startupDelay(MilliSeconds(200)),
+      m_minPlayoutDelay(MilliSeconds(40)),
+      m_maxPlayoutDelay(Seconds(1)),
+      m_jitterFactor(4.0),
+      m_maxPlayoutStretch(0.05)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -62,6 +186,7 @@ VideoReceiver::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
     m_socket = 0;
+    m_pendingFeedback.clear();
     Application::DoDispose();
 }
 
@@ -96,19 +221,31 @@ VideoReceiver::StartApplication(void)
 
     m_socket->SetRecvCallback(MakeCallback(&VideoReceiver::HandleRead, this));
 
-    // Initial buffering - wait for some frames before starting consumption
-    uint32_t initialBufferFrames = 5;
-    Time initialBufferingTime = Seconds(std::max(10.0, initialBufferFrames * m_frameInterval.GetSeconds()));
+    // Playout starts from ProcessVideoPacket once StartupDelay of media is buffered
+    m_frameInterval = Seconds(1.0 / std::max<uint32_t>(m_frameRate, 1));
+    m_playout.SetFrameInterval(m_frameInterval);
+    m_playout.SetLimits(m_minPlayoutDelay, m_maxPlayoutDelay);
+    m_playout.SetJitterFactor(m_jitterFactor);
+    m_playout.SetMaxStretch(m_maxPlayoutStretch);
+    m_playing = false;
 
-    // Schedule initial frame consumption after initial buffering period
-    m_consumeEvent = Simulator::Schedule(initialBufferingTime, &VideoReceiver::ConsumeFrame, this);
+    if (m_ackEveryN == 0 && !m_ackInterval.IsStrictlyPositive())
+    {
+        NS_LOG_WARN("AckEveryN = 0 without an AckInterval, sending one ACK per packet");
+    }
 
-    NS_LOG_INFO("Video receiver starting with initial buffering time of " <<
-                initialBufferingTime.GetSeconds() << " seconds (" <<
-                initialBufferFrames << " frames at " << m_frameRate << " fps)");
+    NS_LOG_INFO("Video receiver starting, playout begins once "
+                << m_startupDelay.GetMilliSeconds() << " ms are buffered ("
+                << m_frameRate << " fps)");
 
     // Schedule buffer stats recording (every 100ms)
     m_statsEvent = Simulator::Schedule(MilliSeconds(100), &VideoReceiver::RecordBufferState, this);
+
+    // The legacy layout has no NACK packet type
+    if (m_nackEnabled && NadaHeader::GetWireFormat() == NadaHeader::COMPACT)
+    {
+        m_nackEvent = Simulator::Schedule(m_nackHoldoff, &VideoReceiver::SendNacks, this);
+    }
 }
 
 void
@@ -130,6 +267,14 @@ VideoReceiver::StopApplication(void)
     {
         Simulator::Cancel(m_statsEvent);
     }
+
+    Simulator::Cancel(m_nackEvent);
+
+    for (auto& entry : m_pendingFeedback)
+    {
+        Simulator::Cancel(entry.second.flushEvent);
+        entry.second.ackVector.Clear();
+    }
 }
 
 void
@@ -161,40 +306,39 @@ VideoReceiver::ProcessVideoPacket(Ptr<Packet> packet, Address from, const NadaHe
 {
     NS_LOG_FUNCTION(this << packet << from);
 
-    // Extract frame information from NADA header
-    uint32_t sequenceNumber = header.GetSequenceNumber();
-    uint32_t frameId, packetId;
-
-    // **CRITICAL FIX: Handle both aggregate and multipath sequence formats**
-    if (sequenceNumber >= 1000) {
-        // Frame.Packet format (1000+ indicates frame ID encoding)
-        frameId = sequenceNumber / 1000;
-        packetId = sequenceNumber % 1000;
-    } else {
-        // Legacy format - convert to frame-based
-        static uint32_t legacyFrameId = 1;
-        static uint32_t legacyPacketCount = 0;
-
-        if (legacyPacketCount >= 15) { // 15 packets per frame
-            legacyFrameId++;
-            legacyPacketCount = 0;
+    uint32_t frameId;
+    uint16_t packetIndex;
+    uint16_t packetsInFrame;
+    uint16_t packetsRequired;
+
+    if (header.HasField(NadaHeader::FIELD_FRAME_INFO))
+    {
+        frameId = header.GetFrameId();
+        packetIndex = header.GetPacketIndex();
+        packetsInFrame = header.GetPacketsInFrame();
+        packetsRequired = header.GetSourcePackets();
+        m_nackPeer = from;
+    }
+    else
+    {
+        // Senders without frame info (legacy headers): assume 15 packets per frame
+        const uint16_t fallbackPacketsPerFrame = 15;
+        if (m_fallbackPacketCount >= fallbackPacketsPerFrame)
+        {
+            m_fallbackFrameId++;
+            m_fallbackPacketCount = 0;
         }
 
-        frameId = legacyFrameId;
-        packetId = legacyPacketCount;
-        legacyPacketCount++;
+        frameId = m_fallbackFrameId;
+        packetIndex = m_fallbackPacketCount++;
+        packetsInFrame = fallbackPacketsPerFrame;
+        packetsRequired = fallbackPacketsPerFrame;
     }
 
     bool isKeyFrame = (header.GetVideoFrameType() == 0);
-    uint32_t frameSize = header.GetVideoFrameSize();
     uint32_t packetSize = packet->GetSize();
 
-    // **Force minimum frame size for aggregate client**
-    if (frameSize == 0 || frameSize < packetSize * 10) {
-        frameSize = packetSize * 15; // Assume 15 packets per frame
-    }
-
-    SendAcknowledgment(from, header);
+    QueueFeedback(from, header);
 
     Time currentTime = Simulator::Now();
 
@@ -203,62 +347,61 @@ VideoReceiver::ProcessVideoPacket(Ptr<Packet> packet, Address from, const NadaHe
         m_lastFrameId = frameId;
     }
 
-    // Find or create frame
-    if (m_incompleteFrames.find(frameId) == m_incompleteFrames.end()) {
-        VideoFrame newFrame(frameId, isKeyFrame);
-        newFrame.firstPacketTime = currentTime;
-        newFrame.lastPacketTime = currentTime;
-        newFrame.totalSize = 0;
-        newFrame.complete = false;
-        m_incompleteFrames[frameId] = newFrame;
-
-        NS_LOG_DEBUG("Created frame " << frameId << " (" << (isKeyFrame ? "KEY" : "DELTA") << ")"
-                    << " - expected size: " << frameSize);
-    }
-
-    VideoFrame& frame = m_incompleteFrames[frameId];
-
-    // Add packet to frame
-    VideoPacket vPacket(frameId, packetId, isKeyFrame, packetSize, currentTime);
-    frame.packets.push_back(vPacket);
-    frame.totalSize += packetSize;
-    frame.lastPacketTime = currentTime;
-
-    // **CRITICAL FIX: More aggressive frame completion for aggregate client**
-    Time assemblyTime = currentTime - frame.firstPacketTime;
-
-    // **SIMPLIFIED completion criteria**
-    bool hasMinPackets = (frame.packets.size() >= 3); // Minimum 3 packets
-    bool hasReasonableSize = (frame.totalSize >= frameSize * 0.3); // 30% of expected size
-    bool hasTimeout = (assemblyTime >= MilliSeconds(50)); // 50ms timeout
-    bool hasMaxPackets = (frame.packets.size() >= 20); // Max 20 packets per frame
-
-    if ((hasMinPackets && hasReasonableSize) || hasTimeout || hasMaxPackets) {
-        frame.complete = true;
-
+    VideoFrame frame;
+    VideoFrameAssembler::Result result = m_assembler.AddPacket(frameId,
+                                                               packetIndex,
+                                                               packetsInFrame,
+                                                               packetsRequired,
+                                                               isKeyFrame,
+                                                               packetSize,
+                                                               header.GetTimestamp(),
+                                                               currentTime,
+                                                               frame);
+
+    if (result == VideoFrameAssembler::COMPLETE)
+    {
+        Time assemblyTime = frame.lastPacketTime - frame.firstPacketTime;
         NS_LOG_INFO("Frame " << frameId << " completed: "
-                   << frame.packets.size() << " packets, "
+                   << frame.packetsReceived << " packets, "
                    << frame.totalSize << " bytes, "
-                   << assemblyTime.GetMilliSeconds() << "ms assembly"
-                   << (hasTimeout ? " (TIMEOUT)" : "")
-                   << (hasMaxPackets ? " (MAX_PACKETS)" : ""));
+                   << assemblyTime.GetMilliSeconds() << "ms assembly");
+
+        // RFC 3550 jitter, taken over frames instead of packets
+        Time latency = frame.lastPacketTime - frame.firstSendTime;
+        m_frameLatency.Push(std::max<int64_t>(latency.GetMicroSeconds(), 0));
+        m_assemblyTime.Push(std::max<int64_t>(assemblyTime.GetMicroSeconds(), 0));
+        if (m_completedFrames > 0)
+        {
+            m_frameJitter.Push(std::abs((latency - m_lastFrameLatency).GetMicroSeconds()));
+        }
+        else
+        {
+            m_firstFrameTime = currentTime;
+        }
+        m_lastFrameLatency = latency;
+        m_completedFrames++;
+        m_completedBytes += frame.totalSize;
 
-        // Add to buffer immediately
         m_frameBuffer.push_back(frame);
-        m_incompleteFrames.erase(frameId);
+        m_playout.OnFrameComplete(frame.frameId, frame.firstPacketTime, frame.lastPacketTime);
+        m_frameCompleteTrace(frame.frameId, frame.totalSize, assemblyTime);
+        m_bufferDepthTrace(m_frameBuffer.size(), GetBufferDepth());
 
         NS_LOG_INFO("Frame " << frameId << " added to buffer (buffer size: " << m_frameBuffer.size() << ")");
-    }
 
-    // Clean up old incomplete frames
-    for (auto it = m_incompleteFrames.begin(); it != m_incompleteFrames.end(); ) {
-        if (it->first < frameId - 3) { // Keep only last 3 frames
-            NS_LOG_DEBUG("Cleaning up stale frame " << it->first);
-            it = m_incompleteFrames.erase(it);
-        } else {
-            ++it;
+        if (!m_playing)
+        {
+            MaybeStartPlayout();
         }
     }
+    else if (result != VideoFrameAssembler::PENDING)
+    {
+        NS_LOG_DEBUG("Ignoring " << (result == VideoFrameAssembler::DUPLICATE ? "duplicate" : "stale")
+                    << " packet " << packetIndex << " of frame " << frameId);
+    }
+
+    // Give up on frames that have been incomplete for too long
+    m_assembler.ExpireOlderThan(currentTime - m_frameTimeout);
 }
 
 void
@@ -274,15 +417,22 @@ VideoReceiver::SendAcknowledgment(Address from, const NadaHeader& originalHeader
 
     try
     {
-        // Create ACK packet with minimal size
-        Ptr<Packet> ackPacket = Create<Packet>(64);
+        // The header is the whole ACK; only the legacy layout keeps its old padding
+        Ptr<Packet> ackPacket =
+            Create<Packet>(NadaHeader::GetWireFormat() == NadaHeader::LEGACY ? 64 : 0);
 
         // Create ACK header based on original packet
         NadaHeader ackHeader;
+        ackHeader.SetPacketType(NadaHeader::FEEDBACK);
         ackHeader.SetSequenceNumber(originalHeader.GetSequenceNumber());
         ackHeader.SetTimestamp(Simulator::Now()); // Current time for RTT calculation
+        // Echo the forward delay; the packet arrived just now, so nothing was held back
+        Time arrival = Simulator::Now();
+        ackHeader.SetReceiveTimestamp(arrival);
+        ackHeader.SetArrivalTimeOffset((arrival - originalHeader.GetTimestamp()).GetNanoSeconds());
         ackHeader.SetVideoFrameType(originalHeader.GetVideoFrameType());
         ackHeader.SetVideoFrameSize(originalHeader.GetVideoFrameSize());
+        AttachBufferState(ackHeader);
 
         ackPacket->AddHeader(ackHeader);
 
@@ -306,24 +456,190 @@ VideoReceiver::SendAcknowledgment(Address from, const NadaHeader& originalHeader
 }
 
 void
-VideoReceiver::CheckRebuffering()
+VideoReceiver::AttachBufferState(NadaHeader& header) const
+{
+    // The legacy 78-byte layout has no room for it
+    if (NadaHeader::GetWireFormat() != NadaHeader::COMPACT)
+    {
+        return;
+    }
+    header.SetBufferState(GetBufferDepth(), GetTargetBufferDepth(), m_bufferUnderruns);
+}
+
+bool
+VideoReceiver::IsAckAggregationEnabled(void) const
+{
+    // The legacy 78-byte layout cannot carry an ACK vector. AckEveryN = 0
+    // leaves the timer as the only trigger, so without one nothing would
+    // ever flush the report
+    return (m_ackEveryN > 1 || m_ackInterval.IsStrictlyPositive()) &&
+           NadaHeader::GetWireFormat() == NadaHeader::COMPACT;
+}
+
+void
+VideoReceiver::QueueFeedback(Address from, const NadaHeader& header)
+{
+    NS_LOG_FUNCTION(this << from << header.GetSequenceNumber());
+
+    if (!IsAckAggregationEnabled())
+    {
+        SendAcknowledgment(from, header);
+        return;
+    }
+
+    PendingFeedback& pending = m_pendingFeedback[from];
+    Time now = Simulator::Now();
+
+    if (!pending.ackVector.Record(header.GetSequenceNumber(), now))
+    {
+        // Reordered or far-ahead packet: close the current report and start a new one
+        FlushFeedback(from);
+        pending.ackVector.Record(header.GetSequenceNumber(), now);
+    }
+
+    if (header.GetSequenceNumber() == pending.ackVector.GetHighestSequence())
+    {
+        pending.newestArrival = now;
+        pending.newestForwardDelay = now - header.GetTimestamp();
+    }
+
+    if (m_ackEveryN > 0 && pending.ackVector.GetReceivedCount() >= m_ackEveryN)
+    {
+        FlushFeedback(from);
+    }
+    else if (m_ackInterval.IsStrictlyPositive() && !pending.flushEvent.IsPending())
+    {
+        pending.flushEvent =
+            Simulator::Schedule(m_ackInterval, &VideoReceiver::FlushFeedback, this, from);
+    }
+}
+
+void
+VideoReceiver::FlushFeedback(Address from)
+{
+    NS_LOG_FUNCTION(this << from);
+
+    auto it = m_pendingFeedback.find(from);
+    if (it == m_pendingFeedback.end() || it->second.ackVector.IsEmpty())
+    {
+        return;
+    }
+
+    PendingFeedback& pending = it->second;
+    Simulator::Cancel(pending.flushEvent);
+
+    if (!m_socket)
+    {
+        NS_LOG_ERROR("Cannot send aggregated ACK: socket is null");
+        pending.ackVector.Clear();
+        return;
+    }
+
+    NadaHeader ackHeader;
+    ackHeader.SetPacketType(NadaHeader::FEEDBACK);
+    ackHeader.SetSequenceNumber(pending.ackVector.GetHighestSequence());
+    ackHeader.SetTimestamp(Simulator::Now()); // Lets the sender subtract the hold time
+    ackHeader.SetAckVector(pending.ackVector);
+    ackHeader.SetReceiveTimestamp(pending.newestArrival);
+    ackHeader.SetArrivalTimeOffset(pending.newestForwardDelay.GetNanoSeconds());
+    AttachBufferState(ackHeader);
+
+    Ptr<Packet> ackPacket = Create<Packet>();
+    ackPacket->AddHeader(ackHeader);
+
+    if (m_socket->SendTo(ackPacket, 0, from) > 0)
+    {
+        NS_LOG_DEBUG("Aggregated ACK sent for " << pending.ackVector.GetReceivedCount() << "/"
+                                                << pending.ackVector.GetSpan()
+                                                << " packets up to sequence "
+                                                << pending.ackVector.GetHighestSequence());
+    }
+    else
+    {
+        NS_LOG_WARN("Failed to send aggregated ACK up to sequence "
+                    << pending.ackVector.GetHighestSequence());
+    }
+
+    pending.ackVector.Clear();
+}
+
+void
+VideoReceiver::SendNacks(void)
 {
     NS_LOG_FUNCTION(this);
 
-    // Check if we have enough frames to resume playback
-    uint32_t minimumFrames = std::max(2U, m_frameRate / 10); // At least 100ms worth of frames
+    // Half the holdoff keeps the request delay within 1.5 holdoffs
+    m_nackEvent = Simulator::Schedule(std::max(m_nackHoldoff / 2, MilliSeconds(1)),
+                                      &VideoReceiver::SendNacks,
+                                      this);
 
-    if (m_frameBuffer.size() >= minimumFrames) {
-        NS_LOG_INFO("Rebuffering complete, resuming playback with "
-                   << m_frameBuffer.size() << " frames");
-        // Resume normal consumption
-        m_consumeEvent = Simulator::Schedule(m_frameInterval, &VideoReceiver::ConsumeFrame, this);
-    } else {
-        NS_LOG_INFO("Still rebuffering, need " << minimumFrames
-                   << " frames, have " << m_frameBuffer.size());
-        // Continue rebuffering
-        m_consumeEvent = Simulator::Schedule(MilliSeconds(100), &VideoReceiver::CheckRebuffering, this);
+    if (!m_socket || m_nackPeer.IsInvalid())
+    {
+        return;
+    }
+
+    // Bounded so a burst of loss still fits a single datagram
+    const uint32_t maxNacksPerPacket = 64;
+    m_missing.clear();
+    if (m_assembler.CollectMissing(Simulator::Now(),
+                                   m_nackHoldoff,
+                                   m_nackRetryInterval,
+                                   m_nackRetries,
+                                   maxNacksPerPacket,
+                                   m_missing) == 0)
+    {
+        return;
+    }
+
+    NadaHeader nackHeader;
+    nackHeader.SetPacketType(NadaHeader::NACK);
+    nackHeader.SetTimestamp(Simulator::Now());
+    for (const VideoFrameAssembler::Missing& missing : m_missing)
+    {
+        nackHeader.AddNack(missing.frameId, missing.packetIndex);
+    }
+
+    Ptr<Packet> nackPacket = Create<Packet>();
+    nackPacket->AddHeader(nackHeader);
+
+    if (m_socket->SendTo(nackPacket, 0, m_nackPeer) > 0)
+    {
+        m_nackedPackets += m_missing.size();
+        NS_LOG_DEBUG("NACK sent for " << m_missing.size() << " packets, first in frame "
+                                      << m_missing.front().frameId);
+    }
+    else
+    {
+        NS_LOG_WARN("Failed to send NACK for " << m_missing.size() << " packets");
+    }
+}
+
+void
+VideoReceiver::MaybeStartPlayout()
+{
+    NS_LOG_FUNCTION(this);
+
+    // The first start only waits for StartupDelay, after an underrun the
+    // buffer refills to the live target so it does not run dry again at once
+    Time needed = (m_consumedFrames == 0) ? m_startupDelay : m_playout.GetTargetDelay();
+    if (m_playing || GetBufferDepth() < needed)
+    {
+        return;
+    }
+
+    NS_LOG_INFO((m_consumedFrames == 0 ? "Starting" : "Resuming") << " playback with "
+                << m_frameBuffer.size() << " frames (" << GetBufferDepth().GetMilliSeconds()
+                << " ms) buffered");
+    if (m_consumedFrames == 0)
+    {
+        m_playoutStart = Simulator::Now();
     }
+    else
+    {
+        m_stallTime += Simulator::Now() - m_stallStart;
+    }
+    m_playing = true;
+    m_consumeEvent = Simulator::ScheduleNow(&VideoReceiver::ConsumeFrame, this);
 }
 
 void
@@ -333,12 +649,12 @@ VideoReceiver::ConsumeFrame()
 
     if (m_frameBuffer.empty()) {
         m_bufferUnderruns++;
+        m_underrunTrace(m_bufferUnderruns);
         NS_LOG_WARN("Buffer underrun #" << m_bufferUnderruns);
 
-        // **FIX: Consistent rebuffering across simulations**
-        Time rebufferTime = MilliSeconds(300); // Consistent rebuffer time
-
-        m_consumeEvent = Simulator::Schedule(rebufferTime, &VideoReceiver::CheckRebuffering, this);
+        // Rebuffer until MaybeStartPlayout sees enough frames arrive
+        m_playing = false;
+        m_stallStart = Simulator::Now();
         return;
     }
 
@@ -346,21 +662,15 @@ VideoReceiver::ConsumeFrame()
     VideoFrame frame = m_frameBuffer.front();
     m_frameBuffer.pop_front();
     m_consumedFrames++;
+    m_bufferDepthTrace(m_frameBuffer.size(), GetBufferDepth());
 
     Time delay = Simulator::Now() - frame.firstPacketTime;
     NS_LOG_INFO("Consumed frame " << frame.frameId
                << ", buffer size: " << m_frameBuffer.size()
                << ", delay: " << delay.GetMilliSeconds() << "ms");
 
-    // **FIX: Consistent consumption timing**
-    Time nextInterval = m_frameInterval;
-
-    // Buffer-aware consumption adjustment
-    if (m_frameBuffer.size() < 2) {
-        nextInterval = m_frameInterval * 1.2; // Slow down when buffer low
-    } else if (m_frameBuffer.size() > 8) {
-        nextInterval = m_frameInterval * 0.8; // Speed up when buffer high
-    }
+    // Stretch or compress playout slightly to steer the buffer to its target
+    Time nextInterval = m_playout.GetPlayoutInterval(GetBufferDepth());
 
     m_consumeEvent = Simulator::Schedule(nextInterval, &VideoReceiver::ConsumeFrame, this);
 }
@@ -371,7 +681,7 @@ VideoReceiver::RecordBufferState()
     NS_LOG_FUNCTION(this);
 
     // Record current buffer length in frames
-    m_bufferLengthSamples.push_back(m_frameBuffer.size());
+    m_bufferLengthSamples.Push(m_frameBuffer.size());
 
     // Schedule next recording
     m_statsEvent = Simulator::Schedule(MilliSeconds(100), &VideoReceiver::RecordBufferState, this);
@@ -384,13 +694,9 @@ VideoReceiver::GetBufferStats() const
 
     // Calculate average buffer length
     double avgBufferLength = 0;
-    if (!m_bufferLengthSamples.empty())
+    if (m_bufferLengthSamples.GetCount() > 0)
     {
-        for (uint32_t sample : m_bufferLengthSamples)
-        {
-            avgBufferLength += sample;
-        }
-        avgBufferLength /= m_bufferLengthSamples.size();
+        avgBufferLength = m_bufferLengthSamples.GetMean();
     }
 
     // Calculate buffer length in time
@@ -403,6 +709,23 @@ VideoReceiver::GetBufferStats() const
     oss << "  Avg buffer: " << std::fixed << std::setprecision(2) << avgBufferLength
         << " frames (" << bufferLengthMs << " ms)\n";
     oss << "  Buffer underruns: " << m_bufferUnderruns << "\n";
+    oss << "  Playout target: " << m_playout.GetTargetDelay().GetMilliSeconds() << " ms (jitter "
+        << m_playout.GetJitter().GetMilliSeconds() << " ms, spread "
+        << m_playout.GetDelaySpread().GetMilliSeconds() << " ms)\n";
+    oss << "  Frames dropped: " << m_assembler.GetDroppedFrames() << "\n";
+    oss << "  Frames recovered by FEC: " << m_assembler.GetRecoveredFrames() << "\n";
+    oss << "  Packets NACKed: " << m_nackedPackets << "\n";
+    oss << "  Frame latency p50/p95/p99: " << m_frameLatency.GetQuantile(0.50) / 1000.0 << " / "
+        << m_frameLatency.GetQuantile(0.95) / 1000.0 << " / "
+        << m_frameLatency.GetQuantile(0.99) / 1000.0 << " ms\n";
+    oss << "  Assembly time p50/p95/p99: " << m_assemblyTime.GetQuantile(0.50) / 1000.0 << " / "
+        << m_assemblyTime.GetQuantile(0.95) / 1000.0 << " / "
+        << m_assemblyTime.GetQuantile(0.99) / 1000.0 << " ms\n";
+    oss << "  Frame jitter p50/p95/p99: " << m_frameJitter.GetQuantile(0.50) / 1000.0 << " / "
+        << m_frameJitter.GetQuantile(0.95) / 1000.0 << " / "
+        << m_frameJitter.GetQuantile(0.99) / 1000.0 << " ms\n";
+    oss << "  Stall time: " << GetStallTime().GetMilliSeconds() << " ms\n";
+    oss << "  Estimated MOS: " << GetQoeScore() << "\n";
 
     return oss.str();
 }
@@ -416,19 +739,143 @@ VideoReceiver::GetBufferUnderruns() const
 double
 VideoReceiver::GetAverageBufferLength() const
 {
-    if (m_bufferLengthSamples.empty())
+    if (m_bufferLengthSamples.GetCount() == 0)
+    {
+        return 0.0;
+    }
+
+    return m_bufferLengthSamples.GetMean() * m_frameInterval.GetMilliSeconds();
+}
+
+Time
+VideoReceiver::GetBufferDepth() const
+{
+    return m_frameInterval * static_cast<int64_t>(m_frameBuffer.size());
+}
+
+Time
+VideoReceiver::GetTargetBufferDepth() const
+{
+    return m_playout.GetTargetDelay();
+}
+
+uint64_t
+VideoReceiver::GetDroppedFrames() const
+{
+    return m_assembler.GetDroppedFrames();
+}
+
+uint64_t
+VideoReceiver::GetRecoveredFrames() const
+{
+    return m_assembler.GetRecoveredFrames();
+}
+
+uint64_t
+VideoReceiver::GetNackedPackets() const
+{
+    return m_nackedPackets;
+}
+
+const NadaLogHistogram&
+VideoReceiver::GetFrameLatency() const
+{
+    return m_frameLatency;
+}
+
+const NadaLogHistogram&
+VideoReceiver::GetAssemblyTime() const
+{
+    return m_assemblyTime;
+}
+
+const NadaLogHistogram&
+VideoReceiver::GetFrameJitter() const
+{
+    return m_frameJitter;
+}
+
+Time
+VideoReceiver::GetStallTime() const
+{
+    bool stalled = !m_playing && m_consumedFrames > 0;
+    return m_stallTime + (stalled ? Simulator::Now() - m_stallStart : Seconds(0));
+}
+
+double
+VideoReceiver::GetQoeScore() const
+{
+    if (m_consumedFrames == 0)
     {
         return 0.0;
     }
 
-    double sum = 0;
-    for (uint32_t length : m_bufferLengthSamples)
+    double session = (Simulator::Now() - m_playoutStart).GetSeconds();
+    double received = (Simulator::Now() - m_firstFrameTime).GetSeconds();
+    if (session <= 0.0 || received <= 0.0)
     {
-        sum += length;
+        return 5.0;
     }
 
-    double avgFrames = sum / m_bufferLengthSamples.size();
-    return avgFrames * m_frameInterval.GetMilliSeconds();
+    double rate = m_completedBytes * 8.0 / received;
+    double reference = std::max<double>(m_qoeReferenceRate.GetBitRate(), 1.0);
+    double rateFactor = std::min(1.0, std::log2(1.0 + rate / reference));
+
+    double stallRatio = GetStallTime().GetSeconds() / session;
+    double stallsPerMinute = m_bufferUnderruns * 60.0 / session;
+    double stallFactor = std::max(0.0, 1.0 - stallRatio / 0.2 - 0.02 * stallsPerMinute);
+
+    uint64_t dropped = m_assembler.GetDroppedFrames();
+    double lossPercent = 100.0 * dropped / std::max<uint64_t>(dropped + m_completedFrames, 1);
+    double lossFactor = std::max(0.0, 1.0 - lossPercent / 20.0);
+
+    return 1.0 + 4.0 * rateFactor * stallFactor * lossFactor;
+}
+
+void
+VideoReceiver::SetMetricsSink(Ptr<NadaMetricsSink> sink, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << name);
+    sink->AddSource(name, MakeCallback(&VideoReceiver::ReportMetrics, this));
+}
+
+void
+VideoReceiver::ReportMetrics(Ptr<NadaMetricsSink> sink)
+{
+    sink->Record("buffer_frames", m_frameBuffer.size());
+    sink->Record("buffer_ms", GetBufferDepth().GetSeconds() * 1000.0);
+    sink->Record("target_buffer_ms", GetTargetBufferDepth().GetSeconds() * 1000.0);
+    sink->Record("avg_buffer_ms", GetAverageBufferLength());
+    sink->Record("underruns", m_bufferUnderruns);
+    sink->Record("frames_consumed", m_consumedFrames);
+    sink->Record("frames_dropped", GetDroppedFrames());
+    sink->Record("frames_recovered", GetRecoveredFrames());
+    sink->Record("nacked_packets", GetNackedPackets());
+    sink->Record("jitter_ms", m_playout.GetJitter().GetSeconds() * 1000.0);
+    sink->Record("frame_latency_p50_ms", m_frameLatency.GetQuantile(0.50) / 1000.0);
+    sink->Record("frame_latency_p95_ms", m_frameLatency.GetQuantile(0.95) / 1000.0);
+    sink->Record("frame_latency_p99_ms", m_frameLatency.GetQuantile(0.99) / 1000.0);
+    sink->Record("assembly_p50_ms", m_assemblyTime.GetQuantile(0.50) / 1000.0);
+    sink->Record("assembly_p95_ms", m_assemblyTime.GetQuantile(0.95) / 1000.0);
+    sink->Record("assembly_p99_ms", m_assemblyTime.GetQuantile(0.99) / 1000.0);
+    sink->Record("frame_jitter_p50_ms", m_frameJitter.GetQuantile(0.50) / 1000.0);
+    sink->Record("frame_jitter_p95_ms", m_frameJitter.GetQuantile(0.95) / 1000.0);
+    sink->Record("frame_jitter_p99_ms", m_frameJitter.GetQuantile(0.99) / 1000.0);
+    sink->Record("stall_ms", GetStallTime().GetSeconds() * 1000.0);
+    sink->Record("mos", GetQoeScore());
+}
+
+void
+VideoReceiver::SetFrameWindow(uint32_t window)
+{
+    NS_LOG_FUNCTION(this << window);
+    m_assembler.SetWindow(window);
+}
+
+uint32_t
+VideoReceiver::GetFrameWindow(void) const
+{
+    return m_assembler.GetWindow();
 }
 
 // VideoReceiverHelper implementation
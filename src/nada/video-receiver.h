@@ -2,15 +2,22 @@
 #define VIDEO_RECEIVER_H
 
 #include "ns3/application.h"
+#include "ns3/data-rate.h"
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/address.h"
 #include "ns3/socket.h"
+#include "ns3/traced-callback.h"
 #include "nada-header.h"
+#include "nada-metrics-sink.h"
+#include "nada-ring-queue.h"
+#include "nada-window-stats.h"
+#include "video-frame-assembler.h"
+#include "video-playout-controller.h"
 
+#include <map>
 #include <queue>
 #include <vector>
-#include <deque>
 
 namespace ns3 {
 
@@ -20,6 +27,22 @@ namespace ns3 {
  * This class extends UdpNadaReceiver to add video buffer management functionality.
  * It tracks received video packets, organizes them into frames, and simulates video
  * playback by consuming frames at regular intervals.
+ *
+ * Feedback is sent once per data packet by default. Setting the AckEveryN
+ * and/or AckInterval attributes switches to aggregated ACKs that carry a
+ * NadaAckVector covering every packet received from that sender since the
+ * previous ACK.
+ *
+ * With the Nack attribute set, packets missing from frames that have
+ * stalled are requested again in NACK packets, so the sender can repair
+ * them before the frame is due for playout.
+ *
+ * Every completed frame feeds three fixed-size histograms (see
+ * NadaLogHistogram): its latency from the sender timestamp of its first
+ * packet to its completion, its assembly time, and its jitter, the change
+ * of that latency from the previous frame as in RFC 3550. Their
+ * percentiles, and the QoE estimate of GetQoeScore(), are available at
+ * any time of a run of any length.
  */
 class VideoReceiver : public Application
 {
@@ -31,6 +54,30 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  /**
+   * TracedCallback signature of the FrameComplete trace
+   *
+   * \param frameId The frame
+   * \param size Frame size in bytes
+   * \param assemblyTime Time between its first and last packet
+   */
+  typedef void (*FrameCompleteTracedCallback) (uint32_t frameId, uint32_t size, Time assemblyTime);
+
+  /**
+   * TracedCallback signature of the Underrun trace
+   *
+   * \param underruns Underruns so far, this one included
+   */
+  typedef void (*UnderrunTracedCallback) (uint32_t underruns);
+
+  /**
+   * TracedCallback signature of the BufferDepth trace
+   *
+   * \param frames Frames in the playout buffer
+   * \param depth Media time they hold
+   */
+  typedef void (*BufferDepthTracedCallback) (uint32_t frames, Time depth);
+
   /**
    * \brief Constructor
    */
@@ -42,49 +89,9 @@ public:
   virtual ~VideoReceiver ();
 
   /**
-   * \brief Structure to hold information about a video packet
+   * \brief A video frame assembled from received packets
    */
-  struct VideoPacket {
-    uint32_t frameId;       // Frame ID this packet belongs to
-    uint32_t packetId;      // Packet ID within the frame
-    bool isKeyFrame;        // Whether this packet is part of a key frame
-    uint32_t size;          // Size of the packet
-    Time arrivalTime;       // When the packet arrived
-
-    VideoPacket(uint32_t fId, uint32_t pId, bool isKey, uint32_t s, Time t)
-      : frameId(fId), packetId(pId), isKeyFrame(isKey), size(s), arrivalTime(t) {}
-  };
-
-  /**
-   * \brief Structure to hold information about a video frame
-   */
-  struct VideoFrame {
-    uint32_t frameId;           // Frame ID
-    bool isKeyFrame;            // Whether this is a key frame
-    uint32_t totalSize;         // Total size of the frame in bytes
-    std::vector<VideoPacket> packets;  // Packets that make up this frame
-    bool complete;              // Whether the frame is complete
-    Time firstPacketTime;       // Arrival time of the first packet
-    Time lastPacketTime;        // Arrival time of the last packet
-
-    VideoFrame()
-        : frameId(0),
-          isKeyFrame(false),
-          totalSize(0),
-          packets(),
-          complete(false),
-          firstPacketTime(Seconds(0)),
-          lastPacketTime(Seconds(0)) {}
-
-    VideoFrame(uint32_t id, bool isKey)
-        : frameId(id),
-          isKeyFrame(isKey),
-          totalSize(0),
-          packets(),
-          complete(false),
-          firstPacketTime(Seconds(0)),
-          lastPacketTime(Seconds(0)) {}
-  };
+  typedef VideoFrameAssembler::Frame VideoFrame;
 
     /**
      * \brief Set the local address and port to bind to
@@ -122,9 +129,102 @@ public:
    */
   double GetAverageBufferLength() const;
 
+  /**
+   * \brief Get the media currently buffered for playout
+   *
+   * \return Buffered frames times the frame interval
+   */
+  Time GetBufferDepth() const;
+
+  /**
+   * \brief Get the buffer depth playout currently aims for
+   *
+   * \return The target derived from measured jitter and delay spread
+   */
+  Time GetTargetBufferDepth() const;
+
+  /**
+   * \brief Get the number of frames dropped before they were complete
+   *
+   * \return The number of frames that timed out or left the assembly window
+   */
+  uint64_t GetDroppedFrames() const;
+
+  /**
+   * \brief Get the number of frames rebuilt with FEC repair packets
+   *
+   * \return The number of frames completed despite missing source packets
+   */
+  uint64_t GetRecoveredFrames() const;
+
+  /**
+   * \brief Get the number of packets requested again
+   *
+   * \return The number of NACK entries sent
+   */
+  uint64_t GetNackedPackets() const;
+
+  /**
+   * \brief Get the latency of the completed frames
+   *
+   * \return Histogram of sender timestamp to completion, in microseconds
+   */
+  const NadaLogHistogram &GetFrameLatency () const;
+
+  /**
+   * \brief Get the assembly time of the completed frames
+   *
+   * \return Histogram of first to last packet arrival, in microseconds
+   */
+  const NadaLogHistogram &GetAssemblyTime () const;
+
+  /**
+   * \brief Get the jitter of the completed frames
+   *
+   * \return Histogram of the latency change between consecutive frames, in microseconds
+   */
+  const NadaLogHistogram &GetFrameJitter () const;
+
+  /**
+   * \brief Get the time playout has been stalled since it first started
+   *
+   * \return Time spent rebuffering, the stall in progress included
+   */
+  Time GetStallTime () const;
+
+  /**
+   * \brief Estimate the quality of experience so far
+   *
+   * MOS = 1 + 4 * Qrate * Qstall * Qloss, where
+   * - Qrate = min(1, log2(1 + rate / QoeReferenceRate)), rate being the
+   *   bitrate of the completed frames;
+   * - Qstall = max(0, 1 - stall ratio / 0.2 - 0.02 * stalls per minute),
+   *   so stalling for a fifth of the session, or 50 times a minute, makes
+   *   the video unusable;
+   * - Qloss = max(0, 1 - dropped frame percentage / 20).
+   *
+   * \return Mean opinion score from 1 to 5, 0 before playout starts
+   */
+  double GetQoeScore () const;
+
+  /**
+   * \brief Have a metrics sink poll the playout statistics of this receiver
+   *
+   * \param sink The sink
+   * \param name Source name of the rows
+   */
+  void SetMetricsSink (Ptr<NadaMetricsSink> sink, const std::string& name);
+
 protected:
   virtual void DoDispose (void);
 
+  /**
+   * \brief Record the playout statistics during a sink poll
+   *
+   * \param sink The polling sink
+   */
+  virtual void ReportMetrics (Ptr<NadaMetricsSink> sink);
+
 private:
   virtual void StartApplication (void);
   virtual void StopApplication (void);
@@ -145,7 +245,47 @@ private:
    */
   void ProcessVideoPacket (Ptr<Packet> packet, Address from, const NadaHeader& header);
 
-  void CheckRebuffering();
+  /**
+   * \brief Acknowledge a data packet, immediately or through the aggregated ACK
+   *
+   * \param from The sender of the packet
+   * \param header The NADA header of the packet
+   */
+  void QueueFeedback (Address from, const NadaHeader& header);
+
+  /**
+   * \brief Send the aggregated ACK pending for a sender, if any
+   *
+   * \param from The sender the ACK is addressed to
+   */
+  void FlushFeedback (Address from);
+
+  /**
+   * \brief Check whether aggregated ACKs are configured and encodable
+   *
+   * \return true if feedback is batched instead of sent per packet
+   */
+  bool IsAckAggregationEnabled (void) const;
+
+  /**
+   * \brief Report the playout buffer state on an outgoing feedback header
+   *
+   * Lets the sender follow the buffer from feedback alone. Nothing is
+   * added with the legacy wire format.
+   *
+   * \param header The feedback header
+   */
+  void AttachBufferState (NadaHeader &header) const;
+
+  /**
+   * \brief Request the missing packets of stalled frames and re-arm the NACK timer
+   */
+  void SendNacks (void);
+
+  /**
+   * \brief Start or resume playout once enough media is buffered
+   */
+  void MaybeStartPlayout();
 
   /**
    * \brief Consume a frame from the buffer
@@ -157,6 +297,9 @@ private:
    */
   void RecordBufferState ();
 
+  void SetFrameWindow (uint32_t window);
+  uint32_t GetFrameWindow (void) const;
+
   Ptr<Socket> m_socket;               ///< Socket for receiving
   Address m_localAddress;             ///< Local address to bind to
   uint16_t m_port;                    ///< Port to bind to
@@ -164,8 +307,11 @@ private:
   uint32_t m_frameRate;               ///< Video frame rate (frames per second)
   Time m_frameInterval;               ///< Time between frame consumption
 
-  std::map<uint32_t, VideoFrame> m_incompleteFrames;  ///< Frames being assembled
-  std::deque<VideoFrame> m_frameBuffer;               ///< Complete frames ready for playback
+  VideoFrameAssembler m_assembler;    ///< Frames being assembled
+  Time m_frameTimeout;                ///< Time after which an incomplete frame is dropped
+  uint32_t m_fallbackFrameId;         ///< Inferred frame for packets without frame info
+  uint32_t m_fallbackPacketCount;     ///< Packets assigned to m_fallbackFrameId so far
+  NadaRingQueue<VideoFrame> m_frameBuffer;            ///< Complete frames ready for playback
 
   EventId m_consumeEvent;             ///< Event for consuming frames
   EventId m_statsEvent;               ///< Event for recording buffer statistics
@@ -174,7 +320,55 @@ private:
   uint32_t m_consumedFrames;          ///< Number of frames consumed
   uint32_t m_bufferUnderruns;         ///< Number of buffer underruns
 
-  std::vector<uint32_t> m_bufferLengthSamples;  ///< Samples of buffer length for statistics
+  NadaRunningMeanVar m_bufferLengthSamples;     ///< Running mean of the sampled buffer length
+
+  NadaLogHistogram m_frameLatency;    ///< Sender timestamp to completion of the frames (us)
+  NadaLogHistogram m_assemblyTime;    ///< First to last packet of the frames (us)
+  NadaLogHistogram m_frameJitter;     ///< Latency change between consecutive frames (us)
+  Time m_lastFrameLatency;            ///< Latency of the last completed frame
+  uint64_t m_completedFrames;         ///< Frames that entered the playout buffer
+  uint64_t m_completedBytes;          ///< Bytes of those frames
+  Time m_firstFrameTime;              ///< Completion of the first frame
+  Time m_playoutStart;                ///< First playout, zero before
+  Time m_stallStart;                  ///< Start of the stall in progress, if any
+  Time m_stallTime;                   ///< Time of the stalls that ended
+  DataRate m_qoeReferenceRate;        ///< Bitrate scored as full quality
+
+  /**
+   * \brief Aggregated ACK being built for one sender
+   */
+  struct PendingFeedback
+  {
+    NadaAckVector ackVector;          ///< Packets received since the last ACK
+    EventId flushEvent;               ///< Timer sending the ACK after m_ackInterval
+    Time newestArrival;               ///< Arrival of the highest sequence received
+    Time newestForwardDelay;          ///< Its arrival minus its sender timestamp
+  };
+
+  uint32_t m_ackEveryN;               ///< Packets per aggregated ACK (1 = per-packet ACKs)
+  Time m_ackInterval;                 ///< Maximum time an ACK is held back (0 = no timer)
+  std::map<Address, PendingFeedback> m_pendingFeedback;  ///< Pending ACKs per sender
+
+  bool m_nackEnabled;                 ///< Request missing packets again
+  Time m_nackHoldoff;                 ///< Silence after which a frame's gaps are requested
+  Time m_nackRetryInterval;           ///< Minimum time between two requests for a frame
+  uint32_t m_nackRetries;             ///< Requests allowed per frame
+  EventId m_nackEvent;                ///< Timer looking for stalled frames
+  Address m_nackPeer;                 ///< Sender of the latest frame, NACKs go there
+  uint64_t m_nackedPackets;           ///< NACK entries sent so far
+  std::vector<VideoFrameAssembler::Missing> m_missing;  ///< Reused by SendNacks()
+
+  VideoPlayoutController m_playout;   ///< Target depth and playout rate
+  bool m_playing;                     ///< Frames are being consumed
+  Time m_startupDelay;                ///< Media buffered before playback starts
+  Time m_minPlayoutDelay;             ///< Smallest target playout depth
+  Time m_maxPlayoutDelay;             ///< Largest target playout depth
+  double m_jitterFactor;              ///< Jitter multiple in the target depth
+  double m_maxPlayoutStretch;         ///< Largest relative playout rate change
+
+  TracedCallback<uint32_t, uint32_t, Time> m_frameCompleteTrace;  ///< Frames entering the buffer
+  TracedCallback<uint32_t> m_underrunTrace;                       ///< Buffer underruns
+  TracedCallback<uint32_t, Time> m_bufferDepthTrace;              ///< Buffer depth changes
 };
 
 /**
@@ -0,0 +1,292 @@
+#include "video-source.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("VideoSource");
+NS_OBJECT_ENSURE_REGISTERED(VideoSource);
+
+TypeId
+VideoSource::GetTypeId(void)
+{
+    static TypeId tid =
+        TypeId("ns3::VideoSource")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<VideoSource>()
+            .AddAttribute("TraceFile",
+                          "Frame size trace to replay (see VideoFrameTrace); empty for "
+                          "synthetic frames",
+                          StringValue(""),
+                          MakeStringAccessor(&VideoSource::m_traceFile),
+                          MakeStringChecker())
+            .AddAttribute("Loop",
+                          "Start the trace over when it ends instead of stopping",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&VideoSource::m_loop),
+                          MakeBooleanChecker())
+            .AddAttribute("FrameRate",
+                          "Frames per second",
+                          UintegerValue(30),
+                          MakeUintegerAccessor(&VideoSource::m_frameRate),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("KeyFrameInterval",
+                          "Frames between two synthetic key frames (0 = first frame only)",
+                          UintegerValue(60),
+                          MakeUintegerAccessor(&VideoSource::m_keyFrameInterval),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("KeyFrameRatio",
+                          "Size of a synthetic key frame over that of a delta frame",
+                          DoubleValue(5.0),
+                          MakeDoubleAccessor(&VideoSource::m_keyFrameRatio),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("SizeJitter",
+                          "Largest relative variation of synthetic frame sizes",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&VideoSource::m_sizeJitter),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("Mtu",
+                          "Payload bytes per packet",
+                          UintegerValue(1200),
+                          MakeUintegerAccessor(&VideoSource::m_mtu),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxFrames",
+                          "Frames to send (0 = until stopped)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&VideoSource::m_maxFrames),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TargetRate",
+                          "Bitrate targeted when not rate adaptive",
+                          DataRateValue(DataRate("2Mbps")),
+                          MakeDataRateAccessor(&VideoSource::m_targetRate),
+                          MakeDataRateChecker())
+            .AddAttribute("RateAdaptive",
+                          "Target the total rate of the client's congestion controllers",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&VideoSource::m_rateAdaptive),
+                          MakeBooleanChecker())
+            .AddAttribute("MinRate",
+                          "Lowest bitrate targeted when rate adaptive",
+                          DataRateValue(DataRate("150kbps")),
+                          MakeDataRateAccessor(&VideoSource::m_minRate),
+                          MakeDataRateChecker())
+            .AddAttribute("MaxRate",
+                          "Highest bitrate targeted when rate adaptive",
+                          DataRateValue(DataRate("20Mbps")),
+                          MakeDataRateAccessor(&VideoSource::m_maxRate),
+                          MakeDataRateChecker())
+            .AddAttribute("RetryInterval",
+                          "Wait before trying again while the client is not ready",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&VideoSource::m_retryInterval),
+                          MakeTimeChecker())
+            .AddTraceSource("Frame",
+                            "A frame was produced: frame ID, key frame, size and target rate",
+                            MakeTraceSourceAccessor(&VideoSource::m_frameTrace),
+                            "ns3::VideoSource::FrameTracedCallback");
+    return tid;
+}
+
+VideoSource::VideoSource()
+    : m_client(nullptr),
+      m_trace(nullptr),
+      m_loop(true),
+      m_frameRate(30),
+      m_keyFrameInterval(60),
+      m_keyFrameRatio(5.0),
+      m_sizeJitter(0.1),
+      m_mtu(1200),
+      m_maxFrames(0),
+      m_targetRate(DataRate("2Mbps")),
+      m_rateAdaptive(false),
+      m_minRate(DataRate("150kbps")),
+      m_maxRate(DataRate("20Mbps")),
+      m_retryInterval(MilliSeconds(100)),
+      m_frameIndex(0),
+      m_framesSent(0),
+      m_keyFramesSent(0),
+      m_bytesSent(0),
+      m_lastTarget(DataRate())
+{
+    NS_LOG_FUNCTION(this);
+    m_rng = CreateObject<UniformRandomVariable>();
+}
+
+VideoSource::~VideoSource()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+VideoSource::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_frameEvent);
+    m_client = nullptr;
+    m_trace = nullptr;
+    m_rng = nullptr;
+    Application::DoDispose();
+}
+
+void
+VideoSource::SetClient(Ptr<MultiPathNadaClientBase> client)
+{
+    NS_LOG_FUNCTION(this << client);
+    m_client = client;
+}
+
+int64_t
+VideoSource::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_rng->SetStream(stream);
+    return 1;
+}
+
+uint32_t
+VideoSource::GetFramesSent(void) const
+{
+    return m_framesSent;
+}
+
+uint32_t
+VideoSource::GetKeyFramesSent(void) const
+{
+    return m_keyFramesSent;
+}
+
+uint64_t
+VideoSource::GetBytesSent(void) const
+{
+    return m_bytesSent;
+}
+
+DataRate
+VideoSource::GetTargetRate(void) const
+{
+    return m_lastTarget;
+}
+
+void
+VideoSource::StartApplication(void)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_client)
+    {
+        NS_LOG_ERROR("VideoSource started without a client");
+        return;
+    }
+
+    m_trace = nullptr;
+    if (!m_traceFile.empty())
+    {
+        m_trace = VideoFrameTrace::Open(m_traceFile);
+        if (!m_trace)
+        {
+            NS_LOG_ERROR("Cannot replay video trace " << m_traceFile);
+            return;
+        }
+    }
+
+    m_frameEvent = Simulator::ScheduleNow(&VideoSource::SendFrame, this);
+}
+
+void
+VideoSource::StopApplication(void)
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_frameEvent);
+}
+
+double
+VideoSource::GetTargetBps(void) const
+{
+    if (!m_rateAdaptive)
+    {
+        return m_targetRate.GetBitRate();
+    }
+    double rate = m_client->GetTotalRate().GetBitRate();
+    return std::min<double>(std::max<double>(rate, m_minRate.GetBitRate()), m_maxRate.GetBitRate());
+}
+
+void
+VideoSource::SendFrame(void)
+{
+    if (m_maxFrames > 0 && m_frameIndex >= m_maxFrames)
+    {
+        NS_LOG_INFO("VideoSource reached its frame limit (" << m_maxFrames << ")");
+        return;
+    }
+
+    if (!m_client->IsReady())
+    {
+        NS_LOG_DEBUG("Client not ready, retrying in " << m_retryInterval.GetMilliSeconds() << "ms");
+        m_frameEvent = Simulator::Schedule(m_retryInterval, &VideoSource::SendFrame, this);
+        return;
+    }
+
+    Time frameInterval = Seconds(1.0 / m_frameRate);
+    double targetBps = GetTargetBps();
+    // Mean frame size the target leaves room for
+    double meanBytes = targetBps / 8.0 / m_frameRate;
+
+    bool isKeyFrame;
+    double size;
+    if (m_trace)
+    {
+        if (!m_loop && m_frameIndex >= m_trace->GetFrames())
+        {
+            NS_LOG_INFO("VideoSource reached the end of its trace");
+            return;
+        }
+        uint32_t position = m_frameIndex % m_trace->GetFrames();
+        isKeyFrame = m_trace->IsKeyFrame(position);
+        size = m_trace->GetSize(position);
+        if (m_rateAdaptive)
+        {
+            // Keep the shape of the trace, only its bitrate follows the target
+            size *= meanBytes / m_trace->GetMeanSize();
+        }
+    }
+    else
+    {
+        isKeyFrame = (m_keyFrameInterval > 0) ? (m_frameIndex % m_keyFrameInterval == 0)
+                                              : (m_frameIndex == 0);
+        // Delta size such that a key frame interval averages meanBytes per frame
+        double interval = (m_keyFrameInterval > 0) ? m_keyFrameInterval : 1e9;
+        double deltaBytes = meanBytes * interval / (interval - 1.0 + m_keyFrameRatio);
+        size = isKeyFrame ? deltaBytes * m_keyFrameRatio : deltaBytes;
+        size *= 1.0 + m_rng->GetValue(-m_sizeJitter, m_sizeJitter);
+    }
+    uint32_t frameSize = std::max<uint32_t>(static_cast<uint32_t>(size), 1);
+
+    uint32_t frameId = m_frameIndex++;
+    m_lastTarget = DataRate(static_cast<uint64_t>(targetBps));
+    m_bytesSent += frameSize;
+    m_frameTrace(frameId, isKeyFrame, frameSize, m_lastTarget);
+
+    NS_LOG_INFO("VideoSource frame " << frameId << (isKeyFrame ? " (key)" : "") << ": "
+                                     << frameSize << " bytes at target "
+                                     << targetBps / 1e6 << " Mbps");
+
+    m_client->UpdateVideoFrameInfo(frameSize, isKeyFrame, frameInterval);
+    if (m_client->SendVideoFrame(frameId, isKeyFrame, frameSize, m_mtu))
+    {
+        m_framesSent++;
+        m_keyFramesSent += isKeyFrame ? 1 : 0;
+    }
+
+    m_frameEvent = Simulator::Schedule(frameInterval, &VideoSource::SendFrame, this);
+}
+
+} // namespace ns3
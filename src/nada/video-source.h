@@ -0,0 +1,128 @@
+#ifndef VIDEO_SOURCE_H
+#define VIDEO_SOURCE_H
+
+#include "ns3/application.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/mp-nada-base.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/video-frame-trace.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \brief Video encoder model feeding frames to a multipath NADA client
+ *
+ * Produces one frame every 1/FrameRate and hands it to the client with
+ * SendVideoFrame(). Frame sizes come from one of two models:
+ *
+ * - With TraceFile set, the sizes and key frames of a VideoFrameTrace are
+ *   replayed, looping over the trace if Loop is set;
+ * - otherwise frames are synthetic: a key frame every KeyFrameInterval
+ *   frames, KeyFrameRatio times the size of a delta frame, with sizes
+ *   varying by up to SizeJitter either way.
+ *
+ * The bitrate targeted is TargetRate, or with RateAdaptive the client's
+ * GetTotalRate(), bounded by MinRate and MaxRate, as a rate-adaptive
+ * encoder would follow the congestion controller. Trace frames are scaled
+ * by the target over the trace's own mean bitrate, which keeps the
+ * relative size of key frames and so the bursts they cause. The path
+ * controllers are told about every frame through UpdateVideoFrameInfo().
+ */
+class VideoSource : public Application
+{
+  public:
+    /**
+     * TracedCallback signature of the Frame trace
+     * \param frameId The frame
+     * \param isKeyFrame Whether it is a key frame
+     * \param size Frame size in bytes
+     * \param targetRate Bitrate the encoder targeted
+     */
+    typedef void (*FrameTracedCallback)(uint32_t frameId,
+                                        bool isKeyFrame,
+                                        uint32_t size,
+                                        DataRate targetRate);
+
+    static TypeId GetTypeId(void);
+    VideoSource();
+    virtual ~VideoSource();
+
+    /**
+     * \brief Set the client the frames are sent through
+     * \param client The multipath client, installed on the same node
+     */
+    void SetClient(Ptr<MultiPathNadaClientBase> client);
+
+    /**
+     * \brief Assign a fixed random stream number to the size jitter
+     * \param stream First stream index to use
+     * \return Number of stream indices used
+     */
+    virtual int64_t AssignStreams(int64_t stream) override;
+
+    uint32_t GetFramesSent(void) const;
+    uint32_t GetKeyFramesSent(void) const;
+    uint64_t GetBytesSent(void) const;
+
+    /**
+     * \brief Get the bitrate the last frame was sized for
+     * \return The target rate
+     */
+    DataRate GetTargetRate(void) const;
+
+  protected:
+    virtual void DoDispose(void) override;
+
+  private:
+    virtual void StartApplication(void) override;
+    virtual void StopApplication(void) override;
+
+    /**
+     * \brief Encode and send the next frame, then schedule the one after
+     */
+    void SendFrame(void);
+
+    /**
+     * \brief Bitrate the next frame is sized for
+     */
+    double GetTargetBps(void) const;
+
+    Ptr<MultiPathNadaClientBase> m_client; // Client the frames go through
+    Ptr<VideoFrameTrace> m_trace;          // Replayed sizes, nullptr for synthetic frames
+    Ptr<UniformRandomVariable> m_rng;      // Synthetic size jitter
+
+    std::string m_traceFile;  // Frame size trace, empty for synthetic frames
+    bool m_loop;              // Start the trace over when it ends
+    uint32_t m_frameRate;     // Frames per second
+    uint32_t m_keyFrameInterval; // Frames between synthetic key frames
+    double m_keyFrameRatio;   // Synthetic key frame size over delta frame size
+    double m_sizeJitter;      // Relative synthetic size variation
+    uint32_t m_mtu;           // Payload bytes per packet
+    uint32_t m_maxFrames;     // Frames to send, 0 for no limit
+    DataRate m_targetRate;    // Fixed target bitrate
+    bool m_rateAdaptive;      // Target the client's total rate instead
+    DataRate m_minRate;       // Lowest adaptive target
+    DataRate m_maxRate;       // Highest adaptive target
+    Time m_retryInterval;     // Wait before retrying while the client is not ready
+
+    EventId m_frameEvent;     // Next frame
+    uint32_t m_frameIndex;    // Frames produced, and next trace position
+    uint32_t m_framesSent;    // Frames fully handed to the client
+    uint32_t m_keyFramesSent; // Key frames among them
+    uint64_t m_bytesSent;     // Bytes of the frames produced
+    DataRate m_lastTarget;    // Target of the last frame
+
+    TracedCallback<uint32_t, bool, uint32_t, DataRate> m_frameTrace; // Frames produced
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_SOURCE_H */